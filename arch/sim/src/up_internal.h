@@ -335,12 +335,14 @@ FAR struct ioexpander_dev_s *sim_ioexpander_initialize(void);
 #if defined(CONFIG_NET_ETHERNET) && !defined(__CYGWIN__)
 void tapdev_init(void);
 unsigned int tapdev_read(unsigned char *buf, unsigned int buflen);
+int tapdev_avail(void);
 void tapdev_send(unsigned char *buf, unsigned int buflen);
 void tapdev_ifup(in_addr_t ifaddr);
 void tapdev_ifdown(void);
 
 #  define netdev_init()           tapdev_init()
 #  define netdev_read(buf,buflen) tapdev_read(buf,buflen)
+#  define netdev_avail()          tapdev_avail()
 #  define netdev_send(buf,buflen) tapdev_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     tapdev_ifup(ifaddr)
 #  define netdev_ifdown()         tapdev_ifdown()
@@ -355,6 +357,7 @@ void wpcap_send(unsigned char *buf, unsigned int buflen);
 
 #  define netdev_init()           wpcap_init()
 #  define netdev_read(buf,buflen) wpcap_read(buf,buflen)
+#  define netdev_avail()          (true) /* wpcap_read() does not wait */
 #  define netdev_send(buf,buflen) wpcap_send(buf,buflen)
 #  define netdev_ifup(ifaddr)     {}
 #  define netdev_ifdown()         {}
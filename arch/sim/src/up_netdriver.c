@@ -166,6 +166,7 @@ static int sim_txpoll(struct net_driver_s *dev)
 void netdriver_loop(void)
 {
   FAR struct eth_hdr_s *eth;
+  int nrx = 0;
 
   /* Check for new frames.  If so, then poll the network for new XMIT data */
 
@@ -181,10 +182,12 @@ void netdriver_loop(void)
   /* Disable preemption through to the following so that it behaves a little more
    * like an interrupt (otherwise, the following logic gets pre-empted an behaves
    * oddly.
+   *
+   * Up to CONFIG_NETDEV_RXBUDGET frames are received on each pass.
    */
 
   sched_lock();
-  if (g_sim_dev.d_len > 0)
+  while (g_sim_dev.d_len > 0)
     {
       NETDEV_RXPACKETS(&g_sim_dev);
 
@@ -315,11 +318,22 @@ void netdriver_loop(void)
         {
           NETDEV_RXERRORS(&g_sim_dev);
         }
+
+      /* Only the first read may wait for a frame.  Thereafter, just drain
+       * the frames that are already queued.
+       */
+
+      g_sim_dev.d_len = 0;
+      if (++nrx < CONFIG_NETDEV_RXBUDGET && netdev_avail())
+        {
+          g_sim_dev.d_len = netdev_read((FAR unsigned char *)g_sim_dev.d_buf,
+                                        CONFIG_NET_ETH_PKTSIZE);
+        }
     }
 
-  /* Otherwise, it must be a timeout event */
+  /* If nothing was received, it must be a timeout event */
 
-  else if (timer_expired(&g_periodic_timer))
+  if (nrx == 0 && timer_expired(&g_periodic_timer))
     {
       timer_reset(&g_periodic_timer);
       devif_timer(&g_sim_dev, sim_txpoll);
@@ -278,6 +278,27 @@ unsigned int tapdev_read(unsigned char *buf, unsigned int buflen)
   return ret;
 }
 
+int tapdev_avail(void)
+{
+  fd_set                fdset;
+  struct timeval        tv;
+
+  if (gtapdevfd < 0)
+    {
+      return 0;
+    }
+
+  /* Poll the tap device without waiting */
+
+  tv.tv_sec  = 0;
+  tv.tv_usec = 0;
+
+  FD_ZERO(&fdset);
+  FD_SET(gtapdevfd, &fdset);
+
+  return select(gtapdevfd + 1, &fdset, NULL, NULL, &tv) > 0;
+}
+
 void tapdev_send(unsigned char *buf, unsigned int buflen)
 {
   int ret;
@@ -42,12 +42,37 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
+
 #include <nuttx/binfmt/binfmt.h>
 
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+/* Statistics of the binfmt cache */
+
+struct binfmt_cachestats_s
+{
+  uint32_t hits;                       /* Programs started from the cache */
+  uint32_t misses;                     /* Programs loaded from the file */
+  uint32_t evictions;                  /* Images evicted from the cache */
+  uint16_t nentries;                   /* Number of cached images */
+};
+
+/* Callback used by binfmt_cache_foreach() */
+
+typedef CODE int (*binfmt_cache_callback_t)(FAR const char *filename,
+                                            size_t datasize, uint32_t hits,
+                                            bool busy, FAR void *arg);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -132,6 +157,100 @@ void binfmt_freeargv(FAR struct binary_s *bin);
 #  define binfmt_freeargv(bin)
 #endif
 
+/****************************************************************************
+ * Name: binfmt_cache_lookup
+ *
+ * Description:
+ *   Check if an idle, cached image of the program is available.  If so,
+ *   restore its .data/.bss region and return the image in 'bin'.
+ *
+ * Input Parameters:
+ *   bin - Load structure.  filename must be the absolute path to the
+ *         program file.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the cached image was returned;  -ENOENT is
+ *   returned if the program must be loaded.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+int binfmt_cache_lookup(FAR struct binary_s *bin);
+#endif
+
+/****************************************************************************
+ * Name: binfmt_cache_add
+ *
+ * Description:
+ *   Add the program image that was just loaded into 'bin' to the cache.
+ *
+ * Input Parameters:
+ *   bin - Load structure of the program that was just loaded
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+void binfmt_cache_add(FAR struct binary_s *bin);
+#endif
+
+/****************************************************************************
+ * Name: binfmt_cache_release
+ *
+ * Description:
+ *   Return a program image to the cache when the task using it exits.
+ *
+ * Input Parameters:
+ *   bin - Load structure of the exiting program
+ *
+ * Returned Value:
+ *   True is returned if the image belonged to the cache.  In that case,
+ *   the caller must not free the image.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+bool binfmt_cache_release(FAR struct binary_s *bin);
+#endif
+
+/****************************************************************************
+ * Name: binfmt_cache_flush
+ *
+ * Description:
+ *   Free all cached images that are not in use.
+ *
+ * Returned Value:
+ *   The number of images that were freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+int binfmt_cache_flush(void);
+#endif
+
+/****************************************************************************
+ * Name: binfmt_cache_foreach
+ *
+ * Description:
+ *   Return the cache statistics and visit each cached image.
+ *
+ * Input Parameters:
+ *   callback - This function will be called for each cached image.
+ *   arg      - An opaque argument that will be passed to the callback.
+ *   stats    - The location to return the cache statistics.
+ *
+ * Returned Value:
+ *   Zero (OK) or the non-zero value returned by the callback.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_BINFMT_CACHE
+int binfmt_cache_foreach(binfmt_cache_callback_t callback, FAR void *arg,
+                         FAR struct binfmt_cachestats_s *stats);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
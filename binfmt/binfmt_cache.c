@@ -0,0 +1,632 @@
+/****************************************************************************
+ * binfmt/binfmt_cache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/binfmt/binfmt.h>
+
+#include "binfmt.h"
+
+#ifdef CONFIG_BINFMT_CACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one cached program image.  The image was loaded
+ * and relocated once.  The .text, .rodata, and constructor lists are used
+ * as-is each time the program is started again.  Only the .data/.bss
+ * region is restored from the pristine copy in template[].
+ *
+ * Since the image is relocated for one fixed .data/.bss address, the image
+ * can be used by only one running task at a time.
+ */
+
+struct binfmt_cache_s
+{
+  FAR struct binfmt_cache_s *flink;   /* Supports a singly linked list */
+  FAR char *filename;                 /* Full path to the program file */
+  FAR const struct symtab_s *exports; /* Symbol table used for binding */
+  int nexports;                       /* Number of symbols in exports[] */
+  time_t mtime;                       /* Modification time of the file */
+  off_t filesize;                     /* Size of the file */
+  struct binary_s image;              /* The loaded program image */
+  uint32_t hits;                      /* Number of times the image was reused */
+  bool busy;                          /* The image is used by a running task */
+  bool stale;                         /* Free the image when no longer busy */
+  uint8_t template[1];                /* Pristine copy of .data/.bss */
+};
+
+#define SIZEOF_BINFMT_CACHE_S(n) \
+  (sizeof(struct binfmt_cache_s) + (n) - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static sem_t g_binfmt_cachelock = SEM_INITIALIZER(1);
+static FAR struct binfmt_cache_s *g_binfmt_cache; /* Most recently used first */
+static struct binfmt_cachestats_s g_binfmt_cachestats;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_cache_lock and binfmt_cache_unlock
+ *
+ * Description:
+ *   Get or relinquish exclusive access to the binfmt cache.
+ *
+ ****************************************************************************/
+
+static void binfmt_cache_lock(void)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&g_binfmt_cachelock);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#define binfmt_cache_unlock() nxsem_post(&g_binfmt_cachelock)
+
+/****************************************************************************
+ * Name: binfmt_cache_remove
+ *
+ * Description:
+ *   Remove an entry from the cache list.
+ *
+ * Assumptions:
+ *   The caller holds the cache lock.
+ *
+ ****************************************************************************/
+
+static void binfmt_cache_remove(FAR struct binfmt_cache_s *entry)
+{
+  FAR struct binfmt_cache_s *prev;
+  FAR struct binfmt_cache_s *curr;
+
+  for (prev = NULL, curr = g_binfmt_cache;
+       curr != NULL && curr != entry;
+       prev = curr, curr = curr->flink);
+
+  DEBUGASSERT(curr != NULL);
+  if (curr != NULL)
+    {
+      if (prev != NULL)
+        {
+          prev->flink = curr->flink;
+        }
+      else
+        {
+          g_binfmt_cache = curr->flink;
+        }
+
+      curr->flink = NULL;
+      g_binfmt_cachestats.nentries--;
+    }
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_free
+ *
+ * Description:
+ *   Free an entry that is no longer in use and that has already been
+ *   removed from the cache list.  This releases the program image as
+ *   unload_module() would have done.
+ *
+ ****************************************************************************/
+
+static void binfmt_cache_free(FAR struct binfmt_cache_s *entry)
+{
+  FAR struct binary_s *image = &entry->image;
+  int i;
+
+  DEBUGASSERT(!entry->busy);
+  binfo("Freeing cached image of %s\n", entry->filename);
+
+  if (image->mapped != NULL)
+    {
+      munmap(image->mapped, image->mapsize);
+    }
+
+  for (i = 0; i < BINFMT_NALLOC; i++)
+    {
+      if (image->alloc[i] != NULL)
+        {
+          kumm_free(image->alloc[i]);
+        }
+    }
+
+  kmm_free(entry->filename);
+  kmm_free(entry);
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_freelist
+ *
+ * Description:
+ *   Free a list of entries that have been removed from the cache list.
+ *
+ * Returned Value:
+ *   The number of entries freed.
+ *
+ ****************************************************************************/
+
+static int binfmt_cache_freelist(FAR struct binfmt_cache_s *list)
+{
+  FAR struct binfmt_cache_s *entry;
+  int nfreed = 0;
+
+  while (list != NULL)
+    {
+      entry = list;
+      list  = entry->flink;
+      binfmt_cache_free(entry);
+      nfreed++;
+    }
+
+  return nfreed;
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_evict
+ *
+ * Description:
+ *   Evict the least recently used entry that is not in use.
+ *
+ * Returned Value:
+ *   The evicted entry (which must be freed after the lock is released) or
+ *   NULL if all entries are in use.
+ *
+ * Assumptions:
+ *   The caller holds the cache lock.
+ *
+ ****************************************************************************/
+
+static FAR struct binfmt_cache_s *binfmt_cache_evict(void)
+{
+  FAR struct binfmt_cache_s *victim = NULL;
+  FAR struct binfmt_cache_s *curr;
+
+  for (curr = g_binfmt_cache; curr != NULL; curr = curr->flink)
+    {
+      if (!curr->busy)
+        {
+          victim = curr;
+        }
+    }
+
+  if (victim != NULL)
+    {
+      binfmt_cache_remove(victim);
+      g_binfmt_cachestats.evictions++;
+    }
+
+  return victim;
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_copyimage
+ *
+ * Description:
+ *   Copy the description of the loaded program image (but none of the
+ *   per-invocation information such as the argument list).
+ *
+ ****************************************************************************/
+
+static void binfmt_cache_copyimage(FAR struct binary_s *dest,
+                                   FAR const struct binary_s *src)
+{
+  memcpy(dest->alloc, src->alloc, sizeof(dest->alloc));
+
+  dest->entrypt   = src->entrypt;
+  dest->mapped    = src->mapped;
+  dest->mapsize   = src->mapsize;
+  dest->stacksize = src->stacksize;
+  dest->unload    = src->unload;
+  dest->datastart = src->datastart;
+  dest->datasize  = src->datasize;
+
+#ifdef CONFIG_BINFMT_CONSTRUCTORS
+  dest->ctors     = src->ctors;
+  dest->dtors     = src->dtors;
+  dest->nctors    = src->nctors;
+  dest->ndtors    = src->ndtors;
+#endif
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_cache_lookup
+ *
+ * Description:
+ *   Check if an idle, cached image of the program is available.  If so,
+ *   restore its .data/.bss region and return the image in 'bin'.
+ *
+ * Input Parameters:
+ *   bin - Load structure.  filename must be the absolute path to the
+ *         program file.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if the cached image was returned;  -ENOENT is
+ *   returned if the program must be loaded.
+ *
+ ****************************************************************************/
+
+int binfmt_cache_lookup(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *stale = NULL;
+  FAR struct binfmt_cache_s *prev;
+  FAR struct binfmt_cache_s *curr;
+  FAR struct binfmt_cache_s *next;
+  struct stat buf;
+  int ret;
+
+  DEBUGASSERT(bin != NULL && bin->filename != NULL);
+
+  ret = stat(bin->filename, &buf);
+  if (ret < 0)
+    {
+      return -ENOENT;
+    }
+
+  binfmt_cache_lock();
+
+  for (prev = NULL, curr = g_binfmt_cache; curr != NULL; curr = next)
+    {
+      next = curr->flink;
+
+      if (!curr->stale && curr->exports == bin->exports &&
+          curr->nexports == bin->nexports &&
+          strcmp(curr->filename, bin->filename) == 0)
+        {
+          /* If the file has changed since it was loaded, then the image
+           * can no longer be used.  Discard it now or, if it is busy, when
+           * the task using it exits.
+           */
+
+          if (curr->mtime != buf.st_mtime || curr->filesize != buf.st_size)
+            {
+              curr->stale = true;
+              if (!curr->busy)
+                {
+                  binfmt_cache_remove(curr);
+                  curr->flink = stale;
+                  stale       = curr;
+                  continue;
+                }
+            }
+          else if (!curr->busy)
+            {
+              break;
+            }
+        }
+
+      prev = curr;
+    }
+
+  if (curr == NULL)
+    {
+      g_binfmt_cachestats.misses++;
+      binfmt_cache_unlock();
+
+      binfmt_cache_freelist(stale);
+      return -ENOENT;
+    }
+
+  /* Move the entry to the head of the list */
+
+  if (prev != NULL)
+    {
+      prev->flink    = curr->flink;
+      curr->flink    = g_binfmt_cache;
+      g_binfmt_cache = curr;
+    }
+
+  /* Restore the .data/.bss region to its state immediately after the
+   * program was loaded and return the image.
+   */
+
+  memcpy(curr->image.datastart, curr->template, curr->image.datasize);
+  binfmt_cache_copyimage(bin, &curr->image);
+
+  curr->busy = true;
+  curr->hits++;
+  bin->cache = curr;
+
+  g_binfmt_cachestats.hits++;
+  binfmt_cache_unlock();
+
+  binfmt_cache_freelist(stale);
+
+  binfo("Using cached image of %s\n", bin->filename);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_add
+ *
+ * Description:
+ *   Add the program image that was just loaded into 'bin' to the cache.
+ *   This is only possible if the binary format provided the .data/.bss
+ *   region.  The image then belongs to the cache and will be returned to
+ *   the cache (rather than freed) by unload_module().  Failures are not
+ *   reported; the image is then simply not cached.
+ *
+ * Input Parameters:
+ *   bin - Load structure of the program that was just loaded
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void binfmt_cache_add(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *victim = NULL;
+  FAR struct binfmt_cache_s *entry;
+  struct stat buf;
+  int ret;
+
+  DEBUGASSERT(bin != NULL && bin->cache == NULL);
+
+  /* The image can be restored only if the binary format told us where the
+   * writable region is.  Formats with their own unload logic are not
+   * cached.
+   */
+
+  if (bin->datastart == NULL || bin->unload != NULL)
+    {
+      return;
+    }
+
+  ret = stat(bin->filename, &buf);
+  if (ret < 0)
+    {
+      return;
+    }
+
+  entry = (FAR struct binfmt_cache_s *)
+    kmm_zalloc(SIZEOF_BINFMT_CACHE_S(bin->datasize));
+
+  if (entry == NULL)
+    {
+      return;
+    }
+
+  entry->filename = (FAR char *)kmm_malloc(strlen(bin->filename) + 1);
+  if (entry->filename == NULL)
+    {
+      kmm_free(entry);
+      return;
+    }
+
+  strcpy(entry->filename, bin->filename);
+
+  entry->exports  = bin->exports;
+  entry->nexports = bin->nexports;
+  entry->mtime    = buf.st_mtime;
+  entry->filesize = buf.st_size;
+  entry->busy     = true;
+
+  /* Nothing has run yet, so the .data/.bss region is pristine */
+
+  memcpy(entry->template, bin->datastart, bin->datasize);
+  binfmt_cache_copyimage(&entry->image, bin);
+
+  binfmt_cache_lock();
+
+  /* Make room for the new entry, if necessary.  If all entries are in
+   * use, then the image will not be cached.
+   */
+
+  if (g_binfmt_cachestats.nentries >= CONFIG_BINFMT_CACHE_NENTRIES)
+    {
+      victim = binfmt_cache_evict();
+      if (victim == NULL)
+        {
+          binfmt_cache_unlock();
+          kmm_free(entry->filename);
+          kmm_free(entry);
+          return;
+        }
+    }
+
+  entry->flink   = g_binfmt_cache;
+  g_binfmt_cache = entry;
+  g_binfmt_cachestats.nentries++;
+  bin->cache     = entry;
+
+  binfmt_cache_unlock();
+
+  if (victim != NULL)
+    {
+      binfmt_cache_free(victim);
+    }
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_release
+ *
+ * Description:
+ *   Return a program image to the cache when the task using it exits.
+ *
+ * Input Parameters:
+ *   bin - Load structure of the exiting program
+ *
+ * Returned Value:
+ *   True is returned if the image belonged to the cache.  In that case,
+ *   the caller must not free the image.
+ *
+ ****************************************************************************/
+
+bool binfmt_cache_release(FAR struct binary_s *bin)
+{
+  FAR struct binfmt_cache_s *entry;
+
+  DEBUGASSERT(bin != NULL);
+
+  entry = bin->cache;
+  if (entry == NULL)
+    {
+      return false;
+    }
+
+  bin->cache = NULL;
+
+  binfmt_cache_lock();
+  DEBUGASSERT(entry->busy);
+  entry->busy = false;
+
+  if (entry->stale)
+    {
+      binfmt_cache_remove(entry);
+    }
+  else
+    {
+      entry = NULL;
+    }
+
+  binfmt_cache_unlock();
+
+  if (entry != NULL)
+    {
+      binfmt_cache_free(entry);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_flush
+ *
+ * Description:
+ *   Free all cached images that are not in use.  This is done when a
+ *   program cannot be loaded because of insufficient memory.
+ *
+ * Returned Value:
+ *   The number of images that were freed.
+ *
+ ****************************************************************************/
+
+int binfmt_cache_flush(void)
+{
+  FAR struct binfmt_cache_s *victims = NULL;
+  FAR struct binfmt_cache_s *victim;
+
+  binfmt_cache_lock();
+  while ((victim = binfmt_cache_evict()) != NULL)
+    {
+      victim->flink = victims;
+      victims       = victim;
+    }
+
+  binfmt_cache_unlock();
+
+  return binfmt_cache_freelist(victims);
+}
+
+/****************************************************************************
+ * Name: binfmt_cache_foreach
+ *
+ * Description:
+ *   Return the cache statistics and visit each cached image.  The callback
+ *   is called with the cache locked and must not call back into the cache.
+ *
+ * Input Parameters:
+ *   callback - This function will be called for each cached image.  The
+ *     traversal stops if the callback returns a non-zero value.  May be
+ *     NULL if only the statistics are needed.
+ *   arg      - An opaque argument that will be passed to the callback.
+ *   stats    - The location to return the cache statistics.
+ *
+ * Returned Value:
+ *   Zero (OK) or the non-zero value returned by the callback.
+ *
+ ****************************************************************************/
+
+int binfmt_cache_foreach(binfmt_cache_callback_t callback, FAR void *arg,
+                         FAR struct binfmt_cachestats_s *stats)
+{
+  FAR struct binfmt_cache_s *curr;
+  int ret = OK;
+
+  binfmt_cache_lock();
+
+  if (stats != NULL)
+    {
+      memcpy(stats, &g_binfmt_cachestats, sizeof(struct binfmt_cachestats_s));
+    }
+
+  for (curr = g_binfmt_cache;
+       callback != NULL && curr != NULL && ret == OK;
+       curr = curr->flink)
+    {
+      ret = callback(curr->filename, curr->image.datasize, curr->hits,
+                     curr->busy, arg);
+    }
+
+  binfmt_cache_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_BINFMT_CACHE */
@@ -96,12 +96,13 @@ static int load_default_priority(FAR struct binary_s *bin)
 }
 
 /****************************************************************************
- * Name: load_absmodule
+ * Name: load_binfmts
  *
  * Description:
- *   Load a module into memory, bind it to an exported symbol take, and
- *   prep the module for execution.  bin->filename is known to be an absolute
- *   path to the file to be loaded.
+ *   Try each registered binary format handler to load a module into
+ *   memory, bind it to an exported symbol take, and prep the module for
+ *   execution.  bin->filename is known to be an absolute path to the file
+ *   to be loaded.
  *
  * Returned Value:
  *   Zero (OK) is returned on success; a negated errno value is returned on
@@ -109,7 +110,7 @@ static int load_default_priority(FAR struct binary_s *bin)
  *
  ****************************************************************************/
 
-static int load_absmodule(FAR struct binary_s *bin)
+static int load_binfmts(FAR struct binary_s *bin)
 {
   FAR struct binfmt_s *binfmt;
   int ret = -ENOENT;
@@ -150,6 +151,55 @@ static int load_absmodule(FAR struct binary_s *bin)
   return ret;
 }
 
+/****************************************************************************
+ * Name: load_absmodule
+ *
+ * Description:
+ *   Load a module into memory, bind it to an exported symbol take, and
+ *   prep the module for execution.  bin->filename is known to be an absolute
+ *   path to the file to be loaded.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ ****************************************************************************/
+
+static int load_absmodule(FAR struct binary_s *bin)
+{
+  int ret;
+
+#ifdef CONFIG_BINFMT_CACHE
+  /* Re-use an image of the program that is already in memory, if possible */
+
+  ret = binfmt_cache_lookup(bin);
+  if (ret == OK)
+    {
+      return OK;
+    }
+#endif
+
+  ret = load_binfmts(bin);
+
+#ifdef CONFIG_BINFMT_CACHE
+  /* If there was not enough memory, then release the memory held by idle
+   * cached images and try again.
+   */
+
+  if (ret == -ENOMEM && binfmt_cache_flush() > 0)
+    {
+      ret = load_binfmts(bin);
+    }
+
+  if (ret == OK)
+    {
+      binfmt_cache_add(bin);
+    }
+#endif
+
+  return ret;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -0,0 +1,349 @@
+/****************************************************************************
+ * binfmt/binfmt_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "binfmt.h"
+
+#if defined(CONFIG_BINFMT_CACHE) && !defined(CONFIG_DISABLE_MOUNTPOINT) && \
+    defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BINFMT)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BINFMT_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct binfmt_procfs_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+
+  /* Read helpers */
+
+  FAR char *buffer;                  /* User buffer pointer */
+  size_t buflen;                     /* Size of the user buffer */
+  size_t remaining;                  /* Space remaining in user buffer */
+  size_t totalsize;                  /* Total size returned by read() */
+  off_t offset;                      /* Offset skip on output */
+  char line[BINFMT_LINELEN];         /* Buffer for line formatting */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     binfmt_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     binfmt_procfs_close(FAR struct file *filep);
+static ssize_t binfmt_procfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     binfmt_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     binfmt_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See include/nutts/fs/procfs.h
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations binfmt_procfsoperations =
+{
+  binfmt_procfs_open,   /* open */
+  binfmt_procfs_close,  /* close */
+  binfmt_procfs_read,   /* read */
+  NULL,                 /* write */
+  binfmt_procfs_dup,    /* dup */
+
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  binfmt_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: binfmt_procfs_output
+ ****************************************************************************/
+
+static int binfmt_procfs_output(FAR struct binfmt_procfs_file_s *priv,
+                                size_t linesize)
+{
+  size_t copysize;
+
+  if (linesize >= BINFMT_LINELEN)
+    {
+      linesize = BINFMT_LINELEN - 1;
+    }
+
+  copysize = procfs_memcpy(priv->line, linesize, priv->buffer,
+                           priv->remaining, &priv->offset);
+  priv->totalsize += copysize;
+  priv->buffer    += copysize;
+  priv->remaining -= copysize;
+
+  return (priv->totalsize >= priv->buflen) ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_callback
+ ****************************************************************************/
+
+static int binfmt_procfs_callback(FAR const char *filename, size_t datasize,
+                                  uint32_t hits, bool busy, FAR void *arg)
+{
+  FAR struct binfmt_procfs_file_s *priv;
+  size_t linesize;
+
+  DEBUGASSERT(filename != NULL && arg != NULL);
+  priv = (FAR struct binfmt_procfs_file_s *)arg;
+
+  linesize = snprintf(priv->line, BINFMT_LINELEN, "%s,%lu,%lu,%s\n",
+                      filename, (unsigned long)datasize,
+                      (unsigned long)hits, busy ? "busy" : "idle");
+
+  return binfmt_procfs_output(priv, linesize);
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_open
+ ****************************************************************************/
+
+static int binfmt_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath,
+                              int oflags, mode_t mode)
+{
+  FAR struct binfmt_procfs_file_s *priv;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if (((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0))
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate the open file structure */
+
+  priv = (FAR struct binfmt_procfs_file_s *)
+    kmm_zalloc(sizeof(struct binfmt_procfs_file_s));
+
+  if (!priv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the open file structure as the open-specific state in
+   * filep->f_priv.
+   */
+
+  filep->f_priv = (FAR void *)priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_close
+ ****************************************************************************/
+
+static int binfmt_procfs_close(FAR struct file *filep)
+{
+  FAR struct binfmt_procfs_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct binfmt_procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_read
+ ****************************************************************************/
+
+static ssize_t binfmt_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct binfmt_procfs_file_s *priv;
+  struct binfmt_cachestats_s stats;
+  size_t linesize;
+  int ret;
+
+  finfo("buffer=%p buflen=%lu\n", buffer, (unsigned long)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = (FAR struct binfmt_procfs_file_s *)filep->f_priv;
+  DEBUGASSERT(priv);
+
+  priv->remaining = buflen;
+  priv->totalsize = 0;
+  priv->buffer    = buffer;
+  priv->buflen    = buflen;
+  priv->offset    = filep->f_pos;
+
+  /* Output the cache statistics followed by one line per cached image */
+
+  (void)binfmt_cache_foreach(NULL, NULL, &stats);
+
+  linesize = snprintf(priv->line, BINFMT_LINELEN,
+                      "hits %lu\nmisses %lu\nevictions %lu\nentries %u\n",
+                      (unsigned long)stats.hits,
+                      (unsigned long)stats.misses,
+                      (unsigned long)stats.evictions,
+                      (unsigned int)stats.nentries);
+
+  ret = binfmt_procfs_output(priv, linesize);
+  if (ret == 0)
+    {
+      ret = binfmt_cache_foreach(binfmt_procfs_callback, priv, NULL);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  filep->f_pos += priv->totalsize;
+  return priv->totalsize;
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int binfmt_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct binfmt_procfs_file_s *oldpriv;
+  FAR struct binfmt_procfs_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = (FAR struct binfmt_procfs_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = (FAR struct binfmt_procfs_file_s *)
+    kmm_zalloc(sizeof(struct binfmt_procfs_file_s));
+
+  if (!newpriv)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct binfmt_procfs_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: binfmt_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int binfmt_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode    = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_BINFMT_CACHE && !CONFIG_DISABLE_MOUNTPOINT &&
+        * CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_BINFMT */
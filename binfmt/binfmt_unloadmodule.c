@@ -169,6 +169,17 @@ int unload_module(FAR struct binary_s *binp)
 
       binfmt_freeargv(binp);
 
+#ifdef CONFIG_BINFMT_CACHE
+      /* If the image belongs to the binfmt cache, then just return it to
+       * the cache for re-use.
+       */
+
+      if (binfmt_cache_release(binp))
+        {
+          return OK;
+        }
+#endif
+
       /* Unmap mapped address spaces */
 
       if (binp->mapped)
@@ -279,6 +279,13 @@ static int elf_loadbinary(FAR struct binary_s *binp)
   binp->alloc[0]  = (FAR void *)loadinfo.textalloc;
 #endif
 
+#ifdef CONFIG_BINFMT_CACHE
+  /* Let the binfmt cache know how to restore the image for re-use */
+
+  binp->datastart = (FAR void *)loadinfo.dataalloc;
+  binp->datasize  = loadinfo.datasize;
+#endif
+
 #ifdef CONFIG_BINFMT_CONSTRUCTORS
   /* Save information about constructors.  NOTE:  destructors are not
    * yet supported.
@@ -0,0 +1,990 @@
+/****************************************************************************
+ * drivers/bcache/bcache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/mount.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
+#include <nuttx/drivers/bcache.h>
+
+#include "bcache.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define MAX_OPENCNT (255) /* Limit of uint8_t */
+
+#define bcache_devtake(d)  bcache_takesem(&(d)->exclsem)
+#define bcache_devgive(d)  nxsem_post(&(d)->exclsem)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void    bcache_takesem(FAR sem_t *sem);
+static int     bcache_open(FAR struct inode *inode);
+static int     bcache_close(FAR struct inode *inode);
+static ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                 size_t start_sector, unsigned int nsectors);
+static ssize_t bcache_write(FAR struct inode *inode,
+                 FAR const unsigned char *buffer, size_t start_sector,
+                 unsigned int nsectors);
+static int     bcache_geometry(FAR struct inode *inode,
+                 FAR struct geometry *geometry);
+static int     bcache_ioctl(FAR struct inode *inode, int cmd,
+                 unsigned long arg);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const struct block_operations g_bcache_bops =
+{
+  bcache_open,     /* open */
+  bcache_close,    /* close */
+  bcache_read,     /* read */
+  bcache_write,    /* write */
+  bcache_geometry, /* geometry */
+  bcache_ioctl     /* ioctl */
+#ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
+  , NULL           /* unlink */
+#endif
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The cache pool shared by all cached block devices */
+
+struct bcache_s g_bcache =
+{
+  SEM_INITIALIZER(1)
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_initialize
+ *
+ * Description:
+ *   Put all entries of the cache pool in the LRU list.  Unused entries are
+ *   kept at the tail of the list so that they are allocated first.
+ *
+ * Assumptions:
+ *   The caller holds the cache semaphore.
+ *
+ ****************************************************************************/
+
+static void bcache_initialize(void)
+{
+  int i;
+
+  dq_init(&g_bcache.lru);
+  for (i = 0; i < CONFIG_BCACHE_NBLOCKS; i++)
+    {
+      dq_addlast(&g_bcache.entries[i].lru, &g_bcache.lru);
+    }
+
+  g_bcache.initialized = true;
+}
+
+/****************************************************************************
+ * Name: bcache_hash
+ ****************************************************************************/
+
+static inline unsigned int bcache_hash(FAR struct bcache_dev_s *dev,
+                                       blkcnt_t sector)
+{
+  return ((unsigned int)((uintptr_t)dev >> 4) ^ (unsigned int)sector) &
+         (CONFIG_BCACHE_HASHSIZE - 1);
+}
+
+/****************************************************************************
+ * Name: bcache_find
+ *
+ * Description:
+ *   Look up a sector of a device in the cache.
+ *
+ * Returned Value:
+ *   The cache entry holding the sector or NULL if it is not cached.
+ *
+ ****************************************************************************/
+
+static FAR struct bcache_entry_s *bcache_find(FAR struct bcache_dev_s *dev,
+                                              blkcnt_t sector)
+{
+  FAR struct bcache_entry_s *entry;
+
+  for (entry = g_bcache.hash[bcache_hash(dev, sector)];
+       entry != NULL;
+       entry = entry->hlink)
+    {
+      if (entry->dev == dev && entry->sector == sector)
+        {
+          return entry;
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: bcache_touch
+ *
+ * Description:
+ *   Make the entry the most recently used.
+ *
+ ****************************************************************************/
+
+static inline void bcache_touch(FAR struct bcache_entry_s *entry)
+{
+  dq_rem(&entry->lru, &g_bcache.lru);
+  dq_addfirst(&entry->lru, &g_bcache.lru);
+}
+
+/****************************************************************************
+ * Name: bcache_release
+ *
+ * Description:
+ *   Remove an entry from its hash chain and return it to the tail of the
+ *   LRU list as an unused entry.  Any dirty data is discarded.
+ *
+ ****************************************************************************/
+
+static void bcache_release(FAR struct bcache_entry_s *entry)
+{
+  FAR struct bcache_entry_s **pprev;
+
+  pprev = &g_bcache.hash[bcache_hash(entry->dev, entry->sector)];
+  while (*pprev != NULL && *pprev != entry)
+    {
+      pprev = &(*pprev)->hlink;
+    }
+
+  DEBUGASSERT(*pprev == entry);
+  *pprev        = entry->hlink;
+  entry->hlink  = NULL;
+  entry->dev    = NULL;
+  entry->dirty  = false;
+
+  dq_rem(&entry->lru, &g_bcache.lru);
+  dq_addlast(&entry->lru, &g_bcache.lru);
+}
+
+/****************************************************************************
+ * Name: bcache_takesem
+ *
+ * Description:
+ *   Take a semaphore, retrying if the wait is interrupted by a signal.
+ *
+ ****************************************************************************/
+
+static void bcache_takesem(FAR sem_t *sem)
+{
+  int ret;
+
+  do
+    {
+      /* Take the semaphore (perhaps waiting) */
+
+      ret = nxsem_wait(sem);
+
+      /* The only case that an error should occur here is if the wait was
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: bcache_writeback
+ *
+ * Description:
+ *   Write a dirty sector back to the underlying block driver.
+ *
+ * Assumptions:
+ *   The caller holds the lock of the owning device but not the cache
+ *   semaphore.  Dirty entries are only modified by the owner and are never
+ *   evicted, so the entry cannot change during the write.
+ *
+ ****************************************************************************/
+
+static int bcache_writeback(FAR struct bcache_entry_s *entry)
+{
+  FAR struct bcache_dev_s *dev = entry->dev;
+  FAR struct inode *inode = dev->inode;
+  ssize_t nwritten;
+
+  nwritten = inode->u.i_bops->write(inode, entry->data, entry->sector, 1);
+  if (nwritten != 1)
+    {
+      ferr("ERROR: Write back of sector %lu failed: %d\n",
+           (unsigned long)entry->sector, (int)nwritten);
+      return nwritten < 0 ? (int)nwritten : -EIO;
+    }
+
+  bcache_semtake();
+  entry->dirty = false;
+  dev->writebacks++;
+  bcache_semgive();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_alloc
+ *
+ * Description:
+ *   Allocate a cache entry for a sector that is not yet cached.  The least
+ *   recently used clean entry is re-used.  Dirty entries are never evicted
+ *   here because writing them back would require I/O with the cache
+ *   semaphore held.
+ *
+ * Returned Value:
+ *   Zero on success; -ENOSPC if every entry in the pool is dirty.
+ *
+ * Assumptions:
+ *   The caller holds the cache semaphore.
+ *
+ ****************************************************************************/
+
+static int bcache_alloc(FAR struct bcache_dev_s *dev, blkcnt_t sector,
+                        FAR struct bcache_entry_s **pentry)
+{
+  FAR struct bcache_entry_s *entry;
+  unsigned int ndx;
+
+  for (entry = (FAR struct bcache_entry_s *)dq_tail(&g_bcache.lru);
+       entry != NULL && entry->dev != NULL && entry->dirty;
+       entry = (FAR struct bcache_entry_s *)dq_prev(&entry->lru))
+    {
+    }
+
+  if (entry == NULL)
+    {
+      return -ENOSPC;
+    }
+
+  if (entry->dev != NULL)
+    {
+      bcache_release(entry);
+    }
+
+  ndx                 = bcache_hash(dev, sector);
+  entry->dev          = dev;
+  entry->sector       = sector;
+  entry->dirty        = false;
+  entry->hlink        = g_bcache.hash[ndx];
+  g_bcache.hash[ndx]  = entry;
+
+  bcache_touch(entry);
+  *pentry = entry;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_insert
+ *
+ * Description:
+ *   Add a clean copy of a sector just read from the device to the cache.
+ *   Failures are not fatal; the sector is simply not cached.
+ *
+ * Assumptions:
+ *   The caller holds the cache semaphore.
+ *
+ ****************************************************************************/
+
+static void bcache_insert(FAR struct bcache_dev_s *dev, blkcnt_t sector,
+                          FAR const uint8_t *data)
+{
+  FAR struct bcache_entry_s *entry;
+
+  if (bcache_find(dev, sector) == NULL &&
+      bcache_alloc(dev, sector, &entry) >= 0)
+    {
+      memcpy(entry->data, data, dev->sectsize);
+    }
+}
+
+/****************************************************************************
+ * Name: bcache_flush
+ *
+ * Description:
+ *   Write back all dirty sectors of a device.
+ *
+ * Assumptions:
+ *   The caller holds the lock of the device but not the cache semaphore.
+ *
+ ****************************************************************************/
+
+static int bcache_flush(FAR struct bcache_dev_s *dev)
+{
+  FAR struct bcache_entry_s *entry;
+  bool dirty;
+  int ret = OK;
+  int i;
+
+  for (i = 0; i < CONFIG_BCACHE_NBLOCKS; i++)
+    {
+      entry = &g_bcache.entries[i];
+
+      bcache_semtake();
+      dirty = (entry->dev == dev && entry->dirty);
+      bcache_semgive();
+
+      if (dirty)
+        {
+          int tmp = bcache_writeback(entry);
+          if (tmp < 0)
+            {
+              ret = tmp;
+            }
+        }
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_open
+ *
+ * Description: Open the block device
+ *
+ ****************************************************************************/
+
+static int bcache_open(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret = OK;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+
+  bcache_semtake();
+  if (dev->opencnt == MAX_OPENCNT)
+    {
+      ret = -EMFILE;
+    }
+  else
+    {
+      dev->opencnt++;
+    }
+
+  bcache_semgive();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_close
+ *
+ * Description: Close the block device.  Dirty sectors are written back
+ *   (as when a file system on the device is unmounted).
+ *
+ ****************************************************************************/
+
+static int bcache_close(FAR struct inode *inode)
+{
+  FAR struct bcache_dev_s *dev;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+
+  bcache_semtake();
+  if (dev->opencnt > 0)
+    {
+      dev->opencnt--;
+    }
+
+  bcache_semgive();
+
+  bcache_devtake(dev);
+  ret = bcache_flush(dev);
+  bcache_devgive(dev);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_read
+ *
+ * Description:  Read the specified number of sectors.  Cached sectors are
+ *   copied from the cache.  Runs of uncached sectors are read from the
+ *   device with one request (extended by read-ahead if the run ends the
+ *   request) and added to the cache.  The cache semaphore is released
+ *   while the device is read.
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_read(FAR struct inode *inode, FAR unsigned char *buffer,
+                           size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_entry_s *entry;
+  FAR struct inode *src;
+  blkcnt_t sector = start_sector;
+  unsigned int remaining = nsectors;
+  unsigned int run;
+  unsigned int i;
+  ssize_t nread;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+  src = dev->inode;
+
+  bcache_devtake(dev);
+  bcache_semtake();
+
+  while (remaining > 0)
+    {
+      /* Is the next sector in the cache? */
+
+      entry = bcache_find(dev, sector);
+      if (entry != NULL)
+        {
+          memcpy(buffer, entry->data, dev->sectsize);
+          bcache_touch(entry);
+          dev->hits++;
+
+          buffer += dev->sectsize;
+          sector++;
+          remaining--;
+          continue;
+        }
+
+      /* No.. find the length of the run of uncached sectors.  No sector of
+       * this device can be added to the cache by anyone else while the
+       * device lock is held.
+       */
+
+      run = 1;
+      while (run < remaining && bcache_find(dev, sector + run) == NULL)
+        {
+          run++;
+        }
+
+#if CONFIG_BCACHE_READAHEAD > 0
+      /* If the run ends the request, then read ahead the following
+       * uncached sectors as well.
+       */
+
+      if (run == remaining && run < CONFIG_BCACHE_READAHEAD)
+        {
+          unsigned int nra = run;
+
+          while (nra < CONFIG_BCACHE_READAHEAD &&
+                 sector + nra < dev->nsectors &&
+                 bcache_find(dev, sector + nra) == NULL)
+            {
+              nra++;
+            }
+
+          bcache_semgive();
+          nread = src->u.i_bops->read(src, dev->rabuffer, sector, nra);
+          bcache_semtake();
+
+          if (nread < (ssize_t)run)
+            {
+              goto errout_with_sem;
+            }
+
+          memcpy(buffer, dev->rabuffer, run * dev->sectsize);
+          for (i = 0; i < (unsigned int)nread; i++)
+            {
+              bcache_insert(dev, sector + i,
+                            &dev->rabuffer[i * dev->sectsize]);
+            }
+        }
+      else
+#endif
+        {
+          /* Read the run directly into the caller's buffer */
+
+          bcache_semgive();
+          nread = src->u.i_bops->read(src, buffer, sector, run);
+          bcache_semtake();
+
+          if (nread != (ssize_t)run)
+            {
+              goto errout_with_sem;
+            }
+
+          /* Cache the sectors unless this looks like a large sequential
+           * transfer that would only flush the cache.
+           */
+
+#if CONFIG_BCACHE_BYPASS > 0
+          if (run < CONFIG_BCACHE_BYPASS)
+#endif
+            {
+              for (i = 0; i < run; i++)
+                {
+                  bcache_insert(dev, sector + i, &buffer[i * dev->sectsize]);
+                }
+            }
+        }
+
+      dev->misses += run;
+      buffer      += run * dev->sectsize;
+      sector      += run;
+      remaining   -= run;
+    }
+
+  bcache_semgive();
+  bcache_devgive(dev);
+  return nsectors;
+
+errout_with_sem:
+  bcache_semgive();
+  bcache_devgive(dev);
+
+  /* Return the number of sectors transferred before the failure, if any */
+
+  if (remaining < nsectors)
+    {
+      return nsectors - remaining;
+    }
+
+  return nread < 0 ? nread : -EIO;
+}
+
+/****************************************************************************
+ * Name: bcache_write
+ *
+ * Description: Write the specified number of sectors.  Small writes are
+ *   absorbed by the cache and written back later.  Large writes go
+ *   directly to the device.
+ *
+ ****************************************************************************/
+
+static ssize_t bcache_write(FAR struct inode *inode,
+                            FAR const unsigned char *buffer,
+                            size_t start_sector, unsigned int nsectors)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_entry_s *entry;
+  FAR struct inode *src;
+  ssize_t nwritten;
+  unsigned int i;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+  src = dev->inode;
+
+  if (src->u.i_bops->write == NULL)
+    {
+      return -EACCES;
+    }
+
+  bcache_devtake(dev);
+
+#if CONFIG_BCACHE_BYPASS > 0
+  if (nsectors >= CONFIG_BCACHE_BYPASS)
+    {
+      /* Write directly to the device and keep any cached copies of the
+       * written sectors coherent.
+       */
+
+      nwritten = src->u.i_bops->write(src, buffer, start_sector, nsectors);
+
+      bcache_semtake();
+      for (i = 0; nwritten > 0 && i < (unsigned int)nwritten; i++)
+        {
+          entry = bcache_find(dev, start_sector + i);
+          if (entry != NULL)
+            {
+              memcpy(entry->data, &buffer[i * dev->sectsize], dev->sectsize);
+              entry->dirty = false;
+            }
+        }
+
+      bcache_semgive();
+      bcache_devgive(dev);
+      return nwritten;
+    }
+#endif
+
+  bcache_semtake();
+  for (i = 0; i < nsectors; i++)
+    {
+      entry = bcache_find(dev, start_sector + i);
+      if (entry != NULL)
+        {
+          bcache_touch(entry);
+          memcpy(entry->data, &buffer[i * dev->sectsize], dev->sectsize);
+          entry->dirty = true;
+          continue;
+        }
+
+      ret = bcache_alloc(dev, start_sector + i, &entry);
+      if (ret == -ENOSPC)
+        {
+          /* Every entry in the pool is dirty.  Write back the dirty
+           * sectors of this device and try again.
+           */
+
+          bcache_semgive();
+          ret = bcache_flush(dev);
+          bcache_semtake();
+
+          if (ret >= 0)
+            {
+              ret = bcache_alloc(dev, start_sector + i, &entry);
+            }
+        }
+
+      if (ret == -ENOSPC)
+        {
+          /* The pool is held by dirty sectors of other devices.  Write
+           * this sector through to the device.
+           */
+
+          bcache_semgive();
+          nwritten = src->u.i_bops->write(src, &buffer[i * dev->sectsize],
+                                          start_sector + i, 1);
+          bcache_semtake();
+
+          if (nwritten == 1)
+            {
+              continue;
+            }
+
+          ret = nwritten < 0 ? (int)nwritten : -EIO;
+        }
+
+      if (ret < 0)
+        {
+          bcache_semgive();
+          bcache_devgive(dev);
+          return i > 0 ? (ssize_t)i : ret;
+        }
+
+      memcpy(entry->data, &buffer[i * dev->sectsize], dev->sectsize);
+      entry->dirty = true;
+    }
+
+  bcache_semgive();
+  bcache_devgive(dev);
+  return nsectors;
+}
+
+/****************************************************************************
+ * Name: bcache_geometry
+ *
+ * Description: Return device geometry
+ *
+ ****************************************************************************/
+
+static int bcache_geometry(FAR struct inode *inode,
+                           FAR struct geometry *geometry)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct inode *src;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+  src = dev->inode;
+
+  return src->u.i_bops->geometry(src, geometry);
+}
+
+/****************************************************************************
+ * Name: bcache_ioctl
+ *
+ * Description: Write back the cache, then pass the command to the
+ *   underlying block driver.
+ *
+ ****************************************************************************/
+
+static int bcache_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct inode *src;
+  int ret;
+
+  DEBUGASSERT(inode && inode->i_private);
+  dev = (FAR struct bcache_dev_s *)inode->i_private;
+  src = dev->inode;
+
+  bcache_devtake(dev);
+  ret = bcache_flush(dev);
+  bcache_devgive(dev);
+
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* BIOC_FLUSH is also passed on so that any buffering in the underlying
+   * driver is flushed.  Drivers that do not buffer writes do not support
+   * BIOC_FLUSH.
+   */
+
+  if (src->u.i_bops->ioctl == NULL)
+    {
+      return cmd == BIOC_FLUSH ? OK : -ENOTTY;
+    }
+
+  ret = src->u.i_bops->ioctl(src, cmd, arg);
+  if (cmd == BIOC_FLUSH && ret == -ENOTTY)
+    {
+      ret = OK;
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_semtake
+ ****************************************************************************/
+
+void bcache_semtake(void)
+{
+  bcache_takesem(&g_bcache.sem);
+}
+
+/****************************************************************************
+ * Name: bcache_register
+ *
+ * Description:
+ *   Create a block driver at 'devpath' that accesses the block driver at
+ *   'source' through the shared block cache.
+ *
+ ****************************************************************************/
+
+int bcache_register(FAR const char *source, FAR const char *devpath)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_dev_s **pprev;
+  FAR struct inode *inode;
+  struct geometry geo;
+  int ret;
+
+  DEBUGASSERT(source != NULL && devpath != NULL);
+
+  /* Open the block driver to be cached */
+
+  ret = open_blockdriver(source, MS_RDONLY, &inode);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to open %s: %d\n", source, ret);
+      return ret;
+    }
+
+  if (inode->u.i_bops->geometry == NULL ||
+      inode->u.i_bops->geometry(inode, &geo) < 0 || !geo.geo_available)
+    {
+      ferr("ERROR: Geometry of %s not available\n", source);
+      ret = -ENODEV;
+      goto errout_with_inode;
+    }
+
+  if (geo.geo_sectorsize == 0 ||
+      geo.geo_sectorsize > CONFIG_BCACHE_SECTORSIZE)
+    {
+      ferr("ERROR: Unsupported sector size: %u\n",
+           (unsigned int)geo.geo_sectorsize);
+      ret = -EINVAL;
+      goto errout_with_inode;
+    }
+
+  /* Allocate and initialize the cached device structure */
+
+  dev = (FAR struct bcache_dev_s *)kmm_zalloc(sizeof(struct bcache_dev_s));
+  if (dev == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_inode;
+    }
+
+  dev->path = (FAR char *)kmm_malloc(strlen(devpath) + 1);
+  if (dev->path == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout_with_dev;
+    }
+
+  strcpy(dev->path, devpath);
+
+  dev->inode    = inode;
+  dev->nsectors = geo.geo_nsectors;
+  dev->sectsize = geo.geo_sectorsize;
+  nxsem_init(&dev->exclsem, 0, 1);
+
+  bcache_semtake();
+  if (!g_bcache.initialized)
+    {
+      bcache_initialize();
+    }
+
+  dev->flink       = g_bcache.devlist;
+  g_bcache.devlist = dev;
+  bcache_semgive();
+
+  /* Register the cached block driver */
+
+  ret = register_blockdriver(devpath, &g_bcache_bops, 0666, dev);
+  if (ret < 0)
+    {
+      ferr("ERROR: Failed to register %s: %d\n", devpath, ret);
+      goto errout_with_list;
+    }
+
+  return OK;
+
+errout_with_list:
+  bcache_semtake();
+  for (pprev = &g_bcache.devlist; *pprev != dev; pprev = &(*pprev)->flink)
+    {
+    }
+
+  *pprev = dev->flink;
+  bcache_semgive();
+  nxsem_destroy(&dev->exclsem);
+  kmm_free(dev->path);
+
+errout_with_dev:
+  kmm_free(dev);
+
+errout_with_inode:
+  close_blockdriver(inode);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: bcache_unregister
+ *
+ * Description:
+ *   Flush and release a cached block driver created by bcache_register().
+ *
+ ****************************************************************************/
+
+int bcache_unregister(FAR const char *devpath)
+{
+  FAR struct bcache_dev_s *dev;
+  FAR struct bcache_dev_s **pprev;
+  int ret;
+  int i;
+
+  DEBUGASSERT(devpath != NULL);
+
+  bcache_semtake();
+  for (pprev = &g_bcache.devlist; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (strcmp((*pprev)->path, devpath) == 0)
+        {
+          break;
+        }
+    }
+
+  dev = *pprev;
+  if (dev == NULL)
+    {
+      bcache_semgive();
+      return -ENOENT;
+    }
+
+  if (dev->opencnt > 0)
+    {
+      bcache_semgive();
+      return -EBUSY;
+    }
+
+  *pprev = dev->flink;
+  bcache_semgive();
+
+  /* Write back and discard all cached sectors of the device */
+
+  bcache_devtake(dev);
+  ret = bcache_flush(dev);
+  if (ret < 0)
+    {
+      bcache_semtake();
+      dev->flink       = g_bcache.devlist;
+      g_bcache.devlist = dev;
+      bcache_semgive();
+      bcache_devgive(dev);
+      return ret;
+    }
+
+  bcache_semtake();
+  for (i = 0; i < CONFIG_BCACHE_NBLOCKS; i++)
+    {
+      if (g_bcache.entries[i].dev == dev)
+        {
+          bcache_release(&g_bcache.entries[i]);
+        }
+    }
+
+  bcache_semgive();
+  bcache_devgive(dev);
+
+  /* Remove the driver and release the underlying block driver */
+
+  (void)unregister_blockdriver(devpath);
+  close_blockdriver(dev->inode);
+
+  nxsem_destroy(&dev->exclsem);
+  kmm_free(dev->path);
+  kmm_free(dev);
+  return OK;
+}
@@ -0,0 +1,171 @@
+/****************************************************************************
+ * drivers/bcache/bcache.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __DRIVERS_BCACHE_BCACHE_H
+#define __DRIVERS_BCACHE_BCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <semaphore.h>
+
+#include <nuttx/fs/fs.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_BCACHE_NBLOCKS
+#  define CONFIG_BCACHE_NBLOCKS 16
+#endif
+
+#ifndef CONFIG_BCACHE_SECTORSIZE
+#  define CONFIG_BCACHE_SECTORSIZE 512
+#endif
+
+#ifndef CONFIG_BCACHE_HASHSIZE
+#  define CONFIG_BCACHE_HASHSIZE 16
+#endif
+
+#if (CONFIG_BCACHE_HASHSIZE & (CONFIG_BCACHE_HASHSIZE - 1)) != 0
+#  error CONFIG_BCACHE_HASHSIZE must be a power of two
+#endif
+
+#ifndef CONFIG_BCACHE_READAHEAD
+#  define CONFIG_BCACHE_READAHEAD 4
+#endif
+
+#ifndef CONFIG_BCACHE_BYPASS
+#  define CONFIG_BCACHE_BYPASS 8
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one cached block device */
+
+struct bcache_dev_s
+{
+  FAR struct bcache_dev_s *flink;  /* Next registered cached device */
+  FAR struct inode *inode;         /* The underlying block driver */
+  FAR char *path;                  /* Path of the cached block driver */
+  blkcnt_t  nsectors;              /* Number of sectors on the device */
+  uint16_t  sectsize;              /* Size of one sector */
+  uint8_t   opencnt;               /* Number of open references */
+  sem_t     exclsem;               /* Serializes I/O on the device */
+
+  /* Statistics */
+
+  uint32_t  hits;                  /* Sectors found in the cache */
+  uint32_t  misses;                /* Sectors read from the device */
+  uint32_t  writebacks;            /* Dirty sectors written to the device */
+
+#if CONFIG_BCACHE_READAHEAD > 0
+  uint8_t   rabuffer[CONFIG_BCACHE_READAHEAD * CONFIG_BCACHE_SECTORSIZE];
+#endif
+};
+
+/* This structure describes one sector in the cache pool */
+
+struct bcache_entry_s
+{
+  dq_entry_t lru;                  /* LRU list link.  Must be first. */
+  FAR struct bcache_entry_s *hlink; /* Hash chain link */
+  FAR struct bcache_dev_s *dev;    /* Owning device (NULL if unused) */
+  blkcnt_t   sector;               /* Cached sector number */
+  bool       dirty;                /* Sector must be written back */
+  uint8_t    data[CONFIG_BCACHE_SECTORSIZE];
+};
+
+/* This structure holds the state of the shared cache pool */
+
+struct bcache_s
+{
+  sem_t      sem;                  /* Exclusive access to the pool.  Never
+                                    * held across device I/O. */
+  bool       initialized;          /* True: the pool has been initialized */
+  dq_queue_t lru;                  /* Most recently used at the head */
+  FAR struct bcache_dev_s *devlist; /* List of cached devices */
+  FAR struct bcache_entry_s *hash[CONFIG_BCACHE_HASHSIZE];
+  struct bcache_entry_s entries[CONFIG_BCACHE_NBLOCKS];
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#undef EXTERN
+#if defined(__cplusplus)
+#define EXTERN extern "C"
+extern "C" {
+#else
+#define EXTERN extern
+#endif
+
+/* The shared cache pool */
+
+EXTERN struct bcache_s g_bcache;
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_semtake and bcache_semgive
+ *
+ * Description:
+ *   Get/release exclusive access to the shared cache pool.  The lock of a
+ *   cached device (bcache_dev_s::exclsem) is always taken before this one.
+ *
+ ****************************************************************************/
+
+EXTERN void bcache_semtake(void);
+#define bcache_semgive() nxsem_post(&g_bcache.sem)
+
+#undef EXTERN
+#if defined(__cplusplus)
+}
+#endif
+
+#endif /* __DRIVERS_BCACHE_BCACHE_H */
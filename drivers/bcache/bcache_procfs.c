@@ -0,0 +1,314 @@
+/****************************************************************************
+ * drivers/bcache/bcache_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "bcache.h"
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCACHE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define BCACHE_LINELEN 96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct bcache_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[BCACHE_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     bcache_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     bcache_procfs_close(FAR struct file *filep);
+static ssize_t bcache_procfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     bcache_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     bcache_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations bcache_procfsoperations =
+{
+  bcache_procfs_open,   /* open */
+  bcache_procfs_close,  /* close */
+  bcache_procfs_read,   /* read */
+  NULL,                 /* write */
+  bcache_procfs_dup,    /* dup */
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+  bcache_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bcache_procfs_open
+ ****************************************************************************/
+
+static int bcache_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath, int oflags,
+                              mode_t mode)
+{
+  FAR struct bcache_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct bcache_file_s *)
+    kmm_zalloc(sizeof(struct bcache_file_s));
+  if (procfile == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_close
+ ****************************************************************************/
+
+static int bcache_procfs_close(FAR struct file *filep)
+{
+  FAR struct bcache_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct bcache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_read
+ ****************************************************************************/
+
+static ssize_t bcache_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct bcache_file_s *procfile;
+  FAR struct bcache_dev_s *dev;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct bcache_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* The first lines describe the cache pool and the column headers */
+
+  linesize  = snprintf(procfile->line, BCACHE_LINELEN,
+                       "Sectors: %d Sector size: %d\n"
+                       "%-20s %10s %10s %10s\n",
+                       CONFIG_BCACHE_NBLOCKS, CONFIG_BCACHE_SECTORSIZE,
+                       "Device", "Hits", "Misses", "Writebacks");
+  if (linesize >= BCACHE_LINELEN)
+    {
+      linesize = BCACHE_LINELEN - 1;
+    }
+
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                            &offset);
+  totalsize = copysize;
+
+  /* Followed by one line for each cached device */
+
+  bcache_semtake();
+  for (dev = g_bcache.devlist; dev != NULL && totalsize < buflen;
+       dev = dev->flink)
+    {
+      buffer    += copysize;
+      buflen    -= copysize;
+
+      linesize   = snprintf(procfile->line, BCACHE_LINELEN,
+                            "%-20s %10lu %10lu %10lu\n", dev->path,
+                            (unsigned long)dev->hits,
+                            (unsigned long)dev->misses,
+                            (unsigned long)dev->writebacks);
+      if (linesize >= BCACHE_LINELEN)
+        {
+          /* The device path was truncated */
+
+          linesize = BCACHE_LINELEN - 1;
+        }
+
+      copysize   = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                 &offset);
+      totalsize += copysize;
+    }
+
+  bcache_semgive();
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int bcache_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct bcache_file_s *oldattr;
+  FAR struct bcache_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct bcache_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct bcache_file_s *)
+    kmm_malloc(sizeof(struct bcache_file_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct bcache_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: bcache_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int bcache_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS && !CONFIG_FS_PROCFS_EXCLUDE_BCACHE */
@@ -57,6 +57,16 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/drivers/rwbuffer.h>
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+#  include <crc32.h>
+#  include <nuttx/semaphore.h>
+#endif
+
+#ifdef CONFIG_FTL_LOG_GC_BACKGROUND
+#  include <nuttx/clock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -73,10 +83,96 @@
 
 #define DEV_NAME_MAX    (NAME_MAX + 5)
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+/* Log-structured FTL.  Each erase block holds 'ndata' R/W blocks of sector
+ * data followed by 'nsum' R/W blocks holding the erase block summary.
+ */
+
+#  define FTL_SUMMARY_MAGIC    0x4c4c5446  /* "FTLL" */
+#  define FTL_CHECKPOINT_MAGIC 0x4b435446  /* "FTCK" */
+#  define FTL_UNMAPPED         UINT32_MAX
+
+/* Size of a summary describing 'n' data R/W blocks */
+
+#  define FTL_SUMMARY_SIZE(n) \
+     (sizeof(struct ftl_summary_s) + ((n) - 1) * sizeof(uint32_t))
+
+/* Size of a checkpoint describing 'n' data R/W blocks */
+
+#  define FTL_CHECKPOINT_SIZE(n) \
+     (sizeof(struct ftl_checkpoint_s) + ((n) - 1) * sizeof(uint32_t))
+
+/* Garbage collection runs in the write path whenever fewer than this many
+ * erase blocks are free.  The last free erase block is reserved for the
+ * sectors that garbage collection moves.
+ */
+
+#  define FTL_LOG_MINFREE      2
+
+/* Erase block states */
+
+#  define FTL_EB_FREE          0  /* No valid data, may be erased and opened */
+#  define FTL_EB_OPEN          1  /* At the head of the log */
+#  define FTL_EB_FULL          2  /* Closed, summary written */
+#  define FTL_EB_STALE         3  /* No valid data, but newer copies are not
+                                   * yet safe on FLASH */
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+/* The summary written at the end of each closed erase block.  It records
+ * the logical sector held by each data R/W block of the erase block.
+ */
+
+struct ftl_summary_s
+{
+  uint32_t              magic;      /* FTL_SUMMARY_MAGIC */
+  uint32_t              seq;        /* Order in which erase blocks closed */
+  uint32_t              erasecnt;   /* Times this erase block was erased */
+  uint32_t              crc;        /* CRC-32 of the summary */
+  uint32_t              lsector[1]; /* Logical sector of each R/W block */
+};
+
+/* A checkpoint written into a data R/W block of the open erase block by
+ * BIOC_FLUSH.  It records the logical sectors of the data R/W blocks
+ * written since the previous checkpoint, which immediately precede it.
+ * The erase block is not closed, so the following R/W blocks remain
+ * available for data.
+ */
+
+struct ftl_checkpoint_s
+{
+  uint32_t              magic;      /* FTL_CHECKPOINT_MAGIC */
+  uint32_t              seq;        /* Sequence number of the erase block */
+  uint32_t              erasecnt;   /* Times this erase block was erased */
+  uint32_t              crc;        /* CRC-32 of the checkpoint */
+  uint16_t              first;      /* First data R/W block described */
+  uint16_t              count;      /* Number of data R/W blocks described */
+  uint32_t              lsector[1]; /* Logical sector of each R/W block */
+};
+
+/* In-memory state of one erase block */
+
+struct ftl_eblock_s
+{
+  uint32_t              erasecnt;   /* Times this erase block was erased */
+  uint16_t              nvalid;     /* Number of valid data R/W blocks */
+  uint8_t               state;      /* See FTL_EB_* definitions */
+};
+
+/* Used to replay the erase block summaries in order when mounting */
+
+struct ftl_order_s
+{
+  uint32_t              seq;        /* Sequence number of the summary */
+  off_t                 block;      /* Erase block number */
+  bool                  ckpt;       /* No summary, replay the checkpoints */
+};
+#endif
+
 struct ftl_struct_s
 {
   FAR struct mtd_dev_s *mtd;     /* Contained MTD interface */
@@ -88,6 +184,24 @@ struct ftl_struct_s
 #ifdef CONFIG_FS_WRITABLE
   FAR uint8_t          *eblock;  /* One, in-memory erase block */
 #endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+  sem_t                 exclsem; /* Protects the log state */
+  FAR uint32_t         *l2p;     /* Logical sector to physical R/W block map */
+  FAR struct ftl_eblock_s *eb;   /* State of each erase block */
+  FAR struct ftl_summary_s *summary; /* Summary of the open erase block */
+  uint32_t              nsectors; /* Number of logical sectors */
+  uint32_t              seq;     /* Sequence number of the next erase block */
+  uint32_t              openseq; /* Sequence number of the open erase block */
+  off_t                 openeb;  /* Open erase block (-1 if none) */
+  uint16_t              openpg;  /* Next R/W block in the open erase block */
+  uint16_t              ckptpg;  /* First R/W block not yet checkpointed */
+  uint16_t              ndata;   /* Data R/W blocks per erase block */
+  uint16_t              nsum;    /* Summary R/W blocks per erase block */
+  uint16_t              nfree;   /* Number of free and stale erase blocks */
+#ifdef CONFIG_FTL_LOG_GC_BACKGROUND
+  struct work_s         gcwork;  /* Supports background garbage collection */
+#endif
+#endif
 };
 
 /****************************************************************************
@@ -160,6 +274,903 @@ static int ftl_close(FAR struct inode *inode)
   return OK;
 }
 
+/****************************************************************************
+ * Name: ftl_log_lock and ftl_log_unlock
+ *
+ * Description:
+ *   Get and release exclusive access to the log-structured FTL state.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static void ftl_log_lock(FAR struct ftl_struct_s *dev)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&dev->exclsem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+#  define ftl_log_unlock(dev) nxsem_post(&(dev)->exclsem)
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_crc
+ *
+ * Description:
+ *   Return the CRC of an erase block summary.  The CRC covers the whole
+ *   summary with the crc field taken as zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static uint32_t ftl_log_crc(FAR struct ftl_struct_s *dev,
+                            FAR struct ftl_summary_s *summary)
+{
+  uint32_t save = summary->crc;
+  uint32_t crc;
+
+  summary->crc = 0;
+  crc = crc32((FAR const uint8_t *)summary, FTL_SUMMARY_SIZE(dev->ndata));
+  summary->crc = save;
+  return crc;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_ckptcrc
+ *
+ * Description:
+ *   Return the CRC of a checkpoint.  The CRC covers the whole checkpoint
+ *   with the crc field taken as zero.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static uint32_t ftl_log_ckptcrc(FAR struct ftl_checkpoint_s *ckpt)
+{
+  uint32_t save = ckpt->crc;
+  uint32_t crc;
+
+  ckpt->crc = 0;
+  crc = crc32((FAR const uint8_t *)ckpt, FTL_CHECKPOINT_SIZE(ckpt->count));
+  ckpt->crc = save;
+  return crc;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_release
+ *
+ * Description:
+ *   Make the erase blocks that were emptied while the current erase block
+ *   was open available for re-use.  This is called after the summary of
+ *   that erase block has been written:  Until then the newer copies of the
+ *   data that the emptied erase blocks held would not survive a power
+ *   failure, so the older copies must not be erased.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static void ftl_log_release(FAR struct ftl_struct_s *dev)
+{
+  int i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eb[i].state == FTL_EB_STALE)
+        {
+          dev->eb[i].state = FTL_EB_FREE;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_open
+ *
+ * Description:
+ *   Erase and open the free erase block with the lowest erase count.
+ *   Always picking the least worn free erase block provides dynamic wear
+ *   leveling.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_open(FAR struct ftl_struct_s *dev)
+{
+  off_t eraseblock = -1;
+  int ret;
+  int i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      if (dev->eb[i].state == FTL_EB_FREE &&
+          (eraseblock < 0 ||
+           dev->eb[i].erasecnt < dev->eb[eraseblock].erasecnt))
+        {
+          eraseblock = i;
+        }
+    }
+
+  if (eraseblock < 0)
+    {
+      ferr("ERROR: No free erase block\n");
+      return -ENOSPC;
+    }
+
+  ret = MTD_ERASE(dev->mtd, eraseblock, 1);
+  if (ret < 0)
+    {
+      ferr("ERROR: Erase block=%d failed: %d\n", eraseblock, ret);
+      return ret;
+    }
+
+  dev->eb[eraseblock].erasecnt++;
+  dev->eb[eraseblock].nvalid = 0;
+  dev->eb[eraseblock].state  = FTL_EB_OPEN;
+  dev->nfree--;
+
+  dev->openeb  = eraseblock;
+  dev->openpg  = 0;
+  dev->ckptpg  = 0;
+  dev->openseq = dev->seq++;
+
+  memset(dev->summary, 0xff, dev->nsum * dev->geo.blocksize);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_close
+ *
+ * Description:
+ *   Write the summary of the open erase block.  Once the summary is on
+ *   FLASH, the contents of the erase block survive a power failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_close(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_summary_s *summary = dev->summary;
+  off_t eraseblock = dev->openeb;
+  ssize_t nxfrd;
+
+  if (eraseblock < 0)
+    {
+      return OK;
+    }
+
+  summary->magic    = FTL_SUMMARY_MAGIC;
+  summary->seq      = dev->openseq;
+  summary->erasecnt = dev->eb[eraseblock].erasecnt;
+  summary->crc      = ftl_log_crc(dev, summary);
+
+  dev->openeb = -1;
+  dev->eb[eraseblock].state = FTL_EB_FULL;
+  if (dev->eb[eraseblock].nvalid == 0)
+    {
+      dev->eb[eraseblock].state = FTL_EB_STALE;
+      dev->nfree++;
+    }
+
+  nxfrd = MTD_BWRITE(dev->mtd, eraseblock * dev->blkper + dev->ndata,
+                     dev->nsum, (FAR const uint8_t *)summary);
+  if (nxfrd != dev->nsum)
+    {
+      ferr("ERROR: Write summary of erase block %d failed: %d\n",
+           eraseblock, nxfrd);
+      return -EIO;
+    }
+
+  ftl_log_release(dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_checkpoint
+ *
+ * Description:
+ *   Make the sectors written to the open erase block survive a power
+ *   failure without closing it.  A checkpoint describing the data R/W
+ *   blocks written since the previous checkpoint is written to the next
+ *   R/W block.  This costs one R/W block instead of the rest of the erase
+ *   block.  The erase block is closed instead if the checkpoint would not
+ *   leave room for more data or would not fit in one R/W block.
+ *
+ *   dev->eblock is used to build the checkpoint.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_checkpoint(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_checkpoint_s *ckpt;
+  uint32_t ppage;
+  ssize_t nxfrd;
+  int count;
+  int i;
+
+  if (dev->openeb < 0 || dev->ckptpg == dev->openpg)
+    {
+      return OK;
+    }
+
+  count = dev->openpg - dev->ckptpg;
+  if (dev->openpg + 1 >= dev->ndata ||
+      FTL_CHECKPOINT_SIZE(count) > dev->geo.blocksize)
+    {
+      return ftl_log_close(dev);
+    }
+
+  ckpt = (FAR struct ftl_checkpoint_s *)dev->eblock;
+  memset(ckpt, 0xff, dev->geo.blocksize);
+
+  ckpt->magic    = FTL_CHECKPOINT_MAGIC;
+  ckpt->seq      = dev->openseq;
+  ckpt->erasecnt = dev->eb[dev->openeb].erasecnt;
+  ckpt->first    = dev->ckptpg;
+  ckpt->count    = count;
+
+  for (i = 0; i < count; i++)
+    {
+      ckpt->lsector[i] = dev->summary->lsector[dev->ckptpg + i];
+    }
+
+  ckpt->crc = ftl_log_ckptcrc(ckpt);
+
+  ppage = dev->openeb * dev->blkper + dev->openpg;
+  nxfrd = MTD_BWRITE(dev->mtd, ppage, 1, (FAR const uint8_t *)ckpt);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write checkpoint %d failed: %d\n", ppage, nxfrd);
+      return -EIO;
+    }
+
+  /* The checkpoint R/W block holds no sector.  Its entry in the summary
+   * remains FTL_UNMAPPED.
+   */
+
+  dev->openpg++;
+  dev->ckptpg = dev->openpg;
+
+  /* Everything written so far is now safe on FLASH */
+
+  ftl_log_release(dev);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_append
+ *
+ * Description:
+ *   Write one logical sector out-of-place at the head of the log and
+ *   retire its previous copy.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_append(FAR struct ftl_struct_s *dev, uint32_t lsector,
+                          FAR const uint8_t *buffer)
+{
+  FAR struct ftl_eblock_s *eb;
+  uint32_t ppage;
+  ssize_t nxfrd;
+  int ret;
+
+  if (dev->openeb < 0)
+    {
+      ret = ftl_log_open(dev);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  ppage = dev->openeb * dev->blkper + dev->openpg;
+  nxfrd = MTD_BWRITE(dev->mtd, ppage, 1, buffer);
+  if (nxfrd != 1)
+    {
+      ferr("ERROR: Write block %d failed: %d\n", ppage, nxfrd);
+      return -EIO;
+    }
+
+  /* Retire the previous copy of the sector */
+
+  if (dev->l2p[lsector] != FTL_UNMAPPED)
+    {
+      eb = &dev->eb[dev->l2p[lsector] / dev->blkper];
+      DEBUGASSERT(eb->nvalid > 0);
+
+      if (--eb->nvalid == 0 && eb->state == FTL_EB_FULL)
+        {
+          eb->state = FTL_EB_STALE;
+          dev->nfree++;
+        }
+    }
+
+  dev->l2p[lsector] = ppage;
+  dev->eb[dev->openeb].nvalid++;
+  dev->summary->lsector[dev->openpg] = lsector;
+
+  if (++dev->openpg >= dev->ndata)
+    {
+      return ftl_log_close(dev);
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_gc
+ *
+ * Description:
+ *   Reclaim one erase block.  The full erase block with the fewest valid
+ *   sectors is selected (the less worn one if there is a tie) and its valid
+ *   sectors are moved to the head of the log.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_gc(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_eblock_s *eb;
+  off_t victim = -1;
+  uint32_t lsector;
+  uint32_t ppage;
+  ssize_t nxfrd;
+  int ret;
+  int i;
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eb[i];
+      if (eb->state == FTL_EB_FULL &&
+          (victim < 0 || eb->nvalid < dev->eb[victim].nvalid ||
+           (eb->nvalid == dev->eb[victim].nvalid &&
+            eb->erasecnt < dev->eb[victim].erasecnt)))
+        {
+          victim = i;
+        }
+    }
+
+  if (victim < 0 || dev->eb[victim].nvalid >= dev->ndata)
+    {
+      return -ENOSPC;
+    }
+
+  finfo("Reclaim erase block %d, %d valid\n",
+        victim, dev->eb[victim].nvalid);
+
+  /* Read the data R/W blocks of the erase block.  The logical to physical
+   * map tells which of them still hold valid sectors.  The summary cannot
+   * be used because an erase block recovered from checkpoints has none.
+   */
+
+  nxfrd = MTD_BREAD(dev->mtd, victim * dev->blkper, dev->ndata,
+                    dev->eblock);
+  if (nxfrd != dev->ndata)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", victim, nxfrd);
+      return -EIO;
+    }
+
+  for (lsector = 0;
+       lsector < dev->nsectors && dev->eb[victim].nvalid > 0;
+       lsector++)
+    {
+      ppage = dev->l2p[lsector];
+      if (ppage != FTL_UNMAPPED && ppage / dev->blkper == victim)
+        {
+          i   = ppage - victim * dev->blkper;
+          ret = ftl_log_append(dev, lsector,
+                               &dev->eblock[i * dev->geo.blocksize]);
+          if (ret < 0)
+            {
+              return ret;
+            }
+        }
+    }
+
+  DEBUGASSERT(dev->eb[victim].nvalid == 0);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_gcworker
+ *
+ * Description:
+ *   Reclaims erase blocks on the low priority work queue, one per
+ *   invocation, until the number of free erase blocks reaches the
+ *   watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOG_GC_BACKGROUND
+static void ftl_log_gcworker(FAR void *arg)
+{
+  FAR struct ftl_struct_s *dev = (FAR struct ftl_struct_s *)arg;
+  int ret;
+
+  ftl_log_lock(dev);
+
+  if (dev->nfree < CONFIG_FTL_LOG_GC_WATERMARK)
+    {
+      ret = ftl_log_gc(dev);
+      if (ret >= 0 && dev->nfree < CONFIG_FTL_LOG_GC_WATERMARK)
+        {
+          /* Give the writers a chance to run before the next step */
+
+          work_queue(LPWORK, &dev->gcwork, ftl_log_gcworker, dev,
+                     MSEC2TICK(CONFIG_FTL_LOG_GC_INTERVAL));
+        }
+    }
+
+  ftl_log_unlock(dev);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_write
+ *
+ * Description:
+ *   Write the specified number of sectors to the head of the log
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static ssize_t ftl_log_write(FAR struct ftl_struct_s *dev,
+                             FAR const uint8_t *buffer, off_t startblock,
+                             size_t nblocks)
+{
+  size_t nxfrd;
+  int ret = OK;
+  int i;
+
+  if (startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_lock(dev);
+
+  for (nxfrd = 0; nxfrd < nblocks; nxfrd++)
+    {
+      /* Keep one free erase block in reserve for the garbage collector.
+       * Collection may not gain a free erase block on every pass, so
+       * bound the number of attempts.
+       */
+
+      for (i = 0;
+           dev->nfree < FTL_LOG_MINFREE && i < dev->geo.neraseblocks;
+           i++)
+        {
+          if (ftl_log_gc(dev) < 0)
+            {
+              break;
+            }
+        }
+
+      ret = ftl_log_append(dev, startblock + nxfrd,
+                           buffer + nxfrd * dev->geo.blocksize);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+#ifdef CONFIG_FTL_LOG_GC_BACKGROUND
+  if (dev->nfree < CONFIG_FTL_LOG_GC_WATERMARK &&
+      work_available(&dev->gcwork))
+    {
+      work_queue(LPWORK, &dev->gcwork, ftl_log_gcworker, dev,
+                 MSEC2TICK(CONFIG_FTL_LOG_GC_INTERVAL));
+    }
+#endif
+
+  ftl_log_unlock(dev);
+  return nxfrd > 0 ? (ssize_t)nxfrd : ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_read
+ *
+ * Description:
+ *   Read the specified number of sectors through the logical to physical
+ *   map.  Sectors that have never been written read as erased FLASH.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static ssize_t ftl_log_read(FAR struct ftl_struct_s *dev,
+                            FAR uint8_t *buffer, off_t startblock,
+                            size_t nblocks)
+{
+  uint32_t ppage;
+  ssize_t nread;
+  size_t i;
+
+  if (startblock + nblocks > dev->nsectors)
+    {
+      return -EINVAL;
+    }
+
+  ftl_log_lock(dev);
+
+  for (i = 0; i < nblocks; i++, buffer += dev->geo.blocksize)
+    {
+      ppage = dev->l2p[startblock + i];
+      if (ppage == FTL_UNMAPPED)
+        {
+          memset(buffer, 0xff, dev->geo.blocksize);
+          continue;
+        }
+
+      nread = MTD_BREAD(dev->mtd, ppage, 1, buffer);
+      if (nread != 1)
+        {
+          ferr("ERROR: Read block %d failed: %d\n", ppage, nread);
+          break;
+        }
+    }
+
+  ftl_log_unlock(dev);
+  return i > 0 ? (ssize_t)i : -EIO;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_seqcompare
+ *
+ * Description:
+ *   qsort() comparison function that orders erase blocks by the sequence
+ *   number of their summaries.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_seqcompare(FAR const void *a, FAR const void *b)
+{
+  uint32_t seqa = ((FAR const struct ftl_order_s *)a)->seq;
+  uint32_t seqb = ((FAR const struct ftl_order_s *)b)->seq;
+
+  return seqa < seqb ? -1 : (seqa > seqb ? 1 : 0);
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_replay
+ *
+ * Description:
+ *   Map a logical sector to the R/W block found for it while mounting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static void ftl_log_replay(FAR struct ftl_struct_s *dev, uint32_t lsector,
+                           uint32_t ppage)
+{
+  if (lsector >= dev->nsectors)
+    {
+      return;
+    }
+
+  if (dev->l2p[lsector] != FTL_UNMAPPED)
+    {
+      dev->eb[dev->l2p[lsector] / dev->blkper].nvalid--;
+    }
+
+  dev->l2p[lsector] = ppage;
+  dev->eb[ppage / dev->blkper].nvalid++;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_scanckpt
+ *
+ * Description:
+ *   Look for the checkpoints of an erase block that has no summary.  The
+ *   data R/W blocks are read into dev->eblock.  Each checkpoint must
+ *   describe the R/W blocks between the previous checkpoint and itself;
+ *   anything after the last such checkpoint was not flushed and is
+ *   ignored.  If 'replay' is true, the sectors described are mapped.
+ *
+ * Returned Value:
+ *   The number of checkpoints found; zero if the erase block holds none.
+ *   The sequence number and erase count of the erase block are returned
+ *   through 'seq' and 'erasecnt'.  A negated errno value on a read
+ *   failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_scanckpt(FAR struct ftl_struct_s *dev, off_t block,
+                            bool replay, FAR uint32_t *seq,
+                            FAR uint32_t *erasecnt)
+{
+  FAR struct ftl_checkpoint_s *ckpt;
+  ssize_t nread;
+  int expect = 0;
+  int nckpt = 0;
+  int pg;
+  int i;
+
+  nread = MTD_BREAD(dev->mtd, block * dev->blkper, dev->ndata,
+                    dev->eblock);
+  if (nread != dev->ndata)
+    {
+      ferr("ERROR: Read erase block %d failed: %d\n", block, nread);
+      return -EIO;
+    }
+
+  for (pg = 0; pg < dev->ndata; pg++)
+    {
+      ckpt = (FAR struct ftl_checkpoint_s *)
+        &dev->eblock[pg * dev->geo.blocksize];
+
+      if (ckpt->magic != FTL_CHECKPOINT_MAGIC ||
+          ckpt->first != expect || ckpt->first + ckpt->count != pg ||
+          FTL_CHECKPOINT_SIZE(ckpt->count) > dev->geo.blocksize ||
+          (nckpt > 0 && ckpt->seq != *seq) ||
+          ckpt->crc != ftl_log_ckptcrc(ckpt))
+        {
+          continue;
+        }
+
+      if (replay)
+        {
+          for (i = 0; i < ckpt->count; i++)
+            {
+              ftl_log_replay(dev, ckpt->lsector[i],
+                             block * dev->blkper + ckpt->first + i);
+            }
+        }
+
+      *seq      = ckpt->seq;
+      *erasecnt = ckpt->erasecnt;
+      expect    = pg + 1;
+      nckpt++;
+    }
+
+  return nckpt;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_mount
+ *
+ * Description:
+ *   Rebuild the logical to physical map from the erase block summaries.
+ *   The summaries are replayed oldest first so that the newest copy of
+ *   each logical sector wins.  An erase block without a valid summary was
+ *   open when power was lost; the sectors described by its checkpoints
+ *   are replayed too.  Erase blocks with neither (never used, or never
+ *   flushed) are free.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_mount(FAR struct ftl_struct_s *dev)
+{
+  FAR struct ftl_summary_s *summary = dev->summary;
+  FAR struct ftl_order_s *order;
+  FAR struct ftl_eblock_s *eb;
+  uint32_t maxerase = 0;
+  uint32_t erasecnt;
+  uint32_t seq;
+  ssize_t nread;
+  int nfull = 0;
+  int ret;
+  int i;
+  int j;
+
+  order = (FAR struct ftl_order_s *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_order_s));
+  if (order == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  memset(dev->l2p, 0xff, dev->nsectors * sizeof(uint32_t));
+
+  /* Find the erase blocks with valid summaries */
+
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eb[i];
+      eb->state  = FTL_EB_FREE;
+      eb->nvalid = 0;
+      eb->erasecnt = UINT32_MAX;
+
+      nread = MTD_BREAD(dev->mtd, i * dev->blkper + dev->ndata, dev->nsum,
+                        (FAR uint8_t *)summary);
+      if (nread == dev->nsum && summary->magic == FTL_SUMMARY_MAGIC &&
+          summary->crc == ftl_log_crc(dev, summary))
+        {
+          seq      = summary->seq;
+          erasecnt = summary->erasecnt;
+          order[nfull].ckpt = false;
+        }
+      else
+        {
+          ret = ftl_log_scanckpt(dev, i, false, &seq, &erasecnt);
+          if (ret <= 0)
+            {
+              continue;
+            }
+
+          order[nfull].ckpt = true;
+        }
+
+      /* An erase block recovered from checkpoints is not re-opened:  Its
+       * remaining R/W blocks are reclaimed by garbage collection.
+       */
+
+      eb->state          = FTL_EB_FULL;
+      eb->erasecnt       = erasecnt;
+      order[nfull].seq   = seq;
+      order[nfull].block = i;
+      nfull++;
+
+      if (erasecnt > maxerase)
+        {
+          maxerase = erasecnt;
+        }
+    }
+
+  /* Replay the summaries and checkpoints, oldest first */
+
+  qsort(order, nfull, sizeof(struct ftl_order_s), ftl_log_seqcompare);
+
+  for (i = 0; i < nfull; i++)
+    {
+      if (order[i].ckpt)
+        {
+          ret = ftl_log_scanckpt(dev, order[i].block, true, &seq,
+                                 &erasecnt);
+          if (ret < 0)
+            {
+              kmm_free(order);
+              return ret;
+            }
+
+          continue;
+        }
+
+      nread = MTD_BREAD(dev->mtd,
+                        order[i].block * dev->blkper + dev->ndata,
+                        dev->nsum, (FAR uint8_t *)summary);
+      if (nread != dev->nsum)
+        {
+          ferr("ERROR: Read summary of erase block %d failed: %d\n",
+               order[i].block, nread);
+          kmm_free(order);
+          return -EIO;
+        }
+
+      for (j = 0; j < dev->ndata; j++)
+        {
+          ftl_log_replay(dev, summary->lsector[j],
+                         order[i].block * dev->blkper + j);
+        }
+    }
+
+  dev->seq = nfull > 0 ? order[nfull - 1].seq + 1 : 0;
+  kmm_free(order);
+
+  /* Fully obsolete erase blocks are free.  The wear of erase blocks without
+   * a summary is unknown; assume the worst.
+   */
+
+  dev->nfree = 0;
+  for (i = 0; i < dev->geo.neraseblocks; i++)
+    {
+      eb = &dev->eb[i];
+      if (eb->state == FTL_EB_FULL && eb->nvalid == 0)
+        {
+          eb->state = FTL_EB_FREE;
+        }
+
+      if (eb->erasecnt == UINT32_MAX)
+        {
+          eb->erasecnt = maxerase;
+        }
+
+      if (eb->state == FTL_EB_FREE)
+        {
+          dev->nfree++;
+        }
+    }
+
+  finfo("Mounted %d erase blocks, %d free, seq %u\n",
+        dev->geo.neraseblocks, dev->nfree, dev->seq);
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: ftl_log_initialize
+ *
+ * Description:
+ *   Size the log-structured layout, allocate the in-memory map and mount
+ *   the log.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+static int ftl_log_initialize(FAR struct ftl_struct_s *dev)
+{
+  int nsum;
+  int ret;
+
+  /* Reserve enough R/W blocks at the end of each erase block to hold its
+   * summary.
+   */
+
+  for (nsum = 1; nsum < dev->blkper; nsum++)
+    {
+      if (FTL_SUMMARY_SIZE(dev->blkper - nsum) <= nsum * dev->geo.blocksize)
+        {
+          break;
+        }
+    }
+
+  if (nsum >= dev->blkper ||
+      dev->geo.neraseblocks <= CONFIG_FTL_LOG_RESERVE)
+    {
+      ferr("ERROR: Geometry not supported\n");
+      return -EINVAL;
+    }
+
+  dev->nsum     = nsum;
+  dev->ndata    = dev->blkper - nsum;
+  dev->nsectors = (dev->geo.neraseblocks - CONFIG_FTL_LOG_RESERVE) *
+                  dev->ndata;
+  dev->openeb   = -1;
+
+  dev->l2p     = (FAR uint32_t *)
+    kmm_malloc(dev->nsectors * sizeof(uint32_t));
+  dev->eb      = (FAR struct ftl_eblock_s *)
+    kmm_malloc(dev->geo.neraseblocks * sizeof(struct ftl_eblock_s));
+  dev->summary = (FAR struct ftl_summary_s *)
+    kmm_malloc(nsum * dev->geo.blocksize);
+
+  if (dev->l2p == NULL || dev->eb == NULL || dev->summary == NULL)
+    {
+      ret = -ENOMEM;
+      goto errout;
+    }
+
+  nxsem_init(&dev->exclsem, 0, 1);
+
+  ret = ftl_log_mount(dev);
+  if (ret < 0)
+    {
+      nxsem_destroy(&dev->exclsem);
+      goto errout;
+    }
+
+  return OK;
+
+errout:
+  ferr("ERROR: Failed to initialize the log: %d\n", ret);
+  kmm_free(dev->l2p);
+  kmm_free(dev->eb);
+  kmm_free(dev->summary);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: ftl_reload
  *
@@ -173,9 +1184,15 @@ static ssize_t ftl_reload(FAR void *priv, FAR uint8_t *buffer,
   struct ftl_struct_s *dev = (struct ftl_struct_s *)priv;
   ssize_t nread;
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+  /* Read through the logical to physical map */
+
+  nread   = ftl_log_read(dev, buffer, startblock, nblocks);
+#else
   /* Read the full erase block into the buffer */
 
   nread   = MTD_BREAD(dev->mtd, startblock, nblocks, buffer);
+#endif
   if (nread != nblocks)
     {
       ferr("ERROR: Read %d blocks starting at block %d failed: %d\n",
@@ -231,6 +1248,12 @@ static ssize_t ftl_flush(FAR void *priv, FAR const uint8_t *buffer,
   int    nbytes;
   int    ret;
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+  /* Sectors are never rewritten in place.  Append them to the log. */
+
+  return ftl_log_write(dev, buffer, startblock, nblocks);
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -435,7 +1458,11 @@ static int ftl_geometry(FAR struct inode *inode, struct geometry *geometry)
 #else
       geometry->geo_writeenabled  = false;
 #endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+      geometry->geo_nsectors      = dev->nsectors;
+#else
       geometry->geo_nsectors      = dev->geo.neraseblocks * dev->blkper;
+#endif
       geometry->geo_sectorsize    = dev->geo.blocksize;
 
       finfo("available: true mediachanged: false writeenabled: %s\n",
@@ -464,6 +1491,31 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
   finfo("Entry\n");
   DEBUGASSERT(inode && inode->i_private);
 
+  /* BIOC_FLUSH makes everything written so far survive a power failure:
+   * The write buffer is flushed to FLASH, then the log-structured layout
+   * checkpoints the open erase block.
+   */
+
+  if (cmd == BIOC_FLUSH)
+    {
+      dev = (struct ftl_struct_s *)inode->i_private;
+      ret = OK;
+
+#ifdef CONFIG_FTL_WRITEBUFFER
+      ret = rwb_flush(&dev->rwb);
+#endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+      if (ret >= 0)
+        {
+          ftl_log_lock(dev);
+          ret = ftl_log_checkpoint(dev);
+          ftl_log_unlock(dev);
+        }
+#endif
+
+      return ret;
+    }
+
   /* Only one block driver ioctl command is supported by this driver (and
    * that command is just passed on to the MTD driver in a slightly
    * different form).
@@ -496,7 +1548,7 @@ static int ftl_ioctl(FAR struct inode *inode, int cmd, unsigned long arg)
 
   dev = (struct ftl_struct_s *)inode->i_private;
   ret = MTD_IOCTL(dev->mtd, cmd, arg);
-  if (ret < 0)
+  if (ret < 0 && ret != -ENOTTY)
     {
       ferr("ERROR: MTD ioctl(%04x) failed: %d\n", cmd, ret);
     }
@@ -575,11 +1627,27 @@ int ftl_initialize_by_name(FAR const char *name, FAR struct mtd_dev_s *mtd)
       dev->blkper = dev->geo.erasesize / dev->geo.blocksize;
       DEBUGASSERT(dev->blkper * dev->geo.blocksize == dev->geo.erasesize);
 
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+      /* Rebuild the logical to physical map from FLASH */
+
+      ret = ftl_log_initialize(dev);
+      if (ret < 0)
+        {
+          kmm_free(dev->eblock);
+          kmm_free(dev);
+          return ret;
+        }
+#endif
+
       /* Configure read-ahead/write buffering */
 
 #ifdef FTL_HAVE_RWBUFFER
       dev->rwb.blocksize   = dev->geo.blocksize;
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+      dev->rwb.nblocks     = dev->nsectors;
+#else
       dev->rwb.nblocks     = dev->geo.neraseblocks * dev->blkper;
+#endif
       dev->rwb.dev         = (FAR void *)dev;
 
 #if defined(CONFIG_FS_WRITABLE) && defined(CONFIG_FTL_WRITEBUFFER)
@@ -598,6 +1666,11 @@ int ftl_initialize_by_name(FAR const char *name, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: rwb_initialize failed: %d\n", ret);
 #ifdef CONFIG_FS_WRITABLE
           kmm_free(dev->eblock);
+#endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+          kmm_free(dev->l2p);
+          kmm_free(dev->eb);
+          kmm_free(dev->summary);
 #endif
           kmm_free(dev);
           return ret;
@@ -616,6 +1689,11 @@ int ftl_initialize_by_name(FAR const char *name, FAR struct mtd_dev_s *mtd)
           ferr("ERROR: register_blockdriver failed: %d\n", -ret);
 #ifdef CONFIG_FS_WRITABLE
           kmm_free(dev->eblock);
+#endif
+#ifdef CONFIG_FTL_LOGSTRUCTURED
+          kmm_free(dev->l2p);
+          kmm_free(dev->eb);
+          kmm_free(dev->summary);
 #endif
           kmm_free(dev);
         }
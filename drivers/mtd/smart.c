@@ -152,6 +152,28 @@
 #define SMART_WEAR_ZERO_MASK                0x0f
 #define SMART_WEAR_BLOCK_MASK               0x01
 
+/* Sector map hints.  Each logical sector records the group of erase blocks
+ * holding its physical sector so that a cache miss only needs to scan that
+ * group.
+ */
+
+#define SMART_HINT_NONE                     0xff
+
+/* Sector map checkpoint.  Two slots are reserved at the end of the device.
+ * The header of a slot is written last and is invalidated by programming
+ * its status byte before the first modification of the volume following
+ * the checkpoint.
+ */
+
+#define SMART_CKPT_MAGIC                    0x50434d53  /* "SMCP" */
+#define SMART_CKPT_VERSION                  1
+#define SMART_CKPT_NSLOTS                   2
+#define SMART_CKPT_MAXSEGS                  4
+
+#define SMART_CKPT_FLAG_MINRAM              0x01
+#define SMART_CKPT_FLAG_HINTS               0x02
+#define SMART_CKPT_FLAG_PACKED              0x04
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
 
 /* Bit mapping for wear level bits */
@@ -218,6 +240,41 @@ struct smart_allocsector_s
 };
 #endif
 
+/* The checkpoint saves the state built by smart_scan() so that a volume
+ * that was closed cleanly can be brought up without reading the header of
+ * every physical sector.  The header occupies the first MTD block of a slot
+ * and is followed by the payload segments returned by
+ * smart_ckpt_segments().
+ */
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+struct smart_ckpt_header_s
+{
+  uint8_t               status;           /* Programmed when invalidated */
+  uint8_t               version;          /* SMART_CKPT_VERSION */
+  uint8_t               flags;            /* SMART_CKPT_FLAG_* */
+  uint8_t               formatversion;    /* Format version on the device */
+  uint32_t              magic;            /* SMART_CKPT_MAGIC */
+  uint32_t              seq;              /* Checkpoint sequence number */
+  uint32_t              length;           /* Length of the payload */
+  uint32_t              crc;              /* CRC-32 of the payload */
+  uint16_t              sectorsize;       /* Sector size on device */
+  uint16_t              totalsectors;     /* Total number of sectors */
+  uint16_t              neraseblocks;     /* Number of erase blocks */
+  uint16_t              freesectors;      /* Total number of free sectors */
+  uint16_t              releasesectors;   /* Total number of released sectors */
+  uint8_t               namesize;         /* Length of filenames */
+  uint8_t               reserved;
+  uint32_t              hdrcrc;           /* CRC-32 of the header after status */
+};
+
+struct smart_ckpt_segment_s
+{
+  FAR uint8_t          *data;             /* RAM image of the segment */
+  size_t                len;              /* Length of the segment */
+};
+#endif
+
 struct smart_struct_s
 {
   FAR struct mtd_dev_s *mtd;              /* Contained MTD interface */
@@ -272,6 +329,22 @@ struct smart_struct_s
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   FAR uint8_t          *erasecounts;      /* Number of erases for each erase block */
 #endif
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  FAR uint8_t          *sHint;            /* Erase block group of each logical sector */
+  uint8_t               hintshift;        /* log2 of erase blocks per hint group */
+#endif
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  uint32_t              countsize;        /* Size of the release and free counts */
+  uint32_t              ckptseq;          /* Sequence number of the last checkpoint */
+  uint16_t              ckptblock;        /* First erase block of the checkpoint */
+  uint16_t              ckptslotblocks;   /* Erase blocks per checkpoint slot */
+  uint8_t               ckptslot;         /* Slot holding the last checkpoint */
+  uint8_t               opencount;        /* Number of times the device is open */
+  bool                  ckptvalid;        /* The checkpoint matches the volume */
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  uint16_t              sysmap[SMART_FIRST_ALLOC_SECTOR]; /* Reserved sector map */
+#endif
+#endif
 #ifdef CONFIG_MTD_SMART_ALLOC_DEBUG
   size_t                bytesalloc;
   struct smart_alloc_s  alloc[SMART_MAX_ALLOCS];   /* Array of memory allocations */
@@ -392,6 +465,11 @@ static int smart_relocate_static_data(FAR struct smart_struct_s *dev, uint16_t b
 static int smart_relocate_sector(FAR struct smart_struct_s *dev,
                  uint16_t oldsector, uint16_t newsector);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_invalidate(FAR struct smart_struct_s *dev);
+static int  smart_ckpt_write(FAR struct smart_struct_s *dev);
+#endif
+
 #ifdef CONFIG_SMART_DEV_LOOP
 static ssize_t smart_loop_read(FAR struct file *filep, FAR char *buffer,
                  size_t buflen);
@@ -446,7 +524,17 @@ static const struct file_operations g_fops =
 
 static int smart_open(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR struct smart_struct_s *dev;
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+  dev->opencount++;
+#endif
+
   return OK;
 }
 
@@ -459,7 +547,24 @@ static int smart_open(FAR struct inode *inode)
 
 static int smart_close(FAR struct inode *inode)
 {
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  FAR struct smart_struct_s *dev;
+#endif
+
   finfo("Entry\n");
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Checkpoint the sector map when the last user (normally the file system
+   * being unmounted) closes the device.
+   */
+
+  dev = (FAR struct smart_struct_s *)inode->i_private;
+  if (dev->opencount > 0 && --dev->opencount == 0)
+    {
+      (void)smart_ckpt_write(dev);
+    }
+#endif
+
   return OK;
 }
 
@@ -878,6 +983,10 @@ static ssize_t smart_write(FAR struct inode *inode,
 
   /* I think maybe we need to lock on a mutex here */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_ckpt_invalidate(dev);
+#endif
+
   /* Get the aligned block.  Here is is assumed: (1) The number of R/W blocks
    * per erase block is a power of 2, and (2) the erase begins with that same
    * alignment.
@@ -1094,6 +1203,14 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       dev->sBitMap = NULL;
     }
 
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  if (dev->sHint != NULL)
+    {
+      smart_free(dev, dev->sHint);
+      dev->sHint = NULL;
+    }
+#endif
+
   dev->cache_entries = 0;
   dev->cache_lastlog = 0xffff;
   dev->cache_nextbirth = 0;
@@ -1157,6 +1274,26 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
       goto errexit;
     }
 
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  /* Allocate the sector map hints.  Group erase blocks so that the group
+   * number of every block fits in a byte.
+   */
+
+  dev->sHint = (FAR uint8_t *) smart_malloc(dev, totalsectors, "Sector hints");
+  if (dev->sHint == NULL)
+    {
+      ferr("ERROR: Error allocating SMART sector hints\n");
+      goto errexit;
+    }
+
+  memset(dev->sHint, SMART_HINT_NONE, totalsectors);
+  for (dev->hintshift = 0;
+       ((dev->neraseblocks - 1) >> dev->hintshift) >= SMART_HINT_NONE;
+       dev->hintshift++)
+    {
+    }
+#endif
+
   /* Calculate the alloc size of the freesector and release sector arrays */
 
 #ifdef CONFIG_MTD_SMART_PACK_COUNTS
@@ -1215,6 +1352,10 @@ static int smart_setsectorsize(FAR struct smart_struct_s *dev, uint16_t size)
 
 #endif  /* CONFIG_MTD_SMART_MINIMIZE_RAM */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  dev->countsize = allocsize;
+#endif
+
 #ifdef CONFIG_MTD_SMART_SECTOR_ERASE_DEBUG
   /* Allocate a buffer to hold the erase counts */
 
@@ -1280,6 +1421,14 @@ errexit:
       dev->sBitMap = NULL;
     }
 
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  if (dev->sHint)
+    {
+      smart_free(dev, dev->sHint);
+      dev->sHint = NULL;
+    }
+#endif
+
   if (dev->sCache)
     {
       smart_free(dev, dev->sCache);
@@ -1376,6 +1525,32 @@ errout:
   return ret;
 }
 
+/****************************************************************************
+ * Name: smart_set_hint
+ *
+ * Description: Records the erase block group holding the physical sector
+ *              of a logical sector.  A cache miss on the logical sector
+ *              then only needs to scan that group of erase blocks.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static inline void smart_set_hint(FAR struct smart_struct_s *dev,
+                                  uint16_t logical, uint16_t physical)
+{
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  if (physical == 0xffff)
+    {
+      dev->sHint[logical] = SMART_HINT_NONE;
+    }
+  else
+    {
+      dev->sHint[logical] = (physical / dev->sectorsPerBlk) >> dev->hintshift;
+    }
+#endif
+}
+#endif
+
 /****************************************************************************
  * Name: smart_add_sector_to_cache
  *
@@ -1433,6 +1608,7 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
   dev->sCache[index].birth = dev->cache_nextbirth++;
   dev->cache_lastlog = logical;
   dev->cache_lastphys = physical;
+  smart_set_hint(dev, logical, physical);
 
   if (dev->debuglevel > 1)
     {
@@ -1456,6 +1632,101 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_cache_scan
+ *
+ * Description: Scan the erase blocks firstblock up to (but not including)
+ *              lastblock for the physical sector holding the requested
+ *              logical sector.  Returns the physical sector, 0xffff if it
+ *              was not found or a negated errno value on a read error.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+static int smart_cache_scan(FAR struct smart_struct_s *dev, uint16_t logical,
+                            uint16_t firstblock, uint16_t lastblock)
+{
+  int       ret;
+  uint16_t  block, sector;
+  uint16_t  logicalsector;
+  struct    smart_sect_header_s header;
+  size_t    readaddress;
+
+  if (lastblock > dev->geo.neraseblocks)
+    {
+      lastblock = dev->geo.neraseblocks;
+    }
+
+  /* Instead of scanning start to end, we span the erase blocks and read
+   * one sector from each at a time.  this helps speed up the search on
+   * volumes that aren't full because of sector allocation scheme will use
+   * the lower sector numbers in each erase block first.
+   */
+
+  for (sector = 0; sector < dev->availSectPerBlk; sector++)
+    {
+      /* Now scan across each erase block */
+
+      for (block = firstblock; block < lastblock; block++)
+        {
+          /* Calculate the read address for this sector */
+
+          readaddress = block * dev->erasesize +
+              sector * dev->sectorsize;
+
+          /* Read the header for this sector */
+
+          ret = MTD_READ(dev->mtd, readaddress,
+              sizeof(struct smart_sect_header_s), (FAR uint8_t *) &header);
+          if (ret != sizeof(struct smart_sect_header_s))
+            {
+              return ret < 0 ? ret : -EIO;
+            }
+
+          /* Get the logical sector number for this physical sector */
+
+          logicalsector = *((FAR uint16_t *) header.logicalsector);
+#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
+          if (logicalsector == 0)
+            {
+              continue;
+            }
+#endif
+
+          /* Test if this sector has been committed */
+
+          if ((header.status & SMART_STATUS_COMMITTED) ==
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
+            {
+              continue;
+            }
+
+          /* Test if this sector has been release and skip it if it has */
+
+          if ((header.status & SMART_STATUS_RELEASED) !=
+                  (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
+            {
+              continue;
+            }
+
+          if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
+            {
+              continue;
+            }
+
+          /* Test if this is the sector we are looking for */
+
+          if (logicalsector == logical)
+            {
+              return block * dev->sectorsPerBlk + sector;
+            }
+        }
+    }
+
+  return 0xffff;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_cache_lookup
  *
@@ -1464,6 +1735,8 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
  *              return the physical mapping.  If a cache miss occurs, then
  *              the routine will scan the volume to find the logical sector
  *              and add / replace a cache entry with the newly located sector.
+ *              With CONFIG_MTD_SMART_MAP_HINTS, only the erase blocks of the
+ *              hinted group are scanned unless the hint turns out stale.
  *
  ****************************************************************************/
 
@@ -1471,10 +1744,10 @@ static int smart_add_sector_to_cache(FAR struct smart_struct_s *dev,
 static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logical)
 {
   int       ret;
-  uint16_t  block, sector;
-  uint16_t  x, physical, logicalsector;
-  struct    smart_sect_header_s header;
-  size_t    readaddress;
+  uint16_t  x, physical;
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  uint16_t  block;
+#endif
 
   physical = 0xffff;
 
@@ -1504,75 +1777,37 @@ static uint16_t smart_cache_lookup(FAR struct smart_struct_s *dev, uint16_t logi
 
   if (physical == 0xffff)
     {
-      /* Now scan the MTD device.  Instead of scanning start to end, we
-       * span the erase blocks and read one sector from each at a time.
-       * this helps speed up the search on volumes that aren't full
-       * because of sector allocation scheme will use the lower sector
-       * numbers in each erase block first.
-       */
+      ret = 0xffff;
 
-      for (sector = 0; sector < dev->availSectPerBlk && physical == 0xffff; sector++)
-        {
-          /* Now scan across each erase block */
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+      /* Scan the group of erase blocks the sector was last seen in */
 
-          for (block = 0; block < dev->geo.neraseblocks; block++)
-            {
-              /* Calculate the read address for this sector */
-
-              readaddress = block * dev->erasesize +
-                  sector * dev->sectorsize;
-
-              /* Read the header for this sector */
-
-              ret = MTD_READ(dev->mtd, readaddress,
-                  sizeof(struct smart_sect_header_s), (FAR uint8_t *) &header);
-              if (ret != sizeof(struct smart_sect_header_s))
-                {
-                  goto err_out;
-                }
-
-              /* Get the logical sector number for this physical sector */
+      if (dev->sHint[logical] != SMART_HINT_NONE)
+        {
+          block = (uint16_t)dev->sHint[logical] << dev->hintshift;
+          ret   = smart_cache_scan(dev, logical, block,
+                                   block + (1 << dev->hintshift));
+        }
 
-              logicalsector = *((FAR uint16_t *) header.logicalsector);
-#if CONFIG_SMARTFS_ERASEDSTATE == 0x00
-              if (logicalsector == 0)
-                {
-                  continue;
-                }
+      if (ret == 0xffff)
 #endif
+        {
+          /* Now scan the whole MTD device */
 
-              /* Test if this sector has been committed */
-
-              if ((header.status & SMART_STATUS_COMMITTED) ==
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_COMMITTED))
-                {
-                  continue;
-                }
-
-              /* Test if this sector has been release and skip it if it has */
-
-              if ((header.status & SMART_STATUS_RELEASED) !=
-                      (CONFIG_SMARTFS_ERASEDSTATE & SMART_STATUS_RELEASED))
-                {
-                  continue;
-                }
-
-              if ((header.status & SMART_STATUS_VERBITS) != SMART_STATUS_VERSION)
-                {
-                  continue;
-                }
+          ret = smart_cache_scan(dev, logical, 0, dev->geo.neraseblocks);
+        }
 
-              /* Test if this is the sector we are looking for */
+      if (ret < 0)
+        {
+          goto err_out;
+        }
 
-              if (logicalsector == logical)
-                {
-                  /* This is the sector we are looking for!  Add it to the cache */
+      physical = ret;
+      if (physical != 0xffff)
+        {
+          /* This is the sector we are looking for!  Add it to the cache */
 
-                  physical = block * dev->sectorsPerBlk + sector;
-                  smart_add_sector_to_cache(dev, logical, physical, __LINE__);
-                  break;
-                }
-            }
+          smart_add_sector_to_cache(dev, logical, physical, __LINE__);
         }
     }
 
@@ -1635,6 +1870,8 @@ static void smart_update_cache(FAR struct smart_struct_s *dev, uint16_t
     {
       dev->cache_lastphys = physical;
     }
+
+  smart_set_hint(dev, logical, physical);
 }
 #endif
 
@@ -1824,6 +2061,530 @@ static int smart_set_wear_level(FAR struct smart_struct_s *dev, uint16_t block,
 }
 #endif
 
+/****************************************************************************
+ * Name: smart_ckpt_initialize
+ *
+ * Description:  Reserve the erase blocks at the end of the device that hold
+ *               the sector map checkpoint.  The slots are sized for the
+ *               configured sector size.  Volumes formatted with a smaller
+ *               sector size fall back to a full scan if the checkpoint does
+ *               not fit.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_initialize(FAR struct smart_struct_s *dev)
+{
+  uint32_t  maxsectors;
+  uint32_t  size;
+  uint32_t  nblocks;
+
+  maxsectors = dev->geo.neraseblocks *
+               (dev->geo.erasesize / CONFIG_MTD_SMART_SECTOR_SIZE);
+  if (maxsectors > 65536)
+    {
+      maxsectors = 65536;
+    }
+
+  size    = dev->geo.blocksize + maxsectors * sizeof(uint16_t) +
+            (dev->geo.neraseblocks << 1) +
+            SMART_FIRST_ALLOC_SECTOR * sizeof(uint16_t);
+  nblocks = (size + dev->geo.erasesize - 1) / dev->geo.erasesize;
+
+  /* Don't give up more than 1/8 of the device for the checkpoint */
+
+  if (SMART_CKPT_NSLOTS * nblocks > (dev->geo.neraseblocks >> 3))
+    {
+      fwarn("WARNING: Device too small for a sector map checkpoint\n");
+      dev->ckptslotblocks = 0;
+      return;
+    }
+
+  dev->geo.neraseblocks -= SMART_CKPT_NSLOTS * nblocks;
+  dev->ckptblock         = dev->geo.neraseblocks;
+  dev->ckptslotblocks    = nblocks;
+  dev->ckptslot          = SMART_CKPT_NSLOTS - 1;
+  dev->ckptseq           = 0;
+  dev->ckptvalid         = false;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_segments
+ *
+ * Description:  Describe the RAM state that is saved in a checkpoint.  This
+ *               is everything smart_scan() builds from the sector headers.
+ *               Returns the number of segments.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_segments(FAR struct smart_struct_s *dev,
+                               FAR struct smart_ckpt_segment_s *segs)
+{
+  int nsegs = 0;
+
+#ifndef CONFIG_MTD_SMART_MINIMIZE_RAM
+  segs[nsegs].data   = (FAR uint8_t *)dev->sMap;
+  segs[nsegs++].len  = dev->totalsectors * sizeof(uint16_t);
+#else
+  segs[nsegs].data   = dev->sBitMap;
+  segs[nsegs++].len  = (dev->totalsectors + 7) >> 3;
+  segs[nsegs].data   = (FAR uint8_t *)dev->sysmap;
+  segs[nsegs++].len  = sizeof(dev->sysmap);
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  segs[nsegs].data   = dev->sHint;
+  segs[nsegs++].len  = dev->totalsectors;
+#endif
+#endif
+
+  /* The release and free counts are allocated together */
+
+  segs[nsegs].data   = dev->releasecount;
+  segs[nsegs++].len  = dev->countsize;
+
+  DEBUGASSERT(nsegs <= SMART_CKPT_MAXSEGS);
+  return nsegs;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_flags
+ *
+ * Description:  Return the configuration flags recorded in a checkpoint.  A
+ *               checkpoint is only restored by a matching configuration.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static inline uint8_t smart_ckpt_flags(void)
+{
+  uint8_t flags = 0;
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  flags |= SMART_CKPT_FLAG_MINRAM;
+#endif
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  flags |= SMART_CKPT_FLAG_HINTS;
+#endif
+#ifdef CONFIG_MTD_SMART_PACK_COUNTS
+  flags |= SMART_CKPT_FLAG_PACKED;
+#endif
+
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_hdrcrc
+ *
+ * Description:  Calculate the CRC of a checkpoint header.  The status byte
+ *               is excluded because it is programmed on invalidation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static inline uint32_t smart_ckpt_hdrcrc(FAR struct smart_ckpt_header_s *hdr)
+{
+  return crc32((FAR uint8_t *)hdr + 1,
+               offsetof(struct smart_ckpt_header_s, hdrcrc) - 1);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_mtdblock
+ *
+ * Description:  Return the first MTD block of a checkpoint slot.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static inline off_t smart_ckpt_mtdblock(FAR struct smart_struct_s *dev,
+                                        int slot)
+{
+  return (off_t)(dev->ckptblock + slot * dev->ckptslotblocks) *
+         (dev->geo.erasesize / dev->geo.blocksize);
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_cancel
+ *
+ * Description:  Invalidate the checkpoint in a slot by programming the
+ *               status byte of its header.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_cancel(FAR struct smart_struct_s *dev, int slot)
+{
+  uint8_t status = (uint8_t)~CONFIG_SMARTFS_ERASEDSTATE;
+  ssize_t ret;
+
+  ret = smart_bytewrite(dev, smart_ckpt_mtdblock(dev, slot) *
+                        dev->geo.blocksize, 1, &status);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d invalidating checkpoint %d\n", (int)-ret, slot);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_invalidate
+ *
+ * Description:  Called before the volume is modified.  Invalidates the
+ *               checkpoint on the device if it describes the volume so that
+ *               an unclean shutdown falls back to a full scan.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static void smart_ckpt_invalidate(FAR struct smart_struct_s *dev)
+{
+  if (dev->ckptvalid)
+    {
+      dev->ckptvalid = false;
+      smart_ckpt_cancel(dev, dev->ckptslot);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_load
+ *
+ * Description:  Restore the state built by smart_scan() from the newest
+ *               checkpoint.  Returns OK if the checkpoint was restored.
+ *               Otherwise the caller must scan the device.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_load(FAR struct smart_struct_s *dev)
+{
+  struct smart_ckpt_segment_s segs[SMART_CKPT_MAXSEGS];
+  struct smart_ckpt_header_s hdr;
+  struct smart_ckpt_header_s best;
+  uint32_t  length;
+  uint32_t  crc;
+  off_t     address;
+  int       nsegs;
+  int       slot;
+  int       x;
+  int       ret;
+
+  dev->ckptvalid = false;
+  if (dev->ckptslotblocks == 0)
+    {
+      return -ENOSYS;
+    }
+
+  /* Find the newest checkpoint.  Only the newest one may be restored: an
+   * older one that was never invalidated can still be stale.
+   */
+
+  slot = -1;
+  for (x = 0; x < SMART_CKPT_NSLOTS; x++)
+    {
+      ret = MTD_READ(dev->mtd, smart_ckpt_mtdblock(dev, x) * dev->geo.blocksize,
+                     sizeof(hdr), (FAR uint8_t *)&hdr);
+      if (ret != sizeof(hdr) || hdr.magic != SMART_CKPT_MAGIC ||
+          hdr.hdrcrc != smart_ckpt_hdrcrc(&hdr))
+        {
+          continue;
+        }
+
+      if (slot < 0 || hdr.seq > best.seq)
+        {
+          memcpy(&best, &hdr, sizeof(hdr));
+          slot = x;
+        }
+    }
+
+  if (slot < 0)
+    {
+      return -ENOENT;
+    }
+
+  /* New checkpoints continue the sequence in the other slot */
+
+  dev->ckptslot = slot;
+  dev->ckptseq  = best.seq;
+
+  if (best.status != CONFIG_SMARTFS_ERASEDSTATE)
+    {
+      finfo("Checkpoint %lu was invalidated\n", (unsigned long)best.seq);
+      return -ENOENT;
+    }
+
+  /* Validate the checkpoint against the device and the configuration */
+
+  ret = -EINVAL;
+  if (best.version != SMART_CKPT_VERSION ||
+      best.flags != smart_ckpt_flags() ||
+      best.neraseblocks != dev->geo.neraseblocks)
+    {
+      goto errout;
+    }
+
+  ret = smart_setsectorsize(dev, best.sectorsize);
+  if (ret != OK)
+    {
+      goto errout;
+    }
+
+  ret = -EINVAL;
+  if (best.totalsectors != dev->totalsectors)
+    {
+      goto errout;
+    }
+
+  nsegs = smart_ckpt_segments(dev, segs);
+  for (length = 0, x = 0; x < nsegs; x++)
+    {
+      length += segs[x].len;
+    }
+
+  if (best.length != length)
+    {
+      goto errout;
+    }
+
+  /* Read the payload directly into place */
+
+  address = (smart_ckpt_mtdblock(dev, slot) + 1) * dev->geo.blocksize;
+  crc     = 0;
+
+  for (x = 0; x < nsegs; x++)
+    {
+      ret = MTD_READ(dev->mtd, address, segs[x].len, segs[x].data);
+      if (ret != segs[x].len)
+        {
+          ret = ret < 0 ? ret : -EIO;
+          goto errout;
+        }
+
+      crc      = crc32part(segs[x].data, segs[x].len, crc);
+      address += segs[x].len;
+    }
+
+  if (crc != best.crc)
+    {
+      ferr("ERROR: Checkpoint %lu CRC error\n", (unsigned long)best.seq);
+      ret = -EIO;
+      goto errout;
+    }
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  /* Reload the cache with the reserved sectors */
+
+  dev->cache_entries   = 0;
+  dev->cache_lastlog   = 0xffff;
+  dev->cache_nextbirth = 0;
+
+  for (x = 0; x < SMART_FIRST_ALLOC_SECTOR; x++)
+    {
+      if (dev->sysmap[x] != 0xffff)
+        {
+          smart_add_sector_to_cache(dev, x, dev->sysmap[x], __LINE__);
+        }
+    }
+#endif
+
+  dev->freesectors    = best.freesectors;
+  dev->releasesectors = best.releasesectors;
+  dev->formatversion  = best.formatversion;
+  dev->namesize       = best.namesize;
+  dev->formatstatus   = SMART_FMT_STAT_FORMATTED;
+  dev->ckptvalid      = true;
+
+  finfo("Restored checkpoint %lu\n", (unsigned long)best.seq);
+  return OK;
+
+errout:
+
+  /* Make sure the unusable checkpoint can never be restored later, after
+   * the volume has been modified.
+   */
+
+  ferr("ERROR: Unable to restore checkpoint %lu: %d\n",
+       (unsigned long)best.seq, ret);
+  smart_ckpt_cancel(dev, slot);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Name: smart_ckpt_write
+ *
+ * Description:  Write a checkpoint of the state built by smart_scan() to the
+ *               free slot.  The header is written last, after the payload,
+ *               so an interrupted checkpoint is simply not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+static int smart_ckpt_write(FAR struct smart_struct_s *dev)
+{
+  struct smart_ckpt_segment_s segs[SMART_CKPT_MAXSEGS];
+  struct smart_ckpt_header_s hdr;
+  FAR uint8_t *src;
+  uint32_t  length;
+  uint32_t  crc;
+  size_t    remaining;
+  size_t    fill;
+  size_t    count;
+  off_t     mtdblock;
+  uint16_t  nblocks;
+  int       nsegs;
+  int       slot;
+  int       x;
+  int       ret;
+
+  /* Nothing to do if the checkpoint on the device is still valid */
+
+  if (dev->ckptslotblocks == 0 || dev->ckptvalid ||
+      dev->formatstatus != SMART_FMT_STAT_FORMATTED)
+    {
+      return OK;
+    }
+
+#ifdef CONFIG_MTD_SMART_ENABLE_CRC
+  /* Sectors that have only been allocated in RAM would be lost */
+
+  if (dev->allocsector != NULL)
+    {
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_MTD_SMART_MINIMIZE_RAM
+  /* The reserved sectors are always cached */
+
+  for (x = 0; x < SMART_FIRST_ALLOC_SECTOR; x++)
+    {
+      if (dev->sBitMap[x >> 3] & (1 << (x & 0x07)))
+        {
+          dev->sysmap[x] = smart_cache_lookup(dev, x);
+        }
+      else
+        {
+          dev->sysmap[x] = 0xffff;
+        }
+    }
+#endif
+
+  nsegs = smart_ckpt_segments(dev, segs);
+  for (length = 0, x = 0; x < nsegs; x++)
+    {
+      length += segs[x].len;
+    }
+
+  if (dev->geo.blocksize + length > dev->ckptslotblocks * dev->geo.erasesize)
+    {
+      finfo("Checkpoint does not fit: %lu bytes\n", (unsigned long)length);
+      return -ENOSPC;
+    }
+
+  /* Erase the other slot */
+
+  slot = dev->ckptslot ^ 1;
+  ret  = MTD_ERASE(dev->mtd, dev->ckptblock + slot * dev->ckptslotblocks,
+                   dev->ckptslotblocks);
+  if (ret < 0)
+    {
+      ferr("ERROR: Error %d erasing checkpoint slot %d\n", -ret, slot);
+      return ret;
+    }
+
+  /* Stream the payload through the read/write buffer, one sector at a
+   * time, starting with the block after the header.
+   */
+
+  mtdblock = smart_ckpt_mtdblock(dev, slot) + 1;
+  crc      = 0;
+  fill     = 0;
+
+  for (x = 0; x < nsegs; x++)
+    {
+      src       = segs[x].data;
+      remaining = segs[x].len;
+      crc       = crc32part(src, remaining, crc);
+
+      while (remaining > 0)
+        {
+          count = dev->sectorsize - fill;
+          if (count > remaining)
+            {
+              count = remaining;
+            }
+
+          memcpy(&dev->rwbuffer[fill], src, count);
+          src       += count;
+          remaining -= count;
+          fill      += count;
+
+          /* Flush the buffer when it is full or after the last segment */
+
+          if (fill == dev->sectorsize || (remaining == 0 && x == nsegs - 1))
+            {
+              nblocks = (fill + dev->geo.blocksize - 1) / dev->geo.blocksize;
+              memset(&dev->rwbuffer[fill], CONFIG_SMARTFS_ERASEDSTATE,
+                     nblocks * dev->geo.blocksize - fill);
+
+              ret = MTD_BWRITE(dev->mtd, mtdblock, nblocks,
+                               (FAR uint8_t *)dev->rwbuffer);
+              if (ret != nblocks)
+                {
+                  ferr("ERROR: Error %d writing checkpoint\n", ret);
+                  return ret < 0 ? ret : -EIO;
+                }
+
+              mtdblock += nblocks;
+              fill      = 0;
+            }
+        }
+    }
+
+  /* Commit the checkpoint by writing its header */
+
+  memset(&hdr, 0, sizeof(hdr));
+  hdr.status         = CONFIG_SMARTFS_ERASEDSTATE;
+  hdr.version        = SMART_CKPT_VERSION;
+  hdr.flags          = smart_ckpt_flags();
+  hdr.formatversion  = dev->formatversion;
+  hdr.magic          = SMART_CKPT_MAGIC;
+  hdr.seq            = dev->ckptseq + 1;
+  hdr.length         = length;
+  hdr.crc            = crc;
+  hdr.sectorsize     = dev->sectorsize;
+  hdr.totalsectors   = dev->totalsectors;
+  hdr.neraseblocks   = dev->geo.neraseblocks;
+  hdr.freesectors    = dev->freesectors;
+  hdr.releasesectors = dev->releasesectors;
+  hdr.namesize       = dev->namesize;
+  hdr.hdrcrc         = smart_ckpt_hdrcrc(&hdr);
+
+  memset(dev->rwbuffer, CONFIG_SMARTFS_ERASEDSTATE, dev->geo.blocksize);
+  memcpy(dev->rwbuffer, &hdr, sizeof(hdr));
+
+  ret = MTD_BWRITE(dev->mtd, smart_ckpt_mtdblock(dev, slot), 1,
+                   (FAR uint8_t *)dev->rwbuffer);
+  if (ret != 1)
+    {
+      ferr("ERROR: Error %d writing checkpoint header\n", ret);
+      return ret < 0 ? ret : -EIO;
+    }
+
+  dev->ckptslot  = slot;
+  dev->ckptseq   = hdr.seq;
+  dev->ckptvalid = true;
+
+  finfo("Wrote checkpoint %lu\n", (unsigned long)hdr.seq);
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Name: smart_scan
  *
@@ -1858,6 +2619,17 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 
   finfo("Entry\n");
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  /* Restore the results of the last scan from the checkpoint if the volume
+   * was closed cleanly.
+   */
+
+  if (smart_ckpt_load(dev) == OK)
+    {
+      goto scan_done;
+    }
+#endif
+
   /* Find the sector size on the volume by reading headers from
    * sectors of decreasing size.  On a formatted volume, the sector
    * size is saved in the header status byte of seach sector, so
@@ -1952,6 +2724,9 @@ static int smart_scan(FAR struct smart_struct_s *dev)
   /* Clear all logical sector used bits */
 
   memset(dev->sBitMap, 0, (dev->totalsectors + 7) >> 3);
+#ifdef CONFIG_MTD_SMART_MAP_HINTS
+  memset(dev->sHint, SMART_HINT_NONE, dev->totalsectors);
+#endif
 #endif
 
   /* Now scan the MTD device */
@@ -2283,6 +3058,7 @@ static int smart_scan(FAR struct smart_struct_s *dev)
       /* Mark the logical sector as used in the bitmap */
 
       dev->sBitMap[logicalsector >> 3] |= 1 << (logicalsector & 0x07);
+      smart_set_hint(dev, logicalsector, sector);
 
       if (logicalsector < SMART_FIRST_ALLOC_SECTOR)
         {
@@ -2366,6 +3142,10 @@ static int smart_scan(FAR struct smart_struct_s *dev)
 #endif  /* CONFIG_MTD_SMART_CONVERT_WEAR_FORMAT */
 #endif  /* CONFIG_MTD_SMART_WEAR_LEVEL && SMART_STATUS_VERSION == 1 */
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+scan_done:
+#endif
+
 #ifdef CONFIG_MTD_SMART_WEAR_LEVEL
   /* Read the wear leveling status bits */
 
@@ -2925,7 +3705,7 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
       return -EINVAL;
     }
 
-  /* Erase the MTD device */
+  /* Erase the MTD device.  This also erases any checkpoint. */
 
   ret = MTD_IOCTL(dev->mtd, MTDIOC_BULKERASE, 0);
   if (ret < 0)
@@ -2933,6 +3713,10 @@ static inline int smart_llformat(FAR struct smart_struct_s *dev, unsigned long a
       return ret;
     }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  dev->ckptvalid = false;
+#endif
+
   /* Now construct a logical sector zero header to write to the device. */
 
   sectorheader = (FAR struct smart_sect_header_s *) dev->rwbuffer;
@@ -4268,6 +5052,10 @@ static int smart_writesector(FAR struct smart_struct_s *dev,
   DEBUGASSERT(req->offset <= dev->sectorsize);
   DEBUGASSERT(req->offset+req->count <= dev->sectorsize);
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_ckpt_invalidate(dev);
+#endif
+
   /* Ensure the logical sector has been allocated */
 
   if (req->logsector >= dev->totalsectors)
@@ -4807,6 +5595,10 @@ static inline int smart_allocsector(FAR struct smart_struct_s *dev,
 #endif
   int       x;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_ckpt_invalidate(dev);
+#endif
+
   /* Validate that we have enough sectors available to perform an
    * allocation.  We have to ensure we keep enough reserved sectors
    * on hand to do released sector garbage collection.
@@ -5053,6 +5845,10 @@ static inline int smart_freesector(FAR struct smart_struct_s *dev,
   struct    smart_sect_header_s  header;
   size_t    offset;
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+  smart_ckpt_invalidate(dev);
+#endif
+
   /* Check if the logical sector is within bounds */
 
   if ((logicalsector > 2) && (logicalsector < dev->totalsectors))
@@ -5389,6 +6185,12 @@ int smart_initialize(int minor, FAR struct mtd_dev_s *mtd, FAR const char *partn
           goto errout;
         }
 
+#ifdef CONFIG_MTD_SMART_CHECKPOINT
+      /* Reserve the erase blocks holding the sector map checkpoint */
+
+      smart_ckpt_initialize(dev);
+#endif
+
       /* Set the sector size to the default for now */
 
       dev->sectorsize = 0;
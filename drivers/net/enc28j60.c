@@ -1618,6 +1618,7 @@ static void enc_pktif(FAR struct enc_driver_s *priv)
 static void enc_irqworker(FAR void *arg)
 {
   FAR struct enc_driver_s *priv = (FAR struct enc_driver_s *)arg;
+  unsigned int nrx = 0;
   uint8_t eir;
 
   DEBUGASSERT(priv);
@@ -1771,9 +1772,17 @@ static void enc_irqworker(FAR void *arg)
             {
               ninfo("EPKTCNT: %02x\n", pktcnt);
 
-              /* Handle packet receipt */
-
-              enc_pktif(priv);
+              /* Handle packet receipt.  Drain all of the packets that are
+               * already in the receive buffer (up to the RX budget) rather
+               * than re-reading the interrupt status for each packet.
+               */
+
+              do
+                {
+                  enc_pktif(priv);
+                  nrx++;
+                }
+              while (--pktcnt > 0 && nrx < CONFIG_NETDEV_RXBUDGET);
             }
         }
 
@@ -1802,6 +1811,22 @@ static void enc_irqworker(FAR void *arg)
           enc_rxerif(priv);                       /* Handle the RX error */
           enc_bfcgreg(priv, ENC_EIR, EIR_RXERIF); /* Clear the RXERIF interrupt */
         }
+
+      /* Has the RX budget for this pass been exhausted?  If so, leave
+       * interrupts disabled and re-queue the work so that any other work
+       * pending on the worker thread gets a chance to run.  The remaining
+       * packets will be handled on the next pass.
+       */
+
+      if (nrx >= CONFIG_NETDEV_RXBUDGET)
+        {
+          enc_unlock(priv);
+          net_unlock();
+
+          work_queue(ENCWORK, &priv->irqwork, enc_irqworker,
+                     (FAR void *)priv, 0);
+          return;
+        }
     }
 
   /* Enable GPIO interrupts */
@@ -893,6 +893,7 @@ static void lan91c111_interrupt_work(FAR void *arg)
 {
   FAR struct net_driver_s *dev = arg;
   FAR struct lan91c111_driver_s *priv = dev->d_private;
+  unsigned int nrx = 0;
   uint8_t status;
 
   /* Lock the network and serialize driver operations if necessary.
@@ -922,7 +923,17 @@ static void lan91c111_interrupt_work(FAR void *arg)
 
       if (status & IM_RCV_INT)
         {
-          lan91c111_receive(dev);
+          /* Drain the RX FIFO (up to the RX budget) rather than re-reading
+           * the interrupt status for each packet.
+           */
+
+          do
+            {
+              lan91c111_receive(dev);
+              nrx++;
+            }
+          while (nrx < CONFIG_NETDEV_RXBUDGET &&
+                 (getreg8(priv, RXFIFO_REG) & RXFIFO_REMPTY) == 0);
         }
 
       if (status & IM_RX_OVRN_INT)
@@ -954,6 +965,19 @@ static void lan91c111_interrupt_work(FAR void *arg)
         {
           devif_poll(dev, lan91c111_txpoll);
         }
+
+      /* Has the RX budget for this pass been exhausted?  If so, leave the
+       * interrupt disabled and re-queue the work so that other work on the
+       * worker thread gets a chance to run.
+       */
+
+      if (nrx >= CONFIG_NETDEV_RXBUDGET)
+        {
+          net_unlock();
+          work_queue(LAN91C111_WORK, &priv->irqwork,
+                     lan91c111_interrupt_work, dev, 0);
+          return;
+        }
     }
 
   net_unlock();
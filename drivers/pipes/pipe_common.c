@@ -113,6 +113,221 @@ static void pipecommon_semtake(FAR sem_t *sem)
   while (ret == -EINTR);
 }
 
+/****************************************************************************
+ * Name: pipecommon_nbytes
+ *
+ * Description:
+ *   Return the number of bytes in the pipe buffer.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_nbytes(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdseg
+ *
+ * Description:
+ *   Return the number of bytes that can be read from the pipe buffer
+ *   starting at d_rdndx without wrapping.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_rdseg(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_wrndx - dev->d_rdndx;
+    }
+  else
+    {
+      return dev->d_bufsize - dev->d_rdndx;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_wrseg
+ *
+ * Description:
+ *   Return the number of bytes that can be written into the pipe buffer
+ *   starting at d_wrndx without wrapping.  One byte is always left unused
+ *   so that a full buffer can be distinguished from an empty one.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_wrseg(FAR struct pipe_dev_s *dev)
+{
+  if (dev->d_wrndx >= dev->d_rdndx)
+    {
+      return dev->d_bufsize - dev->d_wrndx - (dev->d_rdndx == 0 ? 1 : 0);
+    }
+  else
+    {
+      return dev->d_rdndx - dev->d_wrndx - 1;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_rdadvance and pipecommon_wradvance
+ *
+ * Description:
+ *   Consume or commit 'n' bytes of a segment returned by
+ *   pipecommon_rdseg() or pipecommon_wrseg().
+ *
+ ****************************************************************************/
+
+static void pipecommon_rdadvance(FAR struct pipe_dev_s *dev, size_t n)
+{
+  dev->d_rdndx += n;
+  if (dev->d_rdndx >= dev->d_bufsize)
+    {
+      dev->d_rdndx = 0;
+    }
+}
+
+static void pipecommon_wradvance(FAR struct pipe_dev_s *dev, size_t n)
+{
+  dev->d_wrndx += n;
+  if (dev->d_wrndx >= dev->d_bufsize)
+    {
+      dev->d_wrndx = 0;
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_bufread
+ *
+ * Description:
+ *   Copy up to 'len' bytes out of the pipe buffer.  Returns the number of
+ *   bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_bufread(FAR struct pipe_dev_s *dev,
+                                 FAR uint8_t *buffer, size_t len)
+{
+  size_t nread = 0;
+  size_t n;
+
+  /* The data may wrap around the end of the buffer so this takes at most
+   * two copies.
+   */
+
+  while (nread < len && (n = pipecommon_rdseg(dev)) > 0)
+    {
+      if (n > len - nread)
+        {
+          n = len - nread;
+        }
+
+      memcpy(&buffer[nread], &dev->d_buffer[dev->d_rdndx], n);
+      pipecommon_rdadvance(dev, n);
+      nread += n;
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: pipecommon_bufwrite
+ *
+ * Description:
+ *   Copy up to 'len' bytes into the pipe buffer.  Returns the number of
+ *   bytes copied.
+ *
+ ****************************************************************************/
+
+static size_t pipecommon_bufwrite(FAR struct pipe_dev_s *dev,
+                                  FAR const uint8_t *buffer, size_t len)
+{
+  size_t nwritten = 0;
+  size_t n;
+
+  while (nwritten < len && (n = pipecommon_wrseg(dev)) > 0)
+    {
+      if (n > len - nwritten)
+        {
+          n = len - nwritten;
+        }
+
+      memcpy(&dev->d_buffer[dev->d_wrndx], &buffer[nwritten], n);
+      pipecommon_wradvance(dev, n);
+      nwritten += n;
+    }
+
+  return nwritten;
+}
+
+/****************************************************************************
+ * Name: pipecommon_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on the semaphore.
+ *
+ ****************************************************************************/
+
+static void pipecommon_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: pipecommon_splicewait
+ *
+ * Description:
+ *   splice() does not hold d_bfsem while it transfers data to or from the
+ *   pipe buffer, because the transfer may block.  Instead, it marks the
+ *   side of the pipe that it owns with PIPE_FLAG_SPLICEIN or
+ *   PIPE_FLAG_SPLICEOUT.  Wait until that side of the pipe is released.
+ *   The splice() wakes up 'sem' when it is done.
+ *
+ * Assumptions:
+ *   The caller holds d_bfsem.  It is still held on success and has been
+ *   released on failure.
+ *
+ ****************************************************************************/
+
+static int pipecommon_splicewait(FAR struct pipe_dev_s *dev, uint8_t flag,
+                                 FAR sem_t *sem, bool nonblock)
+{
+  int ret;
+
+  while ((dev->d_flags & flag) != 0)
+    {
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(sem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  return OK;
+}
+
 /****************************************************************************
  * Name: pipecommon_pollnotify
  ****************************************************************************/
@@ -431,9 +646,11 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
   FAR struct pipe_dev_s *dev    = inode->i_private;
 #ifdef CONFIG_DEV_PIPEDUMP
   FAR uint8_t           *start  = (FAR uint8_t *)buffer;
+#endif
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  bool                   direct = false;
 #endif
   ssize_t                nread  = 0;
-  int                    sval;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -451,6 +668,15 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       return ret;
     }
 
+  /* Wait while splice() is removing data from the pipe */
+
+  ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEOUT, &dev->d_rdsem,
+                              (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
   /* If the pipe is empty, then wait for something to be written to it */
 
   while (dev->d_wrndx == dev->d_rdndx)
@@ -471,6 +697,19 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
           return 0;
         }
 
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      /* Offer our buffer to the next writer so that it can copy its data
+       * directly into it.  Only one reader at a time may do this.
+       */
+
+      if (dev->d_rdbuf == NULL && dev->d_rddone == 0)
+        {
+          dev->d_rdbuf = (FAR uint8_t *)buffer;
+          dev->d_rdlen = len;
+          direct       = true;
+        }
+#endif
+
       /* Otherwise, wait for something to be written to the pipe */
 
       sched_lock();
@@ -478,32 +717,64 @@ ssize_t pipecommon_read(FAR struct file *filep, FAR char *buffer, size_t len)
       ret = nxsem_wait(&dev->d_rdsem);
       sched_unlock();
 
+#ifdef CONFIG_DEV_PIPE_DIRECT
+      if (direct)
+        {
+          /* Withdraw the offer.  A writer may have filled our buffer even
+           * if the wait was interrupted, so check that first.
+           */
+
+          pipecommon_semtake(&dev->d_bfsem);
+
+          nread         = dev->d_rddone;
+          dev->d_rdbuf  = NULL;
+          dev->d_rddone = 0;
+          direct        = false;
+
+          if (nread > 0)
+            {
+              nxsem_post(&dev->d_bfsem);
+              pipe_dumpbuffer("From PIPE:", start, nread);
+              return nread;
+            }
+
+          if (ret < 0)
+            {
+              nxsem_post(&dev->d_bfsem);
+              return ret;
+            }
+
+          ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEOUT,
+                                      &dev->d_rdsem, false);
+          if (ret < 0)
+            {
+              return ret;
+            }
+
+          continue;
+        }
+#endif
+
       if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
         {
           return ret;
         }
-    }
-
-  /* Then return whatever is available in the pipe (which is at least one byte) */
 
-  nread = 0;
-  while ((size_t)nread < len && dev->d_wrndx != dev->d_rdndx)
-    {
-      *buffer++ = dev->d_buffer[dev->d_rdndx];
-      if (++dev->d_rdndx >= dev->d_bufsize)
+      ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEOUT, &dev->d_rdsem,
+                                  false);
+      if (ret < 0)
         {
-          dev->d_rdndx = 0;
+          return ret;
         }
-
-      nread++;
     }
 
+  /* Then return whatever is available in the pipe (which is at least one byte) */
+
+  nread = pipecommon_bufread(dev, (FAR uint8_t *)buffer, len);
+
   /* Notify all waiting writers that bytes have been removed from the buffer */
 
-  while (nxsem_getvalue(&dev->d_wrsem, &sval) == 0 && sval < 0)
-    {
-      nxsem_post(&dev->d_wrsem);
-    }
+  pipecommon_wakeup(&dev->d_wrsem);
 
   /* Notify all poll/select waiters that they can write to the FIFO */
 
@@ -525,8 +796,6 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
   FAR struct pipe_dev_s *dev      = inode->i_private;
   ssize_t                nwritten = 0;
   ssize_t                last;
-  int                    nxtwrndx;
-  int                    sval;
   int                    ret;
 
   DEBUGASSERT(dev);
@@ -573,90 +842,111 @@ ssize_t pipecommon_write(FAR struct file *filep, FAR const char *buffer,
       return ret;
     }
 
-  /* Loop until all of the bytes have been written */
+  /* Wait while splice() is adding data to the pipe */
 
-  last = 0;
-  for (; ; )
+  ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEIN, &dev->d_wrsem,
+                              (filep->f_oflags & O_NONBLOCK) != 0);
+  if (ret < 0)
     {
-      /* Calculate the write index AFTER the next byte is written */
+      return ret;
+    }
+
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  /* If the pipe is empty and a reader has offered its buffer, then copy
+   * the data directly into the reader's buffer.  The pipe buffer must be
+   * empty so that the data is not reordered.
+   */
+
+  if (dev->d_rdbuf != NULL && dev->d_wrndx == dev->d_rdndx)
+    {
+      nwritten = len < dev->d_rdlen ? len : dev->d_rdlen;
+      memcpy(dev->d_rdbuf, buffer, nwritten);
+
+      dev->d_rdbuf   = NULL;
+      dev->d_rddone  = nwritten;
+
+      pipecommon_wakeup(&dev->d_rdsem);
 
-      nxtwrndx = dev->d_wrndx + 1;
-      if (nxtwrndx >= dev->d_bufsize)
+      if ((size_t)nwritten >= len)
         {
-          nxtwrndx = 0;
+          nxsem_post(&dev->d_bfsem);
+          return len;
         }
+    }
+#endif
 
-      /* Would the next write overflow the circular buffer? */
+  /* Loop until all of the bytes have been written */
 
-      if (nxtwrndx != dev->d_rdndx)
-        {
-          /* No... copy the byte */
+  last = nwritten;
+  for (; ; )
+    {
+      /* Copy as much as will fit into the circular buffer */
 
-          dev->d_buffer[dev->d_wrndx] = *buffer++;
-          dev->d_wrndx = nxtwrndx;
+      nwritten += pipecommon_bufwrite(dev,
+                                      (FAR const uint8_t *)&buffer[nwritten],
+                                      len - nwritten);
 
-          /* Is the write complete? */
+      /* Is the write complete? */
 
-          nwritten++;
-          if ((size_t)nwritten >= len)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+      if ((size_t)nwritten >= len)
+        {
+          /* Yes.. Notify all of the waiting readers that more data is available */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+          pipecommon_wakeup(&dev->d_rdsem);
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          /* Notify all poll/select waiters that they can read from the FIFO */
 
-              pipecommon_pollnotify(dev, POLLIN);
+          pipecommon_pollnotify(dev, POLLIN);
 
-              /* Return the number of bytes written */
+          /* Return the number of bytes written */
 
-              nxsem_post(&dev->d_bfsem);
-              return len;
-            }
+          nxsem_post(&dev->d_bfsem);
+          return len;
         }
-      else
-        {
-          /* There is not enough room for the next byte.  Was anything written in this pass? */
 
-          if (last < nwritten)
-            {
-              /* Yes.. Notify all of the waiting readers that more data is available */
+      /* There is not enough room for the rest.  Was anything written in this pass? */
 
-              while (nxsem_getvalue(&dev->d_rdsem, &sval) == 0 && sval < 0)
-                {
-                  nxsem_post(&dev->d_rdsem);
-                }
+      if (last < nwritten)
+        {
+          /* Yes.. Notify all of the waiting readers that more data is available */
 
-              /* Notify all poll/select waiters that they can read from the FIFO */
+          pipecommon_wakeup(&dev->d_rdsem);
 
-              pipecommon_pollnotify(dev, POLLIN);
-            }
+          /* Notify all poll/select waiters that they can read from the FIFO */
 
-          last = nwritten;
+          pipecommon_pollnotify(dev, POLLIN);
+        }
 
-          /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
+      last = nwritten;
 
-          if (filep->f_oflags & O_NONBLOCK)
-            {
-              if (nwritten == 0)
-                {
-                  nwritten = -EAGAIN;
-                }
+      /* If O_NONBLOCK was set, then return partial bytes written or EGAIN */
 
-              nxsem_post(&dev->d_bfsem);
-              return nwritten;
+      if (filep->f_oflags & O_NONBLOCK)
+        {
+          if (nwritten == 0)
+            {
+              nwritten = -EAGAIN;
             }
 
-          /* There is more to be written.. wait for data to be removed from the pipe */
-
-          sched_lock();
           nxsem_post(&dev->d_bfsem);
-          pipecommon_semtake(&dev->d_wrsem);
-          sched_unlock();
-          pipecommon_semtake(&dev->d_bfsem);
+          return nwritten;
+        }
+
+      /* There is more to be written.. wait for data to be removed from the pipe */
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+
+      /* A splice() may have started adding data while we waited */
+
+      ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEIN, &dev->d_wrsem,
+                                  false);
+      if (ret < 0)
+        {
+          return nwritten > 0 ? nwritten : ret;
         }
     }
 }
@@ -712,14 +1002,7 @@ int pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
        * First, determine how many bytes are in the buffer
        */
 
-      if (dev->d_wrndx >= dev->d_rdndx)
-        {
-          nbytes = dev->d_wrndx - dev->d_rdndx;
-        }
-      else
-        {
-          nbytes = dev->d_bufsize + dev->d_wrndx - dev->d_rdndx;
-        }
+      nbytes = pipecommon_nbytes(dev);
 
       /* Notify the POLLOUT event if the pipe is not full, but only if
        * there is readers.
@@ -836,17 +1119,71 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
            *   d_wrndx - Index to next location to add a byte to the buffer.
            */
 
-          if (dev->d_wrndx < dev->d_rdndx)
+          count = pipecommon_nbytes(dev);
+
+          *(FAR int *)((uintptr_t)arg) = count;
+          ret = 0;
+        }
+        break;
+
+      /* Change the capacity of the pipe.  The buffer holds one byte more
+       * than the capacity.
+       */
+
+      case PIPEIOC_SETSIZE:
+        {
+          size_t nbytes = pipecommon_nbytes(dev);
+          FAR uint8_t *newbuf;
+
+          if (arg < 1 || arg >= CONFIG_DEV_PIPE_MAXSIZE)
             {
-              count = (dev->d_bufsize - dev->d_rdndx) + dev->d_wrndx;
+              ret = -EINVAL;
+              break;
             }
-          else
+
+          /* The data already in the pipe must still fit, and the buffer
+           * cannot move while splice() is using it.
+           */
+
+          if (arg < nbytes ||
+              (dev->d_flags & (PIPE_FLAG_SPLICEIN | PIPE_FLAG_SPLICEOUT)) != 0)
             {
-              count = dev->d_wrndx - dev->d_rdndx;
+              ret = -EBUSY;
+              break;
             }
 
-          *(FAR int *)((uintptr_t)arg) = count;
-          ret = 0;
+          if (dev->d_buffer != NULL)
+            {
+              newbuf = (FAR uint8_t *)kmm_malloc(arg + 1);
+              if (newbuf == NULL)
+                {
+                  ret = -ENOMEM;
+                  break;
+                }
+
+              /* Move the buffered data to the beginning of the new buffer */
+
+              (void)pipecommon_bufread(dev, newbuf, nbytes);
+              kmm_free(dev->d_buffer);
+
+              dev->d_buffer = newbuf;
+              dev->d_rdndx  = 0;
+              dev->d_wrndx  = nbytes;
+            }
+
+          dev->d_bufsize = arg + 1;
+
+          /* There may be more space for waiting writers now */
+
+          pipecommon_wakeup(&dev->d_wrsem);
+          pipecommon_pollnotify(dev, POLLOUT);
+          ret = arg;
+        }
+        break;
+
+      case PIPEIOC_GETSIZE:
+        {
+          ret = dev->d_bufsize - 1;
         }
         break;
 
@@ -884,6 +1221,279 @@ int pipecommon_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return ret;
 }
 
+/****************************************************************************
+ * Name: pipecommon_splicein
+ *
+ * Description:
+ *   Fill the pipe with up to 'len' bytes obtained from 'xfer'.  The data is
+ *   read directly into the pipe buffer.  This implements splice() when the
+ *   pipe is the destination.
+ *
+ *   'xfer' may block, so d_bfsem is not held while it runs.  The write side
+ *   of the pipe is reserved with PIPE_FLAG_SPLICEIN instead:  Other writers
+ *   wait, while readers may still remove data because the free space that
+ *   is being filled is not visible to them until d_wrndx is advanced.
+ *
+ * Returned Value:
+ *   The number of bytes transferred into the pipe, zero if 'xfer' reports
+ *   end of file, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_splicein(FAR struct file *filep, pipe_splice_t xfer,
+                            FAR void *arg, size_t len, bool nonblock)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  FAR uint8_t           *seg;
+  ssize_t                ntotal = 0;
+  ssize_t                ret;
+  size_t                 n;
+
+  DEBUGASSERT(dev != NULL && xfer != NULL);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  if (dev->d_nreaders <= 0)
+    {
+      return -EPIPE;
+    }
+
+  nonblock |= (filep->f_oflags & O_NONBLOCK) != 0;
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until no other splice() owns the write side and there is space in
+   * the pipe buffer.
+   */
+
+  for (; ; )
+    {
+      ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEIN, &dev->d_wrsem,
+                                  nonblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (pipecommon_wrseg(dev) > 0)
+        {
+          break;
+        }
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      pipecommon_semtake(&dev->d_wrsem);
+      sched_unlock();
+      pipecommon_semtake(&dev->d_bfsem);
+    }
+
+  dev->d_flags |= PIPE_FLAG_SPLICEIN;
+
+  /* Transfer directly into the free part of the buffer.  This takes at
+   * most two transfers if the free space wraps around the end.
+   */
+
+  while ((size_t)ntotal < len && (n = pipecommon_wrseg(dev)) > 0)
+    {
+      if (n > len - ntotal)
+        {
+          n = len - ntotal;
+        }
+
+      seg = &dev->d_buffer[dev->d_wrndx];
+      nxsem_post(&dev->d_bfsem);
+
+      ret = xfer(arg, seg, n);
+
+      pipecommon_semtake(&dev->d_bfsem);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      /* Commit the data.  Make it visible to the readers at once so that
+       * they need not wait for the second transfer.
+       */
+
+      pipecommon_wradvance(dev, ret);
+      ntotal += ret;
+
+      pipecommon_wakeup(&dev->d_rdsem);
+      pipecommon_pollnotify(dev, POLLIN);
+
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
+
+  /* Release the write side and let the waiting writers in */
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICEIN;
+  pipecommon_wakeup(&dev->d_wrsem);
+
+  if (ntotal > 0)
+    {
+      ret = ntotal;
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: pipecommon_spliceout
+ *
+ * Description:
+ *   Pass up to 'len' bytes from the pipe to 'xfer'.  The data is passed
+ *   directly from the pipe buffer.  This implements splice() when the pipe
+ *   is the source.
+ *
+ *   'xfer' may block, so d_bfsem is not held while it runs.  The read side
+ *   of the pipe is reserved with PIPE_FLAG_SPLICEOUT instead:  Other
+ *   readers wait, while writers may still add data because the data that
+ *   is being passed on is not released to them until d_rdndx is advanced.
+ *
+ * Returned Value:
+ *   The number of bytes removed from the pipe, zero on end of file, or a
+ *   negated errno value on failure.
+ *
+ ****************************************************************************/
+
+ssize_t pipecommon_spliceout(FAR struct file *filep, pipe_splice_t xfer,
+                             FAR void *arg, size_t len, bool nonblock)
+{
+  FAR struct inode      *inode  = filep->f_inode;
+  FAR struct pipe_dev_s *dev    = inode->i_private;
+  FAR uint8_t           *seg;
+  ssize_t                ntotal = 0;
+  ssize_t                ret;
+  size_t                 n;
+
+  DEBUGASSERT(dev != NULL && xfer != NULL);
+
+  if (len == 0)
+    {
+      return 0;
+    }
+
+  nonblock |= (filep->f_oflags & O_NONBLOCK) != 0;
+
+  ret = nxsem_wait(&dev->d_bfsem);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  /* Wait until no other splice() owns the read side and there is data in
+   * the pipe buffer.
+   */
+
+  for (; ; )
+    {
+      ret = pipecommon_splicewait(dev, PIPE_FLAG_SPLICEOUT, &dev->d_rdsem,
+                                  nonblock);
+      if (ret < 0)
+        {
+          return ret;
+        }
+
+      if (dev->d_wrndx != dev->d_rdndx)
+        {
+          break;
+        }
+
+      /* If there are no writers on the pipe, then return end of file.  This
+       * takes precedence over EAGAIN.
+       */
+
+      if (dev->d_nwriters <= 0)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          nxsem_post(&dev->d_bfsem);
+          return -EAGAIN;
+        }
+
+      sched_lock();
+      nxsem_post(&dev->d_bfsem);
+      ret = nxsem_wait(&dev->d_rdsem);
+      sched_unlock();
+
+      if (ret < 0 || (ret = nxsem_wait(&dev->d_bfsem)) < 0)
+        {
+          return ret;
+        }
+    }
+
+  dev->d_flags |= PIPE_FLAG_SPLICEOUT;
+
+  /* Transfer directly from the pipe buffer */
+
+  while ((size_t)ntotal < len && (n = pipecommon_rdseg(dev)) > 0)
+    {
+      if (n > len - ntotal)
+        {
+          n = len - ntotal;
+        }
+
+      seg = &dev->d_buffer[dev->d_rdndx];
+      nxsem_post(&dev->d_bfsem);
+
+      ret = xfer(arg, seg, n);
+
+      pipecommon_semtake(&dev->d_bfsem);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      /* Release the space.  Let the writers use it at once. */
+
+      pipecommon_rdadvance(dev, ret);
+      ntotal += ret;
+
+      pipecommon_wakeup(&dev->d_wrsem);
+      pipecommon_pollnotify(dev, POLLOUT);
+
+      if ((size_t)ret < n)
+        {
+          break;
+        }
+    }
+
+  /* Release the read side and let the waiting readers in */
+
+  dev->d_flags &= ~PIPE_FLAG_SPLICEOUT;
+  pipecommon_wakeup(&dev->d_rdsem);
+
+  if (ntotal > 0)
+    {
+      ret = ntotal;
+    }
+
+  nxsem_post(&dev->d_bfsem);
+  return ret;
+}
+
 /****************************************************************************
  * Name: pipecommon_unlink
  ****************************************************************************/
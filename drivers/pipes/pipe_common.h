@@ -90,6 +90,14 @@
 #  define CONFIG_DEV_PIPE_NPOLLWAITERS 2
 #endif
 
+/* Direct writer-to-reader transfers require that the reader's buffer be
+ * addressable from the writer's context.
+ */
+
+#ifdef CONFIG_ARCH_ADDRENV
+#  undef CONFIG_DEV_PIPE_DIRECT
+#endif
+
 /* Maximum number of open's supported on pipe */
 
 #define CONFIG_DEV_PIPE_MAXUSER 255
@@ -98,6 +106,8 @@
 
 #define PIPE_FLAG_POLICY    (1 << 0) /* Bit 0: Policy=Free buffer when empty */
 #define PIPE_FLAG_UNLINKED  (1 << 1) /* Bit 1: The driver has been unlinked */
+#define PIPE_FLAG_SPLICEIN  (1 << 2) /* Bit 2: splice() owns the write side */
+#define PIPE_FLAG_SPLICEOUT (1 << 3) /* Bit 3: splice() owns the read side */
 
 #define PIPE_POLICY_0(f)    do { (f) &= ~PIPE_FLAG_POLICY; } while (0)
 #define PIPE_POLICY_1(f)    do { (f) |= PIPE_FLAG_POLICY; } while (0)
@@ -122,6 +132,14 @@ typedef uint16_t pipe_ndx_t;  /* 16-bit index */
 typedef uint8_t pipe_ndx_t;   /*  8-bit index */
 #endif
 
+/* Used by splice() to move data between the pipe buffer and another file or
+ * socket.  Transfers up to 'len' bytes to or from 'buffer' and returns the
+ * number of bytes transferred or a negated errno value.
+ */
+
+typedef ssize_t (*pipe_splice_t)(FAR void *arg, FAR uint8_t *buffer,
+                                 size_t len);
+
 /* This structure represents the state of one pipe.  A reference to this
  * structure is retained in the i_private field of the inode whenthe pipe/fifo
  * device is registered.
@@ -141,6 +159,11 @@ struct pipe_dev_s
   uint8_t    d_pipeno;      /* Pipe minor number */
   uint8_t    d_flags;       /* See PIPE_FLAG_* definitions */
   uint8_t   *d_buffer;      /* Buffer allocated when device opened */
+#ifdef CONFIG_DEV_PIPE_DIRECT
+  FAR uint8_t *d_rdbuf;     /* Buffer of a reader waiting on an empty pipe */
+  size_t     d_rdlen;       /* Size of d_rdbuf in bytes */
+  size_t     d_rddone;      /* Bytes copied directly into d_rdbuf by a writer */
+#endif
 
   /* The following is a list if poll structures of threads waiting for
    * driver events. The 'struct pollfd' reference for each open is also
@@ -181,6 +204,10 @@ int     pipecommon_poll(FAR struct file *filep, FAR struct pollfd *fds,
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
 int     pipecommon_unlink(FAR struct inode *priv);
 #endif
+ssize_t pipecommon_splicein(FAR struct file *filep, pipe_splice_t xfer,
+                            FAR void *arg, size_t len, bool nonblock);
+ssize_t pipecommon_spliceout(FAR struct file *filep, pipe_splice_t xfer,
+                             FAR void *arg, size_t len, bool nonblock);
 
 #undef EXTERN
 #ifdef __cplusplus
@@ -0,0 +1,354 @@
+/****************************************************************************
+ * drivers/pipes/pipe_splice.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <assert.h>
+
+#include <nuttx/cancelpt.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
+
+#include "pipe_common.h"
+
+#ifdef CONFIG_PIPES
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One end of a splice() transfer:  Either a file or a socket */
+
+struct splice_end_s
+{
+  FAR struct file *filep;   /* The file structure (NULL for a socket) */
+  FAR void        *arg;     /* Argument for the read and write methods */
+  pipe_splice_t    read;    /* Read from this end into a buffer */
+  pipe_splice_t    write;   /* Write a buffer to this end */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice_fileread and splice_filewrite
+ ****************************************************************************/
+
+static ssize_t splice_fileread(FAR void *arg, FAR uint8_t *buffer,
+                               size_t len)
+{
+  return file_read((FAR struct file *)arg, buffer, len);
+}
+
+static ssize_t splice_filewrite(FAR void *arg, FAR uint8_t *buffer,
+                                size_t len)
+{
+  return file_write((FAR struct file *)arg, buffer, len);
+}
+
+/****************************************************************************
+ * Name: splice_sockread and splice_sockwrite
+ ****************************************************************************/
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+static ssize_t splice_sockread(FAR void *arg, FAR uint8_t *buffer,
+                               size_t len)
+{
+  return psock_recvfrom((FAR struct socket *)arg, buffer, len, 0,
+                        NULL, NULL);
+}
+
+static ssize_t splice_sockwrite(FAR void *arg, FAR uint8_t *buffer,
+                                size_t len)
+{
+  return psock_send((FAR struct socket *)arg, buffer, len, 0);
+}
+#endif
+
+/****************************************************************************
+ * Name: splice_getend
+ *
+ * Description:
+ *   Set up one end of a splice() transfer from a file or socket descriptor.
+ *
+ ****************************************************************************/
+
+static int splice_getend(int fd, FAR struct splice_end_s *end)
+{
+  int ret;
+
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      FAR struct socket *psock = sockfd_socket(fd);
+
+      if (psock == NULL)
+        {
+          return -EBADF;
+        }
+
+      end->filep = NULL;
+      end->arg   = psock;
+      end->read  = splice_sockread;
+      end->write = splice_sockwrite;
+      return OK;
+    }
+#endif
+
+  ret = fs_getfilep(fd, &end->filep);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  end->arg   = end->filep;
+  end->read  = splice_fileread;
+  end->write = splice_filewrite;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: splice_ispipe
+ *
+ * Description:
+ *   Return true if the file refers to a pipe or FIFO.
+ *
+ ****************************************************************************/
+
+static bool splice_ispipe(FAR struct file *filep)
+{
+  FAR struct inode *inode;
+
+  if (filep == NULL)
+    {
+      return false;
+    }
+
+  inode = filep->f_inode;
+  return inode != NULL && INODE_IS_DRIVER(inode) &&
+         inode->u.i_ops->read == pipecommon_read;
+}
+
+/****************************************************************************
+ * Name: splice_xfer
+ *
+ * Description:
+ *   Perform the transfer between the pipe and the other end, positioning
+ *   the other end at '*offset' first if requested.
+ *
+ ****************************************************************************/
+
+static ssize_t splice_xfer(FAR struct file *pipefilep,
+                           FAR struct splice_end_s *other,
+                           FAR off_t *offset, size_t len, bool nonblock,
+                           bool topipe)
+{
+  off_t savepos = 0;
+  ssize_t ret;
+
+  /* Sockets and FIFOs have no file position */
+
+  if (offset != NULL)
+    {
+      if (other->filep == NULL)
+        {
+          return -ESPIPE;
+        }
+
+      savepos = file_seek(other->filep, 0, SEEK_CUR);
+      if (savepos < 0)
+        {
+          return savepos;
+        }
+
+      ret = file_seek(other->filep, *offset, SEEK_SET);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  if (topipe)
+    {
+      ret = pipecommon_splicein(pipefilep, other->read, other->arg, len,
+                                nonblock);
+    }
+  else
+    {
+      ret = pipecommon_spliceout(pipefilep, other->write, other->arg, len,
+                                 nonblock);
+    }
+
+  /* Like pread() and pwrite(), leave the file position unchanged if an
+   * offset was provided.
+   */
+
+  if (offset != NULL)
+    {
+      if (ret > 0)
+        {
+          *offset += ret;
+        }
+
+      (void)file_seek(other->filep, savepos, SEEK_SET);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: splice
+ *
+ * Description:
+ *   splice() moves data between a pipe (or FIFO) and a file or socket
+ *   descriptor without copying it through a user buffer.  Data leaving the
+ *   pipe is written to the destination directly from the pipe buffer; data
+ *   entering the pipe is read directly into the pipe buffer.
+ *
+ *   NOTE: This interface is not specified by POSIX.  The implementation
+ *   follows the Linux interface.  The SPLICE_F_MOVE, SPLICE_F_MORE and
+ *   SPLICE_F_GIFT flags are accepted but ignored.
+ *
+ * Input Parameters:
+ *   fd_in   - The descriptor to read from
+ *   off_in  - If fd_in is not the pipe and off_in is not NULL, the offset
+ *             in fd_in to read from.  It is updated on return and the file
+ *             position of fd_in is not changed.
+ *   fd_out  - The descriptor to write to
+ *   off_out - The same as off_in, but for fd_out
+ *   len     - The maximum number of bytes to transfer
+ *   flags   - SPLICE_F_* flags.  SPLICE_F_NONBLOCK makes the pipe
+ *             operations non-blocking.
+ *
+ * Returned Value:
+ *   The number of bytes transferred, zero on end of input, or -1 (ERROR)
+ *   with the errno value set:
+ *
+ *   EINVAL - Neither descriptor refers to a pipe or both refer to the same
+ *            pipe
+ *   ESPIPE - An offset was provided for a pipe or socket
+ *   EAGAIN - SPLICE_F_NONBLOCK was specified and the pipe was not ready
+ *
+ *   Or any error reported by read() or write() on the other descriptor.
+ *
+ ****************************************************************************/
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags)
+{
+  struct splice_end_s in;
+  struct splice_end_s out;
+  bool nonblock = (flags & SPLICE_F_NONBLOCK) != 0;
+  ssize_t ret;
+
+  /* splice() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  ret = splice_getend(fd_in, &in);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = splice_getend(fd_out, &out);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  if (splice_ispipe(in.filep))
+    {
+      /* Pipe to file, socket or another pipe */
+
+      if (off_in != NULL)
+        {
+          ret = -ESPIPE;
+        }
+      else if (out.filep != NULL &&
+               out.filep->f_inode == in.filep->f_inode)
+        {
+          ret = -EINVAL;
+        }
+      else
+        {
+          ret = splice_xfer(in.filep, &out, off_out, len, nonblock, false);
+        }
+    }
+  else if (splice_ispipe(out.filep))
+    {
+      /* File or socket to pipe */
+
+      if (off_out != NULL)
+        {
+          ret = -ESPIPE;
+        }
+      else
+        {
+          ret = splice_xfer(out.filep, &in, off_in, len, nonblock, true);
+        }
+    }
+  else
+    {
+      ret = -EINVAL;
+    }
+
+errout:
+  leave_cancellation_point();
+
+  if (ret < 0)
+    {
+      set_errno((int)-ret);
+      return ERROR;
+    }
+
+  return ret;
+}
+
+#endif /* CONFIG_PIPES */
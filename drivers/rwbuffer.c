@@ -163,9 +163,9 @@ static inline void rwb_resetwrbuffer(struct rwbuffer_s *rwb)
  ****************************************************************************/
 
 #ifdef CONFIG_DRVR_WRITEBUFFER
-static void rwb_wrflush(struct rwbuffer_s *rwb)
+static int rwb_wrflush(struct rwbuffer_s *rwb)
 {
-  int ret;
+  int ret = OK;
 
   finfo("Timeout!\n");
 
@@ -183,11 +183,17 @@ static void rwb_wrflush(struct rwbuffer_s *rwb)
       if (ret != rwb->wrnblocks)
         {
           ferr("ERROR: Error flushing write buffer: %d\n", ret);
+          ret = ret < 0 ? ret : -EIO;
+        }
+      else
+        {
+          ret = OK;
         }
 
       rwb_resetwrbuffer(rwb);
     }
 
+  return ret;
 }
 #endif
 
@@ -960,6 +966,31 @@ ssize_t rwb_readbytes(FAR struct rwbuffer_s *dev, off_t offset,
 }
 #endif
 
+/****************************************************************************
+ * Name: rwb_flush
+ *
+ * Description:
+ *   Write any buffered data to the device now.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb)
+{
+  int ret = OK;
+
+  if (rwb->wrmaxblocks > 0)
+    {
+      rwb_semtake(&rwb->wrsem);
+      rwb_wrcanceltimeout(rwb);
+      ret = rwb_wrflush(rwb);
+      rwb_semgive(&rwb->wrsem);
+    }
+
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: rwb_mediaremoved
  *
@@ -78,6 +78,37 @@
 #  error AIO needs file and/or socket descriptors
 #endif
 
+#if !defined(CONFIG_FS_AIO_POOL) && !defined(CONFIG_SCHED_LPWORK)
+#  error AIO needs CONFIG_FS_AIO_POOL or the low priority work queue
+#endif
+
+#ifdef CONFIG_FS_AIO_POOL
+#  ifndef CONFIG_FS_AIO_NWORKERS
+#    define CONFIG_FS_AIO_NWORKERS 2
+#  endif
+#  ifndef CONFIG_FS_AIO_PRIORITY
+#    define CONFIG_FS_AIO_PRIORITY 100
+#  endif
+#  ifndef CONFIG_FS_AIO_STACKSIZE
+#    define CONFIG_FS_AIO_STACKSIZE 2048
+#  endif
+#  ifndef CONFIG_FS_AIO_MAXMERGE
+#    define CONFIG_FS_AIO_MAXMERGE 4
+#  endif
+#endif
+
+/* The workers restore the priority of the low priority work queue after
+ * each I/O.  Pool threads manage their own priority.
+ */
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+#  ifdef CONFIG_FS_AIO_POOL
+#    define aio_restorepriority(p) UNUSED(p)
+#  else
+#    define aio_restorepriority(p) lpwork_restorepriority(p)
+#  endif
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -101,8 +132,15 @@ struct aio_container_s
 #endif
     FAR void *ptr;                 /* Generic pointer to FAR data */
   } u;
+#ifdef CONFIG_FS_AIO_POOL
+  dq_entry_t aioc_qlink;           /* Link in the pool's queue of I/O */
+  worker_t aioc_worker;            /* Performs the I/O on a pool thread */
+  FAR void *aioc_key;              /* I/O with the same key is serialized */
+#else
   struct work_s aioc_work;         /* Used to defer I/O to the work thread */
+#endif
   pid_t aioc_pid;                  /* ID of the waiting task */
+  uint8_t aioc_opcode;             /* LIO_READ, LIO_WRITE, or LIO_NOP */
 #ifdef CONFIG_PRIORITY_INHERITANCE
   uint8_t aioc_prio;               /* Priority of the waiting task */
 #endif
@@ -244,7 +282,8 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
  * Name: aio_queue
  *
  * Description:
- *   Schedule the asynchronous I/O on the low priority work queue
+ *   Schedule the asynchronous I/O on the low priority work queue or, with
+ *   CONFIG_FS_AIO_POOL, on the AIO worker pool
  *
  * Input Parameters:
  *   arg - Worker argument.  In this case, a pointer to an instance of
@@ -258,6 +297,24 @@ FAR struct aiocb *aioc_decant(FAR struct aio_container_s *aioc);
 
 int aio_queue(FAR struct aio_container_s *aioc, worker_t worker);
 
+/****************************************************************************
+ * Name: aio_unqueue
+ *
+ * Description:
+ *   Remove asynchronous I/O that was queued by aio_queue() but has not yet
+ *   been started.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container of the I/O to be removed
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed.  -ENOENT if the I/O has already been
+ *   started (or has completed).
+ *
+ ****************************************************************************/
+
+int aio_unqueue(FAR struct aio_container_s *aioc);
+
 /****************************************************************************
  * Name: aio_signal
  *
@@ -133,11 +133,11 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
+               * be canceled.  aio_unqueue() will return -ENOENT in the
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_unqueue(aioc);
               if (status >= 0)
                 {
                   aiocbp->aio_result = -ECANCELED;
@@ -177,11 +177,11 @@ int aio_cancel(int fildes, FAR struct aiocb *aiocbp)
                * possibilities:* (1) the work has already been started and
                * is no longer queued, or (2) the work has not been started
                * and is still in the work queue.  Only the second case can
-               * be canceled.  work_cancel() will return -ENOENT in the
+               * be canceled.  aio_unqueue() will return -ENOENT in the
                * first case.
                */
 
-              status = work_cancel(LPWORK, &aioc->aioc_work);
+              status = aio_unqueue(aioc);
 
               /* Remove the container from the list of pending transfers */
 
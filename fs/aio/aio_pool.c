@@ -0,0 +1,576 @@
+/****************************************************************************
+ * fs/aio/aio_pool.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <sched.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <aio.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/nuttx.h>
+#include <nuttx/sched.h>
+#include <nuttx/kthread.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+
+#include "aio/aio.h"
+
+#ifdef CONFIG_FS_AIO_POOL
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* I/O that has been queued but not yet started, in submission order.  This
+ * list and the other pool state are protected by aio_lock().
+ */
+
+static dq_queue_t g_aio_poolq;
+
+/* Posted when queued I/O may have become runnable */
+
+static sem_t g_aio_poolsem = SEM_INITIALIZER(0);
+
+/* The key of the I/O being performed by each worker thread (or NULL) */
+
+static FAR void *g_aio_busy[CONFIG_FS_AIO_NWORKERS];
+
+/* The number of worker threads created and started */
+
+static uint8_t g_aio_ncreated;
+static uint8_t g_aio_nstarted;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_pool_key
+ *
+ * Description:
+ *   Return the key used to serialize the I/O in 'aioc'.  This is the inode
+ *   of a file or device so that all I/O to the same file or device is
+ *   performed in order, or the socket structure.
+ *
+ ****************************************************************************/
+
+static FAR void *aio_pool_key(FAR struct aio_container_s *aioc)
+{
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  if (aioc->aioc_aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS)
+#endif
+#ifdef AIO_HAVE_FILEP
+    {
+      return aioc->u.aioc_filep->f_inode;
+    }
+#endif
+#if defined(AIO_HAVE_FILEP) && defined(AIO_HAVE_PSOCK)
+  else
+#endif
+#ifdef AIO_HAVE_PSOCK
+    {
+      return aioc->u.aioc_psock;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: aio_pool_isbusy
+ *
+ * Description:
+ *   Return true if a worker is currently performing I/O with this key.
+ *
+ * Assumptions:
+ *   The caller holds aio_lock().
+ *
+ ****************************************************************************/
+
+static bool aio_pool_isbusy(FAR void *key)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_FS_AIO_NWORKERS; i++)
+    {
+      if (g_aio_busy[i] == key)
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: aio_pool_canmerge
+ *
+ * Description:
+ *   Return true if 'next' may be performed as the continuation of the
+ *   transfer described by 'aioc' extended to 'offset' and 'buffer'.  Only
+ *   reads and non-appending writes of the same open file that are
+ *   contiguous both in the file and in memory are merged.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_MAXMERGE > 1 && defined(AIO_HAVE_FILEP)
+static bool aio_pool_canmerge(FAR struct aio_container_s *aioc,
+                              FAR struct aio_container_s *next,
+                              off_t offset, uintptr_t buffer)
+{
+  FAR struct aiocb *aiocbp = next->aioc_aiocbp;
+
+  return next->aioc_opcode == aioc->aioc_opcode &&
+         next->u.ptr == aioc->u.ptr &&
+         aiocbp->aio_offset == offset &&
+         (uintptr_t)aiocbp->aio_buf == buffer;
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_pool_take
+ *
+ * Description:
+ *   Remove the first queued I/O whose key is not busy from the queue,
+ *   together with any queued I/O that can be merged with it.
+ *
+ * Input Parameters:
+ *   me    - The index of the calling worker thread
+ *   batch - The location to return the removed AIO containers
+ *
+ * Returned Value:
+ *   The number of AIO containers returned in 'batch'.  Zero if there is no
+ *   runnable I/O.
+ *
+ * Assumptions:
+ *   The caller holds aio_lock().
+ *
+ ****************************************************************************/
+
+static int aio_pool_take(int me, FAR struct aio_container_s **batch)
+{
+  FAR struct aio_container_s *aioc;
+  FAR dq_entry_t *entry;
+  int nbatch;
+  int i;
+
+  for (entry = dq_peek(&g_aio_poolq); entry != NULL; entry = dq_next(entry))
+    {
+      aioc = container_of(entry, struct aio_container_s, aioc_qlink);
+      if (!aio_pool_isbusy(aioc->aioc_key))
+        {
+          break;
+        }
+    }
+
+  if (entry == NULL)
+    {
+      return 0;
+    }
+
+  g_aio_busy[me] = aioc->aioc_key;
+  batch[0] = aioc;
+  nbatch   = 1;
+
+#if CONFIG_FS_AIO_MAXMERGE > 1 && defined(AIO_HAVE_FILEP)
+  /* Look for following I/O on the same key that continues this transfer.
+   * I/O on the same key must be performed in order, so stop at the first
+   * one that cannot be merged.
+   */
+
+  if ((aioc->aioc_opcode == LIO_READ ||
+       (aioc->aioc_opcode == LIO_WRITE &&
+        (aioc->u.aioc_filep->f_oflags & O_APPEND) == 0))
+#ifdef AIO_HAVE_PSOCK
+      && aioc->aioc_aiocbp->aio_fildes < CONFIG_NFILE_DESCRIPTORS
+#endif
+     )
+    {
+      FAR struct aio_container_s *next;
+      FAR dq_entry_t *nentry;
+      off_t offset;
+      uintptr_t buffer;
+
+      offset = aioc->aioc_aiocbp->aio_offset + aioc->aioc_aiocbp->aio_nbytes;
+      buffer = (uintptr_t)aioc->aioc_aiocbp->aio_buf +
+               aioc->aioc_aiocbp->aio_nbytes;
+
+      for (nentry = dq_next(entry);
+           nentry != NULL && nbatch < CONFIG_FS_AIO_MAXMERGE;
+           nentry = dq_next(nentry))
+        {
+          next = container_of(nentry, struct aio_container_s, aioc_qlink);
+          if (next->aioc_key != aioc->aioc_key)
+            {
+              continue;
+            }
+
+          if (!aio_pool_canmerge(aioc, next, offset, buffer))
+            {
+              break;
+            }
+
+          offset += next->aioc_aiocbp->aio_nbytes;
+          buffer += next->aioc_aiocbp->aio_nbytes;
+          batch[nbatch++] = next;
+        }
+    }
+#endif
+
+  /* Now remove the batch from the queue */
+
+  for (i = 0; i < nbatch; i++)
+    {
+      dq_rem(&batch[i]->aioc_qlink, &g_aio_poolq);
+    }
+
+  return nbatch;
+}
+
+/****************************************************************************
+ * Name: aio_pool_merged
+ *
+ * Description:
+ *   Perform a batch of merged reads or writes as a single transfer, then
+ *   distribute the result among the requests in order and signal each
+ *   client.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FS_AIO_MAXMERGE > 1 && defined(AIO_HAVE_FILEP)
+static void aio_pool_merged(FAR struct aio_container_s **batch, int nbatch)
+{
+  FAR struct aiocb *aiocbp[CONFIG_FS_AIO_MAXMERGE];
+  pid_t pid[CONFIG_FS_AIO_MAXMERGE];
+  FAR struct file *filep;
+  uint8_t opcode;
+  size_t nbytes;
+  ssize_t ret;
+  int i;
+
+  /* Decant all of the AIO control blocks before starting the I/O */
+
+  filep  = batch[0]->u.aioc_filep;
+  opcode = batch[0]->aioc_opcode;
+  nbytes = 0;
+
+  for (i = 0; i < nbatch; i++)
+    {
+      pid[i]    = batch[i]->aioc_pid;
+      aiocbp[i] = aioc_decant(batch[i]);
+      nbytes   += aiocbp[i]->aio_nbytes;
+    }
+
+  if (opcode == LIO_READ)
+    {
+      ret = file_pread(filep, (FAR void *)aiocbp[0]->aio_buf, nbytes,
+                       aiocbp[0]->aio_offset);
+    }
+  else
+    {
+      ret = file_pwrite(filep, (FAR const void *)aiocbp[0]->aio_buf, nbytes,
+                        aiocbp[0]->aio_offset);
+    }
+
+  if (ret < 0)
+    {
+      ferr("ERROR: merged transfer failed: %d\n", (int)ret);
+    }
+
+  /* A short transfer completes the leading requests in full, the request
+   * containing the end of the transfer partially, and the rest with zero
+   * bytes, just as if they had been performed one at a time.
+   */
+
+  for (i = 0; i < nbatch; i++)
+    {
+      if (ret < 0)
+        {
+          aiocbp[i]->aio_result = ret;
+        }
+      else
+        {
+          nbytes = aiocbp[i]->aio_nbytes;
+          if ((size_t)ret < nbytes)
+            {
+              nbytes = ret;
+            }
+
+          aiocbp[i]->aio_result = nbytes;
+          ret -= nbytes;
+        }
+
+      (void)aio_signal(pid[i], aiocbp[i]);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_pool_setprio
+ *
+ * Description:
+ *   Set the priority of the calling worker thread.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+static void aio_pool_setprio(int prio)
+{
+  struct sched_param param;
+
+  param.sched_priority = prio;
+  (void)nxsched_setparam(0, &param);
+}
+#endif
+
+/****************************************************************************
+ * Name: aio_pool_worker
+ *
+ * Description:
+ *   The body of each AIO worker thread.
+ *
+ ****************************************************************************/
+
+static int aio_pool_worker(int argc, FAR char *argv[])
+{
+  FAR struct aio_container_s *batch[CONFIG_FS_AIO_MAXMERGE];
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  uint8_t prio;
+#endif
+  int nbatch;
+  int me;
+
+  aio_lock();
+  me = g_aio_nstarted++;
+  aio_unlock();
+
+  DEBUGASSERT(me < CONFIG_FS_AIO_NWORKERS);
+
+  for (; ; )
+    {
+      /* Wait until there is I/O that may be runnable */
+
+      (void)nxsem_wait(&g_aio_poolsem);
+
+      aio_lock();
+      nbatch = aio_pool_take(me, batch);
+      aio_unlock();
+
+      if (nbatch == 0)
+        {
+          /* All of the queued I/O is for targets that are already being
+           * serviced by other workers.  They will wake us when they are
+           * done.
+           */
+
+          continue;
+        }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      /* Run at the priority of the waiting thread if that is higher */
+
+      prio = batch[0]->aioc_prio;
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          aio_pool_setprio(prio);
+        }
+#endif
+
+      /* Perform the I/O.  The worker frees the container. */
+
+#if CONFIG_FS_AIO_MAXMERGE > 1 && defined(AIO_HAVE_FILEP)
+      if (nbatch > 1)
+        {
+          aio_pool_merged(batch, nbatch);
+        }
+      else
+#endif
+        {
+          batch[0]->aioc_worker(batch[0]);
+        }
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+      if (prio > CONFIG_FS_AIO_PRIORITY)
+        {
+          aio_pool_setprio(CONFIG_FS_AIO_PRIORITY);
+        }
+#endif
+
+      /* Release the key.  Any I/O that was held back because of it may now
+       * be run.
+       */
+
+      aio_lock();
+      g_aio_busy[me] = NULL;
+      if (!dq_empty(&g_aio_poolq))
+        {
+          nxsem_post(&g_aio_poolsem);
+        }
+
+      aio_unlock();
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_pool_start
+ *
+ * Description:
+ *   Start the worker threads if they have not already been started.
+ *
+ * Returned Value:
+ *   Zero (OK) if at least one worker thread is running.  Otherwise, a
+ *   negated errno value.
+ *
+ * Assumptions:
+ *   The caller holds aio_lock().
+ *
+ ****************************************************************************/
+
+static int aio_pool_start(void)
+{
+  int pid;
+
+  while (g_aio_ncreated < CONFIG_FS_AIO_NWORKERS)
+    {
+      pid = kthread_create("aio", CONFIG_FS_AIO_PRIORITY,
+                           CONFIG_FS_AIO_STACKSIZE,
+                           (main_t)aio_pool_worker, NULL);
+      if (pid < 0)
+        {
+          ferr("ERROR: Failed to start AIO worker: %d\n", pid);
+          return g_aio_ncreated > 0 ? OK : pid;
+        }
+
+      g_aio_ncreated++;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: aio_queue
+ *
+ * Description:
+ *   Schedule the asynchronous I/O on the AIO worker pool
+ *
+ * Input Parameters:
+ *   aioc   - The AIO container of the I/O
+ *   worker - The function that performs the I/O
+ *
+ * Returned Value:
+ *   Zero (OK) on success.  Otherwise, -1 is returned and the errno is set
+ *   appropriately.
+ *
+ ****************************************************************************/
+
+int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
+{
+  FAR struct aiocb *aiocbp;
+  int ret;
+
+  aio_lock();
+  ret = aio_pool_start();
+  if (ret < 0)
+    {
+      aio_unlock();
+
+      aiocbp = aioc_decant(aioc);
+      aiocbp->aio_result = ret;
+      set_errno(-ret);
+      return ERROR;
+    }
+
+  aioc->aioc_worker = worker;
+  aioc->aioc_key    = aio_pool_key(aioc);
+  dq_addlast(&aioc->aioc_qlink, &g_aio_poolq);
+  aio_unlock();
+
+  nxsem_post(&g_aio_poolsem);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: aio_unqueue
+ *
+ * Description:
+ *   Remove asynchronous I/O that was queued by aio_queue() but has not yet
+ *   been started.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container of the I/O to be removed
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed.  -ENOENT if the I/O has already been
+ *   started (or has completed).
+ *
+ ****************************************************************************/
+
+int aio_unqueue(FAR struct aio_container_s *aioc)
+{
+  FAR dq_entry_t *entry;
+  int ret = -ENOENT;
+
+  aio_lock();
+  for (entry = dq_peek(&g_aio_poolq); entry != NULL; entry = dq_next(entry))
+    {
+      if (entry == &aioc->aioc_qlink)
+        {
+          dq_rem(entry, &g_aio_poolq);
+          ret = OK;
+          break;
+        }
+    }
+
+  aio_unlock();
+  return ret;
+}
+
+#endif /* CONFIG_FS_AIO_POOL */
@@ -107,4 +107,25 @@ int aio_queue(FAR struct aio_container_s *aioc, worker_t worker)
   return ret;
 }
 
+/****************************************************************************
+ * Name: aio_unqueue
+ *
+ * Description:
+ *   Remove asynchronous I/O that was queued by aio_queue() but has not yet
+ *   been started.
+ *
+ * Input Parameters:
+ *   aioc - The AIO container of the I/O to be removed
+ *
+ * Returned Value:
+ *   Zero (OK) if the I/O was removed.  -ENOENT if the I/O has already been
+ *   started (or has completed).
+ *
+ ****************************************************************************/
+
+int aio_unqueue(FAR struct aio_container_s *aioc)
+{
+  return work_cancel(LPWORK, &aioc->aioc_work);
+}
+
 #endif /* CONFIG_FS_AIO */
@@ -146,7 +146,7 @@ static void aio_read_worker(FAR void *arg)
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
-  lpwork_restorepriority(prio);
+  aio_restorepriority(prio);
 #endif
 }
 
@@ -277,6 +277,7 @@ int aio_read(FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
+  aioc->aioc_opcode = LIO_READ;
   ret = aio_queue(aioc, aio_read_worker);
   if (ret < 0)
     {
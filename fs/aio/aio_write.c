@@ -194,7 +194,7 @@ errout:
 #ifdef CONFIG_PRIORITY_INHERITANCE
   /* Restore the low priority worker thread default priority */
 
-  lpwork_restorepriority(prio);
+  aio_restorepriority(prio);
 #endif
 }
 
@@ -327,6 +327,7 @@ int aio_write(FAR struct aiocb *aiocbp)
 
   /* Defer the work to the worker thread */
 
+  aioc->aioc_opcode = LIO_WRITE;
   ret = aio_queue(aioc, aio_write_worker);
   if (ret < 0)
     {
@@ -120,7 +120,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;      /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;       /* Not used */
+  uint16_t cn_pad;       /* Size of the directory index ('.' nodes only) */
   uint32_t cn_name;      /* Offset from the beginning of the volume header to the
                           * node name string.  NUL-terminated. */
   uint32_t cn_size;      /* Size of the uncompressed data (in bytes) */
@@ -133,4 +133,14 @@ struct cromfs_node_s
   } u;
 };
 
+/* The '.' node at the head of each directory may be followed by an index
+ * of the directory:  If cn_pad is non-zero, then the name of the '.' node
+ * is followed, at the next 4-byte aligned offset, by cn_pad 32-bit offsets
+ * of the nodes in the directory sorted by name (strcmp() order).  This
+ * permits a binary search of the directory.  The peer links are still
+ * present and still provide the readdir() order.
+ */
+
+#define CROMFS_INDEX_ALIGN(o)  (((o) + 3) & ~3)
+
 #endif /* __FS_CROMFS_CROMFS_H */
@@ -53,6 +53,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/dirent.h>
 #include <nuttx/fs/ioctl.h>
@@ -62,6 +63,14 @@
 
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_CROMFS)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_CROMFS_CACHE_NBLOCKS
+#  define CONFIG_CROMFS_CACHE_NBLOCKS 0
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -71,10 +80,28 @@
 struct cromfs_file_s
 {
   FAR const struct cromfs_node_s *ff_node;  /* The open file node */
+  FAR uint32_t *ff_blocks;                  /* Offset of each block (may be NULL) */
+  uint32_t ff_nblocks;                      /* Number of entries in ff_blocks */
+#if CONFIG_CROMFS_CACHE_NBLOCKS == 0
   uint32_t ff_offset;                       /* Cached block offset (zero means none) */
   uint16_t ff_ulen;                         /* Length of decompressed data in cache */
   FAR uint8_t *ff_buffer;                   /* Cached, decompressed data */
+#endif
+};
+
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+/* This structure describes one decompressed block in the block cache that
+ * is shared by all open files.
+ */
+
+struct cromfs_cache_s
+{
+  uint32_t cc_offset;                       /* Block offset (zero means none) */
+  uint32_t cc_stamp;                        /* Time of last use */
+  uint16_t cc_ulen;                         /* Length of decompressed data */
+  FAR uint8_t *cc_buffer;                   /* Decompressed data */
 };
+#endif
 
 /* This is the form of the callback from cromfs_foreach_node(): */
 
@@ -112,9 +139,21 @@ static uint16_t cromfs_seglen(FAR const char *relpath);
 static int      cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
                                    FAR const struct cromfs_node_s *node,
                                    FAR void *arg);
+static int      cromfs_searchdir(FAR const struct cromfs_volume_s *fs,
+                                 FAR const struct cromfs_node_s *node,
+                                 FAR struct cromfs_comparenode_s *cpnode);
 static int      cromfs_findnode(FAR const struct cromfs_volume_s *fs,
                                 FAR const struct cromfs_node_s **node,
                                 FAR const char *relpath);
+static uint32_t cromfs_blockinfo(FAR const struct lzf_header_s *hdr,
+                                 FAR uint16_t *ulen, FAR uint16_t *clen);
+static void     cromfs_blocktable(FAR const struct cromfs_volume_s *fs,
+                                  FAR struct cromfs_file_s *ff);
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+static FAR struct cromfs_cache_s *
+                cromfs_cache_get(FAR const struct cromfs_volume_s *fs,
+                                 FAR const uint8_t *src, uint16_t clen);
+#endif
 
 /* Common file system methods */
 
@@ -194,6 +233,27 @@ const struct mountpt_operations cromfs_operations =
 
 extern const struct cromfs_volume_s g_cromfs_image;
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+/* The cache of decompressed blocks that is shared by all open files.  The
+ * least recently used block is replaced on a miss.
+ */
+
+static struct cromfs_cache_s g_cromfs_cache[CONFIG_CROMFS_CACHE_NBLOCKS];
+static sem_t g_cromfs_cachesem = SEM_INITIALIZER(1);
+static uint32_t g_cromfs_stamp;
+
+/* The number of mounts of the image.  All mounts share the cache, so it is
+ * discarded only when the last one goes away.  Protected by
+ * g_cromfs_cachesem.
+ */
+
+static unsigned int g_cromfs_nmounts;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -376,7 +436,7 @@ static int cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
        * we need to interpret the as matching as long as it is a directory?
        */
 
-      if (segment[namlen] == '/' && segment[namlen = 1] == '\0')
+      if (segment[namlen] == '/' && segment[namlen + 1] == '\0')
         {
           *cpnode->node = node;
           return S_ISDIR(node->cn_mode) ? 1 : -ENOENT;
@@ -414,7 +474,7 @@ static int cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
 
       /* Then recurse */
 
-      return cromfs_foreach_node(fs, child, cromfs_comparenode, cpnode);
+      return cromfs_searchdir(fs, child, cpnode);
     }
   else
     {
@@ -422,6 +482,75 @@ static int cromfs_comparenode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_searchdir
+ *
+ * Description:
+ *   Search the directory whose first node is 'node' for the next path
+ *   segment.  If the directory has a sorted index, then it is binary
+ *   searched; otherwise, all of the entries are compared in turn.
+ *
+ ****************************************************************************/
+
+static int cromfs_searchdir(FAR const struct cromfs_volume_s *fs,
+                            FAR const struct cromfs_node_s *node,
+                            FAR struct cromfs_comparenode_s *cpnode)
+{
+  FAR const struct cromfs_node_s *entry;
+  FAR const uint32_t *index;
+  FAR const char *name;
+  int lower;
+  int upper;
+  int mid;
+  int cmp;
+
+  if (node == NULL || node->cn_pad == 0)
+    {
+      return cromfs_foreach_node(fs, node, cromfs_comparenode, cpnode);
+    }
+
+  /* The index follows the name of the '.' node */
+
+  name  = (FAR const char *)cromfs_offset2addr(fs, node->cn_name);
+  index = (FAR const uint32_t *)
+          cromfs_offset2addr(fs, CROMFS_INDEX_ALIGN(node->cn_name +
+                                                    strlen(name) + 1));
+
+  lower = 0;
+  upper = node->cn_pad - 1;
+
+  while (lower <= upper)
+    {
+      mid   = (lower + upper) >> 1;
+      entry = (FAR const struct cromfs_node_s *)
+              cromfs_offset2addr(fs, index[mid]);
+      name  = (FAR const char *)cromfs_offset2addr(fs, entry->cn_name);
+
+      /* Compare the name with the path segment (which is not terminated) */
+
+      cmp = strncmp(name, cpnode->segment, cpnode->seglen);
+      if (cmp == 0 && name[cpnode->seglen] != '\0')
+        {
+          cmp = 1;
+        }
+
+      if (cmp == 0)
+        {
+          return cromfs_comparenode(fs, entry, cpnode);
+        }
+      else if (cmp < 0)
+        {
+          lower = mid + 1;
+        }
+      else
+        {
+          upper = mid - 1;
+        }
+    }
+
+  return 0;
+}
+
 /****************************************************************************
  * Name: cromfs_findnode
  ****************************************************************************/
@@ -463,7 +592,7 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
   cpnode.segment = relpath;
   cpnode.seglen  = (uint16_t)cromfs_seglen(relpath);
 
-  ret = cromfs_foreach_node(fs, root, cromfs_comparenode, &cpnode);
+  ret = cromfs_searchdir(fs, root, &cpnode);
   if (ret > 0)
     {
       return OK;
@@ -478,6 +607,165 @@ static int cromfs_findnode(FAR const struct cromfs_volume_s *fs,
     }
 }
 
+/****************************************************************************
+ * Name: cromfs_blockinfo
+ *
+ * Description:
+ *   Return the uncompressed and compressed lengths of the block with
+ *   header 'hdr' and the total size of the block including the header.
+ *
+ ****************************************************************************/
+
+static uint32_t cromfs_blockinfo(FAR const struct lzf_header_s *hdr,
+                                 FAR uint16_t *ulen, FAR uint16_t *clen)
+{
+  if (hdr->lzf_type == LZF_TYPE0_HDR)
+    {
+      FAR const struct lzf_type0_header_s *hdr0 =
+        (FAR const struct lzf_type0_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr0->lzf_len[0] << 8 |
+              (uint16_t)hdr0->lzf_len[1];
+      *clen = *ulen;
+      return (uint32_t)*ulen + LZF_TYPE0_HDR_SIZE;
+    }
+  else
+    {
+      FAR const struct lzf_type1_header_s *hdr1 =
+        (FAR const struct lzf_type1_header_s *)hdr;
+
+      *ulen = (uint16_t)hdr1->lzf_ulen[0] << 8 |
+              (uint16_t)hdr1->lzf_ulen[1];
+      *clen = (uint16_t)hdr1->lzf_clen[0] << 8 |
+              (uint16_t)hdr1->lzf_clen[1];
+      return (uint32_t)*clen + LZF_TYPE1_HDR_SIZE;
+    }
+}
+
+/****************************************************************************
+ * Name: cromfs_blocktable
+ *
+ * Description:
+ *   Build the table of block offsets that lets cromfs_read() go directly
+ *   to the block containing any file position.  This is only possible if
+ *   every block but the last holds exactly cv_bsize bytes of file data (as
+ *   generated by tools/gencromfs).  Otherwise, or if memory is not
+ *   available, no table is built and cromfs_read() walks the blocks.
+ *
+ ****************************************************************************/
+
+static void cromfs_blocktable(FAR const struct cromfs_volume_s *fs,
+                              FAR struct cromfs_file_s *ff)
+{
+  FAR const struct lzf_header_s *hdr;
+  uint32_t nblocks;
+  uint32_t offset;
+  uint32_t i;
+  uint16_t ulen;
+  uint16_t clen;
+
+  nblocks = (ff->ff_node->cn_size + fs->cv_bsize - 1) / fs->cv_bsize;
+  if (nblocks < 2)
+    {
+      return;
+    }
+
+  ff->ff_blocks = (FAR uint32_t *)kmm_malloc(nblocks * sizeof(uint32_t));
+  if (ff->ff_blocks == NULL)
+    {
+      return;
+    }
+
+  offset = ff->ff_node->u.cn_blocks;
+  for (i = 0; i < nblocks; i++)
+    {
+      hdr = (FAR const struct lzf_header_s *)cromfs_offset2addr(fs, offset);
+      ff->ff_blocks[i] = offset;
+      offset += cromfs_blockinfo(hdr, &ulen, &clen);
+
+      if (i < nblocks - 1 && ulen != fs->cv_bsize)
+        {
+          kmm_free(ff->ff_blocks);
+          ff->ff_blocks = NULL;
+          return;
+        }
+    }
+
+  ff->ff_nblocks = nblocks;
+}
+
+/****************************************************************************
+ * Name: cromfs_cache_get
+ *
+ * Description:
+ *   Return the cache entry holding the decompressed data of the block whose
+ *   compressed data is at 'src', decompressing it into the least recently
+ *   used entry if necessary.  On success, the cache is locked and must be
+ *   released with nxsem_post(&g_cromfs_cachesem).
+ *
+ ****************************************************************************/
+
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+static FAR struct cromfs_cache_s *
+cromfs_cache_get(FAR const struct cromfs_volume_s *fs,
+                 FAR const uint8_t *src, uint16_t clen)
+{
+  FAR struct cromfs_cache_s *cache;
+  FAR struct cromfs_cache_s *victim;
+  uint32_t voloffs;
+  int ret;
+  int i;
+
+  do
+    {
+      ret = nxsem_wait(&g_cromfs_cachesem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  voloffs = cromfs_addr2offset(fs, src);
+  victim  = &g_cromfs_cache[0];
+
+  for (i = 0; i < CONFIG_CROMFS_CACHE_NBLOCKS; i++)
+    {
+      cache = &g_cromfs_cache[i];
+      if (cache->cc_offset == voloffs)
+        {
+          cache->cc_stamp = ++g_cromfs_stamp;
+          return cache;
+        }
+
+      if (cache->cc_offset == 0 ||
+          (victim->cc_offset != 0 &&
+           (int32_t)(cache->cc_stamp - victim->cc_stamp) < 0))
+        {
+          victim = cache;
+        }
+    }
+
+  /* Cache miss.  Replace the least recently used block. */
+
+  if (victim->cc_buffer == NULL)
+    {
+      victim->cc_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
+      if (victim->cc_buffer == NULL)
+        {
+          nxsem_post(&g_cromfs_cachesem);
+          return NULL;
+        }
+    }
+
+  victim->cc_ulen   = lzf_decompress(src, clen, victim->cc_buffer,
+                                     fs->cv_bsize);
+  victim->cc_offset = voloffs;
+  victim->cc_stamp  = ++g_cromfs_stamp;
+
+  finfo("Cache miss: voloffs=%lu ulen=%u\n",
+        (unsigned long)voloffs, victim->cc_ulen);
+  return victim;
+}
+#endif
+
 /****************************************************************************
  * Name: cromfs_open
  ****************************************************************************/
@@ -546,6 +834,7 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       return -ENOMEM;
     }
 
+#if CONFIG_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   ff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -554,11 +843,16 @@ static int cromfs_open(FAR struct file *filep, FAR const char *relpath,
       kmm_free(ff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
   ff->ff_node = node;
 
+  /* Build the block table for fast seeks */
+
+  cromfs_blocktable(fs, ff);
+
   /* Save the index as the open-specific state in filep->f_priv */
 
   filep->f_priv = (FAR void *)ff;
@@ -579,11 +873,18 @@ static int cromfs_close(FAR struct file *filep)
   /* Get the open file instance from the file structure */
 
   ff = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Free all resources consumed by the opened file */
 
+#if CONFIG_CROMFS_CACHE_NBLOCKS == 0
   kmm_free(ff->ff_buffer);
+#endif
+  if (ff->ff_blocks != NULL)
+    {
+      kmm_free(ff->ff_blocks);
+    }
+
   kmm_free(ff);
 
   return OK;
@@ -606,6 +907,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   off_t fpos;
   size_t remaining;
   uint32_t blkoffs;
+  uint32_t blkndx;
   uint16_t ulen;
   uint16_t clen;
   unsigned int copysize;
@@ -625,7 +927,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   /* Get the open file instance from the file structure */
 
   ff = (FAR struct cromfs_file_s *)filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   /* Check for a read past the end of the file */
 
@@ -656,6 +958,18 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   nexthdr   = (FAR struct lzf_header_s *)
                cromfs_offset2addr(fs, ff->ff_node->u.cn_blocks);
 
+  /* If there is a block table, then go directly to the block containing
+   * fpos.
+   */
+
+  blkndx = fpos / fs->cv_bsize;
+  if (ff->ff_blocks != NULL && blkndx < ff->ff_nblocks)
+    {
+      nexthdr = (FAR struct lzf_header_s *)
+                 cromfs_offset2addr(fs, ff->ff_blocks[blkndx]);
+      blkoffs = blkndx * fs->cv_bsize;
+    }
+
   /* Look until we find the compressed block containing the start of the
    * requested data.
    */
@@ -663,43 +977,20 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
   while (remaining > 0)
     {
       /* Search for the next block containing the fpos file offset.  This is
-       * real search on the first time through but the remaining blocks should
-       * be contiguous so that the logic should not loop.
-       *
+       * real search on the first time through (unless there is a block
+       * table) but the remaining blocks should be contiguous so that the
+       * logic should not loop.
        */
 
       do
         {
-          uint32_t blksize;
-
           /* Go to the next block */
 
           currhdr  = nexthdr;
           blkoffs += ulen;
-
-          if (currhdr->lzf_type == LZF_TYPE0_HDR)
-            {
-              FAR struct lzf_type0_header_s *hdr0 =
-                (FAR struct lzf_type0_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr0->lzf_len[0] << 8 |
-                        (uint16_t)hdr0->lzf_len[1];
-              blksize = (uint32_t)ulen + LZF_TYPE0_HDR_SIZE;
-            }
-          else
-            {
-              FAR struct lzf_type1_header_s * hdr1 =
-                (FAR struct lzf_type1_header_s *)currhdr;
-
-              ulen    = (uint16_t)hdr1->lzf_ulen[0] << 8 |
-                        (uint16_t)hdr1->lzf_ulen[1];
-              clen    = (uint16_t)hdr1->lzf_clen[0] << 8 |
-                        (uint16_t)hdr1->lzf_clen[1];
-              blksize = (uint32_t)clen + LZF_TYPE1_HDR_SIZE;
-            }
-
           nexthdr  = (FAR struct lzf_header_s *)
-                     ((FAR uint8_t *)currhdr + blksize);
+                     ((FAR uint8_t *)currhdr +
+                      cromfs_blockinfo(currhdr, &ulen, &clen));
         }
       while (fpos >= (blkoffs + ulen));
 
@@ -728,39 +1019,56 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
         }
       else
         {
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+          FAR struct cromfs_cache_s *cache;
+
+          /* Get the decompressed block from the shared cache */
+
+          copyoffs = (blkoffs >= filep->f_pos) ? 0 : filep->f_pos - blkoffs;
+          DEBUGASSERT(ulen > copyoffs);
+          copysize = ulen - copyoffs;
+
+          if (copysize > remaining)  /* Clip to the size really needed */
+            {
+              copysize = remaining;
+            }
+
+          src   = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+          cache = cromfs_cache_get(fs, src, clen);
+          if (cache == NULL)
+            {
+              if (remaining == buflen)
+                {
+                  return -ENOMEM;
+                }
+
+              break;
+            }
+
+          DEBUGASSERT(cache->cc_ulen >= (copyoffs + copysize));
+          memcpy(dest, &cache->cc_buffer[copyoffs], copysize);
+          nxsem_post(&g_cromfs_cachesem);
+#else
           /* If the source of the data is at the beginning of the compressed
            * data buffer and if the uncompressed data would not overrun the
            * buffer, then we can decompress directly into the user buffer.
+           * The file buffer is not involved so its content remains valid.
            */
 
           if (filep->f_pos <= blkoffs && ulen <= remaining)
             {
-              uint32_t voloffs;
+              unsigned int decomplen;
 
               copyoffs = 0;
               copysize = ulen;
 
-              /* Get the address and offset in the CROMFS image to obtain
-               * the data.  Check if we already have this offset in the
-               * cache.
-               */
-
-              src     = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
-              voloffs = cromfs_addr2offset(fs, src);
-              if (voloffs != ff->ff_offset)
-                {
-                  unsigned int decomplen;
-
-                  decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
+              src       = (FAR const uint8_t *)currhdr + LZF_TYPE1_HDR_SIZE;
+              decomplen = lzf_decompress(src, clen, dest, fs->cv_bsize);
 
-                  ff->ff_offset = voloffs;
-                  ff->ff_ulen   = decomplen;
-                }
-
-              finfo("voloffs=%lu blkoffs=%lu ulen=%u ff_offset=%u copysize=%u\n",
-                    (unsigned long)voloffs, (unsigned long)blkoffs, ulen,
-                    ff->ff_offset, copysize);
-              DEBUGASSERT(ff->ff_ulen >= copysize);
+              finfo("blkoffs=%lu ulen=%u decomplen=%u copysize=%u\n",
+                    (unsigned long)blkoffs, ulen, decomplen, copysize);
+              DEBUGASSERT(decomplen >= copysize);
+              UNUSED(decomplen);
             }
           else
             {
@@ -804,6 +1112,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
               memcpy(dest, &ff->ff_buffer[copyoffs], copysize);
             }
+#endif
         }
 
       /* Adjust pointers counts and offset */
@@ -815,6 +1124,7 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
   /* Update the file pointer */
 
+  buflen      -= remaining;
   filep->f_pos = fpos;
   return buflen;
 }
@@ -825,9 +1135,22 @@ static ssize_t cromfs_read(FAR struct file *filep, FAR char *buffer,
 
 static int cromfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
+  FAR struct cromfs_volume_s *fs;
+  FAR struct cromfs_file_s *ff;
+  FAR uintptr_t *pid = (FAR uintptr_t *)arg;
+
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
-  /* No IOCTL commands yet supported */
+  if (cmd == FIOC_FILEID && pid != NULL)
+    {
+      /* The offset to the file node identifies the file on the volume */
+
+      ff   = filep->f_priv;
+      fs   = filep->f_inode->i_private;
+      *pid = (uintptr_t)cromfs_addr2offset(fs, ff->ff_node);
+      return OK;
+    }
 
   return -ENOTTY;
 }
@@ -858,7 +1181,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
   /* Get the open file instance from the file structure */
 
   oldff = oldp->f_priv;
-  DEBUGASSERT(oldff->ff_node != NULL && oldff->ff_buffer != NULL);
+  DEBUGASSERT(oldff->ff_node != NULL);
 
   /* Allocate and initialize an new open file instance referring to the
    * same node.
@@ -870,6 +1193,7 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       return -ENOMEM;
     }
 
+#if CONFIG_CROMFS_CACHE_NBLOCKS == 0
   /* Create a file buffer to support partial sector accesses */
 
   newff->ff_buffer = (FAR uint8_t *)kmm_malloc(fs->cv_bsize);
@@ -878,11 +1202,16 @@ static int cromfs_dup(FAR const struct file *oldp, FAR struct file *newp)
       kmm_free(newff);
       return -ENOMEM;
     }
+#endif
 
   /* Save the node in the open file instance */
 
   newff->ff_node = oldff->ff_node;
 
+  /* Build the block table for fast seeks */
+
+  cromfs_blocktable(fs, newff);
+
   /* Copy the index from the old to the new file structure */
 
   newp->f_priv = newff;
@@ -908,14 +1237,14 @@ static int cromfs_fstat(FAR const struct file *filep, FAR struct stat *buf)
 
   /* Sanity checks */
 
-  DEBUGASSERT(filep->f_priv == NULL && filep->f_inode != NULL);
+  DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
 
   /* Get the mountpoint inode reference from the file structure and the
    * volume private data from the inode structure
    */
 
   ff              = filep->f_priv;
-  DEBUGASSERT(ff->ff_node != NULL && ff->ff_buffer != NULL);
+  DEBUGASSERT(ff->ff_node != NULL);
 
   inode           = filep->f_inode;
   fs              = inode->i_private;
@@ -1097,11 +1426,27 @@ static int cromfs_rewinddir(struct inode *mountpt, struct fs_dirent_s *dir)
 static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
                       void **handle)
 {
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+  int ret;
+#endif
+
   finfo("blkdriver: %p data: %p handle: %p\n", blkdriver, data, handle);
 
   DEBUGASSERT(blkdriver == NULL && handle != NULL);
   DEBUGASSERT(g_cromfs_image.cv_magic == CROMFS_MAGIC);
 
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+  do
+    {
+      ret = nxsem_wait(&g_cromfs_cachesem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  g_cromfs_nmounts++;
+  nxsem_post(&g_cromfs_cachesem);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)&g_cromfs_image;
@@ -1119,8 +1464,44 @@ static int cromfs_bind(FAR struct inode *blkdriver, const void *data,
 static int cromfs_unbind(FAR void *handle, FAR struct inode **blkdriver,
                         unsigned int flags)
 {
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+  int ret;
+  int i;
+#endif
+
   finfo("handle: %p blkdriver: %p flags: %02x\n",
         handle, blkdriver, flags);
+
+#if CONFIG_CROMFS_CACHE_NBLOCKS > 0
+  /* Discard the block cache when the last mount of the image goes away.
+   * Other mounts may be reading from it.
+   */
+
+  do
+    {
+      ret = nxsem_wait(&g_cromfs_cachesem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+
+  DEBUGASSERT(g_cromfs_nmounts > 0);
+  if (--g_cromfs_nmounts == 0)
+    {
+      for (i = 0; i < CONFIG_CROMFS_CACHE_NBLOCKS; i++)
+        {
+          if (g_cromfs_cache[i].cc_buffer != NULL)
+            {
+              kmm_free(g_cromfs_cache[i].cc_buffer);
+              g_cromfs_cache[i].cc_buffer = NULL;
+            }
+
+          g_cromfs_cache[i].cc_offset = 0;
+        }
+    }
+
+  nxsem_post(&g_cromfs_cachesem);
+#endif
+
   return OK;
 }
 
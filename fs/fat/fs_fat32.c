@@ -63,6 +63,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/fs/fat.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/fs/dirent.h>
 
 #include "inode/inode.h"
@@ -119,6 +120,20 @@ static int     fat_stat_root(FAR struct fat_mountpt_s *fs,
 static int     fat_stat(struct inode *mountpt, const char *relpath,
                  FAR struct stat *buf);
 
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int32_t fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff, unsigned int nsectors,
+                 bool extend, FAR uint32_t *pcluster);
+#endif
+#if CONFIG_FAT_NEXTENTS > 0
+static uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t fileclus,
+                 FAR uint32_t *diskclus);
+static void    fat_extentadd(FAR struct fat_file_s *ff, uint32_t fileclus,
+                 uint32_t diskclus);
+static void    fat_extentreset(FAR struct fat_mountpt_s *fs,
+                 FAR struct fat_file_s *ff);
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -162,6 +177,215 @@ const struct mountpt_operations fat_operations =
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: fat_contigsectors
+ *
+ * Description:
+ *   Determine how many physically contiguous sectors, beginning with the
+ *   current sector of the file, are available for one multi-sector
+ *   transfer of up to 'nsectors'.  The cluster chain is followed as long as
+ *   each next cluster immediately follows the previous one on the media.
+ *   If 'extend' is true, the chain is extended as needed (for writes).
+ *
+ * Returned Value:
+ *   On success, the number of contiguous sectors from the current sector
+ *   through the end of the cluster returned in 'pcluster'.  This may be
+ *   less than 'nsectors' or may exceed it by less than one cluster.  A
+ *   negated errno value is returned on failure.
+ *
+ ****************************************************************************/
+
+#ifndef CONFIG_FAT_FORCE_INDIRECT
+static int32_t fat_contigsectors(FAR struct fat_mountpt_s *fs,
+                                 FAR struct fat_file_s *ff,
+                                 unsigned int nsectors, bool extend,
+                                 FAR uint32_t *pcluster)
+{
+  uint32_t cluster = ff->ff_currentcluster;
+  int32_t ncontig  = ff->ff_sectorsincluster;
+  int32_t next;
+
+  while (ncontig < nsectors)
+    {
+      if (extend)
+        {
+          next = fat_extendchain(fs, cluster);
+        }
+      else
+        {
+          next = fat_getcluster(fs, cluster);
+        }
+
+      if (next < 0)
+        {
+          return next;
+        }
+
+      /* Stop at the end of the chain or at the first discontinuity.  If
+       * the chain was extended with a non-contiguous cluster, it will be
+       * picked up normally on the next pass through the transfer loop.
+       */
+
+      if (next != cluster + 1)
+        {
+          break;
+        }
+
+      cluster  = next;
+      ncontig += fs->fs_fatsecperclus;
+    }
+
+  *pcluster = cluster;
+  return ncontig;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extentfind
+ *
+ * Description:
+ *   Search the cached extents of an open file for the cluster at index
+ *   'fileclus' in the file's cluster chain.  If that cluster is not cached,
+ *   then return the nearest cached cluster that precedes it.
+ *
+ * Returned Value:
+ *   The index of the cluster that was found.  The corresponding cluster
+ *   number is returned in 'diskclus', which is set to zero if no preceding
+ *   cluster is cached.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+static uint32_t fat_extentfind(FAR struct fat_file_s *ff, uint32_t fileclus,
+                               FAR uint32_t *diskclus)
+{
+  FAR struct fat_extent_s *fe;
+  uint32_t bestclus = 0;
+  uint32_t lastclus;
+  int i;
+
+  *diskclus = 0;
+  for (i = 0; i < CONFIG_FAT_NEXTENTS; i++)
+    {
+      fe = &ff->ff_extents[i];
+      if (fe->fe_nclusters == 0 || fe->fe_fileclus > fileclus)
+        {
+          continue;
+        }
+
+      /* Does this extent include the cluster that we are looking for? */
+
+      lastclus = fe->fe_fileclus + fe->fe_nclusters - 1;
+      if (lastclus >= fileclus)
+        {
+          *diskclus = fe->fe_diskclus + (fileclus - fe->fe_fileclus);
+          return fileclus;
+        }
+
+      /* No.. remember the closest preceding cluster */
+
+      if (*diskclus == 0 || lastclus > bestclus)
+        {
+          bestclus  = lastclus;
+          *diskclus = fe->fe_diskclus + fe->fe_nclusters - 1;
+        }
+    }
+
+  return bestclus;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extentadd
+ *
+ * Description:
+ *   Record that cluster index 'fileclus' of an open file maps to cluster
+ *   number 'diskclus' on the media.  The cluster is appended to an existing
+ *   extent if it is physically contiguous with it; otherwise, a new extent
+ *   replaces the oldest one.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+static void fat_extentadd(FAR struct fat_file_s *ff, uint32_t fileclus,
+                          uint32_t diskclus)
+{
+  FAR struct fat_extent_s *fe;
+  int i;
+
+  for (i = 0; i < CONFIG_FAT_NEXTENTS; i++)
+    {
+      fe = &ff->ff_extents[i];
+      if (fe->fe_nclusters == 0 || fe->fe_fileclus > fileclus)
+        {
+          continue;
+        }
+
+      /* Already cached? */
+
+      if (fileclus < fe->fe_fileclus + fe->fe_nclusters)
+        {
+          return;
+        }
+
+      /* Does it extend this extent? */
+
+      if (fileclus == fe->fe_fileclus + fe->fe_nclusters &&
+          diskclus == fe->fe_diskclus + fe->fe_nclusters)
+        {
+          fe->fe_nclusters++;
+          return;
+        }
+    }
+
+  /* Start a new extent */
+
+  fe               = &ff->ff_extents[ff->ff_extnext];
+  fe->fe_fileclus  = fileclus;
+  fe->fe_diskclus  = diskclus;
+  fe->fe_nclusters = 1;
+
+  if (++ff->ff_extnext >= CONFIG_FAT_NEXTENTS)
+    {
+      ff->ff_extnext = 0;
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_extentreset
+ *
+ * Description:
+ *   Forget the cached extents of every open file that refers to the same
+ *   directory entry as 'ff'.  This is necessary when clusters are released
+ *   from the cluster chain of the file.  Only the start cluster of each
+ *   file is cached again.
+ *
+ ****************************************************************************/
+
+#if CONFIG_FAT_NEXTENTS > 0
+static void fat_extentreset(FAR struct fat_mountpt_s *fs,
+                            FAR struct fat_file_s *ff)
+{
+  FAR struct fat_file_s *tmp;
+
+  for (tmp = fs->fs_head; tmp != NULL; tmp = tmp->ff_next)
+    {
+      if (tmp->ff_dirsector == ff->ff_dirsector &&
+          tmp->ff_dirindex == ff->ff_dirindex)
+        {
+          memset(tmp->ff_extents, 0, sizeof(tmp->ff_extents));
+          tmp->ff_extnext = 0;
+
+          if (tmp->ff_startcluster != 0)
+            {
+              fat_extentadd(tmp, 0, tmp->ff_startcluster);
+            }
+        }
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: fat_open
  ****************************************************************************/
@@ -356,6 +580,15 @@ static int fat_open(FAR struct file *filep, FAR const char *relpath,
   ff->ff_sectorsincluster = fs->fs_fatsecperclus;
   ff->ff_size             = DIR_GETFILESIZE(direntry);
 
+#if CONFIG_FAT_NEXTENTS > 0
+  /* The start cluster is the first cached extent of the chain */
+
+  if (ff->ff_startcluster != 0)
+    {
+      fat_extentadd(ff, 0, ff->ff_startcluster);
+    }
+#endif
+
   /* Attach the private date to the struct file instance */
 
   filep->f_priv = ff;
@@ -493,6 +726,8 @@ static ssize_t fat_read(FAR struct file *filep, FAR char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  int32_t ncontig;
+  uint32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -612,13 +847,21 @@ fat_read_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we read on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the physically contiguous sectors
+           * in this and the following clusters.
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ncontig = fat_contigsectors(fs, ff, nsectors, false,
+                                      &lastcluster);
+          if (ncontig < 0)
             {
-              nsectors = ff->ff_sectorsincluster;
+              ret = ncontig;
+              goto errout_with_semaphore;
+            }
+
+          if (nsectors > ncontig)
+            {
+              nsectors = ncontig;
             }
 
           /* We are not sure of the state of the file buffer so
@@ -652,7 +895,8 @@ fat_read_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = ncontig - nsectors;
           ff->ff_currentsector    += nsectors;
           bytesread                = nsectors * fs->fs_hwsectorsize;
         }
@@ -727,6 +971,8 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
 
 #ifndef CONFIG_FAT_FORCE_INDIRECT
   unsigned int nsectors;
+  int32_t ncontig;
+  uint32_t lastcluster;
   bool force_indirect = false;
 #endif
 
@@ -800,6 +1046,13 @@ static ssize_t fat_write(FAR struct file *filep, FAR const char *buffer,
           ff->ff_startcluster     = fat_createchain(fs);
           ff->ff_currentcluster   = ff->ff_startcluster;
           ff->ff_sectorsincluster = fs->fs_fatsecperclus;
+
+#if CONFIG_FAT_NEXTENTS > 0
+          if (ff->ff_startcluster > 0)
+            {
+              fat_extentadd(ff, 0, ff->ff_startcluster);
+            }
+#endif
         }
 
       /* The current sector can then be determined from the current cluster
@@ -871,13 +1124,22 @@ fat_write_restart:
            * buffer without using our tiny read buffer.
            *
            * Limit the number of sectors that we write on this time
-           * through the loop to the remaining contiguous sectors
-           * in this cluster
+           * through the loop to the physically contiguous sectors
+           * in this and the following clusters (extending the chain
+           * as needed).
            */
 
-          if (nsectors > ff->ff_sectorsincluster)
+          ncontig = fat_contigsectors(fs, ff, nsectors, true,
+                                      &lastcluster);
+          if (ncontig < 0)
+            {
+              ret = ncontig;
+              goto errout_with_semaphore;
+            }
+
+          if (nsectors > ncontig)
             {
-              nsectors = ff->ff_sectorsincluster;
+              nsectors = ncontig;
             }
 
           /* We are not sure of the state of the sector cache so the
@@ -912,7 +1174,8 @@ fat_write_restart:
               goto errout_with_semaphore;
             }
 
-          ff->ff_sectorsincluster -= nsectors;
+          ff->ff_currentcluster    = lastcluster;
+          ff->ff_sectorsincluster  = ncontig - nsectors;
           ff->ff_currentsector    += nsectors;
           writesize                = nsectors * fs->fs_hwsectorsize;
           ff->ff_bflags           |= FFBUFF_MODIFIED;
@@ -1007,6 +1270,19 @@ fat_write_restart:
       ff->ff_size = filep->f_pos;
     }
 
+  /* If the file was opened with O_DIRECT, then do not leave a partial
+   * sector of the write lingering in the file buffer.
+   */
+
+  if ((ff->ff_oflags & O_DIRECT) != 0)
+    {
+      ret = fat_ffcacheflush(fs, ff);
+      if (ret < 0)
+        {
+          goto errout_with_semaphore;
+        }
+    }
+
   fat_semgive(fs);
   return byteswritten;
 
@@ -1027,6 +1303,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
   int32_t cluster;
   off_t position;
   unsigned int clustersize;
+#if CONFIG_FAT_NEXTENTS > 0
+  uint32_t fileclus;
+  uint32_t diskclus;
+#endif
   int ret;
 
   /* Sanity checks */
@@ -1141,6 +1421,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
         }
 
       ff->ff_startcluster = cluster;
+
+#if CONFIG_FAT_NEXTENTS > 0
+      fat_extentadd(ff, 0, cluster);
+#endif
     }
 
   /* Move file position if necessary */
@@ -1152,6 +1436,21 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
        */
 
       clustersize = fs->fs_fatsecperclus * fs->fs_hwsectorsize;
+
+#if CONFIG_FAT_NEXTENTS > 0
+      /* Rather than following the chain from the beginning, start with the
+       * nearest cluster cached from previous walks of the chain.
+       */
+
+      fileclus = fat_extentfind(ff, position / clustersize, &diskclus);
+      if (diskclus != 0)
+        {
+          cluster       = diskclus;
+          filep->f_pos  = (off_t)fileclus * clustersize;
+          position     -= filep->f_pos;
+        }
+#endif
+
       for (; ; )
         {
           /* Skip over clusters prior to the one containing
@@ -1222,6 +1521,10 @@ static off_t fat_seek(FAR struct file *filep, off_t offset, int whence)
 
           filep->f_pos += clustersize;
           position     -= clustersize;
+
+#if CONFIG_FAT_NEXTENTS > 0
+          fat_extentadd(ff, filep->f_pos / clustersize, cluster);
+#endif
         }
 
       /* We get here after we have found the sector containing
@@ -1412,6 +1715,26 @@ static int fat_sync(FAR struct file *filep)
       ret          = fat_updatefsinfo(fs);
     }
 
+  /* Ask the block driver to write back anything that it may be buffering
+   * (such as a block cache).  Most block drivers do not buffer and do not
+   * support BIOC_FLUSH.  Depending on the driver, an unsupported ioctl
+   * command fails with -ENOTTY, -EINVAL, or -ENOSYS.
+   */
+
+  if (ret >= 0)
+    {
+      inode = fs->fs_blkdriver;
+      if (inode->u.i_bops->ioctl != NULL)
+        {
+          int tmp = inode->u.i_bops->ioctl(inode, BIOC_FLUSH, 0);
+          if (tmp < 0 && tmp != -ENOTTY && tmp != -EINVAL &&
+              tmp != -ENOSYS)
+            {
+              ret = tmp;
+            }
+        }
+    }
+
 errout_with_semaphore:
   fat_semgive(fs);
   return ret;
@@ -1514,6 +1837,10 @@ static int fat_dup(FAR const struct file *oldp, FAR struct file *newp)
   newff->ff_startcluster     = oldff->ff_startcluster;     /* Start cluster of file on media */
   newff->ff_currentsector    = oldff->ff_currentsector;    /* Current sector */
   newff->ff_cachesector      = 0;                          /* Sector in file buffer */
+#if CONFIG_FAT_NEXTENTS > 0
+  newff->ff_extnext          = oldff->ff_extnext;          /* Next extent to replace */
+  memcpy(newff->ff_extents, oldff->ff_extents, sizeof(newff->ff_extents));
+#endif
 
   /* Attach the private date to the struct file instance */
 
@@ -1799,6 +2126,14 @@ static int fat_truncate(FAR struct file *filep, off_t length)
           ret = fat_dirshrink(fs, direntry, length);
         }
 
+#if CONFIG_FAT_NEXTENTS > 0
+      /* Forget any cached extents that may refer to released clusters.
+       * Other open files on the same directory entry cache them too.
+       */
+
+      fat_extentreset(fs, ff);
+#endif
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -1817,6 +2152,16 @@ static int fat_truncate(FAR struct file *filep, off_t length)
        */
 
       ret = fat_dirextend(fs, ff, length);
+
+#if CONFIG_FAT_NEXTENTS > 0
+      /* fat_dirextend() may have created the cluster chain */
+
+      if (ff->ff_startcluster > 0)
+        {
+          fat_extentadd(ff, 0, ff->ff_startcluster);
+        }
+#endif
+
       if (ret >= 0)
         {
           /* The truncation has completed without error.  Update the file
@@ -2203,6 +2548,13 @@ static int fat_unbind(FAR void *handle, FAR struct inode **blkdriver,
       fat_io_free(fs->fs_buffer, fs->fs_hwsectorsize);
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  if (fs->fs_freemap)
+    {
+      kmm_free(fs->fs_freemap);
+    }
+#endif
+
   nxsem_destroy(&fs->fs_sem);
   kmm_free(fs);
   return OK;
@@ -56,6 +56,14 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Configuration ************************************************************/
+
+/* Number of cluster chain extents cached for each open file */
+
+#ifndef CONFIG_FAT_NEXTENTS
+#  define CONFIG_FAT_NEXTENTS 0
+#endif
+
 /****************************************************************************
  * These offsets describes the master boot record (MBR).
  *
@@ -901,7 +909,24 @@ struct fat_mountpt_s
   uint8_t  fs_fatsecperclus;       /* MBR: Sectors per allocation unit: 2**n, n=0..7 */
   uint8_t *fs_buffer;              /* This is an allocated buffer to hold one sector
                                     * from the device */
+#ifdef CONFIG_FAT_FREEMAP
+  uint32_t *fs_freemap;            /* Bitmap of free clusters (1=free), built lazily */
+  bool     fs_nofreemap;           /* true: Allocation of fs_freemap failed */
+#endif
+};
+
+#if CONFIG_FAT_NEXTENTS > 0
+/* This structure describes one run of physically contiguous clusters in
+ * the cluster chain of an open file.
+ */
+
+struct fat_extent_s
+{
+  uint32_t fe_fileclus;            /* Index of the first cluster in the file */
+  uint32_t fe_diskclus;            /* Cluster number of the first cluster on media */
+  uint32_t fe_nclusters;           /* Number of contiguous clusters in the run */
 };
+#endif
 
 /* This structure represents on open file under the mountpoint.  An instance
  * of this structure is retained as struct file specific information on each
@@ -912,8 +937,8 @@ struct fat_file_s
 {
   struct fat_file_s *ff_next;      /* Retained in a singly linked list */
   uint8_t  ff_bflags;              /* The file buffer/mount flags */
-  uint8_t  ff_oflags;              /* Flags provided when file was opened */
   uint8_t  ff_sectorsincluster;    /* Sectors remaining in cluster */
+  uint16_t ff_oflags;              /* Flags provided when file was opened */
   uint16_t ff_dirindex;            /* Index into ff_dirsector to directory entry */
   uint32_t ff_currentcluster;      /* Current cluster being accessed */
   off_t    ff_dirsector;           /* Sector containing the directory entry */
@@ -922,6 +947,10 @@ struct fat_file_s
   off_t    ff_currentsector;       /* Current sector being operated on */
   off_t    ff_cachesector;         /* Current sector in the file buffer */
   uint8_t *ff_buffer;              /* File buffer (for partial sector accesses) */
+#if CONFIG_FAT_NEXTENTS > 0
+  uint8_t  ff_extnext;             /* Next extent to be replaced */
+  struct fat_extent_s ff_extents[CONFIG_FAT_NEXTENTS];
+#endif
 };
 
 /* This structure holds the sequence of directory entries used by one
@@ -275,6 +275,214 @@ static int fat_checkbootrecord(struct fat_mountpt_s *fs)
   return OK;
 }
 
+/****************************************************************************
+ * Name: fat_buildfreemap
+ *
+ * Description:
+ *   Allocate the bitmap of free clusters and populate it with a single
+ *   pass over the FAT.  This also refreshes the FSINFO free cluster count.
+ *   This is done lazily:  The bitmap is not built until the first time
+ *   that a free cluster is needed.
+ *
+ * Returned Value:
+ *   OK if the bitmap is available, otherwise a negated errno value.  On
+ *   failure, the caller must fall back to searching the FAT directly.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static int fat_buildfreemap(struct fat_mountpt_s *fs)
+{
+  FAR uint32_t *freemap;
+  uint32_t nfreeclusters;
+  uint32_t cluster;
+  off_t next;
+
+  if (fs->fs_freemap != NULL)
+    {
+      return OK;
+    }
+
+  /* Don't retry every time if memory could not be allocated */
+
+  if (fs->fs_nofreemap)
+    {
+      return -ENOMEM;
+    }
+
+  freemap = (FAR uint32_t *)
+    kmm_zalloc(((fs->fs_nclusters + 31) >> 5) * sizeof(uint32_t));
+  if (freemap == NULL)
+    {
+      fs->fs_nofreemap = true;
+      return -ENOMEM;
+    }
+
+  /* Clusters 0 and 1 are reserved and are never marked free */
+
+  nfreeclusters = 0;
+  for (cluster = 2; cluster < fs->fs_nclusters; cluster++)
+    {
+      next = fat_getcluster(fs, cluster);
+      if (next < 0)
+        {
+          kmm_free(freemap);
+          return (int)next;
+        }
+      else if (next == 0)
+        {
+          freemap[cluster >> 5] |= (uint32_t)1 << (cluster & 31);
+          nfreeclusters++;
+        }
+    }
+
+  fs->fs_freemap      = freemap;
+  fs->fs_fsifreecount = nfreeclusters;
+  if (fs->fs_type == FSTYPE_FAT32)
+    {
+      fs->fs_fsidirty = true;
+    }
+
+  return OK;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_freemapsearch
+ *
+ * Description:
+ *   Return the first free cluster at or after 'cluster' using the bitmap of
+ *   free clusters, or zero if there is no free cluster in that range.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FAT_FREEMAP
+static uint32_t fat_freemapsearch(struct fat_mountpt_s *fs, uint32_t cluster)
+{
+  uint32_t nwords = (fs->fs_nclusters + 31) >> 5;
+  uint32_t ndx    = cluster >> 5;
+  uint32_t bits;
+
+  if (cluster >= fs->fs_nclusters)
+    {
+      return 0;
+    }
+
+  /* Ignore bits before the starting cluster in the first word.  Bits
+   * beyond the last cluster are never set.
+   */
+
+  bits = fs->fs_freemap[ndx] & ((uint32_t)0xffffffff << (cluster & 31));
+  while (bits == 0)
+    {
+      if (++ndx >= nwords)
+        {
+          return 0;
+        }
+
+      bits = fs->fs_freemap[ndx];
+    }
+
+  for (cluster = ndx << 5; (bits & 1) == 0; bits >>= 1)
+    {
+      cluster++;
+    }
+
+  return cluster;
+}
+#endif
+
+/****************************************************************************
+ * Name: fat_findfree
+ *
+ * Description:
+ *   Find a free cluster, starting the search just after 'startcluster' and
+ *   wrapping back to the beginning of the FAT if necessary.
+ *
+ * Returned Value:
+ *   <0:error, 0: no free cluster, >=2: free cluster number
+ *
+ ****************************************************************************/
+
+static int32_t fat_findfree(struct fat_mountpt_s *fs, uint32_t startcluster)
+{
+  off_t    startsector;
+  uint32_t newcluster;
+
+#ifdef CONFIG_FAT_FREEMAP
+  /* Use the bitmap of free clusters if one is (or can be made) available */
+
+  if (fat_buildfreemap(fs) == OK)
+    {
+      newcluster = fat_freemapsearch(fs, startcluster + 1);
+      if (newcluster == 0)
+        {
+          newcluster = fat_freemapsearch(fs, 2);
+        }
+
+      return newcluster;
+    }
+#endif
+
+  /* Loop until (1) we discover that there are not free clusters
+   * (return 0), an errors occurs (return -errno), or (3) we find
+   * the next cluster (return the new cluster number).
+   */
+
+  newcluster = startcluster;
+  for (; ; )
+    {
+      /* Examine the next cluster in the FAT */
+
+      newcluster++;
+      if (newcluster >= fs->fs_nclusters)
+        {
+          /* If we hit the end of the available clusters, then
+           * wrap back to the beginning because we might have
+           * started at a non-optimal place.  But don't continue
+           * past the start cluster.
+           */
+
+          newcluster = 2;
+          if (newcluster > startcluster)
+            {
+              /* We are back past the starting cluster, then there
+               * is no free cluster.
+               */
+
+              return 0;
+            }
+        }
+
+      /* We have a candidate cluster.  Check if the cluster number is
+       * mapped to a group of sectors.
+       */
+
+      startsector = fat_getcluster(fs, newcluster);
+      if (startsector == 0)
+        {
+          /* Found have found a free cluster break out */
+
+          return newcluster;
+        }
+      else if (startsector < 0)
+        {
+          /* Some error occurred, return the error number */
+
+          return startsector;
+        }
+
+      /* We wrap all the back to the starting cluster?  If so, then
+       * there are no free clusters.
+       */
+
+      if (newcluster == startcluster)
+        {
+          return 0;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1107,6 +1315,24 @@ int fat_putcluster(struct fat_mountpt_s *fs, uint32_t clusterno,
             return -EINVAL;
         }
 
+#ifdef CONFIG_FAT_FREEMAP
+      /* Keep the bitmap of free clusters in sync with the FAT */
+
+      if (fs->fs_freemap != NULL && clusterno >= 2)
+        {
+          uint32_t bit = (uint32_t)1 << (clusterno & 31);
+
+          if (nextcluster == 0)
+            {
+              fs->fs_freemap[clusterno >> 5] |= bit;
+            }
+          else
+            {
+              fs->fs_freemap[clusterno >> 5] &= ~bit;
+            }
+        }
+#endif
+
       /* Mark the modified sector as "dirty" and return success */
 
       fs->fs_dirty = true;
@@ -1182,7 +1408,7 @@ int fat_removechain(struct fat_mountpt_s *fs, uint32_t cluster)
 int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
 {
   off_t    startsector;
-  uint32_t newcluster;
+  int32_t  newcluster;
   uint32_t startcluster;
   int      ret;
 
@@ -1233,66 +1459,21 @@ int32_t fat_extendchain(struct fat_mountpt_s *fs, uint32_t cluster)
       startcluster = cluster;
     }
 
-  /* Loop until (1) we discover that there are not free clusters
-   * (return 0), an errors occurs (return -errno), or (3) we find
-   * the next cluster (return the new cluster number).
+  /* Find a free cluster.  When extending a chain, the search begins with
+   * the cluster immediately following the current tail so that sequential
+   * writes tend to produce physically contiguous runs of clusters.
    */
 
-  newcluster = startcluster;
-  for (; ; )
+  newcluster = fat_findfree(fs, startcluster);
+  if (newcluster <= 0)
     {
-      /* Examine the next cluster in the FAT */
+      /* An error occurred or there are no free clusters */
 
-      newcluster++;
-      if (newcluster >= fs->fs_nclusters)
-        {
-          /* If we hit the end of the available clusters, then
-           * wrap back to the beginning because we might have
-           * started at a non-optimal place.  But don't continue
-           * past the start cluster.
-           */
-
-          newcluster = 2;
-          if (newcluster > startcluster)
-            {
-              /* We are back past the starting cluster, then there
-               * is no free cluster.
-               */
-
-              return 0;
-            }
-        }
-
-      /* We have a candidate cluster.  Check if the cluster number is
-       * mapped to a group of sectors.
-       */
-
-      startsector = fat_getcluster(fs, newcluster);
-      if (startsector == 0)
-        {
-          /* Found have found a free cluster break out */
-
-          break;
-        }
-      else if (startsector < 0)
-        {
-          /* Some error occurred, return the error number */
-
-          return startsector;
-        }
-
-      /* We wrap all the back to the starting cluster?  If so, then
-       * there are no free clusters.
-       */
-
-      if (newcluster == startcluster)
-        {
-          return 0;
-        }
+      return newcluster;
     }
 
-  /* We get here only if we break out with an available cluster
-   * number in 'newcluster'  Now mark that cluster as in-use.
+  /* We get here only if we found an available cluster number in
+   * 'newcluster'  Now mark that cluster as in-use.
    */
 
   ret = fat_putcluster(fs, newcluster, 0x0fffffff);
@@ -2049,6 +2230,18 @@ int fat_nfreeclusters(struct fat_mountpt_s *fs, off_t *pfreeclusters)
       return OK;
     }
 
+#ifdef CONFIG_FAT_FREEMAP
+  /* Building the bitmap of free clusters costs the same single pass over
+   * the FAT and also recalculates the free cluster count.
+   */
+
+  if (fat_buildfreemap(fs) == OK)
+    {
+      *pfreeclusters = fs->fs_fsifreecount;
+      return OK;
+    }
+#endif
+
   /* Otherwise, we will have to count the number of free clusters */
 
   nfreeclusters = 0;
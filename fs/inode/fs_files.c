@@ -41,7 +41,9 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
 #include <string.h>
+#include <strings.h>
 #include <semaphore.h>
 #include <assert.h>
 #include <sched.h>
@@ -49,9 +51,18 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
 
 #include "inode/inode.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef SP_DMB
+#  define SP_DMB()
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -85,6 +96,86 @@ static void _files_semtake(FAR struct filelist *list)
 
 #define _files_semgive(list) nxsem_post(&list->fl_sem)
 
+/****************************************************************************
+ * Name: _files_extend
+ *
+ * Description:
+ *   Return the struct file instance for 'fd', allocating the chunk that
+ *   contains it if necessary.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore (or otherwise has exclusive access to
+ *   the list).
+ *
+ ****************************************************************************/
+
+static FAR struct file *_files_extend(FAR struct filelist *list, int fd)
+{
+#ifdef CONFIG_FILELIST_DYNAMIC
+  FAR struct file *chunk;
+  int ndx;
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+  ndx   = fd / CONFIG_FILELIST_CHUNKSIZE;
+  chunk = list->fl_chunks[ndx];
+  if (chunk == NULL)
+    {
+      chunk = (FAR struct file *)
+        kmm_zalloc(CONFIG_FILELIST_CHUNKSIZE * sizeof(struct file));
+      if (chunk == NULL)
+        {
+          return NULL;
+        }
+
+      /* files_getfile() reads fl_chunks[] without the semaphore.  Make sure
+       * that the cleared chunk is visible before the pointer to it.
+       */
+
+      SP_DMB();
+      list->fl_chunks[ndx] = chunk;
+    }
+
+  return &chunk[fd % CONFIG_FILELIST_CHUNKSIZE];
+#else
+  return files_getfile(list, fd);
+#endif
+}
+
+/****************************************************************************
+ * Name: _files_syncinuse
+ *
+ * Description:
+ *   Bring the allocation bit of 'filep' up to date after it was changed
+ *   through its struct file pointer.  Nothing is done if 'filep' does not
+ *   belong to 'list'.
+ *
+ * Assumuptions:
+ *   Caller holds the list semaphore.
+ *
+ ****************************************************************************/
+
+static void _files_syncinuse(FAR struct filelist *list,
+                             FAR struct file *filep)
+{
+  int fd = files_getfd(list, filep);
+
+  if (fd >= 0)
+    {
+      if (filep->f_inode != NULL)
+        {
+          FILELIST_SETINUSE(list, fd);
+        }
+      else
+        {
+          FILELIST_CLRINUSE(list, fd);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: _files_close
  *
@@ -179,16 +270,131 @@ void files_releaselist(FAR struct filelist *list)
    * there should not be any references in this context.
    */
 
+#ifdef CONFIG_FILELIST_DYNAMIC
+  for (i = 0; i < FILELIST_NCHUNKS; i++)
+    {
+      FAR struct file *chunk = list->fl_chunks[i];
+      int j;
+
+      if (chunk != NULL)
+        {
+          for (j = 0; j < CONFIG_FILELIST_CHUNKSIZE; j++)
+            {
+              (void)_files_close(&chunk[j]);
+            }
+
+          list->fl_chunks[i] = NULL;
+          kmm_free(chunk);
+        }
+    }
+#else
   for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       (void)_files_close(&list->fl_files[i]);
     }
+#endif
+
+  memset(list->fl_inuse, 0, sizeof(list->fl_inuse));
 
   /* Destroy the semaphore */
 
   (void)nxsem_destroy(&list->fl_sem);
 }
 
+/****************************************************************************
+ * Name: files_getfile
+ *
+ * Description:
+ *   Return the struct file instance that backs the file descriptor 'fd' in
+ *   'list'.  The returned structure may or may not be open.  This does not
+ *   take the list semaphore:  File structures are never moved or freed
+ *   until the list itself is released.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_getfile(FAR struct filelist *list, int fd)
+{
+#ifdef CONFIG_FILELIST_DYNAMIC
+  FAR struct file *chunk;
+#endif
+
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_FILELIST_DYNAMIC
+  chunk = list->fl_chunks[fd / CONFIG_FILELIST_CHUNKSIZE];
+  if (chunk == NULL)
+    {
+      return NULL;
+    }
+
+  return &chunk[fd % CONFIG_FILELIST_CHUNKSIZE];
+#else
+  return &list->fl_files[fd];
+#endif
+}
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Like files_getfile() but allocate the file structure backing 'fd' if it
+ *   does not yet exist.
+ *
+ ****************************************************************************/
+
+FAR struct file *files_extend(FAR struct filelist *list, int fd)
+{
+  FAR struct file *filep;
+
+  filep = files_getfile(list, fd);
+  if (filep == NULL && (unsigned int)fd < CONFIG_NFILE_DESCRIPTORS)
+    {
+      _files_semtake(list);
+      filep = _files_extend(list, fd);
+      _files_semgive(list);
+    }
+
+  return filep;
+}
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor that corresponds to a struct file instance
+ *   in 'list' or -EBADF if 'filep' is not a member of 'list'.
+ *
+ ****************************************************************************/
+
+int files_getfd(FAR struct filelist *list, FAR struct file *filep)
+{
+#ifdef CONFIG_FILELIST_DYNAMIC
+  FAR struct file *chunk;
+  int i;
+
+  for (i = 0; i < FILELIST_NCHUNKS; i++)
+    {
+      chunk = list->fl_chunks[i];
+      if (chunk != NULL && filep >= chunk &&
+          filep < &chunk[CONFIG_FILELIST_CHUNKSIZE])
+        {
+          return i * CONFIG_FILELIST_CHUNKSIZE + (int)(filep - chunk);
+        }
+    }
+#else
+  if (filep >= list->fl_files &&
+      filep < &list->fl_files[CONFIG_NFILE_DESCRIPTORS])
+    {
+      return (int)(filep - list->fl_files);
+    }
+#endif
+
+  return -EBADF;
+}
+
 /****************************************************************************
  * Name: file_dup2
  *
@@ -285,6 +491,7 @@ int file_dup2(FAR struct file *filep1, FAR struct file *filep2)
 
   if (list != NULL)
     {
+      _files_syncinuse(list, filep2);
       _files_semgive(list);
     }
 
@@ -301,6 +508,7 @@ errout_with_inode:
 errout_with_sem:
   if (list != NULL)
     {
+      _files_syncinuse(list, filep2);
       _files_semgive(list);
     }
 
@@ -314,30 +522,69 @@ errout_with_sem:
  *   Allocate a struct files instance and associate it with an inode instance.
  *   Returns the file descriptor == index into the files array.
  *
+ *   Free descriptors are found a word at a time in the fl_inuse bitmap.
+ *   A descriptor whose bit is clear may still have been populated through
+ *   its struct file pointer by file_dup2() on behalf of a different list
+ *   (as when a new task inherits descriptors); such entries are marked and
+ *   skipped.
+ *
  ****************************************************************************/
 
 int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 {
   FAR struct filelist *list;
-  int i;
+  FAR struct file *filep;
+  uint32_t inuse;
+  int fd;
 
   /* Get the file descriptor list.  It should not be NULL in this context. */
 
   list = sched_getfiles();
   DEBUGASSERT(list != NULL);
 
+  if (minfd < 0)
+    {
+      minfd = 0;
+    }
+
   _files_semtake(list);
-  for (i = minfd; i < CONFIG_NFILE_DESCRIPTORS; i++)
+
+  fd = minfd;
+  while (fd < CONFIG_NFILE_DESCRIPTORS)
     {
-      if (!list->fl_files[i].f_inode)
+      /* Ignore the descriptors below fd in this bitmap word */
+
+      inuse = list->fl_inuse[fd >> 5] | (((uint32_t)1 << (fd & 31)) - 1);
+      if (inuse == UINT32_MAX)
+        {
+          fd = (fd & ~31) + 32;
+          continue;
+        }
+
+      fd = (fd & ~31) + ffs((int)~inuse) - 1;
+      if (fd >= CONFIG_NFILE_DESCRIPTORS)
+        {
+          break;
+        }
+
+      filep = _files_extend(list, fd);
+      if (filep == NULL)
+        {
+          break;
+        }
+
+      FILELIST_SETINUSE(list, fd);
+      if (filep->f_inode == NULL)
         {
-           list->fl_files[i].f_oflags = oflags;
-           list->fl_files[i].f_pos    = pos;
-           list->fl_files[i].f_inode  = inode;
-           list->fl_files[i].f_priv   = NULL;
-           _files_semgive(list);
-           return i;
+          filep->f_oflags = oflags;
+          filep->f_pos    = pos;
+          filep->f_inode  = inode;
+          filep->f_priv   = NULL;
+          _files_semgive(list);
+          return fd;
         }
+
+      fd++;
     }
 
   _files_semgive(list);
@@ -358,6 +605,7 @@ int files_allocate(FAR struct inode *inode, int oflags, off_t pos, int minfd)
 int files_close(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file     *filep;
   int                  ret;
 
   /* Get the thread-specific file list.  It should never be NULL in this
@@ -369,7 +617,8 @@ int files_close(int fd)
 
   /* If the file was properly opened, there should be an inode assigned */
 
-  if (fd < 0 || fd >= CONFIG_NFILE_DESCRIPTORS || !list->fl_files[fd].f_inode)
+  filep = files_getfile(list, fd);
+  if (filep == NULL || !filep->f_inode)
     {
       return -EBADF;
     }
@@ -377,7 +626,8 @@ int files_close(int fd)
   /* Perform the protected close operation */
 
   _files_semtake(list);
-  ret = _files_close(&list->fl_files[fd]);
+  ret = _files_close(filep);
+  FILELIST_CLRINUSE(list, fd);
   _files_semgive(list);
   return ret;
 }
@@ -394,16 +644,19 @@ int files_close(int fd)
 void files_release(int fd)
 {
   FAR struct filelist *list;
+  FAR struct file *filep;
 
   list = sched_getfiles();
   DEBUGASSERT(list);
 
-  if (fd >= 0 && fd < CONFIG_NFILE_DESCRIPTORS)
+  filep = files_getfile(list, fd);
+  if (filep != NULL)
     {
       _files_semtake(list);
-      list->fl_files[fd].f_oflags  = 0;
-      list->fl_files[fd].f_pos     = 0;
-      list->fl_files[fd].f_inode = NULL;
+      filep->f_oflags  = 0;
+      filep->f_pos     = 0;
+      filep->f_inode = NULL;
+      FILELIST_CLRINUSE(list, fd);
       _files_semgive(list);
     }
 }
@@ -61,6 +61,10 @@
 
 void inode_free(FAR struct inode *node)
 {
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *child;
+#endif
+
   /* Verify that we were passed valid pointer to an inode */
 
   if (node != NULL)
@@ -72,6 +76,15 @@ void inode_free(FAR struct inode *node)
                   (node->i_peer == NULL && node->i_child == NULL));
 #endif
 
+#ifdef CONFIG_FS_INODE_HASH
+      /* Remove the children of this inode from the hash table */
+
+      for (child = node->i_child; child != NULL; child = child->i_peer)
+        {
+          inode_hashremove(child);
+        }
+#endif
+
       /* Free all peers and children of this i_node */
 
       inode_free(node->i_peer);
@@ -0,0 +1,230 @@
+/****************************************************************************
+ * fs/inode/fs_inodehash.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_INODE_HASH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if (CONFIG_FS_INODE_HASHSIZE & (CONFIG_FS_INODE_HASHSIZE - 1)) != 0
+#  error CONFIG_FS_INODE_HASHSIZE must be a power of two
+#endif
+
+#define INODE_HASHMASK (CONFIG_FS_INODE_HASHSIZE - 1)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Each bucket holds a list of inodes linked through i_hnext.  Inodes are
+ * keyed by the address of their parent inode, i_hparent (NULL at the top
+ * level), and by their name.
+ */
+
+static FAR struct inode *g_inode_hash[CONFIG_FS_INODE_HASHSIZE];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashkey
+ *
+ * Description:
+ *   Hash a parent inode and one path segment.  The segment is terminated
+ *   either by a NUL or by a '/' character.
+ *
+ ****************************************************************************/
+
+static unsigned int inode_hashkey(FAR struct inode *parent,
+                                  FAR const char *name)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)((uintptr_t)parent >> 2);
+
+  while (*name != '\0' && *name != '/')
+    {
+      hash = (hash ^ (uint8_t)*name++) * 16777619u;
+    }
+
+  return (unsigned int)(hash ^ (hash >> 16)) & INODE_HASHMASK;
+}
+
+/****************************************************************************
+ * Name: inode_namematch
+ *
+ * Description:
+ *   Return true if the path segment 'name' is the name of 'node'
+ *
+ ****************************************************************************/
+
+static bool inode_namematch(FAR struct inode *node, FAR const char *name)
+{
+  FAR const char *nname = node->i_name;
+
+  while (*nname != '\0' && *nname == *name)
+    {
+      nname++;
+      name++;
+    }
+
+  return *nname == '\0' && (*name == '\0' || *name == '/');
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: inode_hashadd
+ *
+ * Description:
+ *   Add an inode that has just been linked below 'parent' to the hash
+ *   table.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_hashadd(FAR struct inode *parent, FAR struct inode *node)
+{
+  unsigned int key = inode_hashkey(parent, node->i_name);
+
+  node->i_hparent   = parent;
+  node->i_hnext     = g_inode_hash[key];
+  g_inode_hash[key] = node;
+}
+
+/****************************************************************************
+ * Name: inode_hashremove
+ *
+ * Description:
+ *   Remove an inode from the hash table.  Nothing is done if the inode is
+ *   not in the hash table.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_hashremove(FAR struct inode *node)
+{
+  FAR struct inode **pnext;
+
+  pnext = &g_inode_hash[inode_hashkey(node->i_hparent, node->i_name)];
+  for (; *pnext != NULL; pnext = &(*pnext)->i_hnext)
+    {
+      if (*pnext == node)
+        {
+          *pnext        = node->i_hnext;
+          node->i_hnext = NULL;
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hashmove
+ *
+ * Description:
+ *   Re-key all of the children of 'oldparent' which are being moved to be
+ *   the children of 'newparent'.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+void inode_hashmove(FAR struct inode *oldparent,
+                    FAR struct inode *newparent)
+{
+  FAR struct inode *child;
+
+  for (child = oldparent->i_child; child != NULL; child = child->i_peer)
+    {
+      inode_hashremove(child);
+      inode_hashadd(newparent, child);
+    }
+}
+
+/****************************************************************************
+ * Name: inode_hashfind
+ *
+ * Description:
+ *   Find the child of 'parent' whose name is the path segment at the
+ *   beginning of 'name'.
+ *
+ * Returned Value:
+ *   The matching inode or NULL if there is none.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name)
+{
+  FAR struct inode *node;
+
+  for (node = g_inode_hash[inode_hashkey(parent, name)];
+       node != NULL;
+       node = node->i_hnext)
+    {
+      if (node->i_hparent == parent && inode_namematch(node, name))
+        {
+          return node;
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_FS_INODE_HASH */
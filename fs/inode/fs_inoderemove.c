@@ -72,6 +72,8 @@ FAR struct inode *inode_unlink(FAR const char *path)
 {
   struct inode_search_s desc;
   FAR struct inode *node = NULL;
+  FAR struct inode *left;
+  FAR struct inode *peer;
   int ret;
 
   /* Verify parameters.  Ignore null paths and relative paths */
@@ -91,13 +93,25 @@ FAR struct inode *inode_unlink(FAR const char *path)
       node = desc.node;
       DEBUGASSERT(node != NULL);
 
+      /* Find the peer node to the "left" of the node being removed (if
+       * any).  inode_search() does not report that when the node is found.
+       */
+
+      left = NULL;
+      peer = desc.parent != NULL ? desc.parent->i_child : g_root_inode;
+      while (peer != NULL && peer != node)
+        {
+          left = peer;
+          peer = peer->i_peer;
+        }
+
       /* If peer is non-null, then remove the node from the right of
        * of that peer node.
        */
 
-      if (desc.peer != NULL)
+      if (left != NULL)
         {
-          desc.peer->i_peer = node->i_peer;
+          left->i_peer = node->i_peer;
         }
 
       /* If parent is non-null, then remove the node from head of
@@ -117,6 +131,10 @@ FAR struct inode *inode_unlink(FAR const char *path)
         }
 
       node->i_peer = NULL;
+
+#ifdef CONFIG_FS_INODE_HASH
+      inode_hashremove(node);
+#endif
     }
 
   RELEASE_SEARCH(&desc);
@@ -280,7 +280,25 @@ static int _inode_search(FAR struct inode_search_s *desc)
 
   while (node != NULL)
     {
-      int result = _inode_compare(name, node);
+      int result;
+
+#ifdef CONFIG_FS_INODE_HASH
+      /* At the beginning of each level of the tree, use the hash table to
+       * go directly to the matching inode.  If there is none, fall through
+       * to the linear search which also finds the insertion point.
+       */
+
+      if (left == NULL)
+        {
+          FAR struct inode *match = inode_hashfind(above, name);
+          if (match != NULL)
+            {
+              node = match;
+            }
+        }
+#endif
+
+      result = _inode_compare(name, node);
 
       /* Case 1:  The name is less than the name of the node.
        * Since the names are ordered, these means that there
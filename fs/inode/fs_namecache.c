@@ -0,0 +1,212 @@
+/****************************************************************************
+ * fs/inode/fs_namecache.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sched.h>
+
+#include <nuttx/fs/fs.h>
+
+#include "inode/inode.h"
+
+#ifdef CONFIG_FS_NAMECACHE
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One negative entry:  A path relative to a mountpoint that is known not
+ * to exist.
+ */
+
+struct namecache_s
+{
+  FAR struct inode *nc_mountpt;            /* Mountpoint inode */
+  uint32_t nc_generation;                  /* Valid if == g_nc_generation */
+  char nc_relpath[CONFIG_FS_NAMECACHE_NAMELEN + 1];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct namecache_s g_namecache[CONFIG_FS_NAMECACHE_NENTRIES];
+
+/* Incremented whenever names may have been created in any mounted volume.
+ * This invalidates every entry at once.  Zero is never used so that the
+ * initial, zeroed entries are invalid.
+ */
+
+static uint32_t g_nc_generation = 1;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: namecache_hash
+ ****************************************************************************/
+
+static unsigned int namecache_hash(FAR struct inode *mountpt,
+                                   FAR const char *relpath)
+{
+  uint32_t hash = 2166136261u ^ (uint32_t)((uintptr_t)mountpt >> 2);
+
+  while (*relpath != '\0')
+    {
+      hash = (hash ^ (uint8_t)*relpath++) * 16777619u;
+    }
+
+  return (unsigned int)(hash % CONFIG_FS_NAMECACHE_NENTRIES);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: namecache_isnegative
+ *
+ * Description:
+ *   Check if 'relpath' within the volume mounted at 'mountpt' is known not
+ *   to exist.
+ *
+ * Returned Value:
+ *   true if the path is known not to exist.  false means only that
+ *   nothing is known about the path.
+ *
+ ****************************************************************************/
+
+bool namecache_isnegative(FAR struct inode *mountpt, FAR const char *relpath)
+{
+  FAR struct namecache_s *nc;
+  bool found;
+
+  if (strlen(relpath) > CONFIG_FS_NAMECACHE_NAMELEN)
+    {
+      return false;
+    }
+
+  nc = &g_namecache[namecache_hash(mountpt, relpath)];
+
+  sched_lock();
+  found = nc->nc_generation == g_nc_generation &&
+          nc->nc_mountpt == mountpt &&
+          strcmp(nc->nc_relpath, relpath) == 0;
+  sched_unlock();
+
+  return found;
+}
+
+/****************************************************************************
+ * Name: namecache_generation
+ *
+ * Description:
+ *   Return the current generation of the cache.  This must be sampled
+ *   before the file system is asked to look up a path and then passed to
+ *   namecache_addnegative() if the path was not found.
+ *
+ ****************************************************************************/
+
+uint32_t namecache_generation(void)
+{
+  return g_nc_generation;
+}
+
+/****************************************************************************
+ * Name: namecache_addnegative
+ *
+ * Description:
+ *   Remember that 'relpath' within the volume mounted at 'mountpt' does not
+ *   exist.  This replaces any previous entry that hashes to the same slot.
+ *   'generation' is the value of namecache_generation() sampled before the
+ *   lookup.  If the cache was invalidated since then, the path may have
+ *   been created after the lookup and nothing is remembered.
+ *
+ ****************************************************************************/
+
+void namecache_addnegative(FAR struct inode *mountpt,
+                           FAR const char *relpath, uint32_t generation)
+{
+  FAR struct namecache_s *nc;
+
+  if (strlen(relpath) > CONFIG_FS_NAMECACHE_NAMELEN)
+    {
+      return;
+    }
+
+  nc = &g_namecache[namecache_hash(mountpt, relpath)];
+
+  sched_lock();
+  if (generation == g_nc_generation)
+    {
+      nc->nc_mountpt    = mountpt;
+      nc->nc_generation = generation;
+      strcpy(nc->nc_relpath, relpath);
+    }
+
+  sched_unlock();
+}
+
+/****************************************************************************
+ * Name: namecache_invalidate
+ *
+ * Description:
+ *   Discard all negative entries.  This must be called whenever a name may
+ *   have been created within a mounted volume or a volume is mounted or
+ *   unmounted.
+ *
+ ****************************************************************************/
+
+void namecache_invalidate(void)
+{
+  sched_lock();
+  if (++g_nc_generation == 0)
+    {
+      g_nc_generation = 1;
+    }
+
+  sched_unlock();
+}
+
+#endif /* CONFIG_FS_NAMECACHE */
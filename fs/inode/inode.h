@@ -55,6 +55,15 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Manage the bitmap of allocated file descriptors in struct filelist.  The
+ * caller must hold the list semaphore.
+ */
+
+#define FILELIST_SETINUSE(l,fd) \
+  ((l)->fl_inuse[(fd) >> 5] |= ((uint32_t)1 << ((fd) & 31)))
+#define FILELIST_CLRINUSE(l,fd) \
+  ((l)->fl_inuse[(fd) >> 5] &= ~((uint32_t)1 << ((fd) & 31)))
+
 #ifdef CONFIG_PSEUDOFS_SOFTLINKS
 
 #  define SETUP_SEARCH(d,p,n) \
@@ -106,7 +115,8 @@
  *  node     - INPUT:  (not used)
  *             OUTPUT: On success, holds the pointer to the inode found.
  *  peer     - INPUT:  (not used)
- *             OUTPUT: The inode to the "left" of the inode found.
+ *             OUTPUT: If the inode was not found, the inode to the "left"
+ *                     of where it would be inserted.
  *  parent   - INPUT:  (not used)
  *             OUTPUT: The inode to the "above" of the inode found.
  *  relpath  - INPUT:  (not used)
@@ -274,6 +284,50 @@ int inode_stat(FAR struct inode *inode, FAR struct stat *buf);
 
 void inode_free(FAR struct inode *node);
 
+/****************************************************************************
+ * Name: inode_hashadd, inode_hashremove, inode_hashmove, and inode_hashfind
+ *
+ * Description:
+ *   Maintain and search the hash table that indexes each inode by its
+ *   parent and name.  This lets inode_search() find an inode at each level
+ *   of the tree without a linear search of the sibling list.
+ *
+ * Assumptions:
+ *   The caller holds the inode semaphore
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_INODE_HASH
+void inode_hashadd(FAR struct inode *parent, FAR struct inode *node);
+void inode_hashremove(FAR struct inode *node);
+void inode_hashmove(FAR struct inode *oldparent,
+                    FAR struct inode *newparent);
+FAR struct inode *inode_hashfind(FAR struct inode *parent,
+                                 FAR const char *name);
+#endif
+
+/****************************************************************************
+ * Name: namecache_isnegative, namecache_addnegative, and
+ *       namecache_invalidate
+ *
+ * Description:
+ *   A small cache of paths within mounted volumes that are known not to
+ *   exist.  open() and stat() consult it before asking the file system to
+ *   look up the path.  Every entry is discarded whenever a name may have
+ *   been created within a mounted volume.  The generation is sampled before
+ *   a lookup so that a name created during the lookup is not cached as
+ *   missing.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_FS_NAMECACHE
+bool namecache_isnegative(FAR struct inode *mountpt, FAR const char *relpath);
+uint32_t namecache_generation(void);
+void namecache_addnegative(FAR struct inode *mountpt,
+                           FAR const char *relpath, uint32_t generation);
+void namecache_invalidate(void);
+#endif
+
 /****************************************************************************
  * Name: inode_nextname
  *
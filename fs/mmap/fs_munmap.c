@@ -123,7 +123,7 @@ int munmap(FAR void *start, size_t length)
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
     {
-      errcode = ret;
+      errcode = -ret;
       goto errout;
     }
 
@@ -149,6 +149,26 @@ int munmap(FAR void *start, size_t length)
       goto errout_with_semaphore;
     }
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  /* If the region is shared with other mappers, then just drop this
+   * reference.  Only the last mapper can actually release the memory.
+   */
+
+  if (curr->crefs > 1)
+    {
+      if (start != curr->addr)
+        {
+          ferr("ERROR: Cannot partially unmap a shared region\n");
+          errcode = ENOSYS;
+          goto errout_with_semaphore;
+        }
+
+      curr->crefs--;
+      nxsem_post(&g_rammaps.exclsem);
+      return OK;
+    }
+#endif
+
   /* Get the offset from the beginning of the region and the actual number
    * of bytes to "unmap".  All mappings must extend to the end of the region.
    * There is no support for free a block of memory but leaving a block of
@@ -185,6 +205,15 @@ int munmap(FAR void *start, size_t length)
           g_rammaps.head = curr->flink;
         }
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+      /* Release the reference to the inode of the mapped file */
+
+      if (curr->inode != NULL)
+        {
+          inode_release(curr->inode);
+        }
+#endif
+
       /* Then free the region */
 
       kumm_free(curr);
@@ -199,6 +228,19 @@ int munmap(FAR void *start, size_t length)
       newaddr = kumm_realloc(curr->addr, sizeof(struct fs_rammap_s) + length);
       DEBUGASSERT(newaddr == (FAR void *)(curr->addr));
       curr->length = length;
+
+#ifdef CONFIG_FS_RAMMAP_SHARED
+      /* The region no longer holds the whole mapping, so it must not be
+       * shared with later mappers of the file.
+       */
+
+      if (curr->inode != NULL)
+        {
+          inode_release(curr->inode);
+          curr->inode  = NULL;
+          curr->fileid = 0;
+        }
+#endif
     }
 
   nxsem_post(&g_rammaps.exclsem);
@@ -48,6 +48,7 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/kmalloc.h>
 
 #include "inode/inode.h"
@@ -101,6 +102,7 @@ void rammap_initialize(void)
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The desired memory protection of the mapping
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -115,29 +117,88 @@ void rammap_initialize(void)
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset)
+FAR void *rammap(int fd, size_t length, off_t offset, int prot)
 {
   FAR struct fs_rammap_s *map;
   FAR uint8_t *alloc;
   FAR uint8_t *rdbuffer;
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  FAR struct file *filep;
+  FAR struct inode *inode;
+  uintptr_t fileid = 0;
+#endif
   ssize_t nread;
   off_t fpos;
   int errcode;
   int ret;
 
-  /* There is a major design flaw that I have not yet thought of fix for:
-   * The goal is to have a single region of memory that represents a single
-   * file and can be shared by many threads.  That is, given a filename a
-   * thread should be able to open the file, get a file descriptor, and
-   * call mmap() to get a memory region.  Different file descriptors opened
-   * with the same file path should get the same memory region when mapped.
-   *
-   * The design flaw is that I don't have sufficient knowledge to know that
-   * these different file descriptors map to the same file.  So, for the time
-   * being, a new memory region is created each time that rammap() is called.
-   * Not very useful!
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  /* The goal is to have a single region of memory that represents a single
+   * file and can be shared by many threads.  Files on a mounted volume all
+   * have the mountpoint inode, so a file is identified by that inode, the
+   * file ID returned by FIOC_FILEID, and the offset and length of the
+   * mapping.  Only file systems whose files never change (ROMFS, CROMFS)
+   * support FIOC_FILEID.  Nothing else is shared:  The content of a driver
+   * may change at any time (through ioctl(), the hardware, or because it
+   * is generated), and each writer must get its own copy.
    */
 
+  ret = fs_getfilep(fd, &filep);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  inode = filep->f_inode;
+  DEBUGASSERT(inode != NULL);
+
+  if ((prot & PROT_WRITE) != 0)
+    {
+      inode = NULL;
+    }
+  else if (INODE_IS_MOUNTPT(inode))
+    {
+      ret = file_ioctl(filep, FIOC_FILEID,
+                       (unsigned long)((uintptr_t)&fileid));
+      if (ret < 0)
+        {
+          inode = NULL;
+        }
+    }
+  else
+    {
+      inode = NULL;
+    }
+
+  /* Hold the list locked until the region is either found or loaded and
+   * added to the list.  Otherwise, two concurrent mappers of the same file
+   * could each load a copy.
+   */
+
+  rammap_initialize();
+  ret = nxsem_wait(&g_rammaps.exclsem);
+  if (ret < 0)
+    {
+      errcode = -ret;
+      goto errout;
+    }
+
+  for (map = g_rammaps.head; inode != NULL && map != NULL; map = map->flink)
+    {
+      if (map->inode == inode && map->fileid == fileid &&
+          map->offset == offset && map->length == length &&
+          map->crefs < UINT16_MAX)
+        {
+          /* Share the existing copy of the file */
+
+          map->crefs++;
+          nxsem_post(&g_rammaps.exclsem);
+          return map->addr;
+        }
+    }
+#endif
+
   /* Allocate a region of memory of the specified size */
 
   alloc = (FAR uint8_t *)kumm_malloc(sizeof(struct fs_rammap_s) + length);
@@ -145,6 +206,9 @@ FAR void *rammap(int fd, size_t length, off_t offset)
     {
       ferr("ERROR: Region allocation failed, length: %d\n", (int)length);
       errcode = ENOMEM;
+#ifdef CONFIG_FS_RAMMAP_SHARED
+      nxsem_post(&g_rammaps.exclsem);
+#endif
       goto errout;
     }
 
@@ -213,6 +277,21 @@ FAR void *rammap(int fd, size_t length, off_t offset)
 
   /* Add the buffer to the list of regions */
 
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  /* The region holds a reference to the inode so that the inode cannot be
+   * freed and its address reused by some other file while the region is
+   * still mapped.
+   */
+
+  if (inode != NULL)
+    {
+      inode_addref(inode);
+    }
+
+  map->inode  = inode;
+  map->fileid = fileid;
+  map->crefs  = 1;
+#else
   rammap_initialize();
   ret = nxsem_wait(&g_rammaps.exclsem);
   if (ret < 0)
@@ -220,6 +299,7 @@ FAR void *rammap(int fd, size_t length, off_t offset)
       errcode = -ret;
       goto errout_with_region;
     }
+#endif
 
   map->flink  = g_rammaps.head;
   g_rammaps.head = map;
@@ -228,6 +308,9 @@ FAR void *rammap(int fd, size_t length, off_t offset)
   return map->addr;
 
 errout_with_region:
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  nxsem_post(&g_rammaps.exclsem);
+#endif
   kumm_free(alloc);
 
 errout:
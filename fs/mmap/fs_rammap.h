@@ -45,6 +45,8 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #ifdef CONFIG_FS_RAMMAP
@@ -68,6 +70,9 @@
  * - All mapped files are read-only.  You can write to the in-memory image,
  *   but the file contents will not change.
  * - There are not access privileges.
+ *
+ * If CONFIG_FS_RAMMAP_SHARED is selected, then mappings of the same region
+ * of the same file share a single, reference counted copy in memory.
  */
 
 struct fs_rammap_s
@@ -76,6 +81,13 @@ struct fs_rammap_s
   FAR void           *addr;        /* Start of allocated memory */
   size_t              length;      /* Length of region */
   off_t               offset;      /* File offset */
+#ifdef CONFIG_FS_RAMMAP_SHARED
+  FAR struct inode   *inode;       /* Inode of the mapped file (NULL if the
+                                    * region is not shared) */
+  uintptr_t           fileid;      /* Identifies the file on a mounted
+                                    * volume (see FIOC_FILEID) */
+  uint16_t            crefs;       /* Number of mappers of the region */
+#endif
 };
 
 /* This structure defines all "mapped" files */
@@ -126,6 +138,7 @@ void rammap_initialize(void);
  *   length  The length of the mapping.  For exception #1 above, this length
  *           ignored:  The entire underlying media is always accessible.
  *   offset  The offset into the file to map
+ *   prot    The desired memory protection of the mapping
  *
  * Returned Value:
  *   On success, rammmap() returns a pointer to the mapped area. On error, the
@@ -140,7 +153,7 @@ void rammap_initialize(void);
  *
  ****************************************************************************/
 
-FAR void *rammap(int fd, size_t length, off_t offset);
+FAR void *rammap(int fd, size_t length, off_t offset, int prot);
 
 #endif /* CONFIG_FS_RAMMAP */
 #endif /* __FS_MMAP_RAMMAP_H */
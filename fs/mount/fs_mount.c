@@ -449,6 +449,12 @@ int mount(FAR const char *source, FAR const char *target,
   mountpt_inode->i_private = fshandle;
   inode_semgive();
 
+#ifdef CONFIG_FS_NAMECACHE
+  /* Forget anything known about a volume previously mounted here */
+
+  namecache_invalidate();
+#endif
+
   /* We can release our reference to the blkdrver_inode, if the filesystem
    * wants to retain the blockdriver inode (which it should), then it must
    * have called inode_addref().  There is one reference on mountpt_inode
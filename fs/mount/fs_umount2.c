@@ -152,6 +152,10 @@ int umount2(FAR const char *target, unsigned int flags)
   mountpt_inode->i_private = NULL;
   mountpt_inode->u.i_mops  = NULL;
 
+#ifdef CONFIG_FS_NAMECACHE
+  namecache_invalidate();
+#endif
+
 #ifndef CONFIG_DISABLE_PSEUDOFS_OPERATIONS
   /* If the node has children, then do not delete it. */
 
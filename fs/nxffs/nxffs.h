@@ -53,6 +53,10 @@
 #include <nuttx/mtd/mtd.h>
 #include <nuttx/fs/nxffs.h>
 
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -256,6 +260,18 @@ struct nxffs_blkentry_s
   uint16_t                  foffset;  /* Offset to start of data */
 };
 
+/* This structure describes one entry in the in-memory index of valid
+ * inodes on the volume.
+ */
+
+#ifdef CONFIG_NXFFS_INDEX
+struct nxffs_index_s
+{
+  off_t                     hoffset;   /* FLASH offset to the inode header */
+  uint32_t                  hash;      /* Hash of the inode name */
+};
+#endif
+
 /* This structure describes the state of one open file.  This structure
  * is protected by the volume semaphore.
  */
@@ -302,6 +318,16 @@ struct nxffs_volume_s
   FAR struct nxffs_ofile_s *ofiles;    /* A singly-linked list of open files */
   FAR uint8_t              *cache;     /* On cached erase block for general I/O */
   FAR uint8_t              *pack;      /* A full erase block to support packing */
+#ifdef CONFIG_NXFFS_INDEX
+  FAR struct nxffs_index_s *index;     /* Locations of the valid inodes */
+  uint16_t                  nindex;    /* Number of entries in the index */
+  uint16_t                  indexsize; /* Allocated size of the index */
+  bool                      indexvalid; /* The index describes the volume */
+#endif
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+  struct work_s             packwork;  /* Supports background packing */
+  bool                      packdirty; /* Inodes deleted since the last pack */
+#endif
 };
 
 /* This structure describes the state of the blocks on the NXFFS volume */
@@ -1082,6 +1108,109 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name);
 
 int nxffs_pack(FAR struct nxffs_volume_s *volume);
 
+/****************************************************************************
+ * Name: nxffs_pack_schedule
+ *
+ * Description:
+ *   Called after an inode has been written or deleted and when the last
+ *   open file is closed.  If inodes have been deleted and the free FLASH
+ *   region has dropped below the configured watermark, schedule
+ *   nxffs_pack() to run on the low priority work queue so that a later
+ *   writer does not have to pack the volume itself.
+ *
+ *   Nothing is scheduled while any file is open:  Open files hold the
+ *   FLASH offsets of their inodes, which packing would move.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_pack.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+void nxffs_pack_schedule(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_rebuild
+ *
+ * Description:
+ *   Build the in-memory index of valid inodes by scanning the volume from
+ *   the first valid inode.  This is done when the volume is initialized and
+ *   again on the first lookup after the volume has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned and the
+ *   index remains invalid.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_index_rebuild(FAR struct nxffs_volume_s *volume);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Use the index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the caller
+ *   must scan the volume.
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry);
+#endif
+
+/****************************************************************************
+ * Name: nxffs_index_add and nxffs_index_remove
+ *
+ * Description:
+ *   Keep the index in sync when an inode header is written or an inode is
+ *   deleted.  Nothing is done while the index is invalid.
+ *
+ * Input Parameters:
+ *   volume  - Describes the NXFFS volume
+ *   hoffset - FLASH offset to the inode header
+ *   name    - The name of the new inode
+ *
+ * Returned Value:
+ *   None
+ *
+ * Defined in nxffs_index.c
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_INDEX
+void nxffs_index_add(FAR struct nxffs_volume_s *volume, off_t hoffset,
+                     FAR const char *name);
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume, off_t hoffset);
+#  define nxffs_index_invalidate(v) ((v)->indexvalid = false)
+#else
+#  define nxffs_index_invalidate(v)
+#endif
+
 /****************************************************************************
  * Standard mountpoint operation methods
  *
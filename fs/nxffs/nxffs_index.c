@@ -0,0 +1,311 @@
+/****************************************************************************
+ * fs/nxffs/nxffs_index.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+
+#include "nxffs.h"
+
+#ifdef CONFIG_NXFFS_INDEX
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Number of index entries to add when the index must be extended */
+
+#define NXFFS_INDEX_INCR 16
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_namehash
+ *
+ * Description:
+ *   Return the FNV-1a hash of an inode name.
+ *
+ ****************************************************************************/
+
+static uint32_t nxffs_namehash(FAR const char *name)
+{
+  uint32_t hash = 2166136261u;
+
+  while (*name != '\0')
+    {
+      hash ^= (uint8_t)*name++;
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_append
+ *
+ * Description:
+ *   Append one entry to the index, extending the index if necessary.
+ *
+ ****************************************************************************/
+
+static int nxffs_index_append(FAR struct nxffs_volume_s *volume,
+                              off_t hoffset, FAR const char *name)
+{
+  FAR struct nxffs_index_s *index;
+
+  if (volume->nindex >= volume->indexsize)
+    {
+      if (volume->indexsize > UINT16_MAX - NXFFS_INDEX_INCR)
+        {
+          return -EFBIG;
+        }
+
+      index = (FAR struct nxffs_index_s *)
+        kmm_realloc(volume->index, (volume->indexsize + NXFFS_INDEX_INCR) *
+                    sizeof(struct nxffs_index_s));
+      if (index == NULL)
+        {
+          return -ENOMEM;
+        }
+
+      volume->index      = index;
+      volume->indexsize += NXFFS_INDEX_INCR;
+    }
+
+  index          = &volume->index[volume->nindex++];
+  index->hoffset = hoffset;
+  index->hash    = nxffs_namehash(name);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxffs_index_rebuild
+ *
+ * Description:
+ *   Build the in-memory index of valid inodes by scanning the volume from
+ *   the first valid inode.  This is done when the volume is initialized and
+ *   again on the first lookup after the volume has been packed.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *
+ * Returned Value:
+ *   Zero on success; Otherwise, a negated errno value is returned and the
+ *   index remains invalid.
+ *
+ ****************************************************************************/
+
+int nxffs_index_rebuild(FAR struct nxffs_volume_s *volume)
+{
+  struct nxffs_entry_s entry;
+  off_t offset;
+  int ret;
+
+  volume->indexvalid = false;
+  volume->nindex     = 0;
+
+  /* Visit each valid inode, just as nxffs_findinode() would */
+
+  offset = volume->inoffset;
+  for (; ; )
+    {
+      ret = nxffs_nextentry(volume, offset, &entry);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      ret    = nxffs_index_append(volume, entry.hoffset, entry.name);
+      offset = nxffs_inodeend(volume, &entry);
+      nxffs_freeentry(&entry);
+
+      if (ret < 0)
+        {
+          ferr("ERROR: Failed to extend the inode index: %d\n", -ret);
+          return ret;
+        }
+    }
+
+  /* -ENOENT means that the end of the inodes was reached */
+
+  if (ret != -ENOENT)
+    {
+      ferr("ERROR: Failed to index the volume: %d\n", -ret);
+      return ret;
+    }
+
+  finfo("Indexed %d inodes\n", volume->nindex);
+  volume->indexvalid = true;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_find
+ *
+ * Description:
+ *   Use the index to find the inode with the provided name.
+ *
+ * Input Parameters:
+ *   volume - Describes the NXFFS volume
+ *   name   - The name of the inode to find
+ *   entry  - The location to return information about the inode.
+ *
+ * Returned Value:
+ *   Zero is returned on success.  -ENOENT is returned if there is no such
+ *   inode.  -ENOSYS is returned if the index cannot be used and the caller
+ *   must scan the volume.
+ *
+ ****************************************************************************/
+
+int nxffs_index_find(FAR struct nxffs_volume_s *volume, FAR const char *name,
+                     FAR struct nxffs_entry_s *entry)
+{
+  uint32_t hash;
+  int ret;
+  int i;
+
+  if (!volume->indexvalid && nxffs_index_rebuild(volume) < 0)
+    {
+      return -ENOSYS;
+    }
+
+  hash = nxffs_namehash(name);
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hash != hash)
+        {
+          continue;
+        }
+
+      /* Read the inode header.  nxffs_nextentry() will begin with the
+       * header at exactly this offset if it is still valid.
+       */
+
+      ret = nxffs_nextentry(volume, volume->index[i].hoffset, entry);
+      if (ret == OK && entry->hoffset == volume->index[i].hoffset)
+        {
+          if (strcmp(name, entry->name) == 0)
+            {
+              return OK;
+            }
+
+          /* A hash collision */
+
+          nxffs_freeentry(entry);
+          continue;
+        }
+
+      /* The index is stale.  Drop it and let the caller scan the volume. */
+
+      ferr("ERROR: Stale index entry at offset %d\n",
+           volume->index[i].hoffset);
+
+      if (ret == OK)
+        {
+          nxffs_freeentry(entry);
+        }
+
+      volume->indexvalid = false;
+      return -ENOSYS;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: nxffs_index_add
+ *
+ * Description:
+ *   Add a newly written inode header to the index.
+ *
+ ****************************************************************************/
+
+void nxffs_index_add(FAR struct nxffs_volume_s *volume, off_t hoffset,
+                     FAR const char *name)
+{
+  if (volume->indexvalid && nxffs_index_append(volume, hoffset, name) < 0)
+    {
+      /* It will be rebuilt on the next lookup */
+
+      volume->indexvalid = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxffs_index_remove
+ *
+ * Description:
+ *   Remove a deleted inode from the index.
+ *
+ ****************************************************************************/
+
+void nxffs_index_remove(FAR struct nxffs_volume_s *volume, off_t hoffset)
+{
+  int i;
+
+  if (!volume->indexvalid)
+    {
+      return;
+    }
+
+  for (i = 0; i < volume->nindex; i++)
+    {
+      if (volume->index[i].hoffset == hoffset)
+        {
+          /* Order does not matter.  Replace it with the last entry. */
+
+          volume->index[i] = volume->index[--volume->nindex];
+          return;
+        }
+    }
+}
+
+#endif /* CONFIG_NXFFS_INDEX */
@@ -276,6 +276,11 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+#ifdef CONFIG_NXFFS_INDEX
+      /* A failure here is not fatal; the index is rebuilt on demand */
+
+      nxffs_index_rebuild(volume);
+#endif
       return OK;
     }
 
@@ -305,6 +310,11 @@ int nxffs_initialize(FAR struct mtd_dev_s *mtd)
   ret = nxffs_limits(volume);
   if (ret == OK)
     {
+#ifdef CONFIG_NXFFS_INDEX
+      /* A failure here is not fatal; the index is rebuilt on demand */
+
+      nxffs_index_rebuild(volume);
+#endif
       return OK;
     }
 
@@ -565,6 +575,27 @@ int nxffs_unbind(FAR void *handle, FAR struct inode **blkdriver,
       return -ENOSYS;
     }
 
-  return g_volume.ofiles ? -EBUSY : OK;
+  if (g_volume.ofiles)
+    {
+      return -EBUSY;
+    }
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+  work_cancel(LPWORK, &g_volume.packwork);
+#endif
+
+#ifdef CONFIG_NXFFS_INDEX
+  if (g_volume.index != NULL)
+    {
+      kmm_free(g_volume.index);
+      g_volume.index = NULL;
+    }
+
+  g_volume.nindex     = 0;
+  g_volume.indexsize  = 0;
+  g_volume.indexvalid = false;
+#endif
+
+  return OK;
 #endif
 }
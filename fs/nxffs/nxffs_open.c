@@ -903,6 +903,15 @@ static inline int nxffs_wrclose(FAR struct nxffs_volume_s *volume,
 
   ret = nxffs_wrinode(volume, &wrfile->ofile.entry);
 
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+  /* The new file may have pushed the free FLASH below the watermark */
+
+  if (ret == OK)
+    {
+      nxffs_pack_schedule(volume);
+    }
+#endif
+
   /* The volume is now available for other writers */
 
 errout:
@@ -1172,6 +1181,15 @@ int nxffs_close(FAR struct file *filep)
       /* Release all resouces held by the open file */
 
       nxffs_freeofile(volume, ofile);
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+      /* Packing was deferred while files were open */
+
+      if (volume->ofiles == NULL)
+        {
+          nxffs_pack_schedule(volume);
+        }
+#endif
     }
   else
     {
@@ -1268,6 +1286,12 @@ int nxffs_wrinode(FAR struct nxffs_volume_s *volume,
       ferr("ERROR: Failed to write inode header block %d: %d\n",
            volume->ioblock, -ret);
     }
+#ifdef CONFIG_NXFFS_INDEX
+  else
+    {
+      nxffs_index_add(volume, entry->hoffset, entry->name);
+    }
+#endif
 
   /* The volume is now available for other writers */
 
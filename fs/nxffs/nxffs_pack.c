@@ -49,6 +49,11 @@
 
 #include <nuttx/kmalloc.h>
 
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+#  include <nuttx/clock.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #include "nxffs.h"
 
 /****************************************************************************
@@ -1243,6 +1248,73 @@ static inline int nxffs_packwriter(FAR struct nxffs_volume_s *volume,
   return -ENOSYS;
 }
 
+/****************************************************************************
+ * Name: nxffs_pack_needed
+ *
+ * Description:
+ *   Return true if inodes have been deleted since the last pack and the
+ *   free FLASH region is below the configured watermark.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+static bool nxffs_pack_needed(FAR struct nxffs_volume_s *volume)
+{
+  off_t volsize = volume->nblocks * volume->geo.blocksize;
+  off_t avail   = volsize - volume->froffset;
+
+  return volume->packdirty &&
+         avail < (volsize / 100) * CONFIG_NXFFS_PACK_WATERMARK;
+}
+#endif
+
+/****************************************************************************
+ * Name: nxffs_pack_worker
+ *
+ * Description:
+ *   Packs the volume on the low priority work queue, exactly as the
+ *   FIOC_OPTIMIZE ioctl would, provided that no file is open.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+static void nxffs_pack_worker(FAR void *arg)
+{
+  FAR struct nxffs_volume_s *volume = (FAR struct nxffs_volume_s *)arg;
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&volume->exclsem);
+    }
+  while (ret == -EINTR);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: nxsem_wait failed: %d\n", ret);
+      return;
+    }
+
+  /* A writer may already have packed the volume while we were waiting.
+   * Don't move inodes if a file was opened in the meantime; the pack will
+   * be scheduled again when the last file is closed.
+   */
+
+  if (volume->ofiles == NULL && nxffs_pack_needed(volume))
+    {
+      finfo("Background pack, froffset: %d\n", volume->froffset);
+
+      ret = nxffs_pack(volume);
+      if (ret < 0)
+        {
+          ferr("ERROR: nxffs_pack failed: %d\n", ret);
+        }
+    }
+
+  nxsem_post(&volume->exclsem);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1274,6 +1346,13 @@ int nxffs_pack(FAR struct nxffs_volume_s *volume)
   int i;
   int ret = OK;
 
+  /* Inode headers are about to move */
+
+  nxffs_index_invalidate(volume);
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+  volume->packdirty = false;
+#endif
+
   /* Get the offset to the first valid inode entry */
 
   wrfile = NULL;
@@ -1601,3 +1680,36 @@ errout_with_pack:
   nxffs_freeentry(&pack.dest.entry);
   return ret;
 }
+
+/****************************************************************************
+ * Name: nxffs_pack_schedule
+ *
+ * Description:
+ *   Called after an inode has been written or deleted and when the last
+ *   open file is closed.  If inodes have been deleted and the free FLASH
+ *   region has dropped below the configured watermark, schedule
+ *   nxffs_pack() to run on the low priority work queue so that a later
+ *   writer does not have to pack the volume itself.
+ *
+ *   Nothing is scheduled while any file is open:  Open files hold the
+ *   FLASH offsets of their inodes, which packing would move.
+ *
+ * Input Parameters:
+ *   volume - The volume to be packed.
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+void nxffs_pack_schedule(FAR struct nxffs_volume_s *volume)
+{
+  if (volume->ofiles == NULL && nxffs_pack_needed(volume) &&
+      work_available(&volume->packwork))
+    {
+      work_queue(LPWORK, &volume->packwork, nxffs_pack_worker, volume,
+                 MSEC2TICK(CONFIG_NXFFS_PACK_DELAY));
+    }
+}
+#endif
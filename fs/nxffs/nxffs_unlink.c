@@ -129,8 +129,21 @@ int nxffs_rminode(FAR struct nxffs_volume_s *volume, FAR const char *name)
     {
       ferr("ERROR: Failed to write block %d: %d\n",
            volume->ioblock, ret);
+      nxffs_index_invalidate(volume);
+      goto errout_with_entry;
     }
 
+#ifdef CONFIG_NXFFS_INDEX
+  nxffs_index_remove(volume, entry.hoffset);
+#endif
+
+#ifdef CONFIG_NXFFS_PACK_BACKGROUND
+  /* The deleted inode leaves space that a background pack could reclaim */
+
+  volume->packdirty = true;
+  nxffs_pack_schedule(volume);
+#endif
+
 errout_with_entry:
   nxffs_freeentry(&entry);
 errout:
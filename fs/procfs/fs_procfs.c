@@ -81,6 +81,7 @@ extern const struct procfs_operations irq_operations;
 extern const struct procfs_operations cpuload_operations;
 extern const struct procfs_operations meminfo_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations binfmt_procfsoperations;
 extern const struct procfs_operations uptime_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -95,6 +96,8 @@ extern const struct procfs_operations mtd_procfsoperations;
 extern const struct procfs_operations part_procfsoperations;
 extern const struct procfs_operations mount_procfsoperations;
 extern const struct procfs_operations smartfs_procfsoperations;
+extern const struct procfs_operations bcache_procfsoperations;
+extern const struct procfs_operations spiffs_procfsoperations;
 
 /* And even worse, this one is specific to the STM32.  The solution to
  * this nasty couple would be to replace this hard-coded, ROM-able
@@ -121,6 +124,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "[0-9]*",        &proc_operations,            PROCFS_DIR_TYPE    },
 #endif
 
+#if defined(CONFIG_BINFMT_CACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BINFMT)
+  { "binfmt",        &binfmt_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_SCHED_CPULOAD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_CPULOAD)
   { "cpuload",       &cpuload_operations,         PROCFS_FILE_TYPE   },
 #endif
@@ -137,6 +144,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "modules",       &module_operations,          PROCFS_FILE_TYPE   },
 #endif
 
+#if defined(CONFIG_BCACHE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_BCACHE)
+  { "fs/bcache",     &bcache_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #ifndef CONFIG_FS_PROCFS_EXCLUDE_BLOCKS
   { "fs/blocks",     &mount_procfsoperations,     PROCFS_FILE_TYPE   },
 #endif
@@ -153,6 +164,10 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "fs/smartfs**",  &smartfs_procfsoperations,   PROCFS_UNKOWN_TYPE },
 #endif
 
+#if defined(CONFIG_FS_SPIFFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+  { "fs/spiffs",     &spiffs_procfsoperations,    PROCFS_FILE_TYPE   },
+#endif
+
 #if defined(CONFIG_MTD) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MTD)
   { "mtd",           &mtd_procfsoperations,       PROCFS_FILE_TYPE   },
 #endif
@@ -978,11 +978,12 @@ static ssize_t proc_groupfd(FAR struct proc_file_s *procfile,
 
   /* Examine each open file descriptor */
 
-  for (i = 0, file = group->tg_filelist.fl_files; i < CONFIG_NFILE_DESCRIPTORS; i++, file++)
+  for (i = 0; i < CONFIG_NFILE_DESCRIPTORS; i++)
     {
       /* Is there an inode associated with the file descriptor? */
 
-      if (file->f_inode)
+      file = files_getfile(&group->tg_filelist, i);
+      if (file != NULL && file->f_inode)
         {
           linesize   = snprintf(procfile->line, STATUS_LINELEN, "%3d %8ld %04x\n",
                                 i, (long)file->f_pos, file->f_oflags);
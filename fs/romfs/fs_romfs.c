@@ -583,6 +583,7 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   FAR struct romfs_mountpt_s *rm;
   FAR struct romfs_file_s    *rf;
   FAR void                  **ppv = (FAR void**)arg;
+  FAR uintptr_t              *pid = (FAR uintptr_t *)arg;
 
   finfo("cmd: %d arg: %08lx\n", cmd, arg);
 
@@ -597,8 +598,6 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 
   DEBUGASSERT(rm != NULL);
 
-  /* Only one ioctl command is supported */
-
   if (cmd == FIOC_MMAP && rm->rm_xipbase && ppv)
     {
       /* Return the address on the media corresponding to the start of
@@ -609,6 +608,16 @@ static int romfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
       return OK;
     }
 
+  if (cmd == FIOC_FILEID && pid)
+    {
+      /* The offset to the file data identifies the file on the volume.
+       * Hard links to the same file share the same data.
+       */
+
+      *pid = (uintptr_t)rf->rf_startoffset;
+      return OK;
+    }
+
   ferr("ERROR: Invalid cmd: %d \n", cmd);
   return -ENOTTY;
 }
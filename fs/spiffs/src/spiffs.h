@@ -60,6 +60,10 @@ extern "C"
 #include <nuttx/semaphore.h>
 #include <nuttx/mtd/mtd.h>
 
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+#  include <nuttx/wqueue.h>
+#endif
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
@@ -72,6 +76,15 @@ extern "C"
 
 #define SPIFFS_NO_HOLDER                ((pid_t)-1)
 
+/* Statistics are reported in /proc/fs/spiffs */
+
+#if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SPIFFS)
+#  define SPIFFS_HAVE_PROCFS 1
+#endif
+
+#define spiffs_lock_volume(fs)          (spiffs_lock_reentrant(&fs->exclsem))
+#define spiffs_unlock_volume(fs)        (spiffs_unlock_reentrant(&fs->exclsem))
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -146,6 +159,20 @@ struct spiffs_s
   uint32_t deleted_pages;           /* Current number of deleted pages */
 #ifdef CONFIG_SPIFFS_GCDBG
   uint32_t stats_gc_runs;
+#endif
+  uint32_t stats_erases;            /* Number of blocks erased */
+  uint32_t stats_pages_written;     /* Number of pages programmed */
+  uint32_t stats_pages_moved;       /* Pages relocated by garbage collection */
+  uint32_t stats_gc_steps;          /* Blocks reclaimed by garbage collection */
+#ifdef SPIFFS_HAVE_PROCFS
+  FAR struct spiffs_s *flink;       /* Supports a list of mounted volumes */
+  FAR const char *mtdname;          /* Name of the MTD inode */
+  FAR uint16_t *erase_counts;       /* Erases of each block since mount */
+#endif
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+  struct work_s gc_work;            /* Supports background garbage collection */
+  bool gc_pending;                  /* Background collection is scheduled */
+  bool gc_stop;                     /* Volume is being unmounted */
 #endif
   uint32_t cache_size;              /* Cache size */
 #ifdef CONFIG_SPIFFS_CACHEDBG
@@ -183,6 +210,32 @@ struct spiffs_file_s
 
 struct stat;  /* Foward reference */
 
+/****************************************************************************
+ * Name: spiffs_lock_reentrant and spiffs_unlock_reentrant
+ *
+ * Description:
+ *   Take or give the re-entrant volume semaphore.  Normally used through
+ *   spiffs_lock_volume() and spiffs_unlock_volume().
+ *
+ ****************************************************************************/
+
+void spiffs_lock_reentrant(FAR struct spiffs_sem_s *rsem);
+void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *rsem);
+
+/****************************************************************************
+ * Name: spiffs_procfs_register and spiffs_procfs_unregister
+ *
+ * Description:
+ *   Add a mounted volume to, or remove it from, the list of volumes that
+ *   are reported in /proc/fs/spiffs.
+ *
+ ****************************************************************************/
+
+#ifdef SPIFFS_HAVE_PROCFS
+void spiffs_procfs_register(FAR struct spiffs_s *fs);
+void spiffs_procfs_unregister(FAR struct spiffs_s *fs);
+#endif
+
 /****************************************************************************
  * Name: spiffs_stat_pgndx
  *
@@ -762,6 +762,14 @@ int spiffs_erase_block(FAR struct spiffs_s *fs, int16_t blkndx)
     }
 
   fs->free_blocks++;
+  fs->stats_erases++;
+
+#ifdef SPIFFS_HAVE_PROCFS
+  if (fs->erase_counts != NULL && fs->erase_counts[blkndx] < UINT16_MAX)
+    {
+      fs->erase_counts[blkndx]++;
+    }
+#endif
 
   /* Register erase count for this block */
 
@@ -1084,6 +1092,7 @@ int spiffs_page_allocate_data(FAR struct spiffs_s *fs, int16_t objid,
     }
 
   fs->alloc_pages++;
+  fs->stats_pages_written++;
 
   /* Write page header */
 
@@ -1227,6 +1236,7 @@ int spiffs_page_move(FAR struct spiffs_s *fs,
     }
 
   fs->alloc_pages++;
+  fs->stats_pages_written++;
 
   if (was_final)
     {
@@ -1365,6 +1375,7 @@ int spiffs_fobj_create(FAR struct spiffs_s *fs,
     }
 
   fs->alloc_pages++;
+  fs->stats_pages_written++;
 
   /* Write empty object index page */
 
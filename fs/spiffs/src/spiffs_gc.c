@@ -48,8 +48,15 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include <errno.h>
 #include <debug.h>
 
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+#  include <nuttx/clock.h>
+#  include <nuttx/signal.h>
+#  include <nuttx/wqueue.h>
+#endif
+
 #include "spiffs.h"
 #include "spiffs_core.h"
 #include "spiffs_cache.h"
@@ -943,6 +950,125 @@ static int spiffs_gc_clean(FAR struct spiffs_s *fs, int16_t blkndx)
   return ret;
 }
 
+/****************************************************************************
+ * Name: spiffs_gc_reclaim
+ *
+ * Description:
+ *   Perform one bounded step of garbage collection:  Select the best
+ *   candidate block, move its live pages elsewhere and erase it.
+ *
+ * Input Parameters:
+ *   fs         - A reference to the SPIFFS volume object instance
+ *   fs_crammed - True: Filesystem is full, ignore block age
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; A negated errno value is returned on
+ *   any failure.  -ENODATA is returned if there was no candidate block.
+ *
+ ****************************************************************************/
+
+static int spiffs_gc_reclaim(FAR struct spiffs_s *fs, bool fs_crammed)
+{
+  FAR int16_t *cands;
+  uint32_t written;
+  int16_t cand;
+  int count;
+  int ret;
+
+  ret = spiffs_gc_find_candidate(fs, &cands, &count, fs_crammed);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_find_candidate() failed: %d\n", ret);
+      return ret;
+    }
+
+  if (count == 0)
+    {
+      return -ENODATA;
+    }
+
+#ifdef CONFIG_SPIFFS_GCDBG
+  fs->stats_gc_runs++;
+#endif
+  cand = cands[0];
+
+  /* Every page programmed while cleaning is a relocated live page */
+
+  written = fs->stats_pages_written;
+  ret = spiffs_gc_clean(fs, cand);
+  fs->stats_pages_moved += fs->stats_pages_written - written;
+
+  spiffs_gcinfo("Cleaning block %d, result=%d\n", cand, ret);
+
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_epage_stats(fs, cand);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
+      return ret;
+    }
+
+  ret = spiffs_gc_erase_block(fs, cand);
+  if (ret < 0)
+    {
+      ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
+      return ret;
+    }
+
+  fs->stats_gc_steps++;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_gc_worker
+ *
+ * Description:
+ *   Performs background garbage collection on the low priority work queue,
+ *   one block per invocation, until the number of free blocks reaches the
+ *   watermark or there is nothing left to reclaim.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+static void spiffs_gc_worker(FAR void *arg)
+{
+  FAR struct spiffs_s *fs = (FAR struct spiffs_s *)arg;
+  int ret;
+
+  spiffs_lock_volume(fs);
+
+  if (!fs->gc_stop && fs->deleted_pages > 0 &&
+      fs->free_blocks < CONFIG_SPIFFS_GC_WATERMARK)
+    {
+      spiffs_gcinfo("Background gc free_blocks=%d pdele=%d\n",
+                    fs->free_blocks, fs->deleted_pages);
+
+      ret = spiffs_gc_reclaim(fs, false);
+      if (ret >= 0 && fs->deleted_pages > 0 &&
+          fs->free_blocks < CONFIG_SPIFFS_GC_WATERMARK)
+        {
+          /* Give the writers a chance to run before the next step */
+
+          ret = work_queue(LPWORK, &fs->gc_work, spiffs_gc_worker, fs,
+                           MSEC2TICK(CONFIG_SPIFFS_GC_INTERVAL));
+          if (ret >= 0)
+            {
+              spiffs_unlock_volume(fs);
+              return;
+            }
+        }
+    }
+
+  fs->gc_pending = false;
+  spiffs_unlock_volume(fs);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1109,6 +1235,12 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
   int tries = 0;
   int ret;
 
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+  /* Let the background collector keep ahead of the writers */
+
+  spiffs_gc_schedule(fs);
+#endif
+
   /* Get the number of free pages */
 
   free_pages = (SPIFFS_GEO_PAGES_PER_BLOCK(fs) -
@@ -1151,9 +1283,6 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 
   do
     {
-      FAR int16_t *cands;
-      int count;
-      int16_t cand;
       int32_t prev_free_pages = free_pages;
 
       spiffs_gcinfo("#%d: run gc free_blocks=%d pfree=%d pallo=%d pdele=%d [%d] len=%d of %d\n",
@@ -1166,45 +1295,14 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
        * of a bad state
        */
 
-      ret = spiffs_gc_find_candidate(fs, &cands, &count, free_pages <= 0);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_find_candidate() failed: %d\n", ret);
-          return ret;
-        }
-
-      if (count == 0)
+      ret = spiffs_gc_reclaim(fs, free_pages <= 0);
+      if (ret == -ENODATA)
         {
           spiffs_gcinfo("No candidates, return\n");
           return (int32_t) needed_pages < free_pages ? OK : -ENOSPC;
         }
-
-#ifdef CONFIG_SPIFFS_GCDBG
-      fs->stats_gc_runs++;
-#endif
-      cand = cands[0];
-
-      ret = spiffs_gc_clean(fs, cand);
-
-      spiffs_gcinfo("Cleaning block %d, result=%d\n", cand, ret);
-
-      if (ret < 0)
+      else if (ret < 0)
         {
-          ferr("ERROR: spiffs_gc_clean() failed: %d\n", ret);
-          return ret;
-        }
-
-      ret = spiffs_gc_epage_stats(fs, cand);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_epage_stats() failed: %d\n", ret);
-          return ret;
-        }
-
-      ret = spiffs_gc_erase_block(fs, cand);
-      if (ret < 0)
-        {
-          ferr("ERROR: spiffs_gc_erase_block() failed: %d\n", ret);
           return ret;
         }
 
@@ -1243,3 +1341,77 @@ int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len)
 
   return ret;
 }
+
+/****************************************************************************
+ * Name: spiffs_gc_schedule
+ *
+ * Description:
+ *   Schedule background garbage collection if the number of free blocks
+ *   has fallen below CONFIG_SPIFFS_GC_WATERMARK and there are deleted
+ *   pages to reclaim.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+void spiffs_gc_schedule(FAR struct spiffs_s *fs)
+{
+  if (!fs->gc_pending && !fs->gc_stop && fs->deleted_pages > 0 &&
+      fs->free_blocks < CONFIG_SPIFFS_GC_WATERMARK)
+    {
+      if (work_queue(LPWORK, &fs->gc_work, spiffs_gc_worker, fs, 0) >= 0)
+        {
+          fs->gc_pending = true;
+        }
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: spiffs_gc_cancel
+ *
+ * Description:
+ *   Stop background garbage collection on a volume that is being unmounted
+ *   and wait for any step in progress to complete.
+ *
+ * Input Parameters:
+ *   fs - A reference to the SPIFFS volume object instance
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The caller holds the volume lock exactly once.  The lock is released
+ *   while waiting.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+void spiffs_gc_cancel(FAR struct spiffs_s *fs)
+{
+  fs->gc_stop = true;
+  if (fs->gc_pending && work_cancel(LPWORK, &fs->gc_work) >= 0)
+    {
+      fs->gc_pending = false;
+    }
+
+  /* The worker may already be waiting for the volume lock.  It will see
+   * gc_stop and clear gc_pending.
+   */
+
+  while (fs->gc_pending)
+    {
+      spiffs_unlock_volume(fs);
+      (void)nxsig_usleep(10 * 1000);
+      spiffs_lock_volume(fs);
+    }
+}
+#endif
@@ -126,6 +126,33 @@ int spiffs_gc_quick(FAR struct spiffs_s *fs, uint16_t max_free_pages);
 
 int spiffs_gc_check(FAR struct spiffs_s *fs, off_t len);
 
+/****************************************************************************
+ * Name: spiffs_gc_schedule
+ *
+ * Description:
+ *   Schedule background garbage collection if the number of free blocks
+ *   has fallen below CONFIG_SPIFFS_GC_WATERMARK.  The caller must hold the
+ *   volume lock.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+void spiffs_gc_schedule(FAR struct spiffs_s *fs);
+#endif
+
+/****************************************************************************
+ * Name: spiffs_gc_cancel
+ *
+ * Description:
+ *   Stop background garbage collection and wait for any step in progress
+ *   to complete.  The caller must hold the volume lock (once).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+void spiffs_gc_cancel(FAR struct spiffs_s *fs);
+#endif
+
 #if defined(__cplusplus)
 }
 #endif
@@ -0,0 +1,485 @@
+/****************************************************************************
+ * fs/spiffs/src/spiffs_procfs.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <semaphore.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "spiffs.h"
+#include "spiffs_core.h"
+
+#ifdef SPIFFS_HAVE_PROCFS
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SPIFFS_LINELEN     96
+
+/* Number of block erase counts shown on each line */
+
+#define SPIFFS_PERLINE     8
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct spiffs_procfile_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  char line[SPIFFS_LINELEN];      /* Pre-allocated buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     spiffs_procfs_open(FAR struct file *filep,
+                 FAR const char *relpath, int oflags, mode_t mode);
+static int     spiffs_procfs_close(FAR struct file *filep);
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     spiffs_procfs_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     spiffs_procfs_stat(FAR const char *relpath,
+                 FAR struct stat *buf);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The list of mounted volumes and the semaphore that protects it */
+
+static FAR struct spiffs_s *g_spiffs_volumes;
+static sem_t g_spiffs_volsem = SEM_INITIALIZER(1);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_procfs.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations spiffs_procfsoperations =
+{
+  spiffs_procfs_open,   /* open */
+  spiffs_procfs_close,  /* close */
+  spiffs_procfs_read,   /* read */
+  NULL,                 /* write */
+  spiffs_procfs_dup,    /* dup */
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+  spiffs_procfs_stat    /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_volsem_take
+ ****************************************************************************/
+
+static void spiffs_volsem_take(void)
+{
+  int ret;
+
+  do
+    {
+      ret = nxsem_wait(&g_spiffs_volsem);
+      DEBUGASSERT(ret == OK || ret == -EINTR);
+    }
+  while (ret == -EINTR);
+}
+
+/****************************************************************************
+ * Name: spiffs_volsem_give
+ ****************************************************************************/
+
+#define spiffs_volsem_give() nxsem_post(&g_spiffs_volsem)
+
+/****************************************************************************
+ * Name: spiffs_procfs_open
+ ****************************************************************************/
+
+static int spiffs_procfs_open(FAR struct file *filep,
+                              FAR const char *relpath, int oflags,
+                              mode_t mode)
+{
+  FAR struct spiffs_procfile_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct spiffs_procfile_s *)
+    kmm_zalloc(sizeof(struct spiffs_procfile_s));
+  if (procfile == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_close
+ ****************************************************************************/
+
+static int spiffs_procfs_close(FAR struct file *filep)
+{
+  FAR struct spiffs_procfile_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct spiffs_procfile_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_volume
+ *
+ * Description:
+ *   Generate the report for one volume.  The whole report is regenerated on
+ *   each read and the lines before the file position are skipped by
+ *   procfs_memcpy().
+ *
+ ****************************************************************************/
+
+static size_t spiffs_procfs_volume(FAR struct spiffs_procfile_s *procfile,
+                                   FAR struct spiffs_s *fs,
+                                   FAR char *buffer, size_t buflen,
+                                   FAR off_t *offset)
+{
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  uint32_t amplification;
+  int blkndx;
+  int i;
+
+  spiffs_lock_volume(fs);
+
+  /* Write amplification is the ratio of all programmed pages to the pages
+   * programmed on behalf of the users, in hundredths.
+   */
+
+  amplification = 100;
+  if (fs->stats_pages_written > fs->stats_pages_moved)
+    {
+      amplification = (uint32_t)
+        (((uint64_t)fs->stats_pages_written * 100) /
+         (fs->stats_pages_written - fs->stats_pages_moved));
+    }
+
+  linesize  = snprintf(procfile->line, SPIFFS_LINELEN,
+                       "%s:\n"
+                       "  Blocks: %u free: %lu Pages: alloc %lu deleted %lu\n",
+                       fs->mtdname, (unsigned int)SPIFFS_GEO_BLOCK_COUNT(fs),
+                       (unsigned long)fs->free_blocks,
+                       (unsigned long)fs->alloc_pages,
+                       (unsigned long)fs->deleted_pages);
+  if (linesize >= SPIFFS_LINELEN)
+    {
+      linesize = SPIFFS_LINELEN - 1;
+    }
+
+  copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen, offset);
+  totalsize = copysize;
+
+  if (totalsize < buflen)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = snprintf(procfile->line, SPIFFS_LINELEN,
+                           "  Erases: %lu GC: %lu Written: %lu Moved: %lu "
+                           "WA: %lu.%02lu\n",
+                           (unsigned long)fs->stats_erases,
+                           (unsigned long)fs->stats_gc_steps,
+                           (unsigned long)fs->stats_pages_written,
+                           (unsigned long)fs->stats_pages_moved,
+                           (unsigned long)(amplification / 100),
+                           (unsigned long)(amplification % 100));
+      if (linesize >= SPIFFS_LINELEN)
+        {
+          linesize = SPIFFS_LINELEN - 1;
+        }
+
+      copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                offset);
+      totalsize += copysize;
+    }
+
+  /* Followed by the erase counts of each block since mount */
+
+  for (blkndx = 0;
+       fs->erase_counts != NULL && totalsize < buflen &&
+       blkndx < SPIFFS_GEO_BLOCK_COUNT(fs);
+       blkndx += SPIFFS_PERLINE)
+    {
+      buffer   += copysize;
+      buflen   -= copysize;
+
+      linesize  = snprintf(procfile->line, SPIFFS_LINELEN, "  %04x:",
+                           blkndx);
+      for (i = blkndx;
+           i < blkndx + SPIFFS_PERLINE && i < SPIFFS_GEO_BLOCK_COUNT(fs) &&
+           linesize < SPIFFS_LINELEN - 1;
+           i++)
+        {
+          linesize += snprintf(&procfile->line[linesize],
+                               SPIFFS_LINELEN - linesize, " %5u",
+                               fs->erase_counts[i]);
+        }
+
+      /* Leave room for the newline if the line was truncated */
+
+      if (linesize > SPIFFS_LINELEN - 2)
+        {
+          linesize = SPIFFS_LINELEN - 2;
+        }
+
+      procfile->line[linesize++] = '\n';
+
+      copysize  = procfs_memcpy(procfile->line, linesize, buffer, buflen,
+                                offset);
+      totalsize += copysize;
+    }
+
+  spiffs_unlock_volume(fs);
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_read
+ ****************************************************************************/
+
+static ssize_t spiffs_procfs_read(FAR struct file *filep, FAR char *buffer,
+                                  size_t buflen)
+{
+  FAR struct spiffs_procfile_s *procfile;
+  FAR struct spiffs_s *fs;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+  offset = filep->f_pos;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct spiffs_procfile_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Generate the report for each mounted volume */
+
+  totalsize = 0;
+
+  spiffs_volsem_take();
+  for (fs = g_spiffs_volumes; fs != NULL && totalsize < buflen;
+       fs = fs->flink)
+    {
+      copysize   = spiffs_procfs_volume(procfile, fs, buffer, buflen,
+                                        &offset);
+      buffer    += copysize;
+      buflen    -= copysize;
+      totalsize += copysize;
+    }
+
+  spiffs_volsem_give();
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int spiffs_procfs_dup(FAR const struct file *oldp,
+                             FAR struct file *newp)
+{
+  FAR struct spiffs_procfile_s *oldattr;
+  FAR struct spiffs_procfile_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct spiffs_procfile_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct spiffs_procfile_s *)
+    kmm_malloc(sizeof(struct spiffs_procfile_s));
+  if (newattr == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct spiffs_procfile_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int spiffs_procfs_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_procfs_register
+ *
+ * Description:
+ *   Add a mounted volume to the list of volumes reported in
+ *   /proc/fs/spiffs.
+ *
+ ****************************************************************************/
+
+void spiffs_procfs_register(FAR struct spiffs_s *fs)
+{
+  spiffs_volsem_take();
+  fs->flink        = g_spiffs_volumes;
+  g_spiffs_volumes = fs;
+  spiffs_volsem_give();
+}
+
+/****************************************************************************
+ * Name: spiffs_procfs_unregister
+ *
+ * Description:
+ *   Remove a volume from the list of volumes reported in /proc/fs/spiffs.
+ *
+ ****************************************************************************/
+
+void spiffs_procfs_unregister(FAR struct spiffs_s *fs)
+{
+  FAR struct spiffs_s **pprev;
+
+  spiffs_volsem_take();
+  for (pprev = &g_spiffs_volumes; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == fs)
+        {
+          *pprev = fs->flink;
+          break;
+        }
+    }
+
+  spiffs_volsem_give();
+}
+
+#endif /* SPIFFS_HAVE_PROCFS */
@@ -68,22 +68,10 @@
 #include "spiffs_gc.h"
 #include "spiffs_check.h"
 
-/****************************************************************************
- * Pre-processor Definitions
- ****************************************************************************/
-
-#define spiffs_lock_volume(fs)       (spiffs_lock_reentrant(&fs->exclsem))
-#define spiffs_unlock_volume(fs)     (spiffs_unlock_reentrant(&fs->exclsem))
-
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
 
-/* SPIFFS helpers */
-
-static void spiffs_lock_reentrant(FAR struct spiffs_sem_s *sem);
-static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *sem);
-
 /* File system operations */
 
 static int  spiffs_open(FAR struct file *filep, FAR const char *relpath,
@@ -172,77 +160,6 @@ static inline int spiffs_map_errno(int errcode)
   return errcode < SPIFFS_ERR_INTERNAL ? -EFTYPE : errcode;
 }
 
-/****************************************************************************
- * Name: spiffs_lock_reentrant
- ****************************************************************************/
-
-static void spiffs_lock_reentrant(FAR struct spiffs_sem_s *rsem)
-{
-  pid_t me;
-
-  /* Do we already hold the semaphore? */
-
-  me = getpid();
-  if (me == rsem->holder)
-    {
-      /* Yes... just increment the count */
-
-      rsem->count++;
-      DEBUGASSERT(rsem->count > 0);
-    }
-
-  /* Take the semaphore (perhaps waiting) */
-
-  else
-    {
-      int ret;
-
-      do
-        {
-          ret = nxsem_wait(&rsem->sem);
-
-          /* The only case that an error should occur here is if the wait
-           * was awakened by a signal.
-           */
-
-          DEBUGASSERT(ret >= 0 || ret == -EINTR);
-        }
-      while (ret == -EINTR);
-
-      /* No we hold the semaphore */
-
-      rsem->holder = me;
-      rsem->count  = 1;
-    }
-}
-
-/****************************************************************************
- * Name: spiffs_unlock_reentrant
- ****************************************************************************/
-
-static void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *rsem)
-{
-  DEBUGASSERT(rsem->holder == getpid());
-
-  /* Is this our last count on the semaphore? */
-
-  if (rsem->count > 1)
-    {
-      /* No.. just decrement the count */
-
-      rsem->count--;
-    }
-
-  /* Yes.. then we can really release the semaphore */
-
-  else
-    {
-      rsem->holder = SPIFFS_NO_HOLDER;
-      rsem->count  = 0;
-      nxsem_post(&rsem->sem);
-    }
-}
-
 /****************************************************************************
  * Name: spiffs_readdir_callback
  ****************************************************************************/
@@ -1477,6 +1394,17 @@ static int spiffs_bind(FAR struct inode *mtdinode, FAR const void *data,
     }
 #endif
 
+#ifdef SPIFFS_HAVE_PROCFS
+  /* Make the volume statistics visible in /proc/fs/spiffs.  The per-block
+   * erase counts are optional.
+   */
+
+  fs->mtdname      = mtdinode->i_name;
+  fs->erase_counts = (FAR uint16_t *)
+    kmm_zalloc(SPIFFS_GEO_BLOCK_COUNT(fs) * sizeof(uint16_t));
+  spiffs_procfs_register(fs);
+#endif
+
   /* Return the new file system handle */
 
   *handle = (FAR void *)fs;
@@ -1508,6 +1436,12 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
         handle, mtdinode, flags);
   DEBUGASSERT(fs != NULL);
 
+#ifdef SPIFFS_HAVE_PROCFS
+  /* Remove the volume from /proc/fs/spiffs before locking it */
+
+  spiffs_procfs_unregister(fs);
+#endif
+
   /* Lock the file system */
 
   spiffs_lock_volume(fs);
@@ -1517,10 +1451,19 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
   if (!dq_empty(&fs->objq) && (flags & MNT_FORCE) == 0)
     {
       fwarn("WARNING: Open files and umount not forced\n");
+#ifdef SPIFFS_HAVE_PROCFS
+      spiffs_procfs_register(fs);
+#endif
       ret = -EBUSY;
       goto errout_with_lock;
     }
 
+#ifdef CONFIG_SPIFFS_GC_BACKGROUND
+  /* Stop any background garbage collection */
+
+  spiffs_gc_cancel(fs);
+#endif
+
   /* Release all of the open file objects... Very scary stuff. */
 
   while ((fobj  = (FAR struct spiffs_file_s *)dq_peek(&fs->objq)) != NULL)
@@ -1542,6 +1485,13 @@ static int spiffs_unbind(FAR void *handle, FAR struct inode **mtdinode,
       kmm_free(fs->cache);
     }
 
+#ifdef SPIFFS_HAVE_PROCFS
+  if (fs->erase_counts != NULL)
+    {
+      kmm_free(fs->erase_counts);
+    }
+#endif
+
    /* Free the volume memory (note that the semaphore is now stale!) */
 
   nxsem_destroy(&fs->exclsem.sem);
@@ -1917,3 +1867,74 @@ errout_with_lock:
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
+
+/****************************************************************************
+ * Name: spiffs_lock_reentrant
+ ****************************************************************************/
+
+void spiffs_lock_reentrant(FAR struct spiffs_sem_s *rsem)
+{
+  pid_t me;
+
+  /* Do we already hold the semaphore? */
+
+  me = getpid();
+  if (me == rsem->holder)
+    {
+      /* Yes... just increment the count */
+
+      rsem->count++;
+      DEBUGASSERT(rsem->count > 0);
+    }
+
+  /* Take the semaphore (perhaps waiting) */
+
+  else
+    {
+      int ret;
+
+      do
+        {
+          ret = nxsem_wait(&rsem->sem);
+
+          /* The only case that an error should occur here is if the wait
+           * was awakened by a signal.
+           */
+
+          DEBUGASSERT(ret >= 0 || ret == -EINTR);
+        }
+      while (ret == -EINTR);
+
+      /* No we hold the semaphore */
+
+      rsem->holder = me;
+      rsem->count  = 1;
+    }
+}
+
+/****************************************************************************
+ * Name: spiffs_unlock_reentrant
+ ****************************************************************************/
+
+void spiffs_unlock_reentrant(FAR struct spiffs_sem_s *rsem)
+{
+  DEBUGASSERT(rsem->holder == getpid());
+
+  /* Is this our last count on the semaphore? */
+
+  if (rsem->count > 1)
+    {
+      /* No.. just decrement the count */
+
+      rsem->count--;
+    }
+
+  /* Yes.. then we can really release the semaphore */
+
+  else
+    {
+      rsem->holder = SPIFFS_NO_HOLDER;
+      rsem->count  = 0;
+      nxsem_post(&rsem->sem);
+    }
+}
@@ -67,9 +67,17 @@
 #  warning CONFIG_FS_TMPFS_DIRECTORY_FREEGUARD needs to be > ALLOCGUARD
 #endif
 
-#if CONFIG_FS_TMPFS_FILE_FREEGUARD <= CONFIG_FS_TMPFS_FILE_ALLOCGUARD
-#  warning CONFIG_FS_TMPFS_FILE_FREEGUARD needs to be > ALLOCGUARD
-#endif
+/* File pages */
+
+#define TMPFS_PAGESIZE        CONFIG_FS_TMPFS_PAGESIZE
+#define TMPFS_PAGE(pos)       ((size_t)(pos) / TMPFS_PAGESIZE)
+#define TMPFS_PAGEOFFSET(pos) ((size_t)(pos) % TMPFS_PAGESIZE)
+#define TMPFS_NPAGES(size)    (((size_t)(size) + TMPFS_PAGESIZE - 1) / \
+                               TMPFS_PAGESIZE)
+
+/* Minimum number of entries in a file page table */
+
+#define TMPFS_MINPAGES        4
 
 #define tmpfs_lock_file(tfo) \
            (tmpfs_lock_object((FAR struct tmpfs_object_s *)tfo))
@@ -93,8 +101,15 @@ static void tmpfs_lock_object(FAR struct tmpfs_object_s *to);
 static void tmpfs_unlock_object(FAR struct tmpfs_object_s *to);
 static int  tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
               unsigned int nentries);
-static int  tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
+static int  tmpfs_grow_pagetable(FAR struct tmpfs_file_s *tfo,
+              size_t npages);
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+              size_t index, bool alloc);
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t first);
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo,
               size_t newsize);
+static int  tmpfs_map_file(FAR struct tmpfs_file_s *tfo, FAR void **ppv);
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo);
 static void tmpfs_release_lockedobject(FAR struct tmpfs_object_s *to);
 static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo);
 static int  tmpfs_find_dirent(FAR struct tmpfs_directory_s *tdo,
@@ -372,74 +387,303 @@ static int tmpfs_realloc_directory(FAR struct tmpfs_directory_s **tdo,
 }
 
 /****************************************************************************
- * Name: tmpfs_realloc_file
+ * Name: tmpfs_grow_pagetable
+ *
+ * Description:
+ *   Make sure that the page table of a file has at least 'npages' entries.
+ *   The table is grown geometrically so that appending to a file has a
+ *   constant amortized cost.
+ *
  ****************************************************************************/
 
-static int tmpfs_realloc_file(FAR struct tmpfs_file_s **tfo,
-                              size_t newsize)
+static int tmpfs_grow_pagetable(FAR struct tmpfs_file_s *tfo, size_t npages)
 {
-  FAR struct tmpfs_file_s *oldtfo = *tfo;
-  FAR struct tmpfs_file_s *newtfo;
-  size_t objsize;
-  size_t allocsize;
-  size_t delta;
+  FAR uint8_t **newpages;
+  size_t newsize;
 
-  /* Check if the current allocation is sufficient */
+  if (npages <= tfo->tfo_npages)
+    {
+      return OK;
+    }
 
-  objsize = SIZEOF_TMPFS_FILE(newsize);
+  newsize = 2 * tfo->tfo_npages;
+  if (newsize < TMPFS_MINPAGES)
+    {
+      newsize = TMPFS_MINPAGES;
+    }
 
-  /* Are we growing or shrinking the object? */
+  if (newsize < npages)
+    {
+      newsize = npages;
+    }
 
-  if (objsize <= oldtfo->tfo_alloc)
+  newpages = (FAR uint8_t **)
+    kmm_realloc(tfo->tfo_pages, newsize * sizeof(FAR uint8_t *));
+  if (newpages == NULL)
     {
-      /* Shrinking ... Shrink unconditionally if the size is shrinking to
-       * zero.
-       */
+      return -ENOMEM;
+    }
+
+  /* The new entries refer to unallocated pages */
+
+  memset(&newpages[tfo->tfo_npages], 0,
+         (newsize - tfo->tfo_npages) * sizeof(FAR uint8_t *));
+
+  tfo->tfo_alloc += (newsize - tfo->tfo_npages) * sizeof(FAR uint8_t *);
+  tfo->tfo_pages  = newpages;
+  tfo->tfo_npages = newsize;
+  return OK;
+}
 
-      if (newsize > 0)
+/****************************************************************************
+ * Name: tmpfs_get_page
+ *
+ * Description:
+ *   Return the page of the file with the given index.  If the page has not
+ *   been allocated, then either allocate a zeroed page (if 'alloc' is true)
+ *   or return NULL.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tmpfs_get_page(FAR struct tmpfs_file_s *tfo,
+                                   size_t index, bool alloc)
+{
+  FAR uint8_t *page;
+
+  if (index < tfo->tfo_npages && tfo->tfo_pages[index] != NULL)
+    {
+      return tfo->tfo_pages[index];
+    }
+
+  if (!alloc || tmpfs_grow_pagetable(tfo, index + 1) < 0)
+    {
+      return NULL;
+    }
+
+  page = (FAR uint8_t *)kmm_zalloc(TMPFS_PAGESIZE);
+  if (page != NULL)
+    {
+      tfo->tfo_pages[index] = page;
+      tfo->tfo_alloc       += TMPFS_PAGESIZE;
+    }
+
+  return page;
+}
+
+/****************************************************************************
+ * Name: tmpfs_free_pages
+ *
+ * Description:
+ *   Free all pages of the file starting with page 'first'.  Pages that are
+ *   part of the contiguous memory created for FIOC_MMAP may still be
+ *   referenced by a mapping.  They are zeroed but kept in the page table.
+ *
+ ****************************************************************************/
+
+static void tmpfs_free_pages(FAR struct tmpfs_file_s *tfo, size_t first)
+{
+  FAR uint8_t *page;
+  size_t index;
+
+  for (index = first; index < tfo->tfo_npages; index++)
+    {
+      page = tfo->tfo_pages[index];
+      if (page != NULL)
         {
-          /* Otherwise, don't realloc unless the object has shrunk by a
-           * lot.
-           */
+          if (page >= tfo->tfo_map && page < tfo->tfo_map + tfo->tfo_mapsize)
+            {
+              memset(page, 0, TMPFS_PAGESIZE);
+            }
+          else
+            {
+              kmm_free(page);
+              tfo->tfo_alloc -= TMPFS_PAGESIZE;
+              tfo->tfo_pages[index] = NULL;
+            }
+        }
+    }
+}
 
-          delta = oldtfo->tfo_alloc - objsize;
-          if (delta <= CONFIG_FS_TMPFS_FILE_FREEGUARD)
+/****************************************************************************
+ * Name: tmpfs_resize_file
+ *
+ * Description:
+ *   Change the size of a file.  Growing the file allocates nothing; the new
+ *   region reads as zero until it is written.  Shrinking the file frees the
+ *   pages beyond the new end of file and zeroes the remainder of the last
+ *   page.
+ *
+ ****************************************************************************/
+
+static void tmpfs_resize_file(FAR struct tmpfs_file_s *tfo, size_t newsize)
+{
+  FAR uint8_t *page;
+  size_t offset;
+
+  if (newsize < tfo->tfo_size)
+    {
+      tmpfs_free_pages(tfo, TMPFS_NPAGES(newsize));
+
+      offset = TMPFS_PAGEOFFSET(newsize);
+      if (offset > 0)
+        {
+          page = tmpfs_get_page(tfo, TMPFS_PAGE(newsize), false);
+          if (page != NULL)
             {
-              /* Hasn't shrunk enough.. Return doing nothing for now */
+              memset(&page[offset], 0, TMPFS_PAGESIZE - offset);
+            }
+        }
+
+      /* Release the page table if the file is now empty.  The contiguous
+       * memory of FIOC_MMAP (and the page table that refers to it) is kept
+       * until the file is freed because it may still be mapped.
+       */
+
+      if (newsize == 0 && tfo->tfo_map == NULL && tfo->tfo_pages != NULL)
+        {
+          kmm_free(tfo->tfo_pages);
+          tfo->tfo_alloc -= tfo->tfo_npages * sizeof(FAR uint8_t *);
+          tfo->tfo_pages  = NULL;
+          tfo->tfo_npages = 0;
+        }
+    }
+
+  tfo->tfo_size = newsize;
+}
+
+/****************************************************************************
+ * Name: tmpfs_map_file
+ *
+ * Description:
+ *   Return the address of the file data in contiguous memory.  The pages of
+ *   the file are gathered once into a single allocation which then
+ *   continues to serve as the file's pages.  Later writes within that
+ *   region are seen through the mapping.
+ *
+ *   A mapping may be used until the file is freed, so the contiguous memory
+ *   is never moved or released before then.  If the file has grown beyond
+ *   it, the file cannot be mapped again and -EBUSY is returned.
+ *
+ ****************************************************************************/
+
+static int tmpfs_map_file(FAR struct tmpfs_file_s *tfo, FAR void **ppv)
+{
+  FAR uint8_t *newmap;
+  FAR uint8_t *page;
+  size_t npages;
+  size_t index;
+  int ret;
+
+  npages = TMPFS_NPAGES(tfo->tfo_size);
+
+  /* Is the file already mapped? */
+
+  if (tfo->tfo_map != NULL)
+    {
+      if (npages * TMPFS_PAGESIZE > tfo->tfo_mapsize)
+        {
+          return -EBUSY;
+        }
 
-              oldtfo->tfo_size = newsize;
-              return OK;
+      for (index = 0; index < npages; index++)
+        {
+          if (tfo->tfo_pages[index] != &tfo->tfo_map[index * TMPFS_PAGESIZE])
+            {
+              return -EBUSY;
             }
         }
+
+      *ppv = tfo->tfo_map;
+      return OK;
     }
 
-  /* Added some additional amount to the new size to account frequent
-   * reallocations.
+  /* A file of no more than one page is trivially contiguous.  The first
+   * page becomes the contiguous memory of the file.
    */
 
-  allocsize = objsize + CONFIG_FS_TMPFS_FILE_ALLOCGUARD;
+  if (npages <= 1)
+    {
+      page = tmpfs_get_page(tfo, 0, true);
+      if (page == NULL)
+        {
+          return -ENOMEM;
+        }
 
-  /* Realloc the file object */
+      tfo->tfo_map     = page;
+      tfo->tfo_mapsize = TMPFS_PAGESIZE;
 
-  newtfo = (FAR struct tmpfs_file_s *)kmm_realloc(oldtfo, allocsize);
-  if (newtfo == NULL)
+      *ppv = page;
+      return OK;
+    }
+
+  /* Otherwise, gather the pages into one allocation */
+
+  ret = tmpfs_grow_pagetable(tfo, npages);
+  if (ret < 0)
+    {
+      return ret;
+    }
+
+  newmap = (FAR uint8_t *)kmm_malloc(npages * TMPFS_PAGESIZE);
+  if (newmap == NULL)
     {
       return -ENOMEM;
     }
 
-  /* Adjust the reference in the parent directory entry */
+  for (index = 0; index < npages; index++)
+    {
+      page = tfo->tfo_pages[index];
+      if (page != NULL)
+        {
+          memcpy(&newmap[index * TMPFS_PAGESIZE], page, TMPFS_PAGESIZE);
+        }
+      else
+        {
+          memset(&newmap[index * TMPFS_PAGESIZE], 0, TMPFS_PAGESIZE);
+        }
+    }
+
+  /* Release the old pages and let the page table refer to the contiguous
+   * memory.
+   */
 
-  DEBUGASSERT(newtfo->tfo_dirent);
-  newtfo->tfo_dirent->tde_object = (FAR struct tmpfs_object_s *)newtfo;
+  tmpfs_free_pages(tfo, 0);
+
+  for (index = 0; index < npages; index++)
+    {
+      tfo->tfo_pages[index] = &newmap[index * TMPFS_PAGESIZE];
+    }
 
-  /* Return the new address of the reallocated file object */
+  tfo->tfo_map     = newmap;
+  tfo->tfo_mapsize = npages * TMPFS_PAGESIZE;
+  tfo->tfo_alloc  += tfo->tfo_mapsize;
 
-  newtfo->tfo_alloc = allocsize;
-  newtfo->tfo_size  = newsize;
-  *tfo              = newtfo;
+  *ppv = newmap;
   return OK;
 }
 
+/****************************************************************************
+ * Name: tmpfs_free_file
+ ****************************************************************************/
+
+static void tmpfs_free_file(FAR struct tmpfs_file_s *tfo)
+{
+  tmpfs_free_pages(tfo, 0);
+
+  if (tfo->tfo_pages != NULL)
+    {
+      kmm_free(tfo->tfo_pages);
+    }
+
+  if (tfo->tfo_map != NULL)
+    {
+      kmm_free(tfo->tfo_map);
+    }
+
+  nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
+  kmm_free(tfo);
+}
+
 /****************************************************************************
  * Name: tmpfs_release_lockedobject
  ****************************************************************************/
@@ -475,8 +719,7 @@ static void tmpfs_release_lockedfile(FAR struct tmpfs_file_s *tfo)
 
   if (tfo->tfo_refs == 1 && (tfo->tfo_flags & TFO_FLAG_UNLINKED) != 0)
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Otherwise, just decrement the reference count on the file object */
@@ -622,12 +865,12 @@ static int tmpfs_add_dirent(FAR struct tmpfs_directory_s **tdo,
 static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
 {
   FAR struct tmpfs_file_s *tfo;
-  size_t allocsize;
 
-  /* Create a new zero length file object */
+  /* Create a new zero length file object.  No pages are allocated until
+   * the file is written.
+   */
 
-  allocsize = SIZEOF_TMPFS_FILE(CONFIG_FS_TMPFS_FILE_ALLOCGUARD);
-  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(allocsize);
+  tfo = (FAR struct tmpfs_file_s *)kmm_malloc(sizeof(struct tmpfs_file_s));
   if (tfo == NULL)
     {
       return NULL;
@@ -637,11 +880,15 @@ static FAR struct tmpfs_file_s *tmpfs_alloc_file(void)
    * locked with one reference count.
    */
 
-  tfo->tfo_alloc = allocsize;
-  tfo->tfo_type  = TMPFS_REGULAR;
-  tfo->tfo_refs  = 1;
-  tfo->tfo_flags = 0;
-  tfo->tfo_size  = 0;
+  tfo->tfo_alloc   = sizeof(struct tmpfs_file_s);
+  tfo->tfo_type    = TMPFS_REGULAR;
+  tfo->tfo_refs    = 1;
+  tfo->tfo_flags   = 0;
+  tfo->tfo_size    = 0;
+  tfo->tfo_npages  = 0;
+  tfo->tfo_pages   = NULL;
+  tfo->tfo_map     = NULL;
+  tfo->tfo_mapsize = 0;
 
   tfo->tfo_exclsem.ts_holder = getpid();
   tfo->tfo_exclsem.ts_count  = 1;
@@ -1275,6 +1522,11 @@ static int tmpfs_free_callout(FAR struct tmpfs_directory_s *tdo,
           tfo->tfo_flags |= TFO_FLAG_UNLINKED;
           return TMPFS_UNLINKED;
         }
+
+      /* Free the file object and its pages now */
+
+      tmpfs_free_file(tfo);
+      return TMPFS_DELETED;
     }
 
   /* Free the object now */
@@ -1428,11 +1680,7 @@ static int tmpfs_open(FAR struct file *filep, FAR const char *relpath,
 
           if (tfo->tfo_size > 0)
             {
-              ret = tmpfs_realloc_file(&tfo, 0);
-              if (ret < 0)
-                {
-                  goto errout_with_filelock;
-                }
+              tmpfs_resize_file(tfo, 0);
             }
         }
     }
@@ -1543,7 +1791,7 @@ static int tmpfs_close(FAR struct file *filep)
        * have any other references.
        */
 
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
       return OK;
     }
 
@@ -1561,9 +1809,13 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
                           size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nread;
   off_t startpos;
   off_t endpos;
+  size_t remaining;
+  size_t offset;
+  size_t chunk;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1583,16 +1835,42 @@ static ssize_t tmpfs_read(FAR struct file *filep, FAR char *buffer,
   nread    = buflen;
   endpos   = startpos + buflen;
 
-  if (endpos > tfo->tfo_size)
+  if (startpos >= tfo->tfo_size)
+    {
+      nread = 0;
+    }
+  else if (endpos > tfo->tfo_size)
     {
       endpos = tfo->tfo_size;
       nread  = endpos - startpos;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Copy data from the file pages to the user buffer.  Unallocated pages
+   * read as zero.
+   */
 
-  memcpy(buffer, &tfo->tfo_data[startpos], nread);
-  filep->f_pos += nread;
+  for (remaining = nread; remaining > 0; remaining -= chunk)
+    {
+      offset = TMPFS_PAGEOFFSET(filep->f_pos);
+      chunk  = TMPFS_PAGESIZE - offset;
+      if (chunk > remaining)
+        {
+          chunk = remaining;
+        }
+
+      page = tmpfs_get_page(tfo, TMPFS_PAGE(filep->f_pos), false);
+      if (page != NULL)
+        {
+          memcpy(buffer, &page[offset], chunk);
+        }
+      else
+        {
+          memset(buffer, 0, chunk);
+        }
+
+      buffer       += chunk;
+      filep->f_pos += chunk;
+    }
 
   /* Release the lock on the file */
 
@@ -1608,10 +1886,10 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
                            size_t buflen)
 {
   FAR struct tmpfs_file_s *tfo;
+  FAR uint8_t *page;
   ssize_t nwritten;
-  off_t startpos;
-  off_t endpos;
-  int ret;
+  size_t offset;
+  size_t chunk;
 
   finfo("filep: %p buffer: %p buflen: %lu\n",
         filep, buffer, (unsigned long)buflen);
@@ -1625,38 +1903,48 @@ static ssize_t tmpfs_write(FAR struct file *filep, FAR const char *buffer,
 
   tmpfs_lock_file(tfo);
 
-  /* Handle attempts to write beyond the end of the file */
-
-  startpos = filep->f_pos;
-  nwritten = buflen;
-  endpos   = startpos + buflen;
+  /* Copy data from the user buffer into the file pages, allocating pages
+   * as needed.  Writing past the end of the file never moves the existing
+   * data.
+   */
 
-  if (endpos > tfo->tfo_size)
+  for (nwritten = 0; nwritten < buflen; nwritten += chunk)
     {
-      /* Reallocate the file to handle the write past the end of the file. */
+      offset = TMPFS_PAGEOFFSET(filep->f_pos);
+      chunk  = TMPFS_PAGESIZE - offset;
+      if (chunk > buflen - nwritten)
+        {
+          chunk = buflen - nwritten;
+        }
 
-      ret = tmpfs_realloc_file(&tfo, (size_t)endpos);
-      if (ret < 0)
+      page = tmpfs_get_page(tfo, TMPFS_PAGE(filep->f_pos), true);
+      if (page == NULL)
         {
-          goto errout_with_lock;
+          /* Out of memory.  Report the partial write, if any */
+
+          if (nwritten == 0)
+            {
+              nwritten = -ENOMEM;
+            }
+
+          break;
         }
 
-      filep->f_priv = tfo;
+      memcpy(&page[offset], &buffer[nwritten], chunk);
+      filep->f_pos += chunk;
     }
 
-  /* Copy data from the memory object to the user buffer */
+  /* Extend the file if we wrote past the end of the file */
 
-  memcpy(&tfo->tfo_data[startpos], buffer, nwritten);
-  filep->f_pos += nwritten;
+  if (filep->f_pos > tfo->tfo_size)
+    {
+      tfo->tfo_size = filep->f_pos;
+    }
 
   /* Release the lock on the file */
 
   tmpfs_unlock_file(tfo);
   return nwritten;
-
-errout_with_lock:
-  tmpfs_unlock_file(tfo);
-  return (ssize_t)ret;
 }
 
 /****************************************************************************
@@ -1727,6 +2015,7 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
 {
   FAR struct tmpfs_file_s *tfo;
   FAR void **ppv = (FAR void**)arg;
+  int ret;
 
   finfo("filep: %p cmd: %d arg: %08lx\n", filep, cmd, arg);
   DEBUGASSERT(filep->f_priv != NULL && filep->f_inode != NULL);
@@ -1742,11 +2031,13 @@ static int tmpfs_ioctl(FAR struct file *filep, int cmd, unsigned long arg)
   if (cmd == FIOC_MMAP && ppv != NULL)
     {
       /* Return the address on the media corresponding to the start of
-       * the file.
+       * the file.  The pages are made contiguous first if necessary.
        */
 
-      *ppv = (FAR void *)tfo->tfo_data;
-      return OK;
+      tmpfs_lock_file(tfo);
+      ret = tmpfs_map_file(tfo, ppv);
+      tmpfs_unlock_file(tfo);
+      return ret;
     }
 
   ferr("ERROR: Invalid cmd: %d\n", cmd);
@@ -1848,31 +2139,15 @@ static int tmpfs_truncate(FAR struct file *filep, off_t length)
   oldsize = tfo->tfo_size;
   if (oldsize != length)
     {
-      /* The size is changing.. up or down.  Reallocate the file memory. */
-
-      ret = tmpfs_realloc_file(&tfo, (size_t)length);
-      if (ret < 0)
-        {
-          goto errout_with_lock;
-        }
-
-      filep->f_priv = tfo;
-
-      /* If the size has increased, then we need to zero the newly added
-       * memory.
+      /* The size is changing.. up or down.  Any newly added region reads
+       * as zero without allocating pages.
        */
 
-      if (length > oldsize)
-        {
-          memset(&tfo->tfo_data[oldsize], 0, length - oldsize);
-        }
-
-      ret = OK;
+      tmpfs_resize_file(tfo, (size_t)length);
     }
 
   /* Release the lock on the file */
 
-errout_with_lock:
   tmpfs_unlock_file(tfo);
   return ret;
 }
@@ -2275,8 +2550,7 @@ static int tmpfs_unlink(FAR struct inode *mountpt, FAR const char *relpath)
 
   else
     {
-      nxsem_destroy(&tfo->tfo_exclsem.ts_sem);
-      kmm_free(tfo);
+      tmpfs_free_file(tfo);
     }
 
   /* Release the reference and lock on the parent directory */
@@ -132,6 +132,11 @@ struct tmpfs_directory_s
   (sizeof(struct tmpfs_directory_s) + ((n) - 1) * sizeof(struct tmpfs_dirent_s))
 
 /* The form of a regular file memory object
+ *
+ * File data is held in fixed size pages of CONFIG_FS_TMPFS_PAGESIZE bytes
+ * referenced by a per-file page table.  Pages are allocated only when
+ * they are written so that files may be sparse.  Bytes in a page beyond
+ * the end of the file are always zero.
  *
  * NOTE that in this very simplified implementation, there is no per-open
  * state.  The file memory object also serves as the open file object,
@@ -150,15 +155,17 @@ struct tmpfs_file_s
   uint8_t  tfo_type;     /* See enum tmpfs_objtype_e */
   uint8_t  tfo_refs;     /* Reference count */
 
-  /* Remaining fields are unique to a directory object */
+  /* Remaining fields are unique to a file object */
 
   uint8_t  tfo_flags;    /* See TFO_FLAG_* definitions */
   size_t   tfo_size;     /* Valid file size */
-  uint8_t  tfo_data[1];  /* File data starts here */
+  size_t   tfo_npages;   /* Number of entries in the page table */
+  FAR uint8_t **tfo_pages; /* Page table.  NULL entries read as zero */
+  FAR uint8_t *tfo_map;  /* Contiguous pages created by FIOC_MMAP.  Kept
+                          * until the file is freed */
+  size_t   tfo_mapsize;  /* Size of the contiguous pages in bytes */
 };
 
-#define SIZEOF_TMPFS_FILE(n) (sizeof(struct tmpfs_file_s) + (n) - 1)
-
 /* This structure represents one instance of a TMPFS file system */
 
 struct tmpfs_s
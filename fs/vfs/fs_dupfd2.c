@@ -91,13 +91,19 @@ int dup2(int fd1, int fd2)
   /* Get the file structures corresponding to the file descriptors. */
 
   ret = fs_getfilep(fd1, &filep1);
-  if (ret >= 0)
+  if (ret < 0)
     {
-      ret = fs_getfilep(fd2, &filep2);
+      goto errout;
     }
 
-  if (ret < 0)
+  /* The target descriptor need not have been allocated before.  Make sure
+   * that there is a file structure for it.
+   */
+
+  filep2 = files_extend(sched_getfiles(), fd2);
+  if (filep2 == NULL)
     {
+      ret = (unsigned int)fd2 < CONFIG_NFILE_DESCRIPTORS ? -ENOMEM : -EBADF;
       goto errout;
     }
 
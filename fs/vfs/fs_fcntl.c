@@ -48,6 +48,7 @@
 #include <nuttx/sched.h>
 #include <nuttx/cancelpt.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 
 #include "inode/inode.h"
@@ -206,6 +207,24 @@ int file_vfcntl(FAR struct file *filep, int cmd, va_list ap)
         ret = -ENOSYS; /* Not implemented */
         break;
 
+      case F_GETPIPE_SZ:
+        /* Return the capacity of the pipe referred to by fd (linux).  Other
+         * drivers will fail the ioctl.
+         */
+
+        ret = file_ioctl(filep, PIPEIOC_GETSIZE, 0);
+        break;
+
+      case F_SETPIPE_SZ:
+        /* Change the capacity of the pipe referred to by fd to the third
+         * argument, arg, taken as type int (linux).  The new capacity is
+         * returned.
+         */
+
+        ret = file_ioctl(filep, PIPEIOC_SETSIZE,
+                         (unsigned long)va_arg(ap, int));
+        break;
+
       default:
         break;
     }
@@ -60,6 +60,9 @@
  *   file.  NOTE that this function will currently fail if it is provided
  *   with a socket descriptor.
  *
+ *   The list semaphore is not taken:  The struct file instances of a list
+ *   are not moved or freed while the task group exists.
+ *
  * Input Parameters:
  *   fd    - The file descriptor
  *   filep - The location to return the struct file instance
@@ -100,8 +103,11 @@ int fs_getfilep(int fd, FAR struct file **filep)
       return -EAGAIN;
     }
 
-  /* And return the file pointer from the list */
+  /* And return the file pointer from the list.  With
+   * CONFIG_FILELIST_DYNAMIC, there is no file structure for a descriptor
+   * that has never been allocated.
+   */
 
-  *filep = &list->fl_files[fd];
-  return OK;
+  *filep = files_getfile(list, fd);
+  return *filep != NULL ? OK : -EBADF;
 }
@@ -126,6 +126,10 @@ int mkdir(const char *pathname, mode_t mode)
               errcode = -ret;
               goto errout_with_inode;
             }
+
+#ifdef CONFIG_FS_NAMECACHE
+          namecache_invalidate();
+#endif
         }
       else
         {
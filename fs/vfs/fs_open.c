@@ -230,7 +230,37 @@ int nx_vopen(FAR const char *path, int oflags, va_list ap)
 #ifndef CONFIG_DISABLE_MOUNTPOINT
       if (INODE_IS_MOUNTPT(inode))
         {
-          ret = inode->u.i_mops->open(filep, desc.relpath, oflags, mode);
+#ifdef CONFIG_FS_NAMECACHE
+          /* An open that cannot create the file will fail if the path is
+           * known not to exist.
+           */
+
+          if ((oflags & O_CREAT) == 0 &&
+              namecache_isnegative(inode, desc.relpath))
+            {
+              ret = -ENOENT;
+            }
+          else
+#endif
+            {
+#ifdef CONFIG_FS_NAMECACHE
+              uint32_t generation = namecache_generation();
+#endif
+
+              ret = inode->u.i_mops->open(filep, desc.relpath, oflags,
+                                          mode);
+
+#ifdef CONFIG_FS_NAMECACHE
+              if (ret == -ENOENT && (oflags & O_CREAT) == 0)
+                {
+                  namecache_addnegative(inode, desc.relpath, generation);
+                }
+              else if (ret >= 0 && (oflags & O_CREAT) != 0)
+                {
+                  namecache_invalidate();
+                }
+#endif
+            }
         }
       else
 #endif
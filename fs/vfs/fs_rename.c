@@ -239,6 +239,10 @@ next_subdir:
 
   /* Copy the inode state from the old inode to the newly allocated inode */
 
+#ifdef CONFIG_FS_INODE_HASH
+  inode_hashmove(oldinode, newinode);
+#endif
+
   newinode->i_child   = oldinode->i_child;   /* Link to lower level inode */
   newinode->i_flags   = oldinode->i_flags;   /* Flags for inode */
   newinode->u.i_ops   = oldinode->u.i_ops;   /* Inode operations */
@@ -467,6 +471,12 @@ next_subdir:
        */
 
       ret = oldinode->u.i_mops->rename(oldinode, oldrelpath, newrelpath);
+
+#ifdef CONFIG_FS_NAMECACHE
+      /* The new name now exists */
+
+      namecache_invalidate();
+#endif
     }
 
 errout_with_newinode:
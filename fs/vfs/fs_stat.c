@@ -145,9 +145,31 @@ int stat_recursive(FAR const char *path, FAR struct stat *buf)
 
       if (inode->u.i_mops && inode->u.i_mops->stat)
         {
-          /* Perform the stat() operation */
+#ifdef CONFIG_FS_NAMECACHE
+          /* Don't ask the file system about paths known not to exist */
 
-          ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+          if (namecache_isnegative(inode, desc.relpath))
+            {
+              ret = -ENOENT;
+            }
+          else
+#endif
+            {
+#ifdef CONFIG_FS_NAMECACHE
+              uint32_t generation = namecache_generation();
+#endif
+
+              /* Perform the stat() operation */
+
+              ret = inode->u.i_mops->stat(inode, desc.relpath, buf);
+
+#ifdef CONFIG_FS_NAMECACHE
+              if (ret == -ENOENT)
+                {
+                  namecache_addnegative(inode, desc.relpath, generation);
+                }
+#endif
+            }
         }
     }
   else
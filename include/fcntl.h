@@ -109,6 +109,8 @@
 #define F_SETLKW    12 /* Like F_SETLK, but wait for lock to become available */
 #define F_SETOWN    13 /* Set pid that will receive SIGIO and SIGURG signals for fd */
 #define F_SETSIG    14 /* Set the signal to be sent */
+#define F_SETPIPE_SZ 15 /* Set the capacity of the pipe referred to by fd (linux) */
+#define F_GETPIPE_SZ 16 /* Get the capacity of the pipe referred to by fd (linux) */
 
 /* For posix fcntl() and lockf() */
 
@@ -116,6 +118,13 @@
 #define F_WRLCK     1  /* Take out a write lease */
 #define F_UNLCK     2  /* Remove a lease */
 
+/* Flags for splice() (linux) */
+
+#define SPLICE_F_MOVE     (1 << 0) /* Hint only: Move rather than copy */
+#define SPLICE_F_NONBLOCK (1 << 1) /* Do not block on the pipe */
+#define SPLICE_F_MORE     (1 << 2) /* Hint only: More data will follow */
+#define SPLICE_F_GIFT     (1 << 3) /* Unused */
+
 /* close-on-exec flag for F_GETRL and F_SETFL */
 
 #define FD_CLOEXEC  1
@@ -173,6 +182,11 @@ extern "C"
 int open(const char *path, int oflag, ...);
 int fcntl(int fd, int cmd, ...);
 
+/* Move data between a pipe and a file or socket descriptor (linux) */
+
+ssize_t splice(int fd_in, FAR off_t *off_in, int fd_out, FAR off_t *off_out,
+               size_t len, unsigned int flags);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -50,6 +50,12 @@
 
 #define MQ_NONBLOCK O_NONBLOCK
 
+/* Non-standard mq_flags attribute for mq_open():  The queue has a single
+ * sender and a single receiver (see CONFIG_MQ_SPSC).
+ */
+
+#define MQ_SPSC     (1 << 15)
+
 /********************************************************************************
  * Public Type Declarations
  ********************************************************************************/
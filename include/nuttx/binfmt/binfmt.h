@@ -81,6 +81,7 @@ typedef FAR void (*binfmt_dtor_t)(void);
  */
 
 struct symtab_s;
+struct binfmt_cache_s;
 struct binary_s
 {
   /* Information provided to the loader to load and bind a module */
@@ -124,6 +125,17 @@ struct binary_s
 
   size_t mapsize;                      /* Size of the mapped address region (needed for munmap) */
 
+#ifdef CONFIG_BINFMT_CACHE
+  /* The writable .data/.bss region of the loaded image.  This is provided
+   * by binary formats whose image can be cached and restarted by restoring
+   * only this region.
+   */
+
+  FAR void *datastart;                 /* Start of the .data/.bss region */
+  size_t datasize;                     /* Size of the .data/.bss region */
+  FAR struct binfmt_cache_s *cache;    /* Cache entry that owns the image */
+#endif
+
   /* Start-up information that is provided by the loader, but may be modified
    * by the caller between load_module() and exec_module() calls.
    */
@@ -0,0 +1,105 @@
+/****************************************************************************
+ * include/nuttx/drivers/bcache.h
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+#ifndef __INCLUDE_NUTTX_DRIVERS_BCACHE_H
+#define __INCLUDE_NUTTX_DRIVERS_BCACHE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_BCACHE
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: bcache_register
+ *
+ * Description:
+ *   Create a block driver at 'devpath' that accesses the block driver at
+ *   'source' through the shared block cache.  File systems (FAT, ROMFS,
+ *   ...), BCH and loop devices may then be layered on 'devpath' instead of
+ *   'source'.  Sectors are cached in a pool shared by all cached devices.
+ *   Dirty sectors are written back when the pool has no clean sector left,
+ *   when BIOC_FLUSH is received, and when the device is closed.
+ *
+ * Input Parameters:
+ *   source  - The path to the block driver to be cached
+ *   devpath - The path of the cached block driver to create
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int bcache_register(FAR const char *source, FAR const char *devpath);
+
+/****************************************************************************
+ * Name: bcache_unregister
+ *
+ * Description:
+ *   Flush and release a cached block driver created by bcache_register().
+ *
+ * Input Parameters:
+ *   devpath - The path of the cached block driver
+ *
+ * Returned Value:
+ *   Zero on success; a negated errno value on failure.  -EBUSY is returned
+ *   if the device is still open.
+ *
+ ****************************************************************************/
+
+int bcache_unregister(FAR const char *devpath);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* CONFIG_BCACHE */
+#endif /* __INCLUDE_NUTTX_DRIVERS_BCACHE_H */
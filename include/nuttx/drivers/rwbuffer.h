@@ -184,6 +184,12 @@ ssize_t rwb_write(FAR struct rwbuffer_s *rwb,
                   off_t startblock, size_t blockcount,
                   FAR const uint8_t *wrbuffer);
 
+/* Write any buffered data to the device */
+
+#ifdef CONFIG_DRVR_WRITEBUFFER
+int rwb_flush(FAR struct rwbuffer_s *rwb);
+#endif
+
 /* Character oriented transfers */
 
 #ifdef CONFIG_DRVR_READBYTES
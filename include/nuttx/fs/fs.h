@@ -400,6 +400,10 @@ struct inode
 {
   FAR struct inode *i_peer;     /* Link to same level inode */
   FAR struct inode *i_child;    /* Link to lower level inode */
+#ifdef CONFIG_FS_INODE_HASH
+  FAR struct inode *i_hnext;    /* Link in the inode hash table */
+  FAR struct inode *i_hparent;  /* Parent inode used as the hash key */
+#endif
   int16_t           i_crefs;    /* References to inode */
   uint16_t          i_flags;    /* Flags for inode */
   union inode_ops_u u;          /* Inode operations */
@@ -425,13 +429,32 @@ struct file
   void             *f_priv;     /* Per file driver private data */
 };
 
-/* This defines a list of files indexed by the file descriptor */
+/* This defines a list of files indexed by the file descriptor.  fl_inuse
+ * is a bitmap with one bit set for each allocated descriptor so that a free
+ * descriptor can be found a word at a time.  With CONFIG_FILELIST_DYNAMIC,
+ * the file structures are allocated in chunks as they are needed.  Chunks
+ * are never freed or moved until the list is released so that a struct
+ * file pointer may be used without holding fl_sem.
+ */
 
 #if CONFIG_NFILE_DESCRIPTORS > 0
+#define FILELIST_NWORDS   ((CONFIG_NFILE_DESCRIPTORS + 31) >> 5)
+
+#ifdef CONFIG_FILELIST_DYNAMIC
+#  define FILELIST_NCHUNKS \
+     ((CONFIG_NFILE_DESCRIPTORS + CONFIG_FILELIST_CHUNKSIZE - 1) / \
+      CONFIG_FILELIST_CHUNKSIZE)
+#endif
+
 struct filelist
 {
   sem_t   fl_sem;               /* Manage access to the file list */
+  uint32_t fl_inuse[FILELIST_NWORDS]; /* Bitmap of allocated descriptors */
+#ifdef CONFIG_FILELIST_DYNAMIC
+  FAR struct file *fl_chunks[FILELIST_NCHUNKS]; /* Allocated file chunks */
+#else
   struct file fl_files[CONFIG_NFILE_DESCRIPTORS];
+#endif
 };
 #endif
 
@@ -692,6 +715,58 @@ void files_initlist(FAR struct filelist *list);
 void files_releaselist(FAR struct filelist *list);
 #endif
 
+/****************************************************************************
+ * Name: files_getfile
+ *
+ * Description:
+ *   Return the struct file instance that backs the file descriptor 'fd' in
+ *   'list'.  The returned structure may or may not be open.  This does not
+ *   take the list semaphore.
+ *
+ * Returned Value:
+ *   The struct file instance or NULL if 'fd' is out of range or, with
+ *   CONFIG_FILELIST_DYNAMIC, if no file structure has yet been allocated
+ *   for the descriptor.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_getfile(FAR struct filelist *list, int fd);
+#endif
+
+/****************************************************************************
+ * Name: files_extend
+ *
+ * Description:
+ *   Like files_getfile() but, with CONFIG_FILELIST_DYNAMIC, allocate the
+ *   file structure backing 'fd' if it does not yet exist.
+ *
+ * Returned Value:
+ *   The struct file instance or NULL if 'fd' is out of range or the
+ *   allocation failed.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+FAR struct file *files_extend(FAR struct filelist *list, int fd);
+#endif
+
+/****************************************************************************
+ * Name: files_getfd
+ *
+ * Description:
+ *   Return the file descriptor that corresponds to a struct file instance
+ *   in 'list'.
+ *
+ * Returned Value:
+ *   The file descriptor or -EBADF if 'filep' is not a member of 'list'.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NFILE_DESCRIPTORS > 0
+int files_getfd(FAR struct filelist *list, FAR struct file *filep);
+#endif
+
 /****************************************************************************
  * Name: file_dup2
  *
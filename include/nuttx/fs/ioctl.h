@@ -167,6 +167,12 @@
                                            * OUT: Instance number is returned on
                                            *      success.
                                            */
+#define FIOC_FILEID     _FIOC(0x000b)     /* IN:  Location to return value (uintptr_t *)
+                                           * OUT: Value that identifies the file
+                                           *      uniquely on its volume.  Only
+                                           *      supported by file systems whose
+                                           *      file content never changes.
+                                           */
 
 /* NuttX file system ioctl definitions **************************************/
 
@@ -257,6 +263,11 @@
                                            *      to return geometry.
                                            * OUT: Data return in user-provided
                                            *      buffer. */
+#define BIOC_FLUSH      _BIOC(0x000d)     /* Write back any data buffered by
+                                           * the block driver.
+                                           * IN:  None
+                                           * OUT: None (ioctl return value provides
+                                           *      success/failure indication). */
 
 /* NuttX MTD driver ioctl definitions ***************************************/
 
@@ -371,6 +382,15 @@
                                              *       (default)
                                              *     1=fre when empty
                                              * OUT: None */
+#define PIPEIOC_SETSIZE   _PIPEIOC(0x0002)  /* Resize the pipe buffer
+                                             * IN: unsigned long integer
+                                             *     new size in bytes
+                                             * OUT: None (The new size is
+                                             *      returned) */
+#define PIPEIOC_GETSIZE   _PIPEIOC(0x0003)  /* Get the pipe buffer size
+                                             * IN: None
+                                             * OUT: None (The size is
+                                             *      returned) */
 
 /* RTC driver ioctl definitions *********************************************/
 /* (see nuttx/include/rtc.h */
@@ -210,6 +210,10 @@ struct mod_loadinfo_s
   Elf32_Ehdr        ehdr;        /* Buffered module file header */
   FAR Elf32_Shdr   *shdr;        /* Buffered module section headers */
   uint8_t          *iobuffer;    /* File I/O buffer */
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+  FAR Elf32_Sym    *symbols;     /* Cached copy of the symbol table */
+  int               nsymbols;    /* Number of entries in symbols[] */
+#endif
 
   uint16_t          symtabidx;   /* Symbol table section index */
   uint16_t          strtabidx;   /* String table section index */
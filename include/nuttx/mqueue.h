@@ -47,6 +47,7 @@
 #include <sys/types.h>
 #include <stdint.h>
 #include <stdbool.h>
+#include <limits.h>
 #include <mqueue.h>
 #include <queue.h>
 #include <signal.h>
@@ -98,12 +99,21 @@
 
 /* This structure defines a message queue */
 
-struct mq_des; /* forward reference */
+struct mq_des;       /* forward reference */
+struct mqueue_msg_s; /* forward reference */
 
 struct mqueue_inode_s
 {
   FAR struct inode *inode;    /* Containing inode */
   sq_queue_t msglist;         /* Prioritized message list */
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  FAR struct mqueue_msg_s *prtail[MQ_PRIO_MAX + 1]; /* Last msg of each prio */
+#endif
+#ifdef CONFIG_MQ_SPSC
+  FAR struct mqueue_msg_s *ring; /* SPSC queue: maxmsgs + 1 messages, or NULL */
+  volatile uint16_t rdndx;    /* SPSC queue: Next message to receive */
+  volatile uint16_t wrndx;    /* SPSC queue: Next message to send */
+#endif
   int16_t maxmsgs;            /* Maximum number of messages in the queue */
   int16_t nmsgs;              /* Number of message in the queue */
   int16_t nwaitnotfull;       /* Number tasks waiting for not full */
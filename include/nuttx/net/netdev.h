@@ -95,6 +95,14 @@
 #  define RADIO_MAX_ADDRLEN CONFIG_PKTRADIO_ADDRLEN
 #endif
 
+/* The maximum number of frames that a driver will receive in one pass of
+ * its interrupt work before re-queuing the work (see CONFIG_NETDEV_RXBUDGET).
+ */
+
+#ifndef CONFIG_NETDEV_RXBUDGET
+#  define CONFIG_NETDEV_RXBUDGET 8
+#endif
+
 /* Helper macros for network device statistics */
 
 #ifdef CONFIG_NETDEV_STATISTICS
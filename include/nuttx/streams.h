@@ -58,6 +58,8 @@ typedef int  (*lib_getc_t)(FAR struct lib_instream_s *this);
 
 struct lib_outstream_s;
 typedef void (*lib_putc_t)(FAR struct lib_outstream_s *this, int ch);
+typedef int  (*lib_puts_t)(FAR struct lib_outstream_s *this,
+                           FAR const void *buf, int len);
 typedef int  (*lib_flush_t)(FAR struct lib_outstream_s *this);
 
 struct lib_instream_s
@@ -70,9 +72,11 @@ struct lib_instream_s
 struct lib_outstream_s
 {
   lib_putc_t             put;     /* Put one character to the outstream */
+  lib_puts_t             puts;    /* Put a block of characters to the outstream
+                                   * (optional, may be NULL) */
   lib_flush_t            flush;   /* Flush any buffered characters in the outstream */
   int                    nput;    /* Total number of characters put.  Written
-                                   * by put method, readable by user */
+                                   * by put and puts methods, readable by user */
 };
 
 /* Seek-able streams */
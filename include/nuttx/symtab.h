@@ -42,10 +42,16 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+
 /****************************************************************************
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* Marks the end of a hash chain (and limits the size of a hashed table) */
+
+#define SYMTAB_HASH_NONE 0xffff
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -70,6 +76,24 @@ struct symtab_s
   FAR const void *sym_value;         /* The value associated witht the string */
 };
 
+#ifdef CONFIG_SYMTAB_HASHINDEX
+/* struct symtab_hash_s is a hash index for a symbol table.  The symbol
+ * table itself is not modified.  Symbols with the same hash bucket are
+ * linked in a chain; the full hash of each name is retained so that names
+ * need to be compared only when the hashes match.
+ */
+
+struct symtab_hash_s
+{
+  FAR const struct symtab_s *symtab; /* The indexed symbol table */
+  int nsyms;                         /* The number of symbols in the table */
+  int nbuckets;                      /* The number of hash buckets */
+  FAR uint32_t *hashes;              /* The hash of each symbol name */
+  FAR uint16_t *chain;               /* Next symbol in the same bucket */
+  FAR uint16_t *buckets;             /* First symbol in each bucket */
+};
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -155,6 +179,61 @@ FAR const struct symtab_s *
 symtab_findorderedbyvalue(FAR const struct symtab_s *symtab,
                           FAR void *value, int nsyms);
 
+/****************************************************************************
+ * Name: symtab_hash_create
+ *
+ * Description:
+ *   Build a hash index for the symbol table.  The hash index permits
+ *   symbols to be found by name in (nearly) constant time, regardless of
+ *   the ordering of the symbol table.  The symbol table must persist for
+ *   the lifetime of the hash index.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+int symtab_hash_create(FAR struct symtab_hash_s *hash,
+                       FAR const struct symtab_s *symtab, int nsyms);
+#endif
+
+/****************************************************************************
+ * Name: symtab_hash_release
+ *
+ * Description:
+ *   Free the resources used by a hash index created by
+ *   symtab_hash_create().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+void symtab_hash_release(FAR struct symtab_hash_s *hash);
+#endif
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the hash indexed symbol table with the matching
+ *   name.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -227,6 +227,9 @@
  *     used for any purpose.  if CONFIG_SCHED_LPWORK is not defined, then
  *     there is only one kernel work queue and LPWORK == HPWORK.
  *
+ *   NAMEDWORK: The ID of the first work queue created by work_create().
+ *     The IDs of the queues created at run time follow it.
+ *
  * User Work Queue:
  *   USRWORK:  In the kernel phase a a kernel build, there should be no
  *     references to user-space work queues.  That would be an error.
@@ -251,6 +254,7 @@
 #    define LPWORK HPWORK     /* Redirect low-priority references */
 #  endif
 #  define USRWORK  LPWORK     /* Redirect user-mode references */
+#  define NAMEDWORK 3          /* First work queue created by work_create() */
 
 #endif /* CONFIG_LIB_USRWORK && !__KERNEL__ */
 
@@ -276,6 +280,21 @@ struct work_s
   FAR void *arg;         /* Callback argument */
   clock_t qtime;         /* Time work queued */
   clock_t delay;         /* Delay until work performed */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  uint8_t wndx;          /* Worker whose queue holds the work */
+#endif
+};
+
+/* This structure holds the latency statistics of one work queue as
+ * returned by work_stats().  Latencies are measured in clock ticks from
+ * the time that the work was ready to run until it was started.
+ */
+
+struct work_stats_s
+{
+  uint32_t nwork;        /* Number of work items performed */
+  clock_t  maxlat;       /* Longest latency */
+  clock_t  totlat;       /* Sum of all latencies */
 };
 
 /* This is an enumeration of the various events that may be
@@ -460,6 +479,55 @@ int work_signal(int qid);
 
 #define work_available(work) ((work)->worker == NULL)
 
+/****************************************************************************
+ * Name: work_create
+ *
+ * Description:
+ *   Create a new kernel work queue with its own worker thread(s).  Work is
+ *   then queued to it with work_queue() using the returned queue ID.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker thread(s)
+ *   priority  - The priority of the worker thread(s)
+ *   stacksize - The stack size of the worker thread(s)
+ *   nthreads  - The number of worker threads servicing the queue
+ *
+ * Returned Value:
+ *   The ID of the new work queue is returned on success.  A negated errno
+ *   value is returned on failure:
+ *
+ *   -EINVAL - An invalid argument was provided
+ *   -ENOMEM - The work queue could not be allocated
+ *   -ENOSPC - CONFIG_SCHED_NWORKQUEUES work queues already exist
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && CONFIG_SCHED_NWORKQUEUES > 0
+int work_create(FAR const char *name, int priority, int stacksize,
+                int nthreads);
+#endif
+
+/****************************************************************************
+ * Name: work_stats
+ *
+ * Description:
+ *   Return the latency statistics of a kernel work queue and reset them.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *   stats  - The location to return the statistics
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno on failure
+ *
+ *   -EINVAL - An invalid work queue was specified
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && defined(CONFIG_SCHED_WORKQUEUE_STATS)
+int work_stats(int qid, FAR struct work_stats_s *stats);
+#endif
+
 /****************************************************************************
  * Name: lpwork_boostpriority
  *
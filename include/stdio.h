@@ -89,6 +89,7 @@
 
 #define putc(c,s)  fputc((c),(s))
 #define putchar(c) fputc(c, stdout)
+#define putc_unlocked(c,s) fputc_unlocked((c),(s))
 #define getc(s)    fgetc(s)
 #define getchar()  fgetc(stdin)
 #define rewind(s)  ((void)fseek((s),0,SEEK_SET))
@@ -169,6 +170,18 @@ void   setbuf(FAR FILE *stream, FAR char *buf);
 int    setvbuf(FAR FILE *stream, FAR char *buffer, int mode, size_t size);
 int    ungetc(int c, FAR FILE *stream);
 
+/* Explicit stream locking and the unlocked variants of the stream
+ * operations that may be used while the stream is locked.
+ */
+
+void   flockfile(FAR FILE *stream);
+int    ftrylockfile(FAR FILE *stream);
+void   funlockfile(FAR FILE *stream);
+int    fputc_unlocked(int c, FAR FILE *stream);
+int    putchar_unlocked(int c);
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+         FAR FILE *stream);
+
 /* Operations on the stdout stream, buffers, paths, and the whole printf-family */
 
 int    printf(FAR const IPTR char *format, ...);
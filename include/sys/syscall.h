@@ -365,9 +365,16 @@
 
 #  if defined(CONFIG_PIPES) && CONFIG_DEV_FIFO_SIZE > 0
 #    define SYS_mkfifo2                (__SYS_mkfifo2 + 0)
-#    define __SYS_fs_fdopen            (__SYS_mkfifo2 + 1)
+#    define __SYS_splice               (__SYS_mkfifo2 + 1)
 #  else
-#    define __SYS_fs_fdopen            (__SYS_mkfifo2 + 0)
+#    define __SYS_splice               (__SYS_mkfifo2 + 0)
+#  endif
+
+#  if defined(CONFIG_PIPES)
+#    define SYS_splice                 (__SYS_splice + 0)
+#    define __SYS_fs_fdopen            (__SYS_splice + 1)
+#  else
+#    define __SYS_fs_fdopen            (__SYS_splice + 0)
 #  endif
 
 #  if CONFIG_NFILE_STREAMS > 0
@@ -535,16 +542,17 @@
 #  define SYS_sendto                   (__SYS_network + 10)
 #  define SYS_setsockopt               (__SYS_network + 11)
 #  define SYS_socket                   (__SYS_network + 12)
+#  define SYS_socketpair               (__SYS_network + 13)
 #else
-#  define SYS_socket                    __SYS_network
+#  define SYS_socketpair                __SYS_network
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
 #if CONFIG_TASK_NAME_SIZE > 0
-#  define SYS_prctl                    (SYS_socket + 1)
+#  define SYS_prctl                    (SYS_socketpair + 1)
 #else
-#  define SYS_prctl                    SYS_socket
+#  define SYS_prctl                    SYS_socketpair
 #endif
 
 /* The following is defined only if entropy pool random number generator
@@ -71,7 +71,17 @@
 #ifdef CONFIG_STDIO_DISABLE_BUFFERING
 #  define lib_sem_initialize(s)
 #  define lib_take_semaphore(s)
+#  define lib_trytake_semaphore(s) (OK)
 #  define lib_give_semaphore(s)
+#else
+/* True if one character can be stored in the write buffer of the stream
+ * without filling it, i.e., without any need to flush.  The caller must
+ * hold the stream semaphore.
+ */
+
+#  define LIB_CANPUTC(s) \
+     ((s)->fs_bufstart != NULL && (s)->fs_bufread == (s)->fs_bufstart && \
+      (s)->fs_bufend - (s)->fs_bufpos > 1 && ((s)->fs_oflags & O_WROK) != 0)
 #endif
 
 /* The NuttX C library an be build in two modes: (1) as a standard, C-library
@@ -190,6 +200,7 @@ int lib_wrflush(FAR FILE *stream);
 #ifndef CONFIG_STDIO_DISABLE_BUFFERING
 void lib_sem_initialize(FAR struct file_struct *stream);
 void lib_take_semaphore(FAR struct file_struct *stream);
+int  lib_trytake_semaphore(FAR struct file_struct *stream);
 void lib_give_semaphore(FAR struct file_struct *stream);
 #endif
 
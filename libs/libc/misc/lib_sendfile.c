@@ -40,17 +40,76 @@
 #include <nuttx/config.h>
 
 #include <sys/sendfile.h>
+#include <sys/ioctl.h>
 #include <stdbool.h>
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 
 #include "libc.h"
 
 #if CONFIG_NSOCKET_DESCRIPTORS > 0 || CONFIG_NFILE_DESCRIPTORS > 0
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sendfile_map
+ *
+ * Description:
+ *   If the input file lives in directly addressable memory (XIP ROMFS,
+ *   TMPFS, ...), return the address of the data at the current file
+ *   position.  The data can then be written directly from the file image
+ *   without copying it through an intermediate I/O buffer.
+ *
+ * Input Parameters:
+ *   infd  - The input file descriptor
+ *   count - The number of bytes to transfer.  This is clipped to the end
+ *           of the file on return.
+ *
+ * Returned Value:
+ *   The address of the file data at the current file position or NULL if
+ *   the file cannot be mapped.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *sendfile_map(int infd, FAR size_t *count)
+{
+  FAR uint8_t *addr = NULL;
+  off_t fpos;
+  off_t fsize;
+
+  if (ioctl(infd, FIOC_MMAP, (unsigned long)((uintptr_t)&addr)) < 0 ||
+      addr == NULL)
+    {
+      return NULL;
+    }
+
+  fpos = lseek(infd, 0, SEEK_CUR);
+  if (fpos == (off_t)-1)
+    {
+      return NULL;
+    }
+
+  fsize = lseek(infd, 0, SEEK_END);
+  if (lseek(infd, fpos, SEEK_SET) == (off_t)-1 || fsize == (off_t)-1 ||
+      fpos > fsize)
+    {
+      return NULL;
+    }
+
+  if (*count > (size_t)(fsize - fpos))
+    {
+      *count = fsize - fpos;
+    }
+
+  return addr + fpos;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,8 +164,9 @@ ssize_t lib_sendfile(int outfd, int infd, off_t *offset, size_t count)
 ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
 #endif
 {
-  FAR uint8_t *iobuffer;
-  FAR uint8_t *wrbuffer;
+  FAR const uint8_t *mapped;
+  FAR uint8_t *iobuffer = NULL;
+  FAR const uint8_t *wrbuffer;
   off_t startpos = 0;
   ssize_t nbytesread;
   ssize_t nbyteswritten;
@@ -133,65 +193,93 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
         }
     }
 
-  /* Allocate an I/O buffer */
+  /* If the input file data is directly addressable, then there is no need
+   * for an intermediate I/O buffer.
+   */
 
-  iobuffer = (FAR void *)lib_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
-  if (!iobuffer)
+  mapped = sendfile_map(infd, &count);
+  if (mapped == NULL)
     {
-      set_errno(ENOMEM);
-      return ERROR;
+      /* Allocate an I/O buffer */
+
+      iobuffer = (FAR void *)lib_malloc(CONFIG_LIB_SENDFILE_BUFSIZE);
+      if (!iobuffer)
+        {
+          set_errno(ENOMEM);
+          return ERROR;
+        }
     }
 
   /* Now transfer 'count' bytes from the infd to the outfd */
 
   for (ntransferred = 0, endxfr = false; ntransferred < count && !endxfr; )
     {
-      /* Loop until the read side of the transfer comes to some conclusion */
+      if (mapped != NULL)
+        {
+          /* Write the remainder of the transfer directly from the file
+           * image.
+           */
 
-      do
+          nbytesread = count - ntransferred;
+          wrbuffer   = mapped + ntransferred;
+        }
+      else
         {
-          /* Read a buffer of data from the infd */
+          /* Loop until the read side of the transfer comes to some
+           * conclusion.
+           */
 
-          nbytesread = _NX_READ(infd, iobuffer, CONFIG_LIB_SENDFILE_BUFSIZE);
+          do
+            {
+              /* Read a buffer of data from the infd */
 
-          /* Check for end of file */
+              nbytesread = _NX_READ(infd, iobuffer,
+                                    CONFIG_LIB_SENDFILE_BUFSIZE);
 
-          if (nbytesread == 0)
-            {
-              /* End of file.  Break out and return current number of bytes
-               * transferred.
-               */
+              /* Check for end of file */
 
-              endxfr = true;
-              break;
-            }
+              if (nbytesread == 0)
+                {
+                  /* End of file.  Break out and return current number
+                   * of bytes transferred.
+                   */
 
-          /* Check for a read ERROR.  EINTR is a special case.  This function
-           * should break out and return an error if EINTR is returned and
-           * no data has been transferred.  But what should it do if some
-           * data has been transferred?  I suppose just continue?
-           */
+                  endxfr = true;
+                  break;
+                }
 
-          else if (nbytesread < 0)
-            {
+              /* Check for a read ERROR.  EINTR is a special case.  This
+               * function should break out and return an error if EINTR is
+               * returned and no data has been transferred.  But what should
+               * it do if some data has been transferred?  I suppose just
+               * continue?
+               */
+
+              else if (nbytesread < 0)
+                {
 #ifndef CONFIG_DISABLE_SIGNALS
-              int errcode = _NX_GETERRNO(nbytesread);
+                  int errcode = _NX_GETERRNO(nbytesread);
 
-              /* EINTR is not an error (but will still stop the copy) */
+                  /* EINTR is not an error (but will still stop the copy) */
 
-              if (errcode != EINTR || ntransferred == 0)
+                  if (errcode != EINTR || ntransferred == 0)
 #endif
-                {
-                  /* Read error.  Break out and return the error condition. */
+                    {
+                      /* Read error.  Break out and return the error
+                       * condition.
+                       */
 
-                  _NX_SETERRNO(nbytesread);
-                  ntransferred = ERROR;
-                  endxfr       = true;
-                  break;
+                      _NX_SETERRNO(nbytesread);
+                      ntransferred = ERROR;
+                      endxfr       = true;
+                      break;
+                    }
                 }
             }
+          while (nbytesread < 0);
+
+          wrbuffer = iobuffer;
         }
-      while (nbytesread < 0);
 
       /* Was anything read? */
 
@@ -201,7 +289,6 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
            * conclusion.
            */
 
-          wrbuffer = iobuffer;
           do
             {
               /* Write the buffer of data to the outfd */
@@ -259,9 +346,19 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
         }
     }
 
-  /* Release the I/O buffer */
+  /* Release the I/O buffer.  If the data was taken directly from the file
+   * image, then advance the file position past the data that was sent.
+   */
 
-  lib_free(iobuffer);
+  if (mapped == NULL)
+    {
+      lib_free(iobuffer);
+    }
+  else if (ntransferred > 0 && ntransferred != (size_t)ERROR &&
+           lseek(infd, ntransferred, SEEK_CUR) == (off_t)-1)
+    {
+      return ERROR;
+    }
 
   /* Return the current file position */
 
@@ -47,6 +47,17 @@
 
 #include <nuttx/arch.h>
 #include <nuttx/module.h>
+#include <nuttx/symtab.h>
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+/* Hash index for the symbol table selected by modlib_setsymtab() */
+
+extern struct symtab_hash_s g_modlib_symhash;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
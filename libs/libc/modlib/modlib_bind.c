@@ -50,43 +50,112 @@
 #include <nuttx/lib/modlib.h>
 #include <nuttx/binfmt/symtab.h>
 
+#include "libc.h"
 #include "modlib/modlib.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_MODLIB_RELOCATION_BUFFERCOUNT
+#  define CONFIG_MODLIB_RELOCATION_BUFFERCOUNT 32
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Name: modlib_readrel
+ * Name: modlib_readrels
  *
  * Description:
- *   Read the ELF32_Rel structure into memory.
+ *   Read up to 'count' ELF32_Rel structures into memory, beginning with the
+ *   relocation at 'index'.
  *
  ****************************************************************************/
 
-static inline int modlib_readrel(FAR struct mod_loadinfo_s *loadinfo,
-                                 FAR const Elf32_Shdr *relsec,
-                                 int index, FAR Elf32_Rel *rel)
+static inline int modlib_readrels(FAR struct mod_loadinfo_s *loadinfo,
+                                  FAR const Elf32_Shdr *relsec,
+                                  int index, FAR Elf32_Rel *rels, int count)
 {
   off_t offset;
+  int nrels;
 
-  /* Verify that the symbol table index lies within symbol table */
+  /* Verify that the relocation index lies within the relocation section */
 
-  if (index < 0 || index > (relsec->sh_size / sizeof(Elf32_Rel)))
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  if (index < 0 || index >= nrels)
     {
-      berr("ERROR: Bad relocation symbol index: %d\n", index);
+      berr("ERROR: Bad relocation index: %d\n", index);
       return -EINVAL;
     }
 
-  /* Get the file offset to the symbol table entry */
+  if (count > nrels - index)
+    {
+      count = nrels - index;
+    }
+
+  /* Get the file offset to the first relocation entry */
 
   offset = relsec->sh_offset + sizeof(Elf32_Rel) * index;
 
-  /* And, finally, read the symbol table entry into memory */
+  /* And, finally, read the relocation entries into memory */
 
-  return modlib_read(loadinfo, (FAR uint8_t *)rel, sizeof(Elf32_Rel), offset);
+  return modlib_read(loadinfo, (FAR uint8_t *)rels,
+                     sizeof(Elf32_Rel) * count, offset);
 }
 
+/****************************************************************************
+ * Name: modlib_loadsymbols
+ *
+ * Description:
+ *   Read the entire symbol table into memory with a single read.  This
+ *   avoids reading the same symbol table entry from the file for every
+ *   relocation that refers to it.  The cached entries also retain the
+ *   resolved symbol value so that each symbol is resolved only once.
+ *
+ *   This is only an optimization:  If there is insufficient memory to
+ *   hold the symbol table, the symbol table entries will be read one at
+ *   a time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+static void modlib_loadsymbols(FAR struct mod_loadinfo_s *loadinfo)
+{
+  FAR Elf32_Shdr *symtab = &loadinfo->shdr[loadinfo->symtabidx];
+  int nsymbols;
+  int ret;
+
+  nsymbols = symtab->sh_size / sizeof(Elf32_Sym);
+  if (nsymbols <= 0)
+    {
+      return;
+    }
+
+  loadinfo->symbols = (FAR Elf32_Sym *)
+    lib_malloc(sizeof(Elf32_Sym) * nsymbols);
+
+  if (loadinfo->symbols == NULL)
+    {
+      bwarn("WARNING: No memory to cache %d symbols\n", nsymbols);
+      return;
+    }
+
+  ret = modlib_read(loadinfo, (FAR uint8_t *)loadinfo->symbols,
+                    sizeof(Elf32_Sym) * nsymbols, symtab->sh_offset);
+  if (ret < 0)
+    {
+      berr("ERROR: Failed to read the symbol table: %d\n", ret);
+      lib_free(loadinfo->symbols);
+      loadinfo->symbols = NULL;
+      return;
+    }
+
+  loadinfo->nsymbols = nsymbols;
+}
+#endif
+
 /****************************************************************************
  * Name: modlib_relocate and modlib_relocateadd
  *
@@ -105,52 +174,97 @@ static int modlib_relocate(FAR struct module_s *modp,
 {
   FAR Elf32_Shdr *relsec = &loadinfo->shdr[relidx];
   FAR Elf32_Shdr *dstsec = &loadinfo->shdr[relsec->sh_info];
-  Elf32_Rel       rel;
+  FAR Elf32_Rel  *rels;
+  FAR Elf32_Rel  *rel;
   Elf32_Sym       sym;
   FAR Elf32_Sym  *psym;
   uintptr_t       addr;
   int             symidx;
+  int             nrels;
   int             ret;
   int             i;
+  int             j;
+
+  /* Allocate a buffer to hold a batch of relocation entries.  The entries
+   * are read from the file in batches rather than one at a time.
+   */
+
+  rels = (FAR Elf32_Rel *)
+    lib_malloc(sizeof(Elf32_Rel) * CONFIG_MODLIB_RELOCATION_BUFFERCOUNT);
+
+  if (rels == NULL)
+    {
+      berr("ERROR: Failed to allocate the relocation buffer\n");
+      return -ENOMEM;
+    }
 
   /* Examine each relocation in the section.  'relsec' is the section
    * containing the relations.  'dstsec' is the section containing the data
    * to be relocated.
    */
 
-  for (i = 0; i < relsec->sh_size / sizeof(Elf32_Rel); i++)
+  nrels = relsec->sh_size / sizeof(Elf32_Rel);
+  ret   = OK;
+
+  for (i = 0; i < nrels; i++)
     {
       psym = &sym;
 
-      /* Read the relocation entry into memory */
+      /* Read the next batch of relocation entries into memory */
 
-      ret = modlib_readrel(loadinfo, relsec, i, &rel);
-      if (ret < 0)
+      j = i % CONFIG_MODLIB_RELOCATION_BUFFERCOUNT;
+      if (j == 0)
         {
-          berr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
-               relidx, i, ret);
-          return ret;
+          ret = modlib_readrels(loadinfo, relsec, i, rels,
+                                CONFIG_MODLIB_RELOCATION_BUFFERCOUNT);
+          if (ret < 0)
+            {
+              berr("ERROR: Section %d reloc %d: Failed to read relocation entry: %d\n",
+                   relidx, i, ret);
+              break;
+            }
         }
 
+      rel = &rels[j];
+
       /* Get the symbol table index for the relocation.  This is contained
        * in a bit-field within the r_info element.
        */
 
-      symidx = ELF32_R_SYM(rel.r_info);
+      symidx = ELF32_R_SYM(rel->r_info);
 
-      /* Read the symbol table entry into memory */
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+      /* Use the cached copy of the symbol table entry, if available */
 
-      ret = modlib_readsym(loadinfo, symidx, &sym);
-      if (ret < 0)
+      if (loadinfo->symbols != NULL)
+        {
+          if (symidx < 0 || symidx >= loadinfo->nsymbols)
+            {
+              berr("ERROR: Section %d reloc %d: Bad symbol index: %d\n",
+                   relidx, i, symidx);
+              ret = -EINVAL;
+              break;
+            }
+
+          psym = &loadinfo->symbols[symidx];
+        }
+      else
+#endif
         {
-          berr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
-               relidx, i, symidx, ret);
-          return ret;
+          /* Read the symbol table entry into memory */
+
+          ret = modlib_readsym(loadinfo, symidx, &sym);
+          if (ret < 0)
+            {
+              berr("ERROR: Section %d reloc %d: Failed to read symbol[%d]: %d\n",
+                   relidx, i, symidx, ret);
+              break;
+            }
         }
 
-      /* Get the value of the symbol (in sym.st_value) */
+      /* Get the value of the symbol (in st_value) */
 
-      ret = modlib_symvalue(modp, loadinfo, &sym);
+      ret = modlib_symvalue(modp, loadinfo, psym);
       if (ret < 0)
         {
           /* The special error -ESRCH is returned only in one condition:  The
@@ -173,32 +287,44 @@ static int modlib_relocate(FAR struct module_s *modp,
             {
               berr("ERROR: Section %d reloc %d: Failed to get value of symbol[%d]: %d\n",
                   relidx, i, symidx, ret);
-              return ret;
+              break;
             }
         }
+      else
+        {
+          /* st_value now holds the absolute value of the symbol.  Mark the
+           * symbol as absolute so that, if this is the cached copy of the
+           * symbol table entry, the symbol is not resolved again by the
+           * next relocation that refers to it.
+           */
+
+          psym->st_shndx = SHN_ABS;
+        }
 
       /* Calculate the relocation address. */
 
-      if (rel.r_offset < 0 || rel.r_offset > dstsec->sh_size - sizeof(uint32_t))
+      if (rel->r_offset < 0 || rel->r_offset > dstsec->sh_size - sizeof(uint32_t))
         {
           berr("ERROR: Section %d reloc %d: Relocation address out of range, offset %d size %d\n",
-               relidx, i, rel.r_offset, dstsec->sh_size);
-          return -EINVAL;
+               relidx, i, rel->r_offset, dstsec->sh_size);
+          ret = -EINVAL;
+          break;
         }
 
-      addr = dstsec->sh_addr + rel.r_offset;
+      addr = dstsec->sh_addr + rel->r_offset;
 
       /* Now perform the architecture-specific relocation */
 
-      ret = up_relocate(&rel, psym, addr);
+      ret = up_relocate(rel, psym, addr);
       if (ret < 0)
         {
           berr("ERROR: Section %d reloc %d: Relocation failed: %d\n", relidx, i, ret);
-          return ret;
+          break;
         }
     }
 
-  return OK;
+  lib_free(rels);
+  return ret;
 }
 
 static int modlib_relocateadd(FAR struct module_s *modp,
@@ -253,6 +379,12 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
       return -ENOMEM;
     }
 
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+  /* Read the symbol table into memory (if possible) */
+
+  modlib_loadsymbols(loadinfo);
+#endif
+
   /* Process relocations in every allocated section */
 
   for (i = 1; i < loadinfo->ehdr.e_shnum; i++)
@@ -302,5 +434,16 @@ int modlib_bind(FAR struct module_s *modp, FAR struct mod_loadinfo_s *loadinfo)
 
 #endif
 
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+  /* The cached symbol table is no longer needed */
+
+  if (loadinfo->symbols != NULL)
+    {
+      lib_free(loadinfo->symbols);
+      loadinfo->symbols  = NULL;
+      loadinfo->nsymbols = 0;
+    }
+#endif
+
   return ret;
 }
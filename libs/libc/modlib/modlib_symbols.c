@@ -399,13 +399,34 @@ int modlib_symvalue(FAR struct module_s *modp,
 
         if (symbol == NULL)
           {
+            /* modlib_setsymtab() may replace the symbol table and rebuild
+             * its hash index concurrently.  Borrow the registry lock to
+             * keep both stable during the lookup.
+             */
+
+            modlib_registry_lock();
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+            if (g_modlib_symhash.symtab == g_modlib_symtab &&
+                g_modlib_symhash.nsyms == g_modlib_nsymbols)
+              {
+                symbol = symtab_findbyhash(&g_modlib_symhash,
+                                           exportinfo.name);
+              }
+            else
+#endif
+              {
 #ifdef CONFIG_SYMTAB_ORDEREDBYNAME
-            symbol = symtab_findorderedbyname(g_modlib_symtab, exportinfo.name,
-                                              g_modlib_nsymbols);
+                symbol = symtab_findorderedbyname(g_modlib_symtab,
+                                                  exportinfo.name,
+                                                  g_modlib_nsymbols);
 #else
-            symbol = symtab_findbyname(g_modlib_symtab, exportinfo.name,
-                                       g_modlib_nsymbols);
+                symbol = symtab_findbyname(g_modlib_symtab, exportinfo.name,
+                                           g_modlib_nsymbols);
 #endif
+              }
+
+            modlib_registry_unlock();
           }
 
         /* Was the symbol found from any exporter? */
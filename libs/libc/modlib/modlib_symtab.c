@@ -40,11 +40,14 @@
 #include <nuttx/config.h>
 
 #include <assert.h>
+#include <debug.h>
 
 #include <nuttx/symtab.h>
 #include <nuttx/module.h>
 #include <nuttx/lib/modlib.h>
 
+#include "modlib/modlib.h"
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -52,6 +55,10 @@
 FAR const struct symtab_s *g_modlib_symtab;
 FAR int g_modlib_nsymbols;
 
+#ifdef CONFIG_SYMTAB_HASHINDEX
+struct symtab_hash_s g_modlib_symhash;
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -100,10 +107,30 @@ void modlib_getsymtab(FAR const struct symtab_s **symtab, FAR int *nsymbols)
 
 void modlib_setsymtab(FAR const struct symtab_s *symtab, int nsymbols)
 {
+#ifdef CONFIG_SYMTAB_HASHINDEX
+  int ret;
+#endif
+
   /* Borrow the registry lock to assure atomic access */
 
   modlib_registry_lock();
   g_modlib_symtab   = symtab;
   g_modlib_nsymbols = nsymbols;
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+  /* Replace the hash index of the old symbol table.  If the new index
+   * cannot be created, symbols will be found by searching the symbol
+   * table.
+   */
+
+  symtab_hash_release(&g_modlib_symhash);
+
+  ret = symtab_hash_create(&g_modlib_symhash, symtab, nsymbols);
+  if (ret < 0)
+    {
+      bwarn("WARNING: Failed to index the symbol table: %d\n", ret);
+    }
+#endif
+
   modlib_registry_unlock();
 }
@@ -112,5 +112,14 @@ int modlib_freebuffers(struct mod_loadinfo_s *loadinfo)
       loadinfo->buflen    = 0;
     }
 
+#ifdef CONFIG_MODLIB_SYMBOL_CACHE
+  if (loadinfo->symbols != NULL)
+    {
+      lib_free((FAR void *)loadinfo->symbols);
+      loadinfo->symbols   = NULL;
+      loadinfo->nsymbols  = 0;
+    }
+#endif
+
   return OK;
 }
@@ -0,0 +1,98 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_flockfile.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdio.h>
+#include <assert.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: flockfile
+ *
+ * Description:
+ *   Acquire ownership of the stream for the calling thread, waiting if the
+ *   stream is owned by another thread.  Ownership is recursive: each call
+ *   must be balanced by a call to funlockfile().  While the stream is
+ *   owned, the *_unlocked() functions may be used to access it without
+ *   per-call locking overhead.
+ *
+ ****************************************************************************/
+
+void flockfile(FAR FILE *stream)
+{
+  DEBUGASSERT(stream != NULL);
+  lib_take_semaphore(stream);
+}
+
+/****************************************************************************
+ * Name: ftrylockfile
+ *
+ * Description:
+ *   Non-waiting version of flockfile().  Returns zero if ownership of the
+ *   stream was acquired or a non-zero value if the stream is owned by
+ *   another thread.
+ *
+ ****************************************************************************/
+
+int ftrylockfile(FAR FILE *stream)
+{
+  DEBUGASSERT(stream != NULL);
+  return lib_trytake_semaphore(stream) < 0 ? -1 : 0;
+}
+
+/****************************************************************************
+ * Name: funlockfile
+ *
+ * Description:
+ *   Release one reference to the ownership of the stream acquired by
+ *   flockfile() or ftrylockfile().
+ *
+ ****************************************************************************/
+
+void funlockfile(FAR FILE *stream)
+{
+  DEBUGASSERT(stream != NULL);
+  lib_give_semaphore(stream);
+}
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <stdio.h>
+#include <string.h>
 #include <unistd.h>
 #include <fcntl.h>
 #include <errno.h>
@@ -64,7 +65,6 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
   FAR const unsigned char *start = ptr;
   FAR const unsigned char *src   = ptr;
   ssize_t ret = ERROR;
-  unsigned char *dest;
 
   /* Make sure that writing to this stream is allowed */
 
@@ -139,16 +139,13 @@ ssize_t lib_fwrite(FAR const void *ptr, size_t count, FAR FILE *stream)
 
       /* Transfer the data into the buffer */
 
-      for (dest = stream->fs_bufpos; gulp_size > 0; gulp_size--)
-        {
-          *dest++ = *src++;
-        }
-
-      stream->fs_bufpos = dest;
+      memcpy(stream->fs_bufpos, src, gulp_size);
+      stream->fs_bufpos += gulp_size;
+      src               += gulp_size;
 
       /* Is the buffer full? */
 
-      if (dest >= stream->fs_bufend)
+      if (stream->fs_bufpos >= stream->fs_bufend)
         {
           /* Flush the buffered data to the IO stream */
 
@@ -91,6 +91,13 @@
 #define IS_NEGATE(f)             (((f) & FLAG_NEGATE) != 0)
 #define IS_SIGNED(f)             (((f) & (FLAG_SHOWPLUS|FLAG_NEGATE)) != 0)
 
+/* Size of a local buffer large enough to hold the decimal or hexadecimal
+ * representation of an unsigned integer of the given type.  Numbers are
+ * converted into such a buffer and then sent to the stream in one block.
+ */
+
+#define NUMBUF_SIZE(t)           (3 * sizeof(t))
+
 /* If CONFIG_ARCH_ROMGETC is defined, then it is assumed that the format
  * string data cannot be accessed by simply de-referencing the format string
  * pointer.  This might be in the case in Harvard architectures where string
@@ -207,6 +214,31 @@ static const char g_nullstring[] = "(null)";
 #  include "stdio/lib_libdtoa.c"
 #endif
 
+/****************************************************************************
+ * Name: vsprintf_puts
+ *
+ * Description:
+ *   Send a block of characters to the stream, using the bulk puts method
+ *   if the stream provides one.
+ *
+ ****************************************************************************/
+
+static void vsprintf_puts(FAR struct lib_outstream_s *obj,
+                          FAR const char *str, int len)
+{
+  if (obj->puts != NULL)
+    {
+      (void)obj->puts(obj, str, len);
+    }
+  else
+    {
+      while (len-- > 0)
+        {
+          obj->put(obj, *str++);
+        }
+    }
+}
+
 /****************************************************************************
  * Name: ptohex
  ****************************************************************************/
@@ -270,15 +302,17 @@ static int getpsize(uint8_t flags, FAR void *p)
 
 static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 {
-  unsigned int remainder = n % 10;
-  unsigned int dividend  = n / 10;
+  char buffer[NUMBUF_SIZE(unsigned int)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  if (dividend != 0)
+  do
     {
-      utodec(obj, dividend);
+      *--ptr = (char)(n % 10 + '0');
+      n /= 10;
     }
+  while (n != 0);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -288,31 +322,18 @@ static void utodec(FAR struct lib_outstream_s *obj, unsigned int n)
 static void utohex(FAR struct lib_outstream_s *obj, unsigned int n,
                    uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buffer[NUMBUF_SIZE(unsigned int)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  for (bits = 8*sizeof(unsigned int); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
-
-          if (nibble < 10)
-            {
-              obj->put(obj, nibble + '0');
-            }
-          else
-            {
-              obj->put(obj, nibble + a - 10);
-            }
-        }
+      uint8_t nibble = (uint8_t)(n & 0xf);
+      *--ptr = nibble < 10 ? nibble + '0' : nibble + a - 10;
+      n >>= 4;
     }
+  while (n != 0);
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
-    }
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -498,15 +519,17 @@ static int getdblsize(uint8_t fmt, int trunc, uint8_t flags, double n)
 
 static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 {
-  unsigned int  remainder = n % 10;
-  unsigned long dividend  = n / 10;
+  char buffer[NUMBUF_SIZE(unsigned long)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  if (dividend != 0)
+  do
     {
-      lutodec(obj, dividend);
+      *--ptr = (char)(n % 10 + '0');
+      n /= 10;
     }
+  while (n != 0);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -516,31 +539,18 @@ static void lutodec(FAR struct lib_outstream_s *obj, unsigned long n)
 static void lutohex(FAR struct lib_outstream_s *obj, unsigned long n,
                     uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buffer[NUMBUF_SIZE(unsigned long)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  for (bits = 8*sizeof(unsigned long); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
-
-          if (nibble < 10)
-            {
-              obj->put(obj, nibble + '0');
-            }
-          else
-            {
-              obj->put(obj, nibble + a - 10);
-            }
-        }
+      uint8_t nibble = (uint8_t)(n & 0xf);
+      *--ptr = nibble < 10 ? nibble + '0' : nibble + a - 10;
+      n >>= 4;
     }
+  while (n != 0);
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
-    }
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -707,15 +717,17 @@ static int getlusize(uint8_t fmt, uint8_t flags, unsigned long ln)
 
 static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 {
-  unsigned int remainder = n % 10;
-  unsigned long long dividend = n / 10;
+  char buffer[NUMBUF_SIZE(unsigned long long)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  if (dividend != 0)
+  do
     {
-      llutodec(obj, dividend);
+      *--ptr = (char)(n % 10 + '0');
+      n /= 10;
     }
+  while (n != 0);
 
-  obj->put(obj, (remainder + (unsigned int)'0'));
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -725,31 +737,18 @@ static void llutodec(FAR struct lib_outstream_s *obj, unsigned long long n)
 static void llutohex(FAR struct lib_outstream_s *obj, unsigned long long n,
                      uint8_t a)
 {
-  bool    nonzero = false;
-  uint8_t bits;
+  char buffer[NUMBUF_SIZE(unsigned long long)];
+  FAR char *ptr = &buffer[sizeof(buffer)];
 
-  for (bits = 8*sizeof(unsigned long long); bits > 0; bits -= 4)
+  do
     {
-      uint8_t nibble = (uint8_t)((n >> (bits - 4)) & 0xf);
-      if (nibble || nonzero)
-        {
-          nonzero = true;
-
-          if (nibble < 10)
-            {
-              obj->put(obj, (nibble + '0'));
-            }
-          else
-            {
-              obj->put(obj, (nibble + a - 10));
-            }
-        }
+      uint8_t nibble = (uint8_t)(n & 0xf);
+      *--ptr = nibble < 10 ? nibble + '0' : nibble + a - 10;
+      n >>= 4;
     }
+  while (n != 0);
 
-  if (!nonzero)
-    {
-      obj->put(obj, '0');
-    }
+  vsprintf_puts(obj, ptr, &buffer[sizeof(buffer)] - ptr);
 }
 
 /****************************************************************************
@@ -1136,9 +1135,25 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
 
       if (FMT_CHAR != '%')
         {
+#ifndef CONFIG_ARCH_ROMGETC
+           /* Output the whole run of regular characters up to the next
+            * format specifier or through the next newline at once.
+            */
+
+           FAR const char *run = src;
+
+           while (*run != '\n' && run[1] != '\0' && run[1] != '%')
+             {
+               run++;
+             }
+
+           vsprintf_puts(obj, src, run - src + 1);
+           src = run;
+#else
            /* Output the character */
 
            obj->put(obj, FMT_CHAR);
+#endif
 
            /* Flush the buffer if a newline is encountered */
 
@@ -1284,7 +1299,6 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
       if (FMT_CHAR == 's')
         {
           int swidth;
-          int left;
 
           /* Get the string to output */
 
@@ -1301,20 +1315,10 @@ int lib_vsprintf(FAR struct lib_outstream_s *obj, FAR const IPTR char *src,
           swidth = (IS_HASDOT(flags) && trunc >= 0)
                       ? strnlen(ptmp, trunc) : strlen(ptmp);
           prejustify(obj, FMT_CHAR, justify, 0, width, swidth, 0);
-          left = swidth;
 
           /* Concatenate the string into the output */
 
-          while (*ptmp)
-            {
-              if (left-- <= 0)
-                {
-                  break;
-                }
-
-              obj->put(obj, *ptmp);
-              ptmp++;
-            }
+          vsprintf_puts(obj, ptmp, swidth);
 
           /* Perform left-justification operations. */
 
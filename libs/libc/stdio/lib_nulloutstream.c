@@ -53,6 +53,18 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
   this->nput++;
 }
 
+/****************************************************************************
+ * Name: nulloutstream_puts
+ ****************************************************************************/
+
+static int nulloutstream_puts(FAR struct lib_outstream_s *this,
+                              FAR const void *buf, int len)
+{
+  DEBUGASSERT(this);
+  this->nput += len;
+  return len;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -76,6 +88,7 @@ static void nulloutstream_putc(FAR struct lib_outstream_s *this, int ch)
 void lib_nulloutstream(FAR struct lib_outstream_s *nulloutstream)
 {
   nulloutstream->put   = nulloutstream_putc;
+  nulloutstream->puts  = nulloutstream_puts;
   nulloutstream->flush = lib_noflush;
   nulloutstream->nput  = 0;
 }
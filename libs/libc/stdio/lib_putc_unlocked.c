@@ -0,0 +1,111 @@
+/****************************************************************************
+ * libs/libc/stdio/lib_putc_unlocked.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+
+#include "libc.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: fputc_unlocked
+ *
+ * Description:
+ *   Same as fputc() but the caller must already own the stream (see
+ *   flockfile()).  If the character fits into the write buffer, it is
+ *   stored there directly; otherwise this falls back to fputc().
+ *
+ ****************************************************************************/
+
+int fputc_unlocked(int c, FAR FILE *stream)
+{
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  if (stream != NULL && c != '\n' && LIB_CANPUTC(stream))
+    {
+      *stream->fs_bufpos++ = (unsigned char)c;
+      return (unsigned char)c;
+    }
+#endif
+
+  return fputc(c, stream);
+}
+
+/****************************************************************************
+ * Name: putchar_unlocked
+ ****************************************************************************/
+
+int putchar_unlocked(int c)
+{
+  return fputc_unlocked(c, stdout);
+}
+
+/****************************************************************************
+ * Name: fwrite_unlocked
+ *
+ * Description:
+ *   Same as fwrite() but the caller must already own the stream (see
+ *   flockfile()).  Data that fits into the write buffer is copied there
+ *   directly; otherwise this falls back to fwrite().
+ *
+ ****************************************************************************/
+
+size_t fwrite_unlocked(FAR const void *ptr, size_t size, size_t n_items,
+                       FAR FILE *stream)
+{
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  size_t full_size = n_items * size;
+
+  if (stream != NULL && full_size > 0 && LIB_CANPUTC(stream) &&
+      (size_t)(stream->fs_bufend - stream->fs_bufpos) > full_size)
+    {
+      memcpy(stream->fs_bufpos, ptr, full_size);
+      stream->fs_bufpos += full_size;
+      return n_items;
+    }
+#endif
+
+  return fwrite(ptr, size, n_items, stream);
+}
@@ -38,6 +38,7 @@
  ****************************************************************************/
 
 #include <fcntl.h>
+#include <string.h>
 #include <assert.h>
 #include <errno.h>
 
@@ -58,6 +59,21 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
 
   DEBUGASSERT(this && sthis->stream);
 
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+  /* The caller holds the stream semaphore (see vfprintf()).  If the
+   * character fits in the write buffer without filling it, then just store
+   * it there.  Newlines take the slow path so that line buffering is
+   * honored.
+   */
+
+  if (ch != '\n' && LIB_CANPUTC(sthis->stream))
+    {
+      *sthis->stream->fs_bufpos++ = ch;
+      this->nput++;
+      return;
+    }
+#endif
+
   /* Loop until the character is successfully transferred or an irrecoverable
    * error occurs.
    */
@@ -78,6 +94,51 @@ static void stdoutstream_putc(FAR struct lib_outstream_s *this, int ch)
   while (get_errno() == EINTR);
 }
 
+/****************************************************************************
+ * Name: stdoutstream_puts
+ ****************************************************************************/
+
+static int stdoutstream_puts(FAR struct lib_outstream_s *this,
+                             FAR const void *buf, int len)
+{
+  FAR struct lib_stdoutstream_s *sthis = (FAR struct lib_stdoutstream_s *)this;
+  int result;
+
+  DEBUGASSERT(this && sthis->stream);
+
+  /* Loop until the data is successfully transferred or an irrecoverable
+   * error occurs.
+   */
+
+  do
+    {
+      result = lib_fwrite(buf, len, sthis->stream);
+      if (result >= 0)
+        {
+          this->nput += result;
+
+#ifndef CONFIG_STDIO_DISABLE_BUFFERING
+          /* Honor line buffering as fputc() would */
+
+          if ((sthis->stream->fs_flags & __FS_FLAG_LBF) != 0 &&
+              memchr(buf, '\n', result) != NULL)
+            {
+              (void)lib_fflush(sthis->stream, true);
+            }
+#endif
+
+          return result;
+        }
+
+      /* EINTR (meaning that lib_fwrite was interrupted by a signal) is the
+       * only recoverable error.
+       */
+    }
+  while (get_errno() == EINTR);
+
+  return result;
+}
+
 /****************************************************************************
  * Name: stdoutstream_flush
  ****************************************************************************/
@@ -100,7 +161,8 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *this)
  * Name: lib_stdoutstream
  *
  * Description:
- *   Initializes a stream for use with a FILE instance.
+ *   Initializes a stream for use with a FILE instance.  The caller must
+ *   hold the stream semaphore for as long as the outstream is in use.
  *
  * Input Parameters:
  *   outstream - User allocated, uninitialized instance of struct
@@ -116,9 +178,10 @@ static int stdoutstream_flush(FAR struct lib_outstream_s *this)
 void lib_stdoutstream(FAR struct lib_stdoutstream_s *outstream,
                       FAR FILE *stream)
 {
-  /* Select the put operation */
+  /* Select the put operations */
 
-  outstream->public.put = stdoutstream_putc;
+  outstream->public.put  = stdoutstream_putc;
+  outstream->public.puts = stdoutstream_puts;
 
   /* Select the correct flush operation.  This flush is only called when
    * a newline is encountered in the output stream.  However, we do not
@@ -0,0 +1,243 @@
+/****************************************************************************
+ * libs/libc/symtab/symtab_hash.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/symtab.h>
+
+#include "libc.h"
+
+#ifdef CONFIG_SYMTAB_HASHINDEX
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hashname
+ *
+ * Description:
+ *   Return the hash of a symbol name.  This is the same simple hash
+ *   function (h * 33 + c) that is used in GNU-style ELF hash sections.
+ *
+ ****************************************************************************/
+
+static uint32_t symtab_hashname(FAR const char *name)
+{
+  uint32_t hash = 5381;
+
+  while (*name != '\0')
+    {
+      hash = (hash << 5) + hash + (uint8_t)*name++;
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: symtab_hash_create
+ *
+ * Description:
+ *   Build a hash index for the symbol table.  The hash index permits
+ *   symbols to be found by name in (nearly) constant time, regardless of
+ *   the ordering of the symbol table.
+ *
+ * Input Parameters:
+ *   hash   - The hash index instance to be initialized
+ *   symtab - The symbol table to be indexed
+ *   nsyms  - The number of symbols in the symbol table
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   any failure.
+ *
+ ****************************************************************************/
+
+int symtab_hash_create(FAR struct symtab_hash_s *hash,
+                       FAR const struct symtab_s *symtab, int nsyms)
+{
+  FAR uint8_t *alloc;
+  size_t allocsize;
+  int nbuckets;
+  int bucket;
+  int i;
+
+  DEBUGASSERT(hash != NULL && (symtab != NULL || nsyms == 0));
+
+  memset(hash, 0, sizeof(struct symtab_hash_s));
+  if (nsyms <= 0)
+    {
+      return OK;
+    }
+
+  if (nsyms >= SYMTAB_HASH_NONE)
+    {
+      return -E2BIG;
+    }
+
+  /* Use roughly one bucket for every two symbols */
+
+  nbuckets  = (nsyms + 1) >> 1;
+
+  /* Allocate the array of hashes, the chain links, and the bucket heads in
+   * one allocation.
+   */
+
+  allocsize = nsyms * (sizeof(uint32_t) + sizeof(uint16_t)) +
+              nbuckets * sizeof(uint16_t);
+
+  alloc = (FAR uint8_t *)lib_malloc(allocsize);
+  if (alloc == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  hash->symtab   = symtab;
+  hash->nsyms    = nsyms;
+  hash->nbuckets = nbuckets;
+  hash->hashes   = (FAR uint32_t *)alloc;
+  hash->chain    = (FAR uint16_t *)&hash->hashes[nsyms];
+  hash->buckets  = &hash->chain[nsyms];
+
+  for (i = 0; i < nbuckets; i++)
+    {
+      hash->buckets[i] = SYMTAB_HASH_NONE;
+    }
+
+  /* Add the symbols in reverse order so that the symbols in each chain
+   * appear in the same order as in the symbol table.  If a name appears
+   * more than once, then the first occurrence will be found, just as with
+   * symtab_findbyname().
+   */
+
+  for (i = nsyms - 1; i >= 0; i--)
+    {
+      hash->hashes[i]       = symtab_hashname(symtab[i].sym_name);
+      bucket                = hash->hashes[i] % nbuckets;
+      hash->chain[i]        = hash->buckets[bucket];
+      hash->buckets[bucket] = (uint16_t)i;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: symtab_hash_release
+ *
+ * Description:
+ *   Free the resources used by a hash index created by
+ *   symtab_hash_create().
+ *
+ * Input Parameters:
+ *   hash - The hash index instance to be released
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void symtab_hash_release(FAR struct symtab_hash_s *hash)
+{
+  DEBUGASSERT(hash != NULL);
+
+  if (hash->hashes != NULL)
+    {
+      lib_free(hash->hashes);
+    }
+
+  memset(hash, 0, sizeof(struct symtab_hash_s));
+}
+
+/****************************************************************************
+ * Name: symtab_findbyhash
+ *
+ * Description:
+ *   Find the symbol in the hash indexed symbol table with the matching
+ *   name.
+ *
+ * Returned Value:
+ *   A reference to the symbol table entry if an entry with the matching
+ *   name is found; NULL is returned if the entry is not found.
+ *
+ ****************************************************************************/
+
+FAR const struct symtab_s *
+symtab_findbyhash(FAR const struct symtab_hash_s *hash,
+                  FAR const char *name)
+{
+  uint32_t namehash;
+  uint16_t index;
+
+  DEBUGASSERT(hash != NULL && name != NULL);
+
+  if (hash->nsyms == 0)
+    {
+      return NULL;
+    }
+
+  /* Only the names of the symbols with a matching hash need to be
+   * compared.
+   */
+
+  namehash = symtab_hashname(name);
+  for (index = hash->buckets[namehash % hash->nbuckets];
+       index != SYMTAB_HASH_NONE;
+       index = hash->chain[index])
+    {
+      if (hash->hashes[index] == namehash &&
+          strcmp(name, hash->symtab[index].sym_name) == 0)
+        {
+          return &hash->symtab[index];
+        }
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_SYMTAB_HASHINDEX */
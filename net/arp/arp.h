@@ -488,6 +488,133 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_dump(arp)
 #endif
 
+/****************************************************************************
+ * Name: arp_pending_add
+ *
+ * Description:
+ *   Hold a copy of the IPv4 packet in the device buffer until the MAC
+ *   address of 'ipaddr' has been resolved.  This is called from arp_out()
+ *   just before the packet is replaced with an ARP request.
+ *
+ * Input Parameters:
+ *   dev    - The device holding the outgoing IPv4 packet
+ *   ipaddr - The next hop address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_add(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_resolved
+ *
+ * Description:
+ *   The MAC address of 'ipaddr' has been added to the ARP table.  Mark all
+ *   packets held for the address as ready to send and notify the network
+ *   devices that there is TX data available.
+ *
+ * Input Parameters:
+ *   ipaddr - The address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_resolved(in_addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Provide each held packet that is ready to be sent on this device to the
+ *   driver.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver's poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the poll callback (non-zero
+ *   terminates the poll).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback);
+#else
+#  define arp_pending_poll(d,c) (0)
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_purge
+ *
+ * Description:
+ *   Discard all packets held for a network device that is being
+ *   unregistered.
+ *
+ * Input Parameters:
+ *   dev - The device being unregistered
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_purge(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_reset
+ *
+ * Description:
+ *   Discard all held packets.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_reset(void);
+#endif
+
+/****************************************************************************
+ * Name: arp_pending_expire
+ *
+ * Description:
+ *   Discard held packets whose address has not been resolved in time.
+ *
+ * Assumptions:
+ *   Called from the ARP timer interrupt handler.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARP_PENDING
+void arp_pending_expire(void);
+#endif
+
 #else /* CONFIG_NET_ARP */
 
 /* If ARP is disabled, stub out all ARP interfaces */
@@ -256,6 +256,15 @@ void arp_out(FAR struct net_driver_s *dev)
     {
       ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
+#ifdef CONFIG_NET_ARP_PENDING
+      /* Hold a copy of the IP packet so that it can be sent when the
+       * address has been resolved, rather than waiting for it to be
+       * retransmitted.
+       */
+
+      arp_pending_add(dev, ipaddr);
+#endif
+
       /* The destination address was not in our ARP table, so we overwrite
        * the IP packet with an ARP request.
        */
@@ -0,0 +1,462 @@
+/****************************************************************************
+ * net/arp/arp_pending.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/arp.h>
+
+#include "netdev/netdev.h"
+#include "arp/arp.h"
+
+#ifdef CONFIG_NET_ARP_PENDING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packets are discarded if the address is not resolved within this time */
+
+#define ARP_PENDING_MAXAGE MSEC2TICK(3000)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one IPv4 packet waiting for the resolution of
+ * the MAC address of its next hop.
+ */
+
+struct arp_pending_s
+{
+  FAR struct iob_s        *ap_iob;    /* The held IPv4 packet (NULL: unused) */
+  FAR struct net_driver_s *ap_dev;    /* The device that will send the packet */
+  in_addr_t                ap_ipaddr; /* The next hop IPv4 address */
+  clock_t                  ap_time;   /* Time when the packet was held */
+  bool                     ap_ready;  /* True: The address has been resolved */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct arp_pending_s g_arp_pending[CONFIG_NET_ARP_NPENDING];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_pending_free
+ *
+ * Description:
+ *   Release a held packet.
+ *
+ ****************************************************************************/
+
+static void arp_pending_free(FAR struct arp_pending_s *pending)
+{
+  iob_free_chain(pending->ap_iob);
+  pending->ap_iob   = NULL;
+  pending->ap_dev   = NULL;
+  pending->ap_ready = false;
+}
+
+/****************************************************************************
+ * Name: arp_pending_match
+ *
+ * Description:
+ *   Return true if the held packet is identical to the IPv4 packet in the
+ *   device buffer.  This happens when a packet is retransmitted before its
+ *   next hop address has been resolved.
+ *
+ ****************************************************************************/
+
+static bool arp_pending_match(FAR struct arp_pending_s *pending,
+                              FAR struct net_driver_s *dev)
+{
+  FAR const uint8_t *buf = &dev->d_buf[NET_LL_HDRLEN(dev)];
+  FAR struct iob_s *iob = pending->ap_iob;
+
+  if (pending->ap_dev != dev || iob->io_pktlen != dev->d_len)
+    {
+      return false;
+    }
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (memcmp(buf, &iob->io_data[iob->io_offset], iob->io_len) != 0)
+        {
+          return false;
+        }
+
+      buf += iob->io_len;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: arp_pending_discard
+ *
+ * Description:
+ *   Release all held packets whose address has not been resolved within
+ *   ARP_PENDING_MAXAGE.
+ *
+ * Assumptions:
+ *   Interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static void arp_pending_discard(clock_t now)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      FAR struct arp_pending_s *pending = &g_arp_pending[i];
+
+      if (pending->ap_iob != NULL && !pending->ap_ready &&
+          now - pending->ap_time >= ARP_PENDING_MAXAGE)
+        {
+          ninfo("Discarding packet for %08lx\n",
+                (unsigned long)pending->ap_ipaddr);
+          arp_pending_free(pending);
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_pending_add
+ *
+ * Description:
+ *   Hold a copy of the IPv4 packet in the device buffer until the MAC
+ *   address of 'ipaddr' has been resolved.  This is called from arp_out()
+ *   just before the packet is replaced with an ARP request.  If there is no
+ *   space to hold the packet, then it is simply lost as it would be without
+ *   this feature.
+ *
+ * Input Parameters:
+ *   dev    - The device holding the outgoing IPv4 packet
+ *   ipaddr - The next hop address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_add(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_pending_s *pending = NULL;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  clock_t now = clock_systimer();
+  int ret;
+  int i;
+
+  /* Discard expired packets and find a free slot.  Interrupts are disabled
+   * because unresolved packets may also be discarded by arp_timer().
+   */
+
+  flags = enter_critical_section();
+  arp_pending_discard(now);
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      FAR struct arp_pending_s *tmp = &g_arp_pending[i];
+
+      /* Don't hold a second copy of a retransmitted packet */
+
+      if (tmp->ap_iob != NULL && !tmp->ap_ready &&
+          net_ipv4addr_cmp(tmp->ap_ipaddr, ipaddr) &&
+          arp_pending_match(tmp, dev))
+        {
+          leave_critical_section(flags);
+          return;
+        }
+
+      if (tmp->ap_iob == NULL && pending == NULL)
+        {
+          pending = tmp;
+        }
+    }
+
+  leave_critical_section(flags);
+
+  if (pending == NULL)
+    {
+      ninfo("No space to hold packet for %08lx\n", (unsigned long)ipaddr);
+      return;
+    }
+
+  /* Copy the IPv4 packet (without the link layer header) into an I/O
+   * buffer chain.  Do not wait for I/O buffers; we are on the driver's
+   * transmit path.  The free slot cannot be taken meanwhile:  Only this
+   * function, called with the network locked, fills slots.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[NET_LL_HDRLEN(dev)], dev->d_len, 0,
+                      true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  flags = enter_critical_section();
+  pending->ap_iob    = iob;
+  pending->ap_dev    = dev;
+  pending->ap_ipaddr = ipaddr;
+  pending->ap_time   = now;
+  pending->ap_ready  = false;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: arp_pending_resolved
+ *
+ * Description:
+ *   The MAC address of 'ipaddr' has been added to the ARP table.  Mark all
+ *   packets held for the address as ready to send and notify the network
+ *   devices that there is TX data available.
+ *
+ * Input Parameters:
+ *   ipaddr - The address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_resolved(in_addr_t ipaddr)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      FAR struct arp_pending_s *pending = &g_arp_pending[i];
+
+      if (pending->ap_iob != NULL && !pending->ap_ready &&
+          net_ipv4addr_cmp(pending->ap_ipaddr, ipaddr))
+        {
+          pending->ap_ready = true;
+          netdev_txnotify_dev(pending->ap_dev);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Provide each packet that is ready to be sent on this device to the
+ *   driver.  The driver's poll callback will add the Ethernet header with
+ *   arp_out() as it does for any other outgoing IPv4 packet.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver's poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the poll callback (non-zero
+ *   terminates the poll).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback)
+{
+  int bstop = 0;
+  int i;
+
+  /* Packets that are ready to send are never discarded by arp_timer() so
+   * there is no need to disable interrupts here.
+   */
+
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING && !bstop; i++)
+    {
+      FAR struct arp_pending_s *pending = &g_arp_pending[i];
+
+      if (pending->ap_iob != NULL && pending->ap_ready &&
+          pending->ap_dev == dev)
+        {
+          /* Restore the IPv4 packet to the device buffer */
+
+          dev->d_len    = iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)],
+                                      pending->ap_iob,
+                                      pending->ap_iob->io_pktlen, 0);
+          dev->d_sndlen = 0;
+          IFF_SET_IPv4(dev->d_flags);
+
+          arp_pending_free(pending);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
+    }
+
+  return bstop;
+}
+
+/****************************************************************************
+ * Name: arp_pending_purge
+ *
+ * Description:
+ *   Discard all packets held for a network device.  This is called when
+ *   the device is unregistered so that no reference to it remains.
+ *
+ * Input Parameters:
+ *   dev - The device being unregistered
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_purge(FAR struct net_driver_s *dev)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      if (g_arp_pending[i].ap_iob != NULL && g_arp_pending[i].ap_dev == dev)
+        {
+          arp_pending_free(&g_arp_pending[i]);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: arp_pending_reset
+ *
+ * Description:
+ *   Discard all held packets.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void arp_pending_reset(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = enter_critical_section();
+  for (i = 0; i < CONFIG_NET_ARP_NPENDING; i++)
+    {
+      if (g_arp_pending[i].ap_iob != NULL)
+        {
+          arp_pending_free(&g_arp_pending[i]);
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: arp_pending_expire
+ *
+ * Description:
+ *   Discard held packets whose address has not been resolved in time.
+ *   This is called from arp_timer() so that held I/O buffers are released
+ *   even if there are no further ARP misses.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the ARP timer interrupt handler.
+ *
+ ****************************************************************************/
+
+void arp_pending_expire(void)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  arp_pending_discard(clock_systimer());
+  leave_critical_section(flags);
+}
+
+#endif /* CONFIG_NET_ARP_PENDING */
@@ -65,6 +65,18 @@
 
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifndef CONFIG_NET_ARP_HASHSIZE
+#  define CONFIG_NET_ARP_HASHSIZE 8
+#endif
+
+#if CONFIG_NET_ARP_HASHSIZE < 1
+#  error CONFIG_NET_ARP_HASHSIZE must be at least 1
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -75,13 +87,26 @@ struct arp_table_info_s
   FAR struct ether_addr *ai_ethaddr;  /* Location to return the MAC address */
 };
 
+/* One entry in the ARP table.  In-use entries are retained in a hash bucket
+ * list selected by the IP address; unused entries are retained in a free
+ * list.
+ */
+
+struct arp_tabent_s
+{
+  struct arp_entry_s       te_entry;  /* The ARP table entry (must be first) */
+  FAR struct arp_tabent_s *te_flink;  /* Next entry in the bucket/free list */
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_tabent_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static FAR struct arp_tabent_s *g_arphash[CONFIG_NET_ARP_HASHSIZE];
+static FAR struct arp_tabent_s *g_arpfree;
 static uint8_t g_arptime;
 
 /****************************************************************************
@@ -134,6 +159,57 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the hash bucket list associated with an IP address.
+ *
+ ****************************************************************************/
+
+static inline FAR struct arp_tabent_s **arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr;
+
+  /* Fold all of the address bytes into the low-order bits.  The low-order
+   * host bytes are in different positions for each byte ordering so all
+   * bytes must contribute.
+   */
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return &g_arphash[hash % CONFIG_NET_ARP_HASHSIZE];
+}
+
+/****************************************************************************
+ * Name: arp_remove
+ *
+ * Description:
+ *   Remove an in-use entry from its hash bucket and return it to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+static void arp_remove(FAR struct arp_tabent_s *tabent)
+{
+  FAR struct arp_tabent_s **link;
+
+  for (link = arp_hash(tabent->te_entry.at_ipaddr);
+       *link != NULL;
+       link = &(*link)->te_flink)
+    {
+      if (*link == tabent)
+        {
+          *link = tabent->te_flink;
+          break;
+        }
+    }
+
+  tabent->te_entry.at_ipaddr = 0;
+  tabent->te_flink           = g_arpfree;
+  g_arpfree                  = tabent;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -150,10 +226,24 @@ void arp_reset(void)
 {
   int i;
 
+  for (i = 0; i < CONFIG_NET_ARP_HASHSIZE; ++i)
+    {
+      g_arphash[i] = NULL;
+    }
+
+  g_arpfree = NULL;
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+      g_arptable[i].te_entry.at_ipaddr = 0;
+      g_arptable[i].te_flink           = g_arpfree;
+      g_arpfree                        = &g_arptable[i];
     }
+
+#ifdef CONFIG_NET_ARP_PENDING
+  /* Discard any packets waiting for address resolution */
+
+  arp_pending_reset();
+#endif
 }
 
 /****************************************************************************
@@ -175,14 +265,20 @@ void arp_timer(void)
   ++g_arptime;
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &g_arptable[i].te_entry;
 
       if (tabptr->at_ipaddr != 0 &&
           g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
         {
-          tabptr->at_ipaddr = 0;
+          arp_remove(&g_arptable[i]);
         }
     }
+
+#ifdef CONFIG_NET_ARP_PENDING
+  /* Discard held packets that are still waiting for address resolution */
+
+  arp_pending_expire();
+#endif
 }
 
 /****************************************************************************
@@ -207,61 +303,44 @@ void arp_timer(void)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry_s *tabptr = NULL;
-  int               i;
+  FAR struct arp_tabent_s **bucket;
+  FAR struct arp_tabent_s *tabent;
+  FAR struct arp_entry_s *tabptr;
+  int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  /* Try to find an existing entry to update. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabptr = arp_lookup(ipaddr);
+  if (tabptr != NULL)
     {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
-
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
+      /* An old entry found, update this and return. */
 
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
-        }
+      memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
+      tabptr->at_time = g_arptime;
+      return OK;
     }
 
-  /* If we get here, no existing ARP table entry was found, so we create one. */
-  /* First, we try to find an unused entry in the ARP table. */
+  /* If we get here, no existing ARP table entry was found, so we create one.
+   * First, we try to get an unused entry from the free list.
+   */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  tabent = g_arpfree;
+  if (tabent != NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
+      g_arpfree = tabent->te_flink;
     }
-
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
-   */
-
-  if (i == CONFIG_NET_ARPTAB_SIZE)
+  else
     {
       uint8_t tmpage = 0;
       int j = 0;
 
+      /* If no unused entry is found, we try to find the oldest entry and
+       * throw it away.
+       */
+
       for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
         {
-          tabptr = &g_arptable[i];
+          tabptr = &g_arptable[i].te_entry;
           if (g_arptime - tabptr->at_time > tmpage)
             {
               tmpage = g_arptime - tabptr->at_time;
@@ -269,17 +348,31 @@ int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
             }
         }
 
-      i = j;
-      tabptr = &g_arptable[i];
+      arp_remove(&g_arptable[j]);
+
+      tabent    = g_arpfree;
+      g_arpfree = tabent->te_flink;
     }
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
+  /* Now, fill the entry with the new information and add it to its hash
+   * bucket.
    */
 
+  tabptr = &tabent->te_entry;
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_time = g_arptime;
+
+  bucket           = arp_hash(ipaddr);
+  tabent->te_flink = *bucket;
+  *bucket          = tabent;
+
+#ifdef CONFIG_NET_ARP_PENDING
+  /* Release any packets that were waiting for this address */
+
+  arp_pending_resolved(ipaddr);
+#endif
+
   return OK;
 }
 
@@ -329,17 +422,17 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr)
 {
-  FAR struct arp_entry_s *tabptr;
-  int i;
+  FAR struct arp_tabent_s *tabent;
 
-  /* Check if the IPv4 address is already in the ARP table. */
+  /* Check if the IPv4 address is already in the ARP table.  Only the hash
+   * bucket selected by the address needs to be searched.
+   */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (tabent = *arp_hash(ipaddr); tabent != NULL; tabent = tabent->te_flink)
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+      if (net_ipv4addr_cmp(ipaddr, tabent->te_entry.at_ipaddr))
         {
-          return tabptr;
+          return &tabent->te_entry;
         }
     }
 
@@ -434,9 +527,9 @@ void arp_delete(in_addr_t ipaddr)
   tabptr = arp_lookup(ipaddr);
   if (tabptr != NULL)
     {
-      /* Yes.. Set the IP address to zero to "delete" it */
+      /* Yes.. Remove it from its hash bucket and free it */
 
-      tabptr->at_ipaddr = 0;
+      arp_remove((FAR struct arp_tabent_s *)tabptr);
     }
 }
 
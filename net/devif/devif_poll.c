@@ -41,6 +41,7 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <stdbool.h>
 #include <debug.h>
 
 #include <nuttx/clock.h>
@@ -496,7 +497,13 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
  * Name: devif_poll_tcp_connections
  *
  * Description:
- *   Poll all UDP connections for available packets to send.
+ *   Poll all TCP connections for available packets to send.
+ *
+ *   If CONFIG_NET_TCP_TXBURST > 1, then a connection that provided a packet
+ *   will be polled again (up to CONFIG_NET_TCP_TXBURST times) for as long
+ *   as the driver accepts the packets and continues the poll.  This allows
+ *   drivers with TX queues to take a burst of segments from one connection
+ *   in a single poll.
  *
  * Assumptions:
  *   This function is called from the MAC device driver with the network
@@ -515,6 +522,27 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
 
   while (!bstop && (conn = tcp_nextconn(conn)))
     {
+#if CONFIG_NET_TCP_TXBURST > 1
+      int nsegs = 0;
+      bool sent;
+
+      do
+        {
+          /* Perform the TCP TX poll */
+
+          tcp_poll(dev, conn);
+          sent = (dev->d_len > 0);
+
+          /* Perform any necessary conversions on outgoing packets */
+
+          devif_packet_conversion(dev, DEVIF_TCP);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
+      while (!bstop && sent && ++nsegs < CONFIG_NET_TCP_TXBURST);
+#else
       /* Perform the TCP TX poll */
 
       tcp_poll(dev, conn);
@@ -526,6 +554,7 @@ static inline int devif_poll_tcp_connections(FAR struct net_driver_s *dev,
       /* Call back into the driver */
 
       bstop = callback(dev);
+#endif
     }
 
   return bstop;
@@ -621,6 +650,24 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
   bstop = arp_poll(dev, callback);
   if (!bstop)
 #endif
+#ifdef CONFIG_NET_ARP_PENDING
+    {
+      /* Send packets that were waiting for address resolution */
+
+      bstop = arp_pending_poll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+    {
+      /* Send IPv6 packets that were waiting for address resolution */
+
+      bstop = neighbor_pending_poll(dev, callback);
+    }
+
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_PKT
     {
       /* Check for pending packet socket transfer */
@@ -53,6 +53,9 @@
 
 #include <nuttx/fs/fs.h>
 #include <nuttx/net/net.h>
+#ifdef CONFIG_NET_LOCAL_DIRECT
+#  include <nuttx/mm/iob.h>
+#endif
 
 #ifdef CONFIG_NET_LOCAL
 
@@ -68,7 +71,7 @@
 
 /* Packet format in FIFO:
  *
- * 1. Sync bytes (7 at most)
+ * 1. Sync bytes (always 7)
  * 2. End/Start byte
  * 3. 16-bit packet length (in host order)
  * 4. Packet data (in host order)
@@ -77,6 +80,9 @@
 #define LOCAL_SYNC_BYTE   0x42     /* Byte in sync sequence */
 #define LOCAL_END_BYTE    0xbd     /* End of sync seqence */
 
+#define LOCAL_PREAMBLE_SIZE 8      /* Sync bytes + end byte */
+#define LOCAL_HEADER_SIZE   (LOCAL_PREAMBLE_SIZE + sizeof(uint16_t))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -157,12 +163,25 @@ struct local_conn_s
 
 #ifdef HAVE_LOCAL_POLL
   /* The following is a list if poll structures of threads waiting for
-   * socket accept events.
+   * socket accept events, or for data events on a socket connected by the
+   * direct transport.
    */
 
   struct pollfd *lc_accept_fds[LOCAL_ACCEPT_NPOLLWAITERS];
 #endif
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Fields of connected SOCK_STREAM or SOCK_SEQPACKET sockets that use the
+   * direct transport.  Protected by the network lock.
+   */
+
+  bool lc_direct;              /* Connected by the direct transport */
+  FAR struct local_conn_s *lc_peer; /* The other socket (NULL once closed) */
+  FAR struct iob_s *lc_rcvq;   /* Data received from the peer, in order */
+  sem_t lc_rcvsem;             /* Used to wait for data in lc_rcvq */
+  sem_t lc_sndsem;             /* Used to wait for room in the peer lc_rcvq */
+#endif
+
   /* Union of fields unique to SOCK_STREAM client, server, and connected
    * peers.
    */
@@ -363,6 +382,182 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                  FAR socklen_t *addrlen, FAR struct socket *newsock);
 #endif
 
+/****************************************************************************
+ * Name: local_generate_instance_id
+ *
+ * Description:
+ *   Generate a new instance ID used to make the FIFO names of a stream
+ *   connection unique.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+int32_t local_generate_instance_id(void);
+#endif
+
+/****************************************************************************
+ * Name: local_socketpair
+ *
+ * Description:
+ *   Connect two newly created, unbound Unix domain sockets to each other.
+ *   This is the local socket part of socketpair().  SOCK_STREAM sockets are
+ *   supported; so are SOCK_SEQPACKET sockets if CONFIG_NET_LOCAL_DIRECT is
+ *   enabled.
+ *
+ * Input Parameters:
+ *   conn0, conn1 - The connection structures of the two sockets
+ *   type         - The socket type
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.  On failure, the connections are left for the caller to close.
+ *
+ * Assumptions:
+ *   Network is NOT locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+int local_socketpair(FAR struct local_conn_s *conn0,
+                     FAR struct local_conn_s *conn1, int type);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_link
+ *
+ * Description:
+ *   Connect two Unix domain sockets directly to each other.  This is used
+ *   for the sockets of a socketpair() and by accept() to connect the new
+ *   socket with the client that called connect().
+ *
+ * Input Parameters:
+ *   conn0, conn1 - The connection structures of the two sockets
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_link(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_pair
+ *
+ * Description:
+ *   Connect two newly created, unbound SOCK_STREAM or SOCK_SEQPACKET Unix
+ *   domain sockets directly to each other.  Data sent on one socket is
+ *   copied into I/O buffers queued on the other; no FIFO is involved.
+ *
+ * Input Parameters:
+ *   conn0, conn1 - The connection structures of the two sockets
+ *   type         - The socket type
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.
+ *
+ * Assumptions:
+ *   Network is NOT locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+int local_direct_pair(FAR struct local_conn_s *conn0,
+                      FAR struct local_conn_s *conn1, int type);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Send data to the peer of a socket connected by the direct transport.
+ *
+ * Input Parameters:
+ *   psock    An instance of the internal socket structure.
+ *   buf      Data to send
+ *   len      Length of data to send
+ *   flags    Send flags (MSG_DONTWAIT is honored)
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes sent.  On error, a negated
+ *   errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_send(FAR struct socket *psock, FAR const void *buf,
+                          size_t len, int flags);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_recvfrom
+ *
+ * Description:
+ *   Receive data on a socket connected by the direct transport.
+ *
+ * Input Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   buf      Buffer to receive data
+ *   len      Length of buffer
+ *   flags    Receive flags (MSG_DONTWAIT is honored)
+ *   from     Address of source (may be NULL)
+ *   fromlen  The length of the address structure
+ *
+ * Returned Value:
+ *   On success, returns the number of bytes received; zero once the peer
+ *   has been closed and all queued data has been received.  On error, a
+ *   negated errno value is returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+ssize_t local_direct_recvfrom(FAR struct socket *psock, FAR void *buf,
+                              size_t len, int flags,
+                              FAR struct sockaddr *from,
+                              FAR socklen_t *fromlen);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_events
+ *
+ * Description:
+ *   Return the poll events that are currently true for a socket connected
+ *   by the direct transport.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_LOCAL_DIRECT) && defined(HAVE_LOCAL_POLL)
+pollevent_t local_direct_events(FAR struct local_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: local_direct_disconnect
+ *
+ * Description:
+ *   Detach a socket connected by the direct transport from its peer and
+ *   discard the data queued on it.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+void local_direct_disconnect(FAR struct local_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: psock_local_send
  *
@@ -184,6 +184,13 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
               conn->lc_path[UNIX_PATH_MAX-1] = '\0';
               conn->lc_instance_id = client->lc_instance_id;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              /* The new socket is connected directly to the client below;
+               * no FIFOs are needed.
+               */
+
+              ret = OK;
+#else
               /* Open the server-side write-only FIFO.  This should not
                * block.
                */
@@ -195,8 +202,10 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                    nerr("ERROR: Failed to open write-only FIFOs for %s: %d\n",
                         conn->lc_path, ret);
                 }
+#endif
             }
 
+#ifndef CONFIG_NET_LOCAL_DIRECT
           /* Do we have a connection?  Is the write-side FIFO opened? */
 
           if (ret == OK)
@@ -216,12 +225,15 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                         conn->lc_path, ret);
                 }
             }
+#endif
 
           /* Do we have a connection?  Are the FIFOs opened? */
 
           if (ret == OK)
             {
+#ifndef CONFIG_NET_LOCAL_DIRECT
               DEBUGASSERT(conn->lc_infile.f_inode != NULL);
+#endif
 
               /* Return the address family */
 
@@ -233,6 +245,14 @@ int local_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
           if (ret == OK)
             {
+#ifdef CONFIG_NET_LOCAL_DIRECT
+              /* Connect the new socket directly to the client */
+
+              net_lock();
+              local_direct_link(conn, client);
+              net_unlock();
+#endif
+
               /* Setup the client socket structure */
 
               newsock->s_domain = psock->s_domain;
@@ -105,6 +105,13 @@ FAR struct local_conn_s *local_alloc(void)
 #ifdef HAVE_LOCAL_POLL
       memset(conn->lc_accept_fds, 0, sizeof(conn->lc_accept_fds));
 #endif
+#endif
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      nxsem_init(&conn->lc_rcvsem, 0, 0);
+      nxsem_setprotocol(&conn->lc_rcvsem, SEM_PRIO_NONE);
+      nxsem_init(&conn->lc_sndsem, 0, 0);
+      nxsem_setprotocol(&conn->lc_sndsem, SEM_PRIO_NONE);
 #endif
     }
 
@@ -147,6 +154,18 @@ void local_free(FAR struct local_conn_s *conn)
   nxsem_destroy(&conn->lc_waitsem);
 #endif
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Free any data that was never received */
+
+  if (conn->lc_rcvq != NULL)
+    {
+      iob_free_chain(conn->lc_rcvq);
+    }
+
+  nxsem_destroy(&conn->lc_rcvsem);
+  nxsem_destroy(&conn->lc_sndsem);
+#endif
+
   /* And free the connection structure */
 
   kmm_free(conn);
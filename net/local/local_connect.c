@@ -61,26 +61,6 @@
  * Private Functions
  ****************************************************************************/
 
-/****************************************************************************
- * Name: local_generate_instance_id
- ****************************************************************************/
-
-static int32_t local_generate_instance_id(void)
-{
-  static int32_t g_next_instance_id = 0;
-  int32_t id;
-
-  /* Called from local_connect with net_lock held. */
-
-  id = g_next_instance_id++;
-  if (g_next_instance_id < 0)
-    {
-      g_next_instance_id = 0;
-    }
-
-  return id;
-}
-
 /****************************************************************************
  * Name: _local_semtake() and _local_semgive()
  *
@@ -156,6 +136,42 @@ static int inline local_stream_connect(FAR struct local_conn_s *client,
   server->u.server.lc_pending++;
   DEBUGASSERT(server->u.server.lc_pending != 0);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* The server connects the new socket to us directly when it accepts the
+   * connection.  No FIFOs are needed.
+   */
+
+  dq_addlast(&client->lc_node, &server->u.server.lc_waiters);
+  client->lc_state = LOCAL_STATE_ACCEPT;
+  client->u.client.lc_result = -EBUSY;
+  local_accept_pollnotify(server, POLLIN);
+
+  if (nxsem_getvalue(&server->lc_waitsem, &sval) >= 0 && sval < 1)
+    {
+      _local_semgive(&server->lc_waitsem);
+    }
+
+  net_unlock();
+
+  /* Wait for the server to accept the connection */
+
+  do
+    {
+      _local_semtake(&client->lc_waitsem);
+      ret = client->u.client.lc_result;
+    }
+  while (ret == -EBUSY);
+
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to connect: %d\n", ret);
+      client->lc_state = LOCAL_STATE_BOUND;
+      return ret;
+    }
+
+  DEBUGASSERT(client->lc_direct && client->lc_state == LOCAL_STATE_CONNECTED);
+  return OK;
+#else
   /* Create the FIFOs needed for the connection */
 
   ret = local_create_fifos(client);
@@ -237,12 +253,39 @@ errout_with_fifos:
   (void)local_release_fifos(client);
   client->lc_state = LOCAL_STATE_BOUND;
   return ret;
+#endif /* CONFIG_NET_LOCAL_DIRECT */
 }
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: local_generate_instance_id
+ *
+ * Description:
+ *   Generate a new instance ID used to make the FIFO names of a stream
+ *   connection unique.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int32_t local_generate_instance_id(void)
+{
+  static int32_t g_next_instance_id = 0;
+  int32_t id;
+
+  id = g_next_instance_id++;
+  if (g_next_instance_id < 0)
+    {
+      g_next_instance_id = 0;
+    }
+
+  return id;
+}
+
 /****************************************************************************
  * Name: psock_local_connect
  *
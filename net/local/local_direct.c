@@ -0,0 +1,543 @@
+/****************************************************************************
+ * net/local/local_direct.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <stdint.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/semaphore.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each SOCK_SEQPACKET message is queued behind its 16-bit length */
+
+#define LOCAL_DIRECT_HDRSIZE sizeof(uint16_t)
+
+#ifndef MIN
+#  define MIN(a,b) ((a) < (b) ? (a) : (b))
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_qlen
+ *
+ * Description:
+ *   Return the number of bytes queued for a socket.
+ *
+ ****************************************************************************/
+
+static inline unsigned int local_direct_qlen(FAR struct local_conn_s *conn)
+{
+  return conn->lc_rcvq != NULL ? conn->lc_rcvq->io_pktlen : 0;
+}
+
+/****************************************************************************
+ * Name: local_direct_wakeup
+ *
+ * Description:
+ *   Wake up all threads waiting on the semaphore.
+ *
+ ****************************************************************************/
+
+static void local_direct_wakeup(FAR sem_t *sem)
+{
+  int sval;
+
+  while (nxsem_getvalue(sem, &sval) == 0 && sval < 0)
+    {
+      nxsem_post(sem);
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_waitspace
+ *
+ * Description:
+ *   Wait until the receive queue of the peer has room for 'need' bytes.
+ *
+ * Returned Value:
+ *   Zero (OK) if there is room; -EPIPE if the peer has been closed; -EAGAIN
+ *   if there is no room and 'nonblock' is true; or a negated errno value
+ *   if the wait failed.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static int local_direct_waitspace(FAR struct local_conn_s *conn,
+                                  unsigned int need, bool nonblock)
+{
+  int ret;
+
+  for (; ; )
+    {
+      if (conn->lc_peer == NULL)
+        {
+          return -EPIPE;
+        }
+
+      if (local_direct_qlen(conn->lc_peer) + need <=
+          CONFIG_NET_LOCAL_DIRECT_RCVBUF)
+        {
+          return OK;
+        }
+
+      if (nonblock)
+        {
+          return -EAGAIN;
+        }
+
+      ret = net_lockedwait(&conn->lc_sndsem);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: local_direct_enqueue
+ *
+ * Description:
+ *   Queue an I/O buffer chain on the peer and let its readers know.
+ *
+ * Assumptions:
+ *   The network is locked and the peer has room for the chain.
+ *
+ ****************************************************************************/
+
+static void local_direct_enqueue(FAR struct local_conn_s *conn,
+                                 FAR struct iob_s *iob)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer->lc_rcvq == NULL)
+    {
+      peer->lc_rcvq = iob;
+    }
+  else
+    {
+      iob_concat(peer->lc_rcvq, iob);
+    }
+
+  local_direct_wakeup(&peer->lc_rcvsem);
+  local_accept_pollnotify(peer, POLLIN);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_direct_link
+ *
+ * Description:
+ *   Connect two Unix domain sockets directly to each other.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_direct_link(FAR struct local_conn_s *conn0,
+                       FAR struct local_conn_s *conn1)
+{
+  conn0->lc_direct = true;
+  conn0->lc_peer   = conn1;
+  conn0->lc_state  = LOCAL_STATE_CONNECTED;
+
+  conn1->lc_direct = true;
+  conn1->lc_peer   = conn0;
+  conn1->lc_state  = LOCAL_STATE_CONNECTED;
+}
+
+/****************************************************************************
+ * Name: local_direct_pair
+ *
+ * Description:
+ *   Connect two newly created, unbound Unix domain sockets directly to each
+ *   other.
+ *
+ * Assumptions:
+ *   Network is NOT locked.
+ *
+ ****************************************************************************/
+
+int local_direct_pair(FAR struct local_conn_s *conn0,
+                      FAR struct local_conn_s *conn1, int type)
+{
+  DEBUGASSERT(conn0 != NULL && conn1 != NULL);
+
+  if (type != SOCK_STREAM && type != SOCK_SEQPACKET)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  if (conn0->lc_state != LOCAL_STATE_UNBOUND ||
+      conn1->lc_state != LOCAL_STATE_UNBOUND)
+    {
+      return -EISCONN;
+    }
+
+  net_lock();
+
+  conn0->lc_proto = type;
+  conn0->lc_type  = LOCAL_TYPE_UNNAMED;
+  conn1->lc_proto = type;
+  conn1->lc_type  = LOCAL_TYPE_UNNAMED;
+
+  local_direct_link(conn0, conn1);
+
+  net_unlock();
+  return OK;
+}
+
+/****************************************************************************
+ * Name: local_direct_send
+ *
+ * Description:
+ *   Copy data into I/O buffers queued on the peer socket.  A SOCK_STREAM
+ *   send is split into pieces that fit in the receive queue of the peer.
+ *   A SOCK_SEQPACKET message is queued whole, behind its length.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_send(FAR struct socket *psock, FAR const void *buf,
+                          size_t len, int flags)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR const uint8_t *src = (FAR const uint8_t *)buf;
+  FAR struct iob_s *iob;
+  bool seqpacket = conn->lc_proto == SOCK_SEQPACKET;
+  bool nonblock;
+  unsigned int hdrlen = seqpacket ? LOCAL_DIRECT_HDRSIZE : 0;
+  unsigned int chunk;
+  size_t nsent = 0;
+  uint16_t msglen;
+  int ret;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  if (seqpacket && len + hdrlen > CONFIG_NET_LOCAL_DIRECT_RCVBUF)
+    {
+      return -EMSGSIZE;
+    }
+  else if (!seqpacket && len == 0)
+    {
+      return 0;
+    }
+
+  do
+    {
+      /* Wait for room in the receive queue of the peer */
+
+      net_lock();
+      ret = local_direct_waitspace(conn, seqpacket ? len + hdrlen : 1,
+                                   nonblock);
+      if (ret < 0)
+        {
+          net_unlock();
+          break;
+        }
+
+      if (seqpacket)
+        {
+          chunk = len;
+        }
+      else
+        {
+          chunk = MIN(len - nsent, CONFIG_NET_LOCAL_DIRECT_RCVBUF -
+                      local_direct_qlen(conn->lc_peer));
+        }
+
+      net_unlock();
+
+      /* Copy the data into I/O buffers without holding the network lock:
+       * Waiting for free I/O buffers must not block the receiver.
+       */
+
+      iob = nonblock ? iob_tryalloc(false) : iob_alloc(false);
+      if (iob == NULL)
+        {
+          ret = -EAGAIN;
+          break;
+        }
+
+      if (seqpacket)
+        {
+          msglen = len;
+          ret    = nonblock ?
+                   iob_trycopyin(iob, (FAR const uint8_t *)&msglen,
+                                 hdrlen, 0, false) :
+                   iob_copyin(iob, (FAR const uint8_t *)&msglen,
+                              hdrlen, 0, false);
+        }
+      else
+        {
+          ret = OK;
+        }
+
+      if (ret >= 0 && chunk > 0)
+        {
+          ret = nonblock ?
+                iob_trycopyin(iob, &src[nsent], chunk, hdrlen, false) :
+                iob_copyin(iob, &src[nsent], chunk, hdrlen, false);
+        }
+
+      if (ret < 0)
+        {
+          iob_free_chain(iob);
+          ret = nonblock ? -EAGAIN : ret;
+          break;
+        }
+
+      /* Another sender may have filled the queue in the meantime.  Wait
+       * for room again; the chain is never larger than the queue.
+       */
+
+      net_lock();
+      ret = local_direct_waitspace(conn, chunk + hdrlen, nonblock);
+      if (ret < 0)
+        {
+          net_unlock();
+          iob_free_chain(iob);
+          break;
+        }
+
+      local_direct_enqueue(conn, iob);
+      net_unlock();
+
+      nsent += chunk;
+    }
+  while (nsent < len);
+
+  /* Report a partial stream send as success */
+
+  return nsent > 0 ? (ssize_t)nsent : ret;
+}
+
+/****************************************************************************
+ * Name: local_direct_recvfrom
+ *
+ * Description:
+ *   Copy queued data out of the receive queue.  A SOCK_STREAM receive
+ *   returns whatever is queued, up to 'len' bytes.  A SOCK_SEQPACKET
+ *   receive returns one message; the part of it that does not fit in 'buf'
+ *   is discarded.
+ *
+ ****************************************************************************/
+
+ssize_t local_direct_recvfrom(FAR struct socket *psock, FAR void *buf,
+                              size_t len, int flags,
+                              FAR struct sockaddr *from,
+                              FAR socklen_t *fromlen)
+{
+  FAR struct local_conn_s *conn = (FAR struct local_conn_s *)psock->s_conn;
+  FAR struct local_conn_s *peer;
+  bool nonblock;
+  unsigned int trimlen;
+  uint16_t msglen;
+  ssize_t nread;
+  int ret;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+
+  /* Wait for data.  Queued data is still delivered after the peer has been
+   * closed; after that, report end of file.
+   */
+
+  while (conn->lc_rcvq == NULL)
+    {
+      if (conn->lc_peer == NULL)
+        {
+          net_unlock();
+          return 0;
+        }
+
+      if (nonblock)
+        {
+          net_unlock();
+          return -EAGAIN;
+        }
+
+      ret = net_lockedwait(&conn->lc_rcvsem);
+      if (ret < 0)
+        {
+          net_unlock();
+          return ret;
+        }
+    }
+
+  if (conn->lc_proto == SOCK_SEQPACKET)
+    {
+      (void)iob_copyout((FAR uint8_t *)&msglen, conn->lc_rcvq,
+                        LOCAL_DIRECT_HDRSIZE, 0);
+      nread   = iob_copyout(buf, conn->lc_rcvq, MIN(len, msglen),
+                            LOCAL_DIRECT_HDRSIZE);
+      trimlen = LOCAL_DIRECT_HDRSIZE + msglen;
+    }
+  else
+    {
+      nread   = iob_copyout(buf, conn->lc_rcvq,
+                            MIN(len, conn->lc_rcvq->io_pktlen), 0);
+      trimlen = nread;
+    }
+
+  conn->lc_rcvq = iob_trimhead(conn->lc_rcvq, trimlen);
+  if (conn->lc_rcvq != NULL && conn->lc_rcvq->io_pktlen == 0)
+    {
+      iob_free_chain(conn->lc_rcvq);
+      conn->lc_rcvq = NULL;
+    }
+
+  /* There is room in the queue now.  Let the senders know. */
+
+  peer = conn->lc_peer;
+  if (peer != NULL)
+    {
+      local_direct_wakeup(&peer->lc_sndsem);
+      local_accept_pollnotify(peer, POLLOUT);
+    }
+
+  net_unlock();
+
+  if (from != NULL)
+    {
+      ret = local_getaddr(conn, from, fromlen);
+      if (ret < 0)
+        {
+          return ret;
+        }
+    }
+
+  return nread;
+}
+
+/****************************************************************************
+ * Name: local_direct_events
+ *
+ * Description:
+ *   Return the poll events that are currently true for a socket.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_LOCAL_POLL
+pollevent_t local_direct_events(FAR struct local_conn_s *conn)
+{
+  pollevent_t eventset = 0;
+
+  if (conn->lc_rcvq != NULL || conn->lc_peer == NULL)
+    {
+      eventset |= POLLIN;
+    }
+
+  if (conn->lc_peer == NULL)
+    {
+      eventset |= POLLHUP;
+    }
+  else if (local_direct_qlen(conn->lc_peer) <
+           CONFIG_NET_LOCAL_DIRECT_RCVBUF)
+    {
+      eventset |= POLLOUT;
+    }
+
+  return eventset;
+}
+#endif
+
+/****************************************************************************
+ * Name: local_direct_disconnect
+ *
+ * Description:
+ *   Detach a socket that is being closed from its peer.  The peer reads
+ *   what is left in its queue, then end of file; its sends fail with
+ *   EPIPE.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void local_direct_disconnect(FAR struct local_conn_s *conn)
+{
+  FAR struct local_conn_s *peer = conn->lc_peer;
+
+  if (peer != NULL)
+    {
+      peer->lc_peer = NULL;
+      conn->lc_peer = NULL;
+
+      local_direct_wakeup(&peer->lc_rcvsem);
+      local_direct_wakeup(&peer->lc_sndsem);
+      local_accept_pollnotify(peer, POLLIN | POLLOUT | POLLHUP);
+    }
+
+  /* Anything not yet received is lost */
+
+  if (conn->lc_rcvq != NULL)
+    {
+      iob_free_chain(conn->lc_rcvq);
+      conn->lc_rcvq = NULL;
+    }
+}
+
+#endif /* CONFIG_NET_LOCAL_DIRECT */
@@ -95,6 +95,13 @@ static int local_accept_pollsetup(FAR struct local_conn_s *conn,
         }
 
       eventset = 0;
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      if (conn->lc_direct)
+        {
+          eventset = local_direct_events(conn);
+        }
+      else
+#endif
       if (dq_peek(&conn->u.server.lc_waiters) != NULL)
         {
           eventset |= POLLIN;
@@ -187,6 +194,17 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
       return ret;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* A socket connected by the direct transport keeps its poll waiters in
+   * the same slots as a listener.
+   */
+
+  if (conn->lc_direct)
+    {
+      return local_accept_pollsetup(conn, fds, true);
+    }
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   if (conn->lc_state == LOCAL_STATE_LISTENING &&
       conn->lc_type  == LOCAL_TYPE_PATHNAME)
@@ -328,6 +346,13 @@ int local_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds)
       return ret;
     }
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  if (conn->lc_direct)
+    {
+      return local_accept_pollsetup(conn, fds, false);
+    }
+#endif
+
 #ifdef CONFIG_NET_LOCAL_STREAM
   if (conn->lc_state == LOCAL_STATE_LISTENING &&
       conn->lc_type  == LOCAL_TYPE_PATHNAME)
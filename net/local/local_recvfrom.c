@@ -331,7 +331,7 @@ psock_dgram_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
         {
           /* Read 32 bytes into the bit bucket */
 
-          readlen = MIN(remaining, 32);
+          tmplen  = MIN(remaining, 32);
           ret     = psock_fifo_read(psock, bitbucket, &tmplen);
           if (ret < 0)
             {
@@ -421,6 +421,15 @@ ssize_t local_recvfrom(FAR struct socket *psock, FAR void *buf,
 {
   DEBUGASSERT(psock && psock->s_conn && buf);
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Connected sockets may use the direct transport instead of FIFOs */
+
+  if (((FAR struct local_conn_s *)psock->s_conn)->lc_direct)
+    {
+      return local_direct_recvfrom(psock, buf, len, flags, from, fromlen);
+    }
+#endif
+
   /* Check for a stream socket */
 
 #ifdef CONFIG_NET_LOCAL_STREAM
@@ -128,7 +128,9 @@ errout:
  * Name: local_sync
  *
  * Description:
- *   Read a sync bytes until the start of the packet is found.
+ *   Read a sync bytes until the start of the packet is found.  The whole
+ *   packet header is normally obtained with a single FIFO read; the header
+ *   is only re-scanned a byte at a time if the stream is out of sync.
  *
  * Input Parameters:
  *   filep - File structure of write-only FIFO.
@@ -141,52 +143,60 @@ errout:
 
 int local_sync(FAR struct file *filep)
 {
+  uint8_t hdr[LOCAL_HEADER_SIZE];
   size_t readlen;
   uint16_t pktlen;
-  uint8_t sync;
   int ret;
+  int i;
+
+  /* Read the complete packet header */
+
+  readlen = LOCAL_HEADER_SIZE;
+  ret     = local_fifo_read(filep, hdr, &readlen);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to read packet header: %d\n", ret);
+      return ret;
+    }
 
   /* Loop until a valid pre-amble is encountered:  SYNC bytes followed
-   * by one END byte.
+   * by one END byte.  The sender always sends the full pre-amble so the
+   * header window never extends past the packet length into the data.
    */
 
-  do
+  for (; ; )
     {
-      /* Read until we encounter a sync byte */
-
-      do
+      for (i = 0; i < LOCAL_PREAMBLE_SIZE - 1; i++)
         {
-          readlen = sizeof(uint8_t);
-          ret     = local_fifo_read(filep, &sync, &readlen);
-          if (ret < 0)
+          if (hdr[i] != LOCAL_SYNC_BYTE)
             {
-              nerr("ERROR: Failed to read sync bytes: %d\n", ret);
-              return ret;
+              break;
             }
         }
-      while (sync != LOCAL_SYNC_BYTE);
 
-      /* Then read to the end of the SYNC sequence */
+      if (i == LOCAL_PREAMBLE_SIZE - 1 && hdr[i] == LOCAL_END_BYTE)
+        {
+          break;
+        }
+
+      /* Out of sync.  Slide the header window by one byte. */
+
+      memmove(hdr, &hdr[1], LOCAL_HEADER_SIZE - 1);
 
-      do
+      readlen = sizeof(uint8_t);
+      ret     = local_fifo_read(filep, &hdr[LOCAL_HEADER_SIZE - 1],
+                                &readlen);
+      if (ret < 0)
         {
-          readlen = sizeof(uint8_t);
-          ret     = local_fifo_read(filep, &sync, &readlen);
-          if (ret < 0)
-            {
-              nerr("ERROR: Failed to read sync bytes: %d\n", ret);
-              return ret;
-            }
+          nerr("ERROR: Failed to read sync bytes: %d\n", ret);
+          return ret;
         }
-      while (sync == LOCAL_SYNC_BYTE);
     }
-  while (sync != LOCAL_END_BYTE);
 
-  /* Then read the packet length */
+  /* Then return the packet length */
 
-  readlen = sizeof(uint16_t);
-  ret     = local_fifo_read(filep, (FAR uint8_t *)&pktlen, &readlen);
-  return ret < 0 ? ret : pktlen;
+  memcpy(&pktlen, &hdr[LOCAL_PREAMBLE_SIZE], sizeof(uint16_t));
+  return pktlen;
 }
 
 /****************************************************************************
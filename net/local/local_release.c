@@ -88,9 +88,22 @@ int local_release(FAR struct local_conn_s *conn)
   if (conn->lc_state == LOCAL_STATE_CONNECTED ||
       conn->lc_state == LOCAL_STATE_DISCONNECTED)
     {
-      DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      /* A socket connected by the direct transport must tell its peer
+       * that it is gone.
+       */
+
+      if (conn->lc_direct)
+        {
+          local_direct_disconnect(conn);
+        }
+      else
+#endif
+        {
+          DEBUGASSERT(conn->lc_proto == SOCK_STREAM);
 
-      /* Just free the connection structure */
+          /* Just free the connection structure */
+        }
     }
 
   /* Is the socket is listening socket (SOCK_STREAM server) */
@@ -82,6 +82,15 @@ ssize_t psock_local_send(FAR struct socket *psock, FAR const void *buf,
   DEBUGASSERT(psock && psock->s_conn && buf);
   peer = (FAR struct local_conn_s *)psock->s_conn;
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  /* Connected sockets may use the direct transport instead of FIFOs */
+
+  if (peer->lc_direct)
+    {
+      return local_direct_send(psock, buf, len, flags);
+    }
+#endif
+
   /* Verify that this is a connected peer socket and that it has opened the
    * outgoing FIFO for write-only access.
    */
@@ -41,6 +41,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <string.h>
 #include <unistd.h>
 #include <errno.h>
 #include <assert.h>
@@ -56,17 +57,9 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
-#define LOCAL_PREAMBLE_SIZE 8
+/* Packets of up to this size are sent with a single FIFO write */
 
-/****************************************************************************
- * Private Data
- ****************************************************************************/
-
-static const uint8_t g_preamble[LOCAL_PREAMBLE_SIZE] =
-{
-  LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE,
-  LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_SYNC_BYTE, LOCAL_END_BYTE
-};
+#define LOCAL_SMALLPKT_SIZE 64
 
 /****************************************************************************
  * Private Functions
@@ -142,25 +135,38 @@ static int local_fifo_write(FAR struct file *filep, FAR const uint8_t *buf,
 int local_send_packet(FAR struct file *filep, FAR const uint8_t *buf,
                       size_t len)
 {
+  uint8_t pkt[LOCAL_HEADER_SIZE + LOCAL_SMALLPKT_SIZE];
   uint16_t len16;
+  size_t hdrlen;
   int ret;
 
-  /* Send the packet preamble */
+  /* Build the packet header:  The preamble followed by the packet length.
+   * Each FIFO write wakes up the receiver, so the header is sent in one
+   * write rather than one write for each field.
+   */
+
+  memset(pkt, LOCAL_SYNC_BYTE, LOCAL_PREAMBLE_SIZE - 1);
+  pkt[LOCAL_PREAMBLE_SIZE - 1] = LOCAL_END_BYTE;
+
+  len16 = len;
+  memcpy(&pkt[LOCAL_PREAMBLE_SIZE], &len16, sizeof(uint16_t));
 
-  ret = local_fifo_write(filep, g_preamble, LOCAL_PREAMBLE_SIZE);
-  if (ret == OK)
+  /* Small packets are gathered into the same write as the header */
+
+  hdrlen = LOCAL_HEADER_SIZE;
+  if (len <= LOCAL_SMALLPKT_SIZE)
     {
-      /* Send the packet length */
+      memcpy(&pkt[LOCAL_HEADER_SIZE], buf, len);
+      hdrlen += len;
+      len     = 0;
+    }
 
-      len16 = len;
-      ret = local_fifo_write(filep, (FAR const uint8_t *)&len16,
-                             sizeof(uint16_t));
-      if (ret == OK)
-        {
-          /* Send the packet data */
+  ret = local_fifo_write(filep, pkt, hdrlen);
+  if (ret == OK && len > 0)
+    {
+      /* Send the packet data */
 
-          ret = local_fifo_write(filep, buf, len);
-        }
+      ret = local_fifo_write(filep, buf, len);
     }
 
   return ret;
@@ -0,0 +1,185 @@
+/****************************************************************************
+ * net/local/local_socketpair.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+
+#include "local/local.h"
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The FIFOs connecting a socket pair are created with this base name.  The
+ * names are unlinked as soon as both sockets have opened them.
+ */
+
+#define LOCAL_SOCKETPAIR_PATH "/dev/socketpair"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: local_socketpair
+ *
+ * Description:
+ *   Connect two newly created, unbound Unix domain sockets to each other.
+ *   This is the local socket part of socketpair().  With
+ *   CONFIG_NET_LOCAL_DIRECT, the sockets are connected directly and may
+ *   also be SOCK_SEQPACKET sockets; otherwise they are SOCK_STREAM sockets
+ *   connected through a FIFO pair.
+ *
+ * Input Parameters:
+ *   conn0, conn1 - The connection structures of the two sockets
+ *   type         - The socket type
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned on
+ *   failure.  On failure, the connections are left for the caller to close.
+ *
+ * Assumptions:
+ *   Network is NOT locked.
+ *
+ ****************************************************************************/
+
+int local_socketpair(FAR struct local_conn_s *conn0,
+                     FAR struct local_conn_s *conn1, int type)
+{
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  return local_direct_pair(conn0, conn1, type);
+#else
+  int32_t id;
+  int ret;
+
+  DEBUGASSERT(conn0 != NULL && conn1 != NULL);
+
+  if (type != SOCK_STREAM)
+    {
+      return -EOPNOTSUPP;
+    }
+
+  if (conn0->lc_state != LOCAL_STATE_UNBOUND ||
+      conn1->lc_state != LOCAL_STATE_UNBOUND)
+    {
+      return -EISCONN;
+    }
+
+  net_lock();
+
+  /* Both ends share the FIFO pair:  conn0 takes the client side and conn1
+   * the server side, exactly as if conn0 had connected to conn1.
+   */
+
+  id = local_generate_instance_id();
+
+  conn0->lc_proto       = SOCK_STREAM;
+  conn0->lc_type        = LOCAL_TYPE_UNNAMED;
+  conn0->lc_instance_id = id;
+  strncpy(conn0->lc_path, LOCAL_SOCKETPAIR_PATH, UNIX_PATH_MAX - 1);
+  conn0->lc_path[UNIX_PATH_MAX - 1] = '\0';
+
+  conn1->lc_proto       = SOCK_STREAM;
+  conn1->lc_type        = LOCAL_TYPE_UNNAMED;
+  conn1->lc_instance_id = id;
+  strncpy(conn1->lc_path, LOCAL_SOCKETPAIR_PATH, UNIX_PATH_MAX - 1);
+  conn1->lc_path[UNIX_PATH_MAX - 1] = '\0';
+
+  ret = local_create_fifos(conn0);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to create FIFOs for %s: %d\n",
+           conn0->lc_path, ret);
+      goto errout;
+    }
+
+  /* Open both write-only ends first so that opening the read-only ends
+   * does not block waiting for a writer.
+   */
+
+  ret = local_open_client_tx(conn0, false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = local_open_server_tx(conn1, false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = local_open_client_rx(conn0, false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = local_open_server_rx(conn1, false);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  /* Remove the FIFOs from the namespace.  They persist until both sockets
+   * have been closed.  The sockets remain unnamed.
+   */
+
+  (void)local_release_fifos(conn0);
+  conn0->lc_path[0] = '\0';
+  conn1->lc_path[0] = '\0';
+
+  conn0->lc_state = LOCAL_STATE_CONNECTED;
+  conn1->lc_state = LOCAL_STATE_CONNECTED;
+
+errout:
+  net_unlock();
+  return ret;
+#endif
+}
+
+#endif /* CONFIG_NET_LOCAL_STREAM */
@@ -198,6 +198,20 @@ static int local_setup(FAR struct socket *psock, int protocol)
         return local_sockif_alloc(psock);
 #endif /* CONFIG_NET_LOCAL_STREAM */
 
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      /* SOCK_SEQPACKET sockets can only be connected by socketpair() */
+
+      case SOCK_SEQPACKET:
+        if (protocol != 0)
+          {
+            return -EPROTONOSUPPORT;
+          }
+
+        /* Allocate and attach the local connection structure */
+
+        return local_sockif_alloc(psock);
+#endif /* CONFIG_NET_LOCAL_DIRECT */
+
 #ifdef CONFIG_NET_LOCAL_DGRAM
       case SOCK_DGRAM:
         if (protocol != 0 && protocol != IPPROTO_UDP)
@@ -689,6 +703,9 @@ static ssize_t local_send(FAR struct socket *psock, FAR const void *buf,
   switch (psock->s_type)
     {
 #ifdef CONFIG_NET_LOCAL_STREAM
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      case SOCK_SEQPACKET:
+#endif
       case SOCK_STREAM:
         {
           /* Local TCP packet send */
@@ -803,6 +820,9 @@ static int local_close(FAR struct socket *psock)
 #ifdef CONFIG_NET_LOCAL_STREAM
       case SOCK_STREAM:
 #endif
+#ifdef CONFIG_NET_LOCAL_DIRECT
+      case SOCK_SEQPACKET:
+#endif
 #ifdef CONFIG_NET_LOCAL_DGRAM
       case SOCK_DGRAM:
 #endif
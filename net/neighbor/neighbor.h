@@ -64,6 +64,14 @@
 #  define CONFIG_NET_IPv6_NCONF_ENTRIES 8
 #endif
 
+#ifndef CONFIG_NET_IPv6_NCONF_HASHSIZE
+#  define CONFIG_NET_IPv6_NCONF_HASHSIZE 8
+#endif
+
+#if CONFIG_NET_IPv6_NCONF_HASHSIZE < 1
+#  error CONFIG_NET_IPv6_NCONF_HASHSIZE must be at least 1
+#endif
+
 #define NEIGHBOR_MAXTIME 128
 
 /****************************************************************************
@@ -89,14 +97,17 @@ struct neighbor_addr_s
 };
 
 /* This structure describes on entry in the neighbor table.  This is intended
- * for internal use within the Neighbor implementation.
+ * for internal use within the Neighbor implementation.  In-use entries are
+ * retained in a hash bucket list selected by the IPv6 address; unused
+ * entries are retained in a free list.
  */
 
 struct neighbor_entry
 {
-  net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
-  struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
-  uint8_t                ne_time;    /* For aging, units of half seconds */
+  FAR struct neighbor_entry *ne_flink; /* Next entry in bucket/free list */
+  net_ipv6addr_t         ne_ipaddr;    /* IPv6 address of the Neighbor */
+  struct neighbor_addr_s ne_addr;      /* Link layer address of the Neighbor */
+  uint8_t                ne_time;      /* For aging, units of half seconds */
 };
 
 /****************************************************************************
@@ -109,6 +120,12 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash bucket lists of in-use entries and the list of unused entries */
+
+extern FAR struct neighbor_entry *
+  g_neighborhash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+extern FAR struct neighbor_entry *g_neighborfree;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -134,6 +151,23 @@ struct net_driver_s; /* Forward reference */
 
 void neighbor_initialize(void);
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket list associated with an IPv6 address.  This
+ *   interface is internal to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address
+ *
+ * Returned Value:
+ *   A reference to the head of the hash bucket list.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry **neighbor_hash(const net_ipv6addr_t ipaddr);
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -225,6 +259,118 @@ void neighbor_update(const net_ipv6addr_t ipaddr);
 
 void neighbor_periodic(int hsec);
 
+/****************************************************************************
+ * Name: neighbor_pending_add
+ *
+ * Description:
+ *   Hold a copy of the IPv6 packet in the device buffer until the link
+ *   layer address of 'ipaddr' has been resolved.  This is called from
+ *   neighbor_out() just before the packet is replaced with a Neighbor
+ *   Solicitation.
+ *
+ * Input Parameters:
+ *   dev    - The device holding the outgoing IPv6 packet
+ *   ipaddr - The next hop address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+void neighbor_pending_add(FAR struct net_driver_s *dev,
+                          const net_ipv6addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_resolved
+ *
+ * Description:
+ *   The link layer address of 'ipaddr' has been added to the Neighbor
+ *   Table.  Mark all packets held for the address as ready to send and
+ *   notify the network devices that there is TX data available.
+ *
+ * Input Parameters:
+ *   ipaddr - The address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+void neighbor_pending_resolved(const net_ipv6addr_t ipaddr);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_poll
+ *
+ * Description:
+ *   Provide each held packet that is ready to be sent on this device to the
+ *   driver.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver's poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the poll callback (non-zero
+ *   terminates the poll).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+int neighbor_pending_poll(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_purge
+ *
+ * Description:
+ *   Discard all packets held for a network device that is being
+ *   unregistered.
+ *
+ * Input Parameters:
+ *   dev - The device being unregistered
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+void neighbor_pending_purge(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Name: neighbor_pending_expire
+ *
+ * Description:
+ *   Discard held packets whose address has not been resolved in time.
+ *
+ * Assumptions:
+ *   Called from neighbor_periodic() with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+void neighbor_pending_expire(void);
+#endif
+
 /****************************************************************************
  * Name: neighbor_dumpentry
  *
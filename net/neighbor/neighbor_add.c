@@ -56,6 +56,39 @@
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_remove
+ *
+ * Description:
+ *   Remove an in-use entry from its hash bucket and return it to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+static void neighbor_remove(FAR struct neighbor_entry *neighbor)
+{
+  FAR struct neighbor_entry **link;
+
+  for (link = neighbor_hash(neighbor->ne_ipaddr);
+       *link != NULL;
+       link = &(*link)->ne_flink)
+    {
+      if (*link == neighbor)
+        {
+          *link = neighbor->ne_flink;
+          break;
+        }
+    }
+
+  neighbor->ne_time  = NEIGHBOR_MAXTIME;
+  neighbor->ne_flink = g_neighborfree;
+  g_neighborfree     = neighbor;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -80,6 +113,8 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR struct neighbor_entry **bucket;
+  FAR struct neighbor_entry *neighbor;
   uint8_t lltype;
   uint8_t oldest_time;
   int     oldest_ndx;
@@ -87,48 +122,64 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the first unused entry or the oldest used entry. */
+  /* First check if there is already an entry for the address */
 
-  oldest_time = 0;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
+  bucket = neighbor_hash(ipaddr);
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *bucket; neighbor != NULL; neighbor = neighbor->ne_flink)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
+      if (neighbor->ne_addr.na_lltype == lltype &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
 
-      if (g_neighbors[i].ne_addr.na_lltype == lltype &&
-          net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
+  if (neighbor == NULL)
+    {
+      /* No.. Use the first unused entry or, if there is none, throw away the
+       * oldest used entry.
+       */
 
-      if (g_neighbors[i].ne_time > oldest_time)
+      if (g_neighborfree == NULL)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          oldest_time = 0;
+          oldest_ndx  = 0;
+
+          for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+            {
+              if (g_neighbors[i].ne_time > oldest_time)
+                {
+                  oldest_ndx  = i;
+                  oldest_time = g_neighbors[i].ne_time;
+                }
+            }
+
+          neighbor_remove(&g_neighbors[oldest_ndx]);
         }
-    }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+      neighbor       = g_neighborfree;
+      g_neighborfree = neighbor->ne_flink;
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+      neighbor->ne_flink = *bucket;
+      *bucket            = neighbor;
+    }
 
-  g_neighbors[oldest_ndx].ne_addr.na_lltype = lltype;
-  g_neighbors[oldest_ndx].ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
+  neighbor->ne_time = 0;
+  neighbor->ne_addr.na_lltype = lltype;
+  neighbor->ne_addr.na_llsize = netdev_dev_lladdrsize(dev);
 
-  memcpy(&g_neighbors[oldest_ndx].ne_addr.u, addr,
-         g_neighbors[oldest_ndx].ne_addr.na_llsize);
+  memcpy(&neighbor->ne_addr.u, addr, neighbor->ne_addr.na_llsize);
 
   /* Dump the contents of the new entry */
 
-  neighbor_dumpentry("Added entry", &g_neighbors[oldest_ndx]);
+  neighbor_dumpentry("Added entry", neighbor);
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+  /* Release any packets that were waiting for this address */
+
+  neighbor_pending_resolved(ipaddr);
+#endif
 }
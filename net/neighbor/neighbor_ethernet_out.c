@@ -225,6 +225,15 @@ void neighbor_out(FAR struct net_driver_s *dev)
         {
            ninfo("IPv6 Neighbor solicitation for IPv6\n");
 
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+          /* Hold a copy of the IPv6 packet so that it can be sent as soon
+           * as the address is resolved rather than waiting for it to be
+           * retransmitted.
+           */
+
+          neighbor_pending_add(dev, ipaddr);
+#endif
+
           /* The destination address was not in our Neighbor Table, so we
            * overwrite the IPv6 packet with an ICMDv6 Neighbor Solicitation
            * message.
@@ -52,6 +52,35 @@
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket list associated with an IPv6 address.  This
+ *   interface is internal to the neighbor implementation.
+ *
+ * Input Parameters:
+ *   ipaddr - The IPv6 address
+ *
+ * Returned Value:
+ *   A reference to the head of the hash bucket list.
+ *
+ ****************************************************************************/
+
+FAR struct neighbor_entry **neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint16_t hash;
+
+  /* Fold the interface identifier (the low-order 64 bits) into the
+   * low-order bits.  The network prefix is usually the same for all
+   * neighbors.
+   */
+
+  hash  = ipaddr[4] ^ ipaddr[5] ^ ipaddr[6] ^ ipaddr[7];
+  hash ^= hash >> 8;
+  return &g_neighborhash[hash % CONFIG_NET_IPv6_NCONF_HASHSIZE];
+}
+
 /****************************************************************************
  * Name: neighbor_findentry
  *
@@ -70,12 +99,12 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *neighbor_hash(ipaddr);
+       neighbor != NULL;
+       neighbor = neighbor->ne_flink)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
-
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           neighbor_dumpentry("Entry found", neighbor);
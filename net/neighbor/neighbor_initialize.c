@@ -56,6 +56,11 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash bucket lists of in-use entries and the list of unused entries */
+
+FAR struct neighbor_entry *g_neighborhash[CONFIG_NET_IPv6_NCONF_HASHSIZE];
+FAR struct neighbor_entry *g_neighborfree;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,8 +86,16 @@ void neighbor_initialize(void)
 {
   int i;
 
+  for (i = 0; i < CONFIG_NET_IPv6_NCONF_HASHSIZE; ++i)
+    {
+      g_neighborhash[i] = NULL;
+    }
+
+  g_neighborfree = NULL;
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_time  = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_flink = g_neighborfree;
+      g_neighborfree          = &g_neighbors[i];
     }
 }
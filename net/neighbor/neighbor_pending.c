@@ -0,0 +1,393 @@
+/****************************************************************************
+ * net/neighbor/neighbor_pending.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+
+#include "netdev/netdev.h"
+#include "neighbor/neighbor.h"
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Packets are discarded if the address is not resolved within this time */
+
+#define NEIGHBOR_PENDING_MAXAGE MSEC2TICK(3000)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one IPv6 packet waiting for the resolution of
+ * the link layer address of its next hop.
+ */
+
+struct neighbor_pending_s
+{
+  FAR struct iob_s        *np_iob;    /* The held IPv6 packet (NULL: unused) */
+  FAR struct net_driver_s *np_dev;    /* The device that will send the packet */
+  net_ipv6addr_t           np_ipaddr; /* The next hop IPv6 address */
+  clock_t                  np_time;   /* Time when the packet was held */
+  bool                     np_ready;  /* True: The address has been resolved */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct neighbor_pending_s
+  g_neighbor_pending[CONFIG_NET_IPv6_NEIGHBOR_NPENDING];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_pending_free
+ *
+ * Description:
+ *   Release a held packet.
+ *
+ ****************************************************************************/
+
+static void neighbor_pending_free(FAR struct neighbor_pending_s *pending)
+{
+  iob_free_chain(pending->np_iob);
+  pending->np_iob   = NULL;
+  pending->np_dev   = NULL;
+  pending->np_ready = false;
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_match
+ *
+ * Description:
+ *   Return true if the held packet is identical to the IPv6 packet in the
+ *   device buffer.  This happens when a packet is retransmitted before its
+ *   next hop address has been resolved.
+ *
+ ****************************************************************************/
+
+static bool neighbor_pending_match(FAR struct neighbor_pending_s *pending,
+                                   FAR struct net_driver_s *dev)
+{
+  FAR const uint8_t *buf = &dev->d_buf[NET_LL_HDRLEN(dev)];
+  FAR struct iob_s *iob = pending->np_iob;
+
+  if (pending->np_dev != dev || iob->io_pktlen != dev->d_len)
+    {
+      return false;
+    }
+
+  for (; iob != NULL; iob = iob->io_flink)
+    {
+      if (memcmp(buf, &iob->io_data[iob->io_offset], iob->io_len) != 0)
+        {
+          return false;
+        }
+
+      buf += iob->io_len;
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_pending_add
+ *
+ * Description:
+ *   Hold a copy of the IPv6 packet in the device buffer until the link
+ *   layer address of 'ipaddr' has been resolved.  This is called from
+ *   neighbor_out() just before the packet is replaced with a Neighbor
+ *   Solicitation.  If there is no space to hold the packet, then it is
+ *   simply lost as it would be without this feature.
+ *
+ * Input Parameters:
+ *   dev    - The device holding the outgoing IPv6 packet
+ *   ipaddr - The next hop address that must be resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void neighbor_pending_add(FAR struct net_driver_s *dev,
+                          const net_ipv6addr_t ipaddr)
+{
+  FAR struct neighbor_pending_s *pending = NULL;
+  FAR struct iob_s *iob;
+  int ret;
+  int i;
+
+  /* Find a free slot.  Expired packets are discarded by
+   * neighbor_pending_expire().
+   */
+
+  for (i = 0; i < CONFIG_NET_IPv6_NEIGHBOR_NPENDING; i++)
+    {
+      FAR struct neighbor_pending_s *tmp = &g_neighbor_pending[i];
+
+      /* Don't hold a second copy of a retransmitted packet */
+
+      if (tmp->np_iob != NULL && !tmp->np_ready &&
+          net_ipv6addr_cmp(tmp->np_ipaddr, ipaddr) &&
+          neighbor_pending_match(tmp, dev))
+        {
+          return;
+        }
+
+      if (tmp->np_iob == NULL && pending == NULL)
+        {
+          pending = tmp;
+        }
+    }
+
+  if (pending == NULL)
+    {
+      neighbor_dumpipaddr("No space to hold packet for", ipaddr);
+      return;
+    }
+
+  /* Copy the IPv6 packet (without the link layer header) into an I/O
+   * buffer chain.  Do not wait for I/O buffers; we are on the driver's
+   * transmit path.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return;
+    }
+
+  ret = iob_trycopyin(iob, &dev->d_buf[NET_LL_HDRLEN(dev)], dev->d_len, 0,
+                      true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return;
+    }
+
+  pending->np_iob   = iob;
+  pending->np_dev   = dev;
+  pending->np_time  = clock_systimer();
+  pending->np_ready = false;
+  net_ipv6addr_copy(pending->np_ipaddr, ipaddr);
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_resolved
+ *
+ * Description:
+ *   The link layer address of 'ipaddr' has been added to the Neighbor
+ *   Table.  Mark all packets held for the address as ready to send and
+ *   notify the network devices that there is TX data available.
+ *
+ * Input Parameters:
+ *   ipaddr - The address that was resolved
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void neighbor_pending_resolved(const net_ipv6addr_t ipaddr)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NEIGHBOR_NPENDING; i++)
+    {
+      FAR struct neighbor_pending_s *pending = &g_neighbor_pending[i];
+
+      if (pending->np_iob != NULL && !pending->np_ready &&
+          net_ipv6addr_cmp(pending->np_ipaddr, ipaddr))
+        {
+          pending->np_ready = true;
+          netdev_txnotify_dev(pending->np_dev);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_poll
+ *
+ * Description:
+ *   Provide each packet that is ready to be sent on this device to the
+ *   driver.  The driver's poll callback will add the Ethernet header with
+ *   neighbor_out() as it does for any other outgoing IPv6 packet.
+ *
+ * Input Parameters:
+ *   dev      - The device being polled
+ *   callback - The driver's poll callback
+ *
+ * Returned Value:
+ *   The value returned by the last call to the poll callback (non-zero
+ *   terminates the poll).
+ *
+ * Assumptions:
+ *   This function is called from the MAC device driver indirectly through
+ *   devif_poll() with the network locked.
+ *
+ ****************************************************************************/
+
+int neighbor_pending_poll(FAR struct net_driver_s *dev,
+                          devif_poll_callback_t callback)
+{
+  int bstop = 0;
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NEIGHBOR_NPENDING && !bstop; i++)
+    {
+      FAR struct neighbor_pending_s *pending = &g_neighbor_pending[i];
+
+      if (pending->np_iob != NULL && pending->np_ready &&
+          pending->np_dev == dev)
+        {
+          /* Restore the IPv6 packet to the device buffer */
+
+          dev->d_len    = iob_copyout(&dev->d_buf[NET_LL_HDRLEN(dev)],
+                                      pending->np_iob,
+                                      pending->np_iob->io_pktlen, 0);
+          dev->d_sndlen = 0;
+          IFF_SET_IPv6(dev->d_flags);
+
+          neighbor_pending_free(pending);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
+    }
+
+  return bstop;
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_purge
+ *
+ * Description:
+ *   Discard all packets held for a network device.  This is called when
+ *   the device is unregistered so that no reference to it remains.
+ *
+ * Input Parameters:
+ *   dev - The device being unregistered
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void neighbor_pending_purge(FAR struct net_driver_s *dev)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NEIGHBOR_NPENDING; i++)
+    {
+      if (g_neighbor_pending[i].np_iob != NULL &&
+          g_neighbor_pending[i].np_dev == dev)
+        {
+          neighbor_pending_free(&g_neighbor_pending[i]);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: neighbor_pending_expire
+ *
+ * Description:
+ *   Discard held packets whose address has not been resolved within
+ *   NEIGHBOR_PENDING_MAXAGE.  This is called from neighbor_periodic() so
+ *   that held I/O buffers are released even if there are no further
+ *   Neighbor Table misses.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void neighbor_pending_expire(void)
+{
+  clock_t now = clock_systimer();
+  int i;
+
+  for (i = 0; i < CONFIG_NET_IPv6_NEIGHBOR_NPENDING; i++)
+    {
+      FAR struct neighbor_pending_s *pending = &g_neighbor_pending[i];
+
+      if (pending->np_iob != NULL && !pending->np_ready &&
+          now - pending->np_time >= NEIGHBOR_PENDING_MAXAGE)
+        {
+          neighbor_dumpipaddr("Discarding packet for", pending->np_ipaddr);
+          neighbor_pending_free(pending);
+        }
+    }
+}
+
+#endif /* CONFIG_NET_IPv6_NEIGHBOR_PENDING */
@@ -86,5 +86,13 @@ void neighbor_periodic(int hsec)
 
           g_neighbors[i].ne_time = newtime;
         }
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+      /* Discard held packets that are still waiting for address
+       * resolution.
+       */
+
+      neighbor_pending_expire();
+#endif
     }
 }
@@ -54,6 +54,8 @@
 
 #include "utils/utils.h"
 #include "netdev/netdev.h"
+#include "arp/arp.h"
+#include "neighbor/neighbor.h"
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -162,6 +164,18 @@ int netdev_unregister(FAR struct net_driver_s *dev)
           curr->flink = NULL;
         }
 
+#ifdef CONFIG_NET_ARP_PENDING
+      /* Discard any packets held for the device pending address
+       * resolution.
+       */
+
+      arp_pending_purge(dev);
+#endif
+
+#ifdef CONFIG_NET_IPv6_NEIGHBOR_PENDING
+      neighbor_pending_purge(dev);
+#endif
+
 #ifdef CONFIG_NETDEV_IFINDEX
       free_ifindex(dev->d_ifindex);
 #endif
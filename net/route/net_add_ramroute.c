@@ -75,6 +75,9 @@
 int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_ipv4_s *route;
+#ifdef HAVE_IPv4_LPMROUTE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -96,6 +99,19 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
+#ifdef HAVE_IPv4_LPMROUTE
+  /* Add the new entry to the longest prefix match index */
+
+  ret = net_lpmadd_ipv4(route);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to index the route: %d\n", ret);
+      net_unlock();
+      net_freeroute_ipv4(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv4_addlast((FAR struct net_route_ipv4_entry_s *)route,
@@ -110,6 +126,9 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
                       net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+#ifdef HAVE_IPv6_LPMROUTE
+  int ret;
+#endif
 
   /* Allocate a route entry */
 
@@ -131,6 +150,19 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask,
 
   net_lock();
 
+#ifdef HAVE_IPv6_LPMROUTE
+  /* Add the new entry to the longest prefix match index */
+
+  ret = net_lpmadd_ipv6(route);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to index the route: %d\n", ret);
+      net_unlock();
+      net_freeroute_ipv6(route);
+      return ret;
+    }
+#endif
+
   /* Then add the new entry to the table */
 
   ramroute_ipv6_addlast((FAR struct net_route_ipv6_entry_s *)route,
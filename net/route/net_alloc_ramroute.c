@@ -143,6 +143,12 @@ void net_init_ramroute(void)
       ramroute_ipv6_addlast(&g_prealloc_ipv6routes[i], &g_free_ipv6routes);
     }
 #endif
+
+#ifdef CONFIG_ROUTE_LONGEST_MATCH
+  /* Initialize the longest prefix match index */
+
+  net_init_lpmroute();
+#endif
 }
 
 /****************************************************************************
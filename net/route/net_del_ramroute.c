@@ -122,6 +122,12 @@ static int net_match_ipv4(FAR struct net_route_ipv4_s *route, FAR void *arg)
           (void)ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+#ifdef HAVE_IPv4_LPMROUTE
+      /* Remove the entry from the longest prefix match index */
+
+      net_lpmdel_ipv4(route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv4(route);
@@ -175,6 +181,12 @@ static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
           (void)ramroute_ipv6_remfirst(&g_ipv6_routes);
         }
 
+#ifdef HAVE_IPv6_LPMROUTE
+      /* Remove the entry from the longest prefix match index */
+
+      net_lpmdel_ipv6(route);
+#endif
+
       /* And free the routing table entry by adding it to the free list */
 
       net_freeroute_ipv6(route);
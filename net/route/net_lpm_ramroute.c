@@ -0,0 +1,688 @@
+/****************************************************************************
+ * net/route/net_lpm_ramroute.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/ramroute.h"
+#include "route/route.h"
+
+#ifdef CONFIG_ROUTE_LONGEST_MATCH
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The size of the largest key (i.e., address) held in a trie */
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define LPM_KEYSIZE    16
+#else
+#  define LPM_KEYSIZE    4
+#endif
+
+/* Each route adds at most two nodes to a trie:  The node holding the route
+ * and, possibly, one branch node where its prefix diverges from an existing
+ * prefix.
+ */
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+#  define LPM_IPv4_NNODES (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#else
+#  define LPM_IPv4_NNODES 0
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+#  define LPM_IPv6_NNODES (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+#else
+#  define LPM_IPv6_NNODES 0
+#endif
+
+#define LPM_NNODES       (LPM_IPv4_NNODES + LPM_IPv6_NNODES)
+
+/* Get bit 'n' (counting from the most significant bit of the first byte)
+ * of a key in network order.
+ */
+
+#define LPM_KEYBIT(k,n)  (((k)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one node of a path-compressed binary (Patricia)
+ * trie.  Each node holds a prefix of 'plen' bits.  The prefix of a node is
+ * always a prefix of the prefixes of all of its descendants.  Nodes that
+ * do not hold a route are branch nodes and always have two children.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *parent;   /* Parent node (NULL for the root) */
+  FAR struct lpm_node_s *child[2]; /* Children selected by the next bit */
+  FAR void *route;                 /* Route with exactly this prefix */
+  uint8_t plen;                    /* Length of the prefix in bits */
+  uint8_t prefix[LPM_KEYSIZE];     /* The prefix in network order */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The root of each trie */
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+static FAR struct lpm_node_s *g_ipv4_lpm;
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+static FAR struct lpm_node_s *g_ipv6_lpm;
+#endif
+
+/* The pool of pre-allocated trie nodes and a list of the free nodes (linked
+ * through child[0]).
+ */
+
+static struct lpm_node_s g_lpm_nodes[LPM_NNODES];
+static FAR struct lpm_node_s *g_lpm_free;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_alloc and lpm_free
+ *
+ * Description:
+ *   Allocate a trie node from the free list or return a node to the free
+ *   list.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_alloc(FAR const uint8_t *key,
+                                        uint8_t plen, FAR void *route)
+{
+  FAR struct lpm_node_s *node;
+  int nbytes;
+  int nbits;
+
+  node = g_lpm_free;
+  if (node != NULL)
+    {
+      g_lpm_free = node->child[0];
+
+      /* Save only the significant bits of the key */
+
+      memset(node, 0, sizeof(struct lpm_node_s));
+      nbytes = plen >> 3;
+      nbits  = plen & 7;
+
+      memcpy(node->prefix, key, nbytes);
+      if (nbits > 0)
+        {
+          node->prefix[nbytes] = key[nbytes] & (uint8_t)(0xff << (8 - nbits));
+        }
+
+      node->plen  = plen;
+      node->route = route;
+    }
+
+  return node;
+}
+
+static void lpm_free(FAR struct lpm_node_s *node)
+{
+  node->child[0] = g_lpm_free;
+  g_lpm_free     = node;
+}
+
+/****************************************************************************
+ * Name: lpm_prefixlen
+ *
+ * Description:
+ *   Convert a network mask in network order to a prefix length.
+ *
+ * Returned Value:
+ *   The prefix length on success; -EINVAL if the network mask is not a
+ *   contiguous sequence of one bits.
+ *
+ ****************************************************************************/
+
+static int lpm_prefixlen(FAR const uint8_t *mask, int keysize)
+{
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < keysize && mask[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < keysize)
+    {
+      uint8_t byte = mask[i];
+
+      while ((byte & 0x80) != 0)
+        {
+          byte <<= 1;
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (i++; i < keysize; i++)
+        {
+          if (mask[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits (up to 'maxbits') that are the same
+ *   in two keys.
+ *
+ ****************************************************************************/
+
+static int lpm_common(FAR const uint8_t *key1, FAR const uint8_t *key2,
+                      int maxbits)
+{
+  int nbits = 0;
+  int i;
+
+  for (i = 0; nbits < maxbits; i++, nbits += 8)
+    {
+      uint8_t diff = key1[i] ^ key2[i];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+    }
+
+  return nbits < maxbits ? nbits : maxbits;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Insert a route with the prefix 'key/plen' into a trie.
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route for the prefix;
+ *   -ENOMEM if there are no free trie nodes.
+ *
+ ****************************************************************************/
+
+static int lpm_insert(FAR struct lpm_node_s **root, FAR const uint8_t *key,
+                      uint8_t plen, FAR void *route)
+{
+  FAR struct lpm_node_s **pp = root;
+  FAR struct lpm_node_s *parent = NULL;
+  FAR struct lpm_node_s *node;
+  FAR struct lpm_node_s *leaf;
+  FAR struct lpm_node_s *branch;
+  int common = 0;
+
+  /* Descend while the prefix of the node is a prefix of the new key */
+
+  while ((node = *pp) != NULL)
+    {
+      common = lpm_common(node->prefix, key,
+                          node->plen < plen ? node->plen : plen);
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* Exact match.  This may be a branch node with no route */
+
+          if (node->route != NULL)
+            {
+              return -EEXIST;
+            }
+
+          node->route = route;
+          return OK;
+        }
+
+      parent = node;
+      pp     = &node->child[LPM_KEYBIT(key, node->plen)];
+    }
+
+  /* Create the node that will hold the new route */
+
+  leaf = lpm_alloc(key, plen, route);
+  if (leaf == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  leaf->parent = parent;
+
+  if (node == NULL)
+    {
+      /* Just add the new node as a leaf */
+
+      *pp = leaf;
+    }
+  else if (common == plen)
+    {
+      /* The new prefix is a prefix of the existing node.  Insert the new
+       * node above the existing node.
+       */
+
+      leaf->child[LPM_KEYBIT(node->prefix, plen)] = node;
+      node->parent = leaf;
+      *pp          = leaf;
+    }
+  else
+    {
+      /* The prefixes diverge at bit 'common'.  A new branch node is needed
+       * with the new node and the existing node as its children.
+       */
+
+      branch = lpm_alloc(key, common, NULL);
+      if (branch == NULL)
+        {
+          lpm_free(leaf);
+          return -ENOMEM;
+        }
+
+      branch->parent                                 = parent;
+      branch->child[LPM_KEYBIT(key, common)]          = leaf;
+      branch->child[LPM_KEYBIT(node->prefix, common)] = node;
+      leaf->parent                                   = branch;
+      node->parent                                   = branch;
+      *pp                                            = branch;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lpm_link
+ *
+ * Description:
+ *   Return the address of the link that refers to 'node' (either in its
+ *   parent or the root of the trie).
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s **lpm_link(FAR struct lpm_node_s **root,
+                                        FAR struct lpm_node_s *node)
+{
+  FAR struct lpm_node_s *parent = node->parent;
+
+  if (parent == NULL)
+    {
+      return root;
+    }
+
+  return parent->child[0] == node ? &parent->child[0] : &parent->child[1];
+}
+
+/****************************************************************************
+ * Name: lpm_prune
+ *
+ * Description:
+ *   Remove a node that no longer holds a route if it has fewer than two
+ *   children.  If that leaves its parent as a branch node with only one
+ *   child, then the parent is removed too.
+ *
+ ****************************************************************************/
+
+static void lpm_prune(FAR struct lpm_node_s **root,
+                      FAR struct lpm_node_s *node)
+{
+  while (node != NULL && node->route == NULL &&
+         (node->child[0] == NULL || node->child[1] == NULL))
+    {
+      FAR struct lpm_node_s *parent = node->parent;
+      FAR struct lpm_node_s *child;
+
+      child = node->child[0] != NULL ? node->child[0] : node->child[1];
+      if (child != NULL)
+        {
+          child->parent = parent;
+        }
+
+      *lpm_link(root, node) = child;
+      lpm_free(node);
+
+      node = parent;
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove the route with the prefix 'key/plen' from a trie.
+ *
+ ****************************************************************************/
+
+static void lpm_remove(FAR struct lpm_node_s **root, FAR const uint8_t *key,
+                       uint8_t plen, FAR void *route)
+{
+  FAR struct lpm_node_s *node = *root;
+
+  while (node != NULL && node->plen <= plen &&
+         lpm_common(node->prefix, key, node->plen) == node->plen)
+    {
+      if (node->plen == plen)
+        {
+          if (node->route == route)
+            {
+              node->route = NULL;
+              lpm_prune(root, node);
+            }
+
+          return;
+        }
+
+      node = node->child[LPM_KEYBIT(key, node->plen)];
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Find the node holding the longest prefix that matches 'key'.  Any
+ *   shorter matching prefixes are found by following the parent links from
+ *   this node.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_lookup(FAR struct lpm_node_s *node,
+                                         FAR const uint8_t *key, int keybits)
+{
+  FAR struct lpm_node_s *best = NULL;
+
+  while (node != NULL &&
+         lpm_common(node->prefix, key, node->plen) == node->plen)
+    {
+      if (node->route != NULL)
+        {
+          best = node;
+        }
+
+      if (node->plen >= keybits)
+        {
+          break;
+        }
+
+      node = node->child[LPM_KEYBIT(key, node->plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the in-memory routing
+ *   tables.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+  int i;
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+  g_ipv4_lpm = NULL;
+#endif
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+  g_ipv6_lpm = NULL;
+#endif
+
+  /* Add all of the pre-allocated trie nodes to the free list */
+
+  g_lpm_free = NULL;
+  for (i = 0; i < LPM_NNODES; i++)
+    {
+      lpm_free(&g_lpm_nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: net_lpmadd_ipv4 and net_lpmadd_ipv6
+ *
+ * Description:
+ *   Add a route to the longest prefix match index.
+ *
+ * Input Parameters:
+ *   route - The route to be added.
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpmadd_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)&route->netmask, 4);
+  if (plen < 0)
+    {
+      nerr("ERROR: Non-contiguous netmask\n");
+      return plen;
+    }
+
+  return lpm_insert(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                    plen, route);
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpmadd_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  int plen;
+
+  plen = lpm_prefixlen((FAR const uint8_t *)route->netmask, 16);
+  if (plen < 0)
+    {
+      nerr("ERROR: Non-contiguous netmask\n");
+      return plen;
+    }
+
+  return lpm_insert(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                    plen, route);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmdel_ipv4 and net_lpmdel_ipv6
+ *
+ * Description:
+ *   Remove a route from the longest prefix match index.
+ *
+ * Input Parameters:
+ *   route - The route to be removed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+void net_lpmdel_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  int plen = lpm_prefixlen((FAR const uint8_t *)&route->netmask, 4);
+
+  if (plen >= 0)
+    {
+      lpm_remove(&g_ipv4_lpm, (FAR const uint8_t *)&route->target,
+                 plen, route);
+    }
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+void net_lpmdel_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  int plen = lpm_prefixlen((FAR const uint8_t *)route->netmask, 16);
+
+  if (plen >= 0)
+    {
+      lpm_remove(&g_ipv6_lpm, (FAR const uint8_t *)route->target,
+                 plen, route);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: net_lpmforeach_ipv4 and net_lpmforeach_ipv6
+ *
+ * Description:
+ *   Visit each route whose prefix matches the target address, starting
+ *   with the longest matching prefix and ending with the shortest.  The
+ *   cost of the search depends on the length of the address, not on the
+ *   number of routes.
+ *
+ * Input Parameters:
+ *   target  - The address to match
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if all matching routes were visited.  Handlers
+ *   may terminate the search early with any non-zero value, which is then
+ *   returned.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_IPv4_RAMROUTE
+int net_lpmforeach_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg)
+{
+  FAR struct lpm_node_s *node;
+  int ret = 0;
+
+  net_lock();
+
+  node = lpm_lookup(g_ipv4_lpm, (FAR const uint8_t *)&target, 32);
+  for (; ret == 0 && node != NULL; node = node->parent)
+    {
+      if (node->route != NULL)
+        {
+          ret = handler((FAR struct net_route_ipv4_s *)node->route, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#ifdef CONFIG_ROUTE_IPv6_RAMROUTE
+int net_lpmforeach_ipv6(const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg)
+{
+  FAR struct lpm_node_s *node;
+  int ret = 0;
+
+  net_lock();
+
+  node = lpm_lookup(g_ipv6_lpm, (FAR const uint8_t *)target, 128);
+  for (; ret == 0 && node != NULL; node = node->parent)
+    {
+      if (node->route != NULL)
+        {
+          ret = handler((FAR struct net_route_ipv6_s *)node->route, arg);
+        }
+    }
+
+  net_unlock();
+  return ret;
+}
+#endif
+
+#endif /* CONFIG_ROUTE_LONGEST_MATCH */
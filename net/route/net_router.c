@@ -49,6 +49,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/ramroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -122,8 +123,8 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
   FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  If the longest prefix
+   * match index is used, then the first match is the most specific route.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
@@ -165,8 +166,8 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
   FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
 
   /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
+   * of multiple matches, only the first is returned.  If the longest prefix
+   * match index is used, then the first match is the most specific route.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
@@ -237,7 +238,11 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_IPv4_LPMROUTE
+      ret = net_lpmforeach_ipv4(target, net_ipv4_match, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_match, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -312,7 +317,11 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router)
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_IPv6_LPMROUTE
+      ret = net_lpmforeach_ipv6(target, net_ipv6_match, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_match, &match);
+#endif
     }
 
   /* Did we find a route? */
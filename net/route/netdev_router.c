@@ -48,6 +48,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/ramroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
@@ -128,8 +129,9 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
   /* To match, (1) the masked target addresses must be the same, and (2) the
    * router address must like on the network provided by the device.
    *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * In the event of multiple matches, only the first is returned.  If the
+   * longest prefix match index is used, then the routes are visited from
+   * the most to the least specific.
    */
 
   if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -177,8 +179,9 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
   /* To match, (1) the masked target addresses must be the same, and (2) the
    * router address must like on the network provided by the device.
    *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
+   * In the event of multiple matches, only the first is returned.  If the
+   * longest prefix match index is used, then the routes are visited from
+   * the most to the least specific.
    */
 
   if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask) &&
@@ -250,7 +253,11 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_IPv4_LPMROUTE
+      ret = net_lpmforeach_ipv4(target, net_ipv4_devmatch, &match);
+#else
       ret = net_foreachroute_ipv4(net_ipv4_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
@@ -329,7 +336,11 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
        * routing table that can forward to this address
        */
 
+#ifdef HAVE_IPv6_LPMROUTE
+      ret = net_lpmforeach_ipv6(target, net_ipv6_devmatch, &match);
+#else
       ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
+#endif
     }
 
   /* Did we find a route? */
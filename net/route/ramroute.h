@@ -60,6 +60,16 @@
 #  define CONFIG_ROUTE_MAX_IPv6_RAMROUTES 4
 #endif
 
+/* Longest prefix match index */
+
+#if defined(CONFIG_ROUTE_LONGEST_MATCH) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+#  define HAVE_IPv4_LPMROUTE 1
+#endif
+
+#if defined(CONFIG_ROUTE_LONGEST_MATCH) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+#  define HAVE_IPv6_LPMROUTE 1
+#endif
+
 /* Routing table initializer */
 
 #define ramroute_init(rr) \
@@ -231,5 +241,108 @@ FAR struct net_route_ipv6_entry_s *
   struct net_route_ipv6_queue_s *list);
 #endif
 
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match index of the in-memory routing
+ *   tables.
+ *
+ * Input Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_ROUTE_LONGEST_MATCH
+void net_init_lpmroute(void);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmadd_ipv4 and net_lpmadd_ipv6
+ *
+ * Description:
+ *   Add a route to the longest prefix match index.  The netmask of the
+ *   route must be a contiguous prefix and there must be no other route for
+ *   the same prefix.
+ *
+ * Input Parameters:
+ *   route - The route to be added.
+ *
+ * Returned Value:
+ *   OK on success; Negated errno on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IPv4_LPMROUTE
+int net_lpmadd_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_IPv6_LPMROUTE
+int net_lpmadd_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmdel_ipv4 and net_lpmdel_ipv6
+ *
+ * Description:
+ *   Remove a route from the longest prefix match index.
+ *
+ * Input Parameters:
+ *   route - The route to be removed.
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IPv4_LPMROUTE
+void net_lpmdel_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_IPv6_LPMROUTE
+void net_lpmdel_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_lpmforeach_ipv4 and net_lpmforeach_ipv6
+ *
+ * Description:
+ *   Visit each route whose prefix matches the target address, starting
+ *   with the longest matching prefix and ending with the shortest.
+ *
+ * Input Parameters:
+ *   target  - The address to match
+ *   handler - Will be called for each matching route.
+ *   arg     - An arbitrary value that will be passed to the handler.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned if all matching routes were visited.  Handlers
+ *   may terminate the search early with any non-zero value, which is then
+ *   returned.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_IPv4_LPMROUTE
+int net_lpmforeach_ipv4(in_addr_t target, route_handler_ipv4_t handler,
+                        FAR void *arg);
+#endif
+
+#ifdef HAVE_IPv6_LPMROUTE
+int net_lpmforeach_ipv6(const net_ipv6addr_t target,
+                        route_handler_ipv6_t handler, FAR void *arg);
+#endif
+
 #endif /* CONFIG_ROUTE_IPv4_RAMROUTE || CONFIG_ROUTE_IPv6_RAMROUTE */
 #endif /* __NET_ROUTE_RAMROUTE_H */
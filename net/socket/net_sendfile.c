@@ -150,7 +150,7 @@ ssize_t net_sendfile(int outfd, FAR struct file *infile, FAR off_t *offset,
       list = sched_getfiles();
       DEBUGASSERT(list != NULL);
 
-      infd = infile - list->fl_files;
+      infd = files_getfd(list, infile);
       return lib_sendfile(outfd, infd, offset, count);
     }
   else
@@ -0,0 +1,185 @@
+/****************************************************************************
+ * net/socket/socketpair.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/socket.h>
+#include <errno.h>
+#include <assert.h>
+#include <debug.h>
+
+#include "socket/socket.h"
+#include "local/local.h"
+
+#ifdef CONFIG_NET
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: socketpair
+ *
+ * Description:
+ *   socketpair() creates an unnamed pair of connected sockets in the
+ *   specified domain, of the specified type, and using the optionally
+ *   specified protocol.  The descriptors of the two sockets are returned in
+ *   sv[0] and sv[1].  Only AF_LOCAL SOCK_STREAM sockets are supported, and
+ *   AF_LOCAL SOCK_SEQPACKET sockets if CONFIG_NET_LOCAL_DIRECT is enabled.
+ *
+ * Input Parameters:
+ *   domain   (see sys/socket.h)
+ *   type     (see sys/socket.h)
+ *   protocol (see sys/socket.h)
+ *   sv       Location to return the two socket descriptors
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -1 (ERROR) is returned on failure
+ *   and the errno variable is set appropriately:
+ *
+ *   EAFNOSUPPORT
+ *     The specified address family is not supported on this machine.
+ *   EOPNOTSUPP
+ *     The specified protocol does not support creation of socket pairs.
+ *   EFAULT
+ *     The address sv does not specify a valid part of the process address
+ *     space.
+ *   EMFILE / ENFILE
+ *     Too many descriptors are in use.
+ *
+ ****************************************************************************/
+
+int socketpair(int domain, int type, int protocol, int sv[2])
+{
+#ifdef CONFIG_NET_LOCAL_STREAM
+  FAR struct socket *psock[2];
+  int sockfd[2];
+  int errcode;
+  int ret;
+  int i;
+
+  if (sv == NULL)
+    {
+      errcode = EFAULT;
+      goto errout;
+    }
+
+  if (domain != PF_LOCAL)
+    {
+      errcode = EAFNOSUPPORT;
+      goto errout;
+    }
+
+#ifdef CONFIG_NET_LOCAL_DIRECT
+  if (type != SOCK_STREAM && type != SOCK_SEQPACKET)
+#else
+  if (type != SOCK_STREAM)
+#endif
+    {
+      errcode = EOPNOTSUPP;
+      goto errout;
+    }
+
+  /* Allocate and initialize the two sockets */
+
+  for (i = 0; i < 2; i++)
+    {
+      sockfd[i] = sockfd_allocate(0);
+      if (sockfd[i] < 0)
+        {
+          nerr("ERROR: Failed to allocate a socket descriptor\n");
+          errcode = ENFILE;
+          goto errout_with_sockets;
+        }
+
+      psock[i] = sockfd_socket(sockfd[i]);
+      DEBUGASSERT(psock[i] != NULL);
+
+      ret = psock_socket(domain, type, protocol, psock[i]);
+      if (ret < 0)
+        {
+          nerr("ERROR: psock_socket() failed: %d\n", ret);
+          sockfd_release(sockfd[i]);
+          errcode = -ret;
+          goto errout_with_sockets;
+        }
+
+      if (psock[i]->s_sockif != &g_local_sockif)
+        {
+          /* The domain was claimed by some other socket interface */
+
+          i++;
+          errcode = EOPNOTSUPP;
+          goto errout_with_sockets;
+        }
+    }
+
+  /* Then connect them to each other */
+
+  ret = local_socketpair((FAR struct local_conn_s *)psock[0]->s_conn,
+                         (FAR struct local_conn_s *)psock[1]->s_conn,
+                         type);
+  if (ret < 0)
+    {
+      nerr("ERROR: local_socketpair() failed: %d\n", ret);
+      errcode = -ret;
+      goto errout_with_sockets;
+    }
+
+  sv[0] = sockfd[0];
+  sv[1] = sockfd[1];
+  return OK;
+
+errout_with_sockets:
+  while (--i >= 0)
+    {
+      (void)net_close(sockfd[i]);
+    }
+
+errout:
+  set_errno(errcode);
+  return ERROR;
+
+#else
+  set_errno(domain == PF_LOCAL ? EOPNOTSUPP : EAFNOSUPPORT);
+  return ERROR;
+#endif
+}
+
+#endif /* CONFIG_NET */
@@ -49,7 +49,7 @@
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/ip.h>
 
-#ifdef CONFIG_TCP_NOTIFIER
+#if defined(CONFIG_TCP_NOTIFIER) || defined(CONFIG_NET_TCP_DELAYED_ACK)
 #  include <nuttx/wqueue.h>
 #endif
 
@@ -68,6 +68,14 @@
 #  define HAVE_TCP_POLL
 #endif
 
+/* The maximum number of segments that one TCP connection may provide in
+ * response to a single device poll.
+ */
+
+#ifndef CONFIG_NET_TCP_TXBURST
+#  define CONFIG_NET_TCP_TXBURST 1
+#endif
+
 /* Allocate a new TCP data callback */
 
 /* These macros allocate and free callback structures used for receiving
@@ -152,6 +160,10 @@ struct tcp_conn_s
 #else
   uint16_t unacked;       /* Number bytes sent but not yet ACKed */
 #endif
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  uint8_t  rx_unackseg;   /* Number of received segments not yet ACKed */
+  struct work_s ackwork;  /* Forces out a deferred ACK at its deadline */
+#endif
 
   /* If the TCP socket is bound to a local address, then this is
    * a reference to the device that routes traffic on the corresponding
@@ -779,6 +791,30 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                int hsec);
 
+/****************************************************************************
+ * Name: tcp_ackdelay_start
+ *
+ * Description:
+ *   Arm the deadline of a deferred ACK.  When the deadline expires, the
+ *   device bound to the connection is asked to poll for TX data so that
+ *   the deferred ACK is sent, if it has not been sent in the meantime.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" with the deferred ACK
+ *
+ * Returned Value:
+ *   OK if the deadline was armed.  A negated errno value is returned on
+ *   any failure; the caller must then send the ACK immediately.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+int tcp_ackdelay_start(FAR struct tcp_conn_s *conn);
+#endif
+
 /****************************************************************************
  * Name: tcp_listen_initialize
  *
@@ -774,6 +774,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       dq_rem(&conn->node, &g_active_tcp_connections);
     }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Cancel the deadline of any deferred ACK */
+
+  work_cancel(LPWORK, &conn->ackwork);
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
@@ -124,6 +124,17 @@ void tcp_poll(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
           result = tcp_callback(dev, conn, TCP_POLL);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+          /* Send any deferred ACK, either piggybacked on outgoing data or
+           * as a pure ACK.
+           */
+
+          if (conn->rx_unackseg > 0)
+            {
+              result |= TCP_SNDACK;
+            }
+#endif
+
           /* Handle the callback response */
 
           tcp_appsend(dev, conn, result);
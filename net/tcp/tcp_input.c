@@ -892,6 +892,25 @@ found:
                 net_incr32(conn->rcvseq, len);
               }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+            /* If new data was accepted and there is nothing else to send in
+             * response, then we may defer the ACK of the first segment.  An
+             * ACK is always sent for the second segment (RFC 1122).  A
+             * deferred ACK is piggybacked on the next outgoing packet or
+             * sent when its deadline expires.  If the deadline cannot be
+             * armed, the ACK is sent now.
+             */
+
+            if (len > 0 && dev->d_sndlen == 0 &&
+                (result & (TCP_SNDACK | TCP_CLOSE | TCP_ABORT |
+                           NETDEV_DOWN)) == TCP_SNDACK &&
+                conn->rx_unackseg == 0 && tcp_ackdelay_start(conn) >= 0)
+              {
+                conn->rx_unackseg = 1;
+                result &= ~TCP_SNDACK;
+              }
+#endif
+
             /* Send the response, ACKing the data or not, as appropriate */
 
             tcp_appsend(dev, conn, result);
@@ -406,6 +406,15 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   dev->d_len     = len;
   tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
   tcp_sendcommon(dev, conn, tcp);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Any deferred ACK is now included in this packet */
+
+  if ((flags & TCP_ACK) != 0)
+    {
+      conn->rx_unackseg = 0;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -776,8 +776,27 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
         {
           FAR struct tcp_wrbuffer_s *wrb;
           uint32_t predicted_seqno;
+          uint32_t winleft;
           size_t sndlen;
 
+#if CONFIG_NET_TCP_TXBURST > 1
+          /* Several segments may be sent from one device poll, so the data
+           * that is already in flight must be accounted for in the window.
+           * Wait for an ACK if the peer's window has been filled.
+           */
+
+          if (conn->unacked >= conn->winsize)
+            {
+              ninfo("SEND: Window full: unacked=%u winsize=%u\n",
+                    conn->unacked, conn->winsize);
+              return flags;
+            }
+
+          winleft = conn->winsize - conn->unacked;
+#else
+          winleft = conn->winsize;
+#endif
+
           /* Peek at the head of the write queue (but don't remove anything
            * from the write queue yet).  We know from the above test that
            * the write_q is not empty.
@@ -798,9 +817,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               sndlen = conn->mss;
             }
 
-          if (sndlen > conn->winsize)
+          if (sndlen > winleft)
             {
-              sndlen = conn->winsize;
+              sndlen = winleft;
             }
 
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
@@ -893,7 +912,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 
           /* Only one data can be sent by low level driver at once,
-           * tell the caller stop polling the other connection.
+           * tell the caller stop polling the other connection.  If
+           * CONFIG_NET_TCP_TXBURST > 1, the device poll logic may then
+           * poll this connection again for the next segment.
            */
 
           flags &= ~TCP_POLL;
@@ -58,6 +58,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -99,6 +100,7 @@ struct sendfile_s
   FAR struct devif_callback_s *snd_datacb; /* Data callback */
   FAR struct devif_callback_s *snd_ackcb;  /* ACK callback */
   FAR struct file   *snd_file;    /* File structure of the input file */
+  FAR const uint8_t *snd_map;     /* Mapped file data (or NULL) */
   sem_t              snd_sem;     /* Used to wake up the waiting thread */
   off_t              snd_foffset; /* Input file offset */
   size_t             snd_flen;    /* File length */
@@ -418,21 +420,38 @@ static uint16_t sendfile_eventhandler(FAR struct net_driver_s *dev,
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
-          if (ret < 0)
+          if (pstate->snd_map != NULL)
             {
-              nerr("ERROR: Failed to lseek: %d\n", ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              /* The file data is directly addressable.  Copy the segment
+               * straight from the file image; retransmissions simply copy
+               * the same bytes again without going back through the file
+               * system.
+               */
+
+              memcpy(dev->d_appdata, pstate->snd_map + pstate->snd_sent,
+                     sndlen);
+              ret = sndlen;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+          else
             {
-              nerr("ERROR: Failed to read from input file: %d\n", (int)ret);
-              pstate->snd_sent = ret;
-              goto end_wait;
+              ret = file_seek(pstate->snd_file,
+                              pstate->snd_foffset + pstate->snd_sent,
+                              SEEK_SET);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to lseek: %d\n", ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
+
+              ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
+              if (ret < 0)
+                {
+                  nerr("ERROR: Failed to read from input file: %d\n",
+                       (int)ret);
+                  pstate->snd_sent = ret;
+                  goto end_wait;
+                }
             }
 
           dev->d_sndlen = sndlen;
@@ -556,6 +575,66 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
 #endif /* CONFIG_NET_IPv6 */
 }
 
+/****************************************************************************
+ * Name: sendfile_map
+ *
+ * Description:
+ *   If the input file lives in directly addressable memory (XIP ROMFS,
+ *   TMPFS, ...), return the address of the data at 'offset' so that the
+ *   send logic can take the data directly from the file image.  The
+ *   transfer length is clipped to the end of the file in that case.
+ *
+ * Input Parameters:
+ *   infile - The input file
+ *   offset - The file offset of the first byte to send
+ *   count  - The number of bytes to send.  May be reduced on return.
+ *
+ * Returned Value:
+ *   The address of the file data at 'offset' or NULL if the file cannot
+ *   be mapped.  In the latter case, the data must be read from the file.
+ *
+ ****************************************************************************/
+
+static FAR const uint8_t *sendfile_map(FAR struct file *infile, off_t offset,
+                                       FAR size_t *count)
+{
+  FAR uint8_t *addr = NULL;
+  off_t fpos;
+  off_t fsize;
+  int ret;
+
+  ret = file_ioctl(infile, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+  if (ret < 0 || addr == NULL)
+    {
+      return NULL;
+    }
+
+  /* Get the size of the file so that we never reference beyond the end of
+   * the mapped file image.
+   */
+
+  fpos = file_seek(infile, 0, SEEK_CUR);
+  if (fpos < 0)
+    {
+      return NULL;
+    }
+
+  fsize = file_seek(infile, 0, SEEK_END);
+  (void)file_seek(infile, fpos, SEEK_SET);
+
+  if (fsize < 0 || offset > fsize)
+    {
+      return NULL;
+    }
+
+  if (*count > (size_t)(fsize - offset))
+    {
+      *count = fsize - offset;
+    }
+
+  return addr + offset;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -584,6 +663,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
                       FAR off_t *offset, size_t count)
 {
   FAR struct tcp_conn_s *conn;
+  FAR const uint8_t *map;
   struct sendfile_s state;
   int ret;
 
@@ -631,6 +711,10 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+  /* Check if the file data can be referenced in place */
+
+  map = sendfile_map(infile, offset ? *offset : 0, &count);
+
   /* Set the socket state to sending */
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
@@ -654,6 +738,7 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
   state.snd_foffset = offset ? *offset : 0; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+  state.snd_map     = map;                  /* Mapped file data (or NULL) */
 
   /* Allocate resources to receive a callback */
 
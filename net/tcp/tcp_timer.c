@@ -48,8 +48,11 @@
 
 #include <stdint.h>
 #include <assert.h>
+#include <errno.h>
 #include <debug.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -57,9 +60,45 @@
 #include <nuttx/net/tcp.h>
 
 #include "devif/devif.h"
+#include "netdev/netdev.h"
 #include "socket/socket.h"
 #include "tcp/tcp.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ackdelay_work
+ *
+ * Description:
+ *   The deadline of a deferred ACK has expired.  If the ACK is still
+ *   pending, ask the bound device to poll for TX data; tcp_poll() will then
+ *   send the ACK.
+ *
+ * Input Parameters:
+ *   arg - The TCP "connection" with the deferred ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+static void tcp_ackdelay_work(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = (FAR struct tcp_conn_s *)arg;
+
+  net_lock();
+  if (conn->rx_unackseg > 0 && conn->dev != NULL)
+    {
+      netdev_txnotify_dev(conn->dev);
+    }
+
+  net_unlock();
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -472,12 +511,33 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                */
 
               result = tcp_callback(dev, conn, TCP_POLL);
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+              /* Include any deferred ACK in the response */
+
+              if (conn->rx_unackseg > 0)
+                {
+                  result |= TCP_SNDACK;
+                }
+#endif
+
               tcp_appsend(dev, conn, result);
               goto done;
             }
         }
     }
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* Nothing else to be done.  Send any deferred ACK now. */
+
+  if (conn->rx_unackseg > 0 && dev == conn->dev &&
+      (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED)
+    {
+      tcp_send(dev, conn, TCP_ACK, hdrlen);
+      goto done;
+    }
+#endif
+
   /* Nothing to be done */
 
   dev->d_len = 0;
@@ -486,4 +546,37 @@ done:
   return;
 }
 
+/****************************************************************************
+ * Name: tcp_ackdelay_start
+ *
+ * Description:
+ *   Arm the deadline of a deferred ACK.  When the deadline expires, the
+ *   device bound to the connection is asked to poll for TX data so that
+ *   the deferred ACK is sent, if it has not been sent in the meantime.
+ *
+ * Input Parameters:
+ *   conn - The TCP "connection" with the deferred ACK
+ *
+ * Returned Value:
+ *   OK if the deadline was armed.  A negated errno value is returned on
+ *   any failure; the caller must then send the ACK immediately.
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+int tcp_ackdelay_start(FAR struct tcp_conn_s *conn)
+{
+  if (conn->dev == NULL)
+    {
+      return -ENOTCONN;
+    }
+
+  return work_queue(LPWORK, &conn->ackwork, tcp_ackdelay_work, conn,
+                    MSEC2TICK(CONFIG_NET_TCP_ACKDELAY));
+}
+#endif
+
 #endif /* CONFIG_NET && CONFIG_NET_TCP */
@@ -42,6 +42,8 @@
 #include <mqueue.h>
 #include <nuttx/mqueue.h>
 
+#include "mqueue/mqueue.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -75,7 +77,14 @@ int mq_getattr(mqd_t mqdes, struct mq_attr *mq_stat)
       mq_stat->mq_maxmsg  = mqdes->msgq->maxmsgs;
       mq_stat->mq_msgsize = mqdes->msgq->maxmsgsize;
       mq_stat->mq_flags   = mqdes->oflags;
-      mq_stat->mq_curmsgs = mqdes->msgq->nmsgs;
+      mq_stat->mq_curmsgs = MQ_NMSGS(mqdes->msgq);
+
+#ifdef CONFIG_MQ_SPSC
+      if (MQ_ISSPSC(mqdes->msgq))
+        {
+          mq_stat->mq_flags |= MQ_SPSC;
+        }
+#endif
 
       ret = OK;
     }
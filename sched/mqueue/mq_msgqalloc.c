@@ -64,7 +64,9 @@
  *   mode   - mode_t value is ignored
  *   attr   - The mq_maxmsg attribute is used at the time that the message
  *            queue is created to determine the maximum number of
- *            messages that may be placed in the message queue.
+ *            messages that may be placed in the message queue.  With
+ *            CONFIG_MQ_SPSC, the MQ_SPSC flag in mq_flags selects a lock-free
+ *            single producer, single consumer queue.
  *
  * Returned Value:
  *   The allocated and initialized message queue structure or NULL in the
@@ -111,6 +113,24 @@ FAR struct mqueue_inode_s *nxmq_alloc_msgq(mode_t mode,
 #ifndef CONFIG_DISABLE_SIGNALS
       msgq->ntpid = INVALID_PROCESS_ID;
 #endif
+
+#ifdef CONFIG_MQ_SPSC
+      /* A single producer, single consumer queue owns a ring of messages
+       * with one slot more than it can hold.
+       */
+
+      if (attr && (attr->mq_flags & MQ_SPSC) != 0)
+        {
+          msgq->ring = (FAR struct mqueue_msg_s *)
+            kmm_malloc(sizeof(struct mqueue_msg_s) * (msgq->maxmsgs + 1));
+
+          if (msgq->ring == NULL)
+            {
+              sched_kfree(msgq);
+              return NULL;
+            }
+        }
+#endif
     }
 
   return msgq;
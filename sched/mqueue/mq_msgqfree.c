@@ -82,6 +82,17 @@ void nxmq_free_msgq(FAR struct mqueue_inode_s *msgq)
       curr = next;
     }
 
+#ifdef CONFIG_MQ_SPSC
+  /* Messages still in the ring of a single producer, single consumer queue
+   * are freed with it.
+   */
+
+  if (msgq->ring != NULL)
+    {
+      sched_kfree(msgq->ring);
+    }
+#endif
+
   /* Then deallocate the message queue itself */
 
   sched_kfree(msgq);
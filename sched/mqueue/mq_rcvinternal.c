@@ -56,6 +56,67 @@
 #include "sched/sched.h"
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_receive_notify
+ *
+ * Description:
+ *   A message has been removed from the message queue.  Awaken the highest
+ *   priority task that is waiting for the message queue to become not
+ *   full.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void nxmq_receive_notify(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+
+  /* Check if any tasks are waiting for the MQ not full event. */
+
+  if (msgq->nwaitnotfull > 0)
+    {
+      /* Find the highest priority task that is waiting for
+       * this queue to be not-full in g_waitingformqnotfull list.
+       * This must be performed in a critical section because
+       * messages can be sent from interrupt handlers.
+       */
+
+      flags = enter_critical_section();
+
+      /* Check again:  The wait might have timed out meanwhile */
+
+      if (msgq->nwaitnotfull > 0)
+        {
+          for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
+               btcb && btcb->msgwaitq != msgq;
+               btcb = btcb->flink);
+
+          /* If one was found, unblock it.  NOTE:  There is a race
+           * condition here:  the queue might be full again by the
+           * time the task is unblocked
+           */
+
+          DEBUGASSERT(btcb != NULL);
+
+          btcb->msgwaitq = NULL;
+          msgq->nwaitnotfull--;
+          up_unblock_task(btcb);
+        }
+
+      leave_critical_section(flags);
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -122,7 +183,9 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen)
  *
  * Returned Value:
  *   One success, zero (OK) is returned.  A negated errno value is returned
- *   on any failure.
+ *   on any failure.  For a single producer, single consumer queue, NULL is
+ *   returned in 'rcvmsg'; the message is left in the ring for
+ *   nxmq_do_receive().
  *
  * Assumptions:
  * - The caller has provided all validity checking of the input parameters
@@ -137,7 +200,7 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 {
   FAR struct tcb_s *rtcb;
   FAR struct mqueue_inode_s *msgq;
-  FAR struct mqueue_msg_s *newmsg;
+  FAR struct mqueue_msg_s *newmsg = NULL;
   int ret;
 
   DEBUGASSERT(rcvmsg != NULL);
@@ -162,10 +225,31 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 
   msgq = mqdes->msgq;
 
-  /* Get the message from the head of the queue */
+  /* Get the message from the head of the queue.  The message of a single
+   * producer, single consumer queue stays in its ring:  Just wait until
+   * there is one.
+   */
 
-  while ((newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist)) == NULL)
+  for (; ; )
     {
+#ifdef CONFIG_MQ_SPSC
+      if (MQ_ISSPSC(msgq))
+        {
+          if (!MQ_SPSC_EMPTY(msgq))
+            {
+              break;
+            }
+        }
+      else
+#endif
+        {
+          newmsg = (FAR struct mqueue_msg_s *)sq_remfirst(&msgq->msglist);
+          if (newmsg != NULL)
+            {
+              break;
+            }
+        }
+
       /* The queue is empty!  Should we block until there the above condition
        * has been satisfied?
        */
@@ -180,6 +264,24 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
           rtcb->msgwaitq = msgq;
           msgq->nwaitnotempty++;
 
+#ifdef CONFIG_MQ_SPSC
+          /* The sender of a single producer, single consumer queue does not
+           * enter the critical section unless it sees a waiter.  Check
+           * again now that it will see this one.
+           */
+
+          if (MQ_ISSPSC(msgq))
+            {
+              MQ_SPSC_BARRIER();
+              if (!MQ_SPSC_EMPTY(msgq))
+                {
+                  rtcb->msgwaitq = NULL;
+                  msgq->nwaitnotempty--;
+                  continue;
+                }
+            }
+#endif
+
           /* "Borrow" the per-task errno to communication wake-up error
            * conditions.
            */
@@ -220,6 +322,17 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
   if (newmsg)
     {
       msgq->nmsgs--;
+
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+      /* If that was the only message of its priority, the bucket is now
+       * empty.
+       */
+
+      if (msgq->prtail[newmsg->priority] == newmsg)
+        {
+          msgq->prtail[newmsg->priority] = NULL;
+        }
+#endif
     }
 
   *rcvmsg = newmsg;
@@ -257,11 +370,20 @@ int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg)
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, int *prio)
 {
-  FAR struct tcb_s *btcb;
-  irqstate_t flags;
-  FAR struct mqueue_inode_s *msgq;
   ssize_t rcvmsglen;
 
+#ifdef CONFIG_MQ_SPSC
+  /* The message of a single producer, single consumer queue is still in
+   * its ring.
+   */
+
+  if (mqmsg == NULL)
+    {
+      DEBUGASSERT(MQ_ISSPSC(mqdes->msgq));
+      return nxmq_spsc_receive(mqdes, ubuffer, prio);
+    }
+#endif
+
   /* Get the length of the message (also the return value) */
 
   rcvmsglen = mqmsg->msglen;
@@ -281,37 +403,75 @@ ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   nxmq_free_msg(mqmsg);
 
-  /* Check if any tasks are waiting for the MQ not full event. */
+  /* Wake up a sender that is waiting for the MQ not full event */
 
-  msgq = mqdes->msgq;
-  if (msgq->nwaitnotfull > 0)
-    {
-      /* Find the highest priority task that is waiting for
-       * this queue to be not-full in g_waitingformqnotfull list.
-       * This must be performed in a critical section because
-       * messages can be sent from interrupt handlers.
-       */
+  nxmq_receive_notify(mqdes->msgq);
 
-      flags = enter_critical_section();
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotfull.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink);
+  /* Return the length of the message transferred to the user buffer */
 
-      /* If one was found, unblock it.  NOTE:  There is a race
-       * condition here:  the queue might be full again by the
-       * time the task is unblocked
-       */
+  return rcvmsglen;
+}
 
-      DEBUGASSERT(btcb != NULL);
+/****************************************************************************
+ * Name: nxmq_spsc_receive
+ *
+ * Description:
+ *   Remove the oldest message from a single producer, single consumer queue
+ *   without disabling interrupts or pre-emption.  The message is copied out
+ *   of its slot in the ring and the slot is then released by advancing the
+ *   read index.  Only if a sender is waiting for room is the normal wake-up
+ *   logic run.
+ *
+ * Input Parameters:
+ *   mqdes   - Message queue descriptor
+ *   ubuffer - The address of the user provided buffer to receive the message
+ *   prio    - The user-provided location to return the message priority.
+ *
+ * Returned Value:
+ *   The length of the received message on success; -EAGAIN if the ring is
+ *   empty.
+ *
+ * Assumptions:
+ *   The caller has verified the input parameters using
+ *   nxmq_verify_receive() and is the only receiver on the message queue.
+ *
+ ****************************************************************************/
 
-      btcb->msgwaitq = NULL;
-      msgq->nwaitnotfull--;
-      up_unblock_task(btcb);
+#ifdef CONFIG_MQ_SPSC
+ssize_t nxmq_spsc_receive(mqd_t mqdes, FAR char *ubuffer, FAR int *prio)
+{
+  FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  uint16_t rdndx = msgq->rdndx;
+  ssize_t rcvmsglen;
 
-      leave_critical_section(flags);
+  if (rdndx == msgq->wrndx)
+    {
+      return -EAGAIN;
     }
 
-  /* Return the length of the message transferred to the user buffer */
+  /* Do not read the slot before the sender has filled it */
+
+  MQ_SPSC_BARRIER();
+
+  mqmsg     = &msgq->ring[rdndx];
+  rcvmsglen = mqmsg->msglen;
+  memcpy(ubuffer, (FAR const void *)mqmsg->mail, rcvmsglen);
+
+  if (prio)
+    {
+      *prio = mqmsg->priority;
+    }
+
+  /* Release the slot, then check for waiters.  A sender that is about to
+   * wait checks the ring again after it is counted as a waiter.
+   */
+
+  MQ_SPSC_BARRIER();
+  msgq->rdndx = MQ_SPSC_NEXT(msgq, rdndx);
+  MQ_SPSC_BARRIER();
 
+  nxmq_receive_notify(msgq);
   return rcvmsglen;
 }
+#endif /* CONFIG_MQ_SPSC */
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 #include <stdbool.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <mqueue.h>
 #include <debug.h>
 
@@ -103,6 +104,21 @@ ssize_t nxmq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
       return ret;
     }
 
+#ifdef CONFIG_MQ_SPSC
+  /* A message is taken from a single producer, single consumer queue
+   * without any locking.
+   */
+
+  if (MQ_ISSPSC(mqdes->msgq))
+    {
+      ret = nxmq_spsc_receive(mqdes, msg, prio);
+      if (ret != -EAGAIN || (mqdes->oflags & O_NONBLOCK) != 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Get the next message from the message queue.  We will disable
    * pre-emption until we have completed the message received.  This
    * is not too bad because if the receipt takes a long time, it will
@@ -132,7 +148,7 @@ ssize_t nxmq_receive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
   if (ret >= 0)
     {
-      DEBUGASSERT(mqmsg != NULL);
+      DEBUGASSERT(mqmsg != NULL || MQ_ISSPSC(mqdes->msgq));
       ret = nxmq_do_receive(mqdes, mqmsg, msg, prio);
     }
 
@@ -40,6 +40,7 @@
 #include  <nuttx/config.h>
 
 #include  <sys/types.h>
+#include  <fcntl.h>
 #include  <mqueue.h>
 #include  <errno.h>
 #include  <debug.h>
@@ -99,6 +100,22 @@ int nxmq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
       return ret;
     }
 
+#ifdef CONFIG_MQ_SPSC
+  /* A single producer, single consumer queue that is not full takes the
+   * message without any locking.
+   */
+
+  if (MQ_ISSPSC(mqdes->msgq))
+    {
+      ret = nxmq_spsc_send(mqdes, msg, msglen, prio);
+      if (ret != -EAGAIN || up_interrupt_context() ||
+          (mqdes->oflags & O_NONBLOCK) != 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   /* Get a pointer to the message queue */
 
   sched_lock();
@@ -119,7 +136,7 @@ int nxmq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
     {
       /* No.. Not in an interrupt handler.  Is the message queue FULL? */
 
-      if (msgq->nmsgs >= msgq->maxmsgs) /* Message queue not-FULL? */
+      if (MQ_ISFULL(msgq))              /* Message queue not-FULL? */
         {
          /* Yes.. the message queue is full.  Wait for space to become
           * available in the message queue.
@@ -132,9 +149,11 @@ int nxmq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
   /* ret can only be negative if nxmq_wait_send failed */
 
   leave_critical_section(flags);
-  if (ret >= 0)
+  if (ret >= 0 && !MQ_ISSPSC(msgq))
     {
-      /* Now allocate the message. */
+      /* Now allocate the message.  A single producer, single consumer
+       * queue needs none; the message is copied into its ring.
+       */
 
       mqmsg = nxmq_alloc_msg();
 
@@ -148,7 +167,7 @@ int nxmq_send(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio)
    * to allocate it) or because the allocation failed.
    */
 
-  if (mqmsg != NULL)
+  if (ret >= 0)
     {
       /* The allocation was successful (implying that we can also send the
        * message). Perform the message send.
@@ -61,6 +61,114 @@
 #endif
 #include "mqueue/mqueue.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxmq_send_notify
+ *
+ * Description:
+ *   A message has been added to the message queue.  Notify any task that
+ *   is attached to the message queue by mq_notify() and awaken the highest
+ *   priority task that is waiting for the message queue to become not
+ *   empty.
+ *
+ * Input Parameters:
+ *   msgq - The message queue
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Pre-emption is disabled.
+ *
+ ****************************************************************************/
+
+static void nxmq_send_notify(FAR struct mqueue_inode_s *msgq)
+{
+  FAR struct tcb_s *btcb;
+  irqstate_t flags;
+
+  /* Check if we need to notify any tasks that are attached to the
+   * message queue
+   */
+
+#ifndef CONFIG_DISABLE_SIGNALS
+  if (msgq->ntmqdes)
+    {
+      struct sigevent event;
+      pid_t pid;
+
+      /* Remove the message notification data from the message queue. */
+
+      memcpy(&event, &msgq->ntevent, sizeof(struct sigevent));
+      pid = msgq->ntpid;
+
+      /* Detach the notification */
+
+      memset(&msgq->ntevent, 0, sizeof(struct sigevent));
+      msgq->ntpid   = INVALID_PROCESS_ID;
+      msgq->ntmqdes = NULL;
+
+      /* Notification the client via signal? */
+
+      if (event.sigev_notify == SIGEV_SIGNAL)
+        {
+          /* Yes... Queue the signal -- What if this returns an error? */
+
+#ifdef CONFIG_CAN_PASS_STRUCTS
+          DEBUGVERIFY(nxsig_mqnotempty(pid, event.sigev_signo,
+                                       event.sigev_value));
+#else
+          DEBUGVERIFY(nxsig_mqnotempty(pid, event.sigev_signo,
+                                       event.sigev_value.sival_ptr));
+#endif
+        }
+
+#ifdef CONFIG_SIG_EVTHREAD
+      /* Notify the client via a function call */
+
+      else if (event.sigev_notify == SIGEV_THREAD)
+        {
+          DEBUGVERIFY(nxsig_evthread(pid, &event));
+        }
+#endif
+
+    }
+#endif
+
+  /* Check if any tasks are waiting for the MQ not empty event.  This must
+   * follow the notification:  The awakened task may run at once (on SMP,
+   * sched_lock() does not keep it off the other CPUs) and register a new
+   * notification, which must not be detached above.
+   */
+
+  flags = enter_critical_section();
+  if (msgq->nwaitnotempty > 0)
+    {
+      /* Find the highest priority task that is waiting for
+       * this queue to be non-empty in g_waitingformqnotempty
+       * list. sched_lock() should give us sufficent protection since
+       * interrupts should never cause a change in this list
+       */
+
+      for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head;
+           btcb && btcb->msgwaitq != msgq;
+           btcb = btcb->flink);
+
+      /* If one was found, unblock it */
+
+      DEBUGASSERT(btcb);
+
+      btcb->msgwaitq = NULL;
+      msgq->nwaitnotempty--;
+      up_unblock_task(btcb);
+    }
+
+  leave_critical_section(flags);
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -252,7 +360,7 @@ int nxmq_wait_send(mqd_t mqdes)
 
   /* Verify that the queue is indeed full as the caller thinks */
 
-  if (msgq->nmsgs >= msgq->maxmsgs)
+  if (MQ_ISFULL(msgq))
     {
       /* Should we block until there is sufficient space in the
        * message queue?
@@ -275,7 +383,7 @@ int nxmq_wait_send(mqd_t mqdes)
            * receiving message queue
            */
 
-          while (msgq->nmsgs >= msgq->maxmsgs)
+          while (MQ_ISFULL(msgq))
             {
               int saved_errno;
 
@@ -287,6 +395,24 @@ int nxmq_wait_send(mqd_t mqdes)
               rtcb->msgwaitq = msgq;
               msgq->nwaitnotfull++;
 
+#ifdef CONFIG_MQ_SPSC
+              /* The receiver of a single producer, single consumer queue
+               * does not enter the critical section unless it sees a
+               * waiter.  Check again now that it will see this one.
+               */
+
+              if (MQ_ISSPSC(msgq))
+                {
+                  MQ_SPSC_BARRIER();
+                  if (!MQ_SPSC_FULL(msgq))
+                    {
+                      rtcb->msgwaitq = NULL;
+                      msgq->nwaitnotfull--;
+                      continue;
+                    }
+                }
+#endif
+
               /* "Borrow" the per-task errno to communication wake-up error
                * conditions.
                */
@@ -328,6 +454,8 @@ int nxmq_wait_send(mqd_t mqdes)
  *
  * Input Parameters:
  *   mqdes  - Message queue descriptor
+ *   mqmsg  - The allocated message (NULL for a single producer, single
+ *            consumer queue)
  *   msg    - Message to send
  *   msglen - The length of the message in bytes
  *   prio   - The priority of the message
@@ -340,11 +468,25 @@ int nxmq_wait_send(mqd_t mqdes)
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, int prio)
 {
-  FAR struct tcb_s *btcb;
   FAR struct mqueue_inode_s *msgq;
   FAR struct mqueue_msg_s *next;
   FAR struct mqueue_msg_s *prev;
   irqstate_t flags;
+#ifdef CONFIG_MQ_PRIO_BUCKETS
+  int i;
+#endif
+
+#ifdef CONFIG_MQ_SPSC
+  /* The message is copied straight into the ring of a single producer,
+   * single consumer queue.  The caller has waited for room in the ring.
+   */
+
+  if (mqmsg == NULL)
+    {
+      DEBUGASSERT(MQ_ISSPSC(mqdes->msgq));
+      return nxmq_spsc_send(mqdes, msg, msglen, prio);
+    }
+#endif
 
   /* Get a pointer to the message queue */
 
@@ -364,104 +506,158 @@ int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
 
   flags = enter_critical_section();
 
-  /* Search the message list to find the location to insert the new
-   * message. Each is list is maintained in ascending priority order.
+  /* The message list is maintained in descending priority order with
+   * messages of equal priority in FIFO order.  Most queues carry messages
+   * of a single priority so check first if the new message simply goes at
+   * the end of the list.  That is an O(1) insertion.
    */
 
-  for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
-       next && prio <= next->priority;
-       prev = next, next = next->next);
-
-  /* Add the message at the right place */
-
-  if (prev)
+  prev = (FAR struct mqueue_msg_s *)msgq->msglist.tail;
+  if (prev == NULL || prio <= prev->priority)
     {
-      sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
-                  &msgq->msglist);
+      sq_addlast((FAR sq_entry_t *)mqmsg, &msgq->msglist);
     }
+#ifdef CONFIG_MQ_PRIO_BUCKETS
   else
     {
-      sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
-    }
+      /* The new message goes after the last message of the lowest priority
+       * that is not lower than its own.  The head of the list has the
+       * highest priority, so the search of the buckets is bounded by it
+       * and does not depend on the number of queued messages.
+       */
 
-  /* Increment the count of messages in the queue */
+      next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+      prev = NULL;
 
-  msgq->nmsgs++;
-  leave_critical_section(flags);
+      if (prio <= next->priority)
+        {
+          for (i = prio; i <= next->priority; i++)
+            {
+              if (msgq->prtail[i] != NULL)
+                {
+                  prev = msgq->prtail[i];
+                  break;
+                }
+            }
 
-  /* Check if we need to notify any tasks that are attached to the
-   * message queue
-   */
+          DEBUGASSERT(prev != NULL);
+        }
 
-#ifndef CONFIG_DISABLE_SIGNALS
-  if (msgq->ntmqdes)
+      if (prev)
+        {
+          sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                      &msgq->msglist);
+        }
+      else
+        {
+          sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+        }
+    }
+
+  msgq->prtail[prio] = mqmsg;
+#else
+  else
     {
-      struct sigevent event;
-      pid_t pid;
+      /* Search the message list to find the location to insert the new
+       * message.
+       */
 
-      /* Remove the message notification data from the message queue. */
+      for (prev = NULL, next = (FAR struct mqueue_msg_s *)msgq->msglist.head;
+           next && prio <= next->priority;
+           prev = next, next = next->next);
 
-      memcpy(&event, &msgq->ntevent, sizeof(struct sigevent));
-      pid = msgq->ntpid;
+      /* Add the message at the right place */
 
-      /* Detach the notification */
+      if (prev)
+        {
+          sq_addafter((FAR sq_entry_t *)prev, (FAR sq_entry_t *)mqmsg,
+                      &msgq->msglist);
+        }
+      else
+        {
+          sq_addfirst((FAR sq_entry_t *)mqmsg, &msgq->msglist);
+        }
+    }
+#endif
 
-      memset(&msgq->ntevent, 0, sizeof(struct sigevent));
-      msgq->ntpid   = INVALID_PROCESS_ID;
-      msgq->ntmqdes = NULL;
+  /* Increment the count of messages in the queue */
 
-      /* Notification the client via signal? */
+  msgq->nmsgs++;
+  leave_critical_section(flags);
 
-      if (event.sigev_notify == SIGEV_SIGNAL)
-        {
-          /* Yes... Queue the signal -- What if this returns an error? */
+  /* Notify and wake up the receivers */
 
-#ifdef CONFIG_CAN_PASS_STRUCTS
-          DEBUGVERIFY(nxsig_mqnotempty(pid, event.sigev_signo,
-                                       event.sigev_value));
-#else
-          DEBUGVERIFY(nxsig_mqnotempty(pid, event.sigev_signo,
-                                       event.sigev_value.sival_ptr));
-#endif
-        }
+  nxmq_send_notify(msgq);
+  sched_unlock();
+  return OK;
+}
 
-#ifdef CONFIG_SIG_EVTHREAD
-      /* Notify the client via a function call */
+/****************************************************************************
+ * Name: nxmq_spsc_send
+ *
+ * Description:
+ *   Add a message to a single producer, single consumer queue without
+ *   disabling interrupts or pre-emption.  The message is copied into the
+ *   next free slot of the ring and then published by advancing the write
+ *   index.  Only if a receiver is waiting or a notification is attached
+ *   is the normal notification logic run.
+ *
+ * Input Parameters:
+ *   mqdes  - Message queue descriptor
+ *   msg    - Message to send
+ *   msglen - The length of the message in bytes
+ *   prio   - The priority of the message
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -EAGAIN if the ring is full.
+ *
+ * Assumptions:
+ *   The caller has verified the input parameters using nxmq_verify_send()
+ *   and is the only sender on the message queue.
+ *
+ ****************************************************************************/
 
-      else if (event.sigev_notify == SIGEV_THREAD)
-        {
-          DEBUGVERIFY(nxsig_evthread(pid, &event));
-        }
-#endif
+#ifdef CONFIG_MQ_SPSC
+int nxmq_spsc_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
+                   int prio)
+{
+  FAR struct mqueue_inode_s *msgq = mqdes->msgq;
+  FAR struct mqueue_msg_s *mqmsg;
+  uint16_t wrndx = msgq->wrndx;
 
+  if (MQ_SPSC_NEXT(msgq, wrndx) == msgq->rdndx)
+    {
+      return -EAGAIN;
     }
-#endif
 
-  /* Check if any tasks are waiting for the MQ not empty event. */
+  /* Do not touch the slot before the receiver has released it */
 
-  flags = enter_critical_section();
-  if (msgq->nwaitnotempty > 0)
-    {
-      /* Find the highest priority task that is waiting for
-       * this queue to be non-empty in g_waitingformqnotempty
-       * list. sched_lock() should give us sufficent protection since
-       * interrupts should never cause a change in this list
-       */
+  MQ_SPSC_BARRIER();
 
-      for (btcb = (FAR struct tcb_s *)g_waitingformqnotempty.head;
-           btcb && btcb->msgwaitq != msgq;
-           btcb = btcb->flink);
+  mqmsg           = &msgq->ring[wrndx];
+  mqmsg->priority = prio;
+  mqmsg->msglen   = msglen;
+  memcpy((FAR void *)mqmsg->mail, (FAR const void *)msg, msglen);
 
-      /* If one was found, unblock it */
+  /* Publish the message, then check for waiters.  A receiver that is about
+   * to wait checks the ring again after it is counted as a waiter.
+   */
 
-      DEBUGASSERT(btcb);
+  MQ_SPSC_BARRIER();
+  msgq->wrndx = MQ_SPSC_NEXT(msgq, wrndx);
+  MQ_SPSC_BARRIER();
 
-      btcb->msgwaitq = NULL;
-      msgq->nwaitnotempty--;
-      up_unblock_task(btcb);
+#ifndef CONFIG_DISABLE_SIGNALS
+  if (msgq->nwaitnotempty > 0 || msgq->ntmqdes != NULL)
+#else
+  if (msgq->nwaitnotempty > 0)
+#endif
+    {
+      sched_lock();
+      nxmq_send_notify(msgq);
+      sched_unlock();
     }
 
-  leave_critical_section(flags);
-  sched_unlock();
   return OK;
 }
+#endif /* CONFIG_MQ_SPSC */
@@ -44,6 +44,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
 #include <mqueue.h>
 #include <debug.h>
@@ -170,6 +171,21 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
       return ret;
     }
 
+#ifdef CONFIG_MQ_SPSC
+  /* A message is taken from a single producer, single consumer queue
+   * without any locking.  The time is not checked if there is one.
+   */
+
+  if (MQ_ISSPSC(mqdes->msgq))
+    {
+      ret = nxmq_spsc_receive(mqdes, msg, prio);
+      if (ret != -EAGAIN || (mqdes->oflags & O_NONBLOCK) != 0)
+        {
+          return ret;
+        }
+    }
+#endif
+
   if (!abstime || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000)
     {
       return -EINVAL;
@@ -205,7 +221,7 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
    * will not need to start timer.
    */
 
-  if (mqdes->msgq->msglist.head == NULL)
+  if (MQ_ISEMPTY(mqdes->msgq))
     {
       sclock_t ticks;
 
@@ -267,7 +283,7 @@ ssize_t nxmq_timedreceive(mqd_t mqdes, FAR char *msg, size_t msglen,
 
   if (ret >= 0)
     {
-      DEBUGASSERT(mqmsg != NULL);
+      DEBUGASSERT(mqmsg != NULL || MQ_ISSPSC(mqdes->msgq));
       ret = nxmq_do_receive(mqdes, mqmsg, msg, prio);
     }
 
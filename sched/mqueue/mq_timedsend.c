@@ -43,6 +43,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <mqueue.h>
 #include <errno.h>
 #include <debug.h>
@@ -178,16 +179,33 @@ int nxmq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio,
       return ret;
     }
 
-  /* Pre-allocate a message structure */
+#ifdef CONFIG_MQ_SPSC
+  /* A single producer, single consumer queue that is not full takes the
+   * message without any locking.  It needs no message structure.
+   */
 
-  mqmsg = nxmq_alloc_msg();
-  if (mqmsg == NULL)
+  if (MQ_ISSPSC(mqdes->msgq))
     {
-      /* Failed to allocate the message. nxmq_alloc_msg() does not set the
-       * errno value.
-       */
+      ret = nxmq_spsc_send(mqdes, msg, msglen, prio);
+      if (ret != -EAGAIN || (mqdes->oflags & O_NONBLOCK) != 0)
+        {
+          return ret;
+        }
+    }
+  else
+#endif
+    {
+      /* Pre-allocate a message structure */
 
-      return -ENOMEM;
+      mqmsg = nxmq_alloc_msg();
+      if (mqmsg == NULL)
+        {
+          /* Failed to allocate the message. nxmq_alloc_msg() does not set
+           * the errno value.
+           */
+
+          return -ENOMEM;
+        }
     }
 
   /* Get a pointer to the message queue */
@@ -209,7 +227,7 @@ int nxmq_timedsend(mqd_t mqdes, FAR const char *msg, size_t msglen, int prio,
    * exceeded in that case.
    */
 
-  if (msgq->nmsgs < msgq->maxmsgs || up_interrupt_context())
+  if (!MQ_ISFULL(msgq) || up_interrupt_context())
     {
       /* Do the send with no further checks (possibly exceeding maxmsgs)
        * Currently nxmq_do_send() always returns OK.
@@ -326,7 +344,11 @@ errout_in_critical_section:
    */
 
 errout_with_mqmsg:
-  nxmq_free_msg(mqmsg);
+  if (mqmsg != NULL)
+    {
+      nxmq_free_msg(mqmsg);
+    }
+
   sched_unlock();
   return ret;
 }
@@ -52,6 +52,9 @@
 #include <signal.h>
 
 #include <nuttx/mqueue.h>
+#ifdef CONFIG_MQ_SPSC
+#  include <nuttx/spinlock.h>
+#endif
 
 #if CONFIG_MQ_MAXMSGSIZE > 0
 
@@ -75,6 +78,37 @@
 
 #define NUM_INTERRUPT_MSGS   8
 
+/* A single producer, single consumer (SPSC) queue keeps its messages in a
+ * ring of maxmsgs + 1 slots; rdndx == wrndx means that it is empty.  The
+ * sender only writes wrndx and the receiver only writes rdndx.  The barrier
+ * keeps the message data and the index updates in order.
+ */
+
+#ifdef CONFIG_MQ_SPSC
+#  define MQ_ISSPSC(q)      ((q)->ring != NULL)
+#  define MQ_SPSC_NEXT(q,n) ((n) >= (q)->maxmsgs ? 0 : (n) + 1)
+#  define MQ_SPSC_EMPTY(q)  ((q)->rdndx == (q)->wrndx)
+#  define MQ_SPSC_FULL(q)   (MQ_SPSC_NEXT(q, (q)->wrndx) == (q)->rdndx)
+#  define MQ_ISEMPTY(q)     (MQ_ISSPSC(q) ? MQ_SPSC_EMPTY(q) : \
+                             (q)->msglist.head == NULL)
+#  define MQ_ISFULL(q)      (MQ_ISSPSC(q) ? MQ_SPSC_FULL(q) : \
+                             (q)->nmsgs >= (q)->maxmsgs)
+#  define MQ_NMSGS(q)       (MQ_ISSPSC(q) ? \
+                             ((q)->wrndx + (q)->maxmsgs + 1 - (q)->rdndx) % \
+                             ((q)->maxmsgs + 1) : (q)->nmsgs)
+#  ifdef CONFIG_SPINLOCK
+#    define MQ_SPSC_BARRIER() \
+       do { SP_DMB(); __asm__ __volatile__("" : : : "memory"); } while (0)
+#  else
+#    define MQ_SPSC_BARRIER() __asm__ __volatile__("" : : : "memory")
+#  endif
+#else
+#  define MQ_ISSPSC(q)      false
+#  define MQ_ISEMPTY(q)     ((q)->msglist.head == NULL)
+#  define MQ_ISFULL(q)      ((q)->nmsgs >= (q)->maxmsgs)
+#  define MQ_NMSGS(q)       ((q)->nmsgs)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -155,6 +189,9 @@ int nxmq_verify_receive(mqd_t mqdes, FAR char *msg, size_t msglen);
 int nxmq_wait_receive(mqd_t mqdes, FAR struct mqueue_msg_s **rcvmsg);
 ssize_t nxmq_do_receive(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                         FAR char *ubuffer, FAR int *prio);
+#ifdef CONFIG_MQ_SPSC
+ssize_t nxmq_spsc_receive(mqd_t mqdes, FAR char *ubuffer, FAR int *prio);
+#endif
 
 /* mq_sndinternal.c ********************************************************/
 
@@ -163,6 +200,10 @@ FAR struct mqueue_msg_s *nxmq_alloc_msg(void);
 int nxmq_wait_send(mqd_t mqdes);
 int nxmq_do_send(mqd_t mqdes, FAR struct mqueue_msg_s *mqmsg,
                  FAR const char *msg, size_t msglen, int prio);
+#ifdef CONFIG_MQ_SPSC
+int nxmq_spsc_send(mqd_t mqdes, FAR const char *msg, size_t msglen,
+                   int prio);
+#endif
 
 /* mq_release.c ************************************************************/
 
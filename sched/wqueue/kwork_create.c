@@ -0,0 +1,238 @@
+/****************************************************************************
+ * sched/wqueue/kwork_create.c
+ *
+ *   Copyright (C) 2018 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <unistd.h>
+#include <sched.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/kthread.h>
+#include <nuttx/kmalloc.h>
+
+#include "wqueue/wqueue.h"
+
+#if defined(CONFIG_SCHED_WORKQUEUE) && CONFIG_SCHED_NWORKQUEUES > 0
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* The state of the work queues created by work_create() */
+
+FAR struct kwork_wqueue_s *g_namedwork[CONFIG_SCHED_NWORKQUEUES];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_thread
+ *
+ * Description:
+ *   These are the worker threads that perform the actions placed on the
+ *   work queues created by work_create().
+ *
+ * Input Parameters:
+ *   argc, argv (not used)
+ *
+ * Returned Value:
+ *   Does not return
+ *
+ ****************************************************************************/
+
+static int work_thread(int argc, char *argv[])
+{
+  FAR struct kwork_wqueue_s *wqueue = NULL;
+  pid_t me = getpid();
+  int wndx = 0;
+  int i;
+
+  /* Find our work queue and thread index by searching the workers of the
+   * created work queues.
+   */
+
+  for (i = 0; i < CONFIG_SCHED_NWORKQUEUES && wqueue == NULL; i++)
+    {
+      if (g_namedwork[i] != NULL)
+        {
+          for (wndx = 0; wndx < g_namedwork[i]->nthreads; wndx++)
+            {
+              if (g_namedwork[i]->worker[wndx].pid == me)
+                {
+                  wqueue = g_namedwork[i];
+                  break;
+                }
+            }
+        }
+    }
+
+  DEBUGASSERT(wqueue != NULL);
+
+  /* Loop forever */
+
+  for (; ; )
+    {
+      /* Process queued work.  work_process will not return until: (1)
+       * there is no further work in the work queue, and (2) signal is
+       * triggered, or delayed work expires.
+       */
+
+      work_process(wqueue, wndx);
+    }
+
+  return OK; /* To keep some compilers happy */
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_create
+ *
+ * Description:
+ *   Create a new kernel work queue with its own worker thread(s).  Work is
+ *   then queued to it with work_queue() using the returned queue ID.
+ *
+ * Input Parameters:
+ *   name      - The name of the worker thread(s)
+ *   priority  - The priority of the worker thread(s)
+ *   stacksize - The stack size of the worker thread(s)
+ *   nthreads  - The number of worker threads servicing the queue
+ *
+ * Returned Value:
+ *   The ID of the new work queue is returned on success.  A negated errno
+ *   value is returned on failure:
+ *
+ *   -EINVAL - An invalid argument was provided
+ *   -ENOMEM - The work queue could not be allocated
+ *   -ENOSPC - CONFIG_SCHED_NWORKQUEUES work queues already exist
+ *
+ ****************************************************************************/
+
+int work_create(FAR const char *name, int priority, int stacksize,
+                int nthreads)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+  pid_t pid;
+  int wndx;
+  int ndx;
+
+  if (name == NULL || nthreads < 1 || nthreads > UINT8_MAX)
+    {
+      return -EINVAL;
+    }
+
+  /* Allocate the work queue with room for all of its workers */
+
+  wqueue = (FAR struct kwork_wqueue_s *)
+    kmm_zalloc(sizeof(struct kwork_wqueue_s) +
+               (nthreads - 1) * sizeof(struct kworker_s));
+  if (wqueue == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  /* Don't permit any of the threads to run until we have fully initialized
+   * the work queue.
+   */
+
+  sched_lock();
+
+  for (ndx = 0; ndx < CONFIG_SCHED_NWORKQUEUES; ndx++)
+    {
+      if (g_namedwork[ndx] == NULL)
+        {
+          break;
+        }
+    }
+
+  if (ndx >= CONFIG_SCHED_NWORKQUEUES)
+    {
+      sched_unlock();
+      kmm_free(wqueue);
+      return -ENOSPC;
+    }
+
+  /* Start the worker thread(s) */
+
+  sinfo("Starting %d %s worker thread(s)\n", nthreads, name);
+
+  for (wndx = 0; wndx < nthreads; wndx++)
+    {
+      pid = kthread_create(name, priority, stacksize, (main_t)work_thread,
+                           (FAR char * const *)NULL);
+      if (pid < 0)
+        {
+          serr("ERROR: kthread_create %d failed: %d\n", wndx, (int)pid);
+
+          /* The threads already started cannot be taken back.  Keep the
+           * work queue with just those.
+           */
+
+          if (wndx == 0)
+            {
+              sched_unlock();
+              kmm_free(wqueue);
+              return (int)pid;
+            }
+
+          break;
+        }
+
+      wqueue->worker[wndx].pid  = pid;
+      wqueue->worker[wndx].busy = true;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      work_bindcpu(pid, wndx);
+#endif
+    }
+
+  wqueue->nthreads = wndx;
+  g_namedwork[ndx] = wqueue;
+
+  sched_unlock();
+  return NAMEDWORK + ndx;
+}
+
+#endif /* CONFIG_SCHED_WORKQUEUE && CONFIG_SCHED_NWORKQUEUES > 0 */
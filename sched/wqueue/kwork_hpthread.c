@@ -210,8 +210,17 @@ int work_hpstart(void)
 
       g_hpwork.worker[wndx].pid  = pid;
       g_hpwork.worker[wndx].busy = true;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      work_bindcpu(pid, wndx);
+#endif
     }
 
+  /* work_signal() only considers the workers counted here.  Counting them
+   * only now keeps it from signalling workers that do not exist yet.
+   */
+
+  g_hpwork.nthreads = CONFIG_SCHED_HPNTHREADS;
+
   sched_unlock();
   return g_hpwork.worker[0].pid;
 }
@@ -206,8 +206,17 @@ int work_lpstart(void)
 
       g_lpwork.worker[wndx].pid  = pid;
       g_lpwork.worker[wndx].busy = true;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      work_bindcpu(pid, wndx);
+#endif
     }
 
+  /* work_signal() only considers the workers counted here.  Counting them
+   * only now keeps it from signalling workers that do not exist yet.
+   */
+
+  g_lpwork.nthreads = CONFIG_SCHED_LPNTHREADS;
+
   sched_unlock();
   return g_lpwork.worker[0].pid;
 }
@@ -42,10 +42,12 @@
 #include <stdint.h>
 #include <unistd.h>
 #include <signal.h>
+#include <sched.h>
 #include <assert.h>
 #include <queue.h>
 
 #include <nuttx/irq.h>
+#include <nuttx/sched.h>
 #include <nuttx/clock.h>
 #include <nuttx/signal.h>
 #include <nuttx/wqueue.h>
@@ -78,6 +80,147 @@
 #  define MIN(a,b) ((a) < (b) ? (a) : (b))
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: work_expire
+ *
+ * Description:
+ *   Visit the timer wheel slots of the ticks that have elapsed since the
+ *   last visit and move the delayed work that has expired to the end of
+ *   the ready queue of worker wndx.  Interrupts must be disabled.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue to be processed
+ *   wndx   - The worker thread index
+ *   ctick  - The current time
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void work_expire(FAR struct kwork_wqueue_s *wqueue, int wndx,
+                        clock_t ctick)
+{
+  FAR struct work_s *work;
+  FAR struct work_s *next;
+  FAR dq_queue_t *slot;
+
+  /* If a whole turn of the wheel has elapsed, all slots must be visited,
+   * but only once.
+   */
+
+  if (ctick - wqueue->wtick > WORK_WHEEL_SIZE)
+    {
+      wqueue->wtick = ctick - WORK_WHEEL_SIZE;
+    }
+
+  while (wqueue->wtick != ctick)
+    {
+      wqueue->wtick++;
+      slot = &wqueue->wheel[WORK_SLOT(wqueue->wtick)];
+
+      /* The slot also holds work that expires on later turns of the
+       * wheel.  That is left in place.
+       */
+
+      for (work = (FAR struct work_s *)slot->head; work != NULL; work = next)
+        {
+          next = (FAR struct work_s *)work->dq.flink;
+          if (ctick - work->qtime >= work->delay)
+            {
+              /* qtime becomes the time at which the work was ready */
+
+              dq_rem((FAR dq_entry_t *)work, slot);
+              work->qtime += work->delay;
+              work->delay  = 0;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+              work->wndx   = wndx;
+#endif
+              dq_addlast((FAR dq_entry_t *)work,
+                         WORK_READYQ(wqueue, wndx));
+            }
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: work_nextexpiry
+ *
+ * Description:
+ *   Return the number of ticks until the next timer wheel slot that holds
+ *   delayed work.  If the work in that slot expires on a later turn of the
+ *   wheel, the worker thread will simply wake up, find nothing expired,
+ *   and wait again.  Interrupts must be disabled.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue to be processed
+ *   ctick  - The current time
+ *
+ * Returned Value:
+ *   The number of ticks to wait or WORK_DELAY_MAX if there is no delayed
+ *   work.
+ *
+ ****************************************************************************/
+
+static clock_t work_nextexpiry(FAR struct kwork_wqueue_s *wqueue,
+                               clock_t ctick)
+{
+  clock_t i;
+
+  for (i = 1; i <= WORK_WHEEL_SIZE; i++)
+    {
+      if (wqueue->wheel[WORK_SLOT(ctick + i)].head != NULL)
+        {
+          return i;
+        }
+    }
+
+  return WORK_DELAY_MAX;
+}
+
+/****************************************************************************
+ * Name: work_next
+ *
+ * Description:
+ *   Remove the next work to be performed by worker wndx from the head of
+ *   its ready queue.  With per-CPU queues, a worker whose own queue is
+ *   empty takes the oldest work of another worker.  Interrupts must be
+ *   disabled.
+ *
+ * Input Parameters:
+ *   wqueue - Describes the work queue to be processed
+ *   wndx   - The worker thread index
+ *
+ * Returned Value:
+ *   The work to be performed or NULL if there is none.
+ *
+ ****************************************************************************/
+
+static FAR struct work_s *work_next(FAR struct kwork_wqueue_s *wqueue,
+                                    int wndx)
+{
+  FAR struct work_s *work;
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  int i;
+#endif
+
+  work = (FAR struct work_s *)dq_remfirst(WORK_READYQ(wqueue, wndx));
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  for (i = 1; work == NULL && i < wqueue->nthreads; i++)
+    {
+      work = (FAR struct work_s *)
+        dq_remfirst(WORK_READYQ(wqueue, (wndx + i) % wqueue->nthreads));
+    }
+#endif
+
+  return work;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -105,9 +248,9 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
   worker_t  worker;
   irqstate_t flags;
   FAR void *arg;
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
   clock_t elapsed;
-  clock_t remaining;
-  clock_t stick;
+#endif
   clock_t ctick;
   clock_t next;
 
@@ -115,109 +258,76 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
    * we process items in the work list.
    */
 
-  next  = WORK_DELAY_MAX;
   flags = enter_critical_section();
 
-  /* Get the time that we started processing the queue in clock ticks. */
-
-  stick = clock_systimer();
-
-  /* And check each entry in the work queue.  Since we have disabled
-   * interrupts we know:  (1) we will not be suspended unless we do
-   * so ourselves, and (2) there will be no changes to the work queue
+  /* Since we have disabled interrupts we know:  (1) we will not be
+   * suspended unless we do so ourselves, and (2) there will be no changes
+   * to the work queues.
    */
 
-  work = (FAR struct work_s *)wqueue->q.head;
-  while (work)
+  for (; ; )
     {
-      /* Is this work ready?  It is ready if there is no delay or if
-       * the delay has elapsed. qtime is the time that the work was added
-       * to the work queue.  It will always be greater than or equal to
-       * zero.  Therefore a delay of zero will always execute immediately.
+      /* Move delayed work whose delay has elapsed to the end of the ready
+       * queue.  Only the timer wheel slots of the ticks that have elapsed
+       * since the last check need to be visited.
        */
 
-      ctick   = clock_systimer();
-      elapsed = ctick - work->qtime;
-      if (elapsed >= work->delay)
-        {
-          /* Remove the ready-to-execute work from the list */
-
-          (void)dq_rem((struct dq_entry_s *)work, &wqueue->q);
-
-          /* Extract the work description from the entry (in case the work
-           * instance by the re-used after it has been de-queued).
-           */
+      ctick = clock_systimer();
+      work_expire(wqueue, wndx, ctick);
 
-          worker = work->worker;
+      /* Remove the ready-to-execute work from the head of the ready queue */
 
-          /* Check for a race condition where the work may be nullified
-           * before it is removed from the queue.
-           */
-
-          if (worker != NULL)
-            {
-              /* Extract the work argument (before re-enabling interrupts) */
+      work = work_next(wqueue, wndx);
+      if (work == NULL)
+        {
+          next = work_nextexpiry(wqueue, ctick);
+          break;
+        }
 
-              arg = work->arg;
+      /* Extract the work description from the entry (in case the work
+       * instance by the re-used after it has been de-queued).
+       */
 
-              /* Mark the work as no longer being queued */
+      worker = work->worker;
 
-              work->worker = NULL;
+      /* Check for a race condition where the work may be nullified
+       * before it is removed from the queue.
+       */
 
-              /* Do the work.  Re-enable interrupts while the work is being
-               * performed... we don't have any idea how long this will take!
-               */
+      if (worker != NULL)
+        {
+          /* Extract the work argument (before re-enabling interrupts) */
 
-              leave_critical_section(flags);
-              worker(arg);
+          arg = work->arg;
 
-              /* Now, unfortunately, since we re-enabled interrupts we don't
-               * know the state of the work list and we will have to start
-               * back at the head of the list.
-               */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+          /* qtime is the time at which the work became ready */
 
-              flags = enter_critical_section();
-              work  = (FAR struct work_s *)wqueue->q.head;
-            }
-          else
+          elapsed = ctick - work->qtime;
+          wqueue->stats.nwork++;
+          wqueue->stats.totlat += elapsed;
+          if (elapsed > wqueue->stats.maxlat)
             {
-              /* Cancelled.. Just move to the next work in the list with
-               * interrupts still disabled.
-               */
-
-              work = (FAR struct work_s *)work->dq.flink;
+              wqueue->stats.maxlat = elapsed;
             }
-        }
-      else /* elapsed < work->delay */
-        {
-          /* This one is not ready.
-           *
-           * NOTE that elapsed is relative to the current time,
-           * not the time of beginning of this queue processing pass.
-           * So it may need an adjustment.
-           */
-
-          elapsed += (ctick - stick);
-          if (elapsed > work->delay)
-            {
-              /* The delay has expired while we are processing */
+#endif
 
-              elapsed = work->delay;
-            }
+          /* Mark the work as no longer being queued */
 
-          /* Will it be ready before the next scheduled wakeup interval? */
+          work->worker = NULL;
 
-          remaining = work->delay - elapsed;
-          if (remaining < next)
-            {
-              /* Yes.. Then schedule to wake up when the work is ready */
+          /* Do the work.  Re-enable interrupts while the work is being
+           * performed... we don't have any idea how long this will take!
+           */
 
-              next = remaining;
-            }
+          leave_critical_section(flags);
+          worker(arg);
 
-          /* Then try the next in the list. */
+          /* Now, since we re-enabled interrupts, check the delayed work
+           * again before taking the next work from the ready queue.
+           */
 
-          work = (FAR struct work_s *)work->dq.flink;
+          flags = enter_critical_section();
         }
     }
 
@@ -258,4 +368,30 @@ void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx)
   leave_critical_section(flags);
 }
 
+/****************************************************************************
+ * Name: work_bindcpu
+ *
+ * Description:
+ *   Bind worker thread wndx to the CPU whose ready queue it services.
+ *
+ * Input Parameters:
+ *   pid    - The task ID of the worker thread
+ *   wndx   - The worker thread index
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+void work_bindcpu(pid_t pid, int wndx)
+{
+  cpu_set_t cpuset;
+
+  CPU_ZERO(&cpuset);
+  CPU_SET(wndx % CONFIG_SMP_NCPUS, &cpuset);
+  DEBUGVERIFY(nxsched_setaffinity(pid, sizeof(cpu_set_t), &cpuset));
+}
+#endif
+
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -108,7 +108,7 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
        * end of the work queue.
        */
 
-      dq_rem((FAR dq_entry_t *)work, &wqueue->q);
+      dq_rem((FAR dq_entry_t *)work, WORK_QUEUE(wqueue, work));
     }
 
   /* Initialize the work structure. */
@@ -121,7 +121,29 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 
   work->qtime  = clock_systimer(); /* Time work queued */
 
-  dq_addlast((FAR dq_entry_t *)work, &wqueue->q);
+  if (delay == 0)
+    {
+      /* Work to be performed immediately goes at the end of the ready
+       * queue.  With per-CPU queues, that is the ready queue of the worker
+       * that services this CPU (or of worker 0 if the worker threads have
+       * not been started yet).
+       */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+      work->wndx = wqueue->nthreads > 0 ?
+                   up_cpu_index() % wqueue->nthreads : 0;
+#endif
+      dq_addlast((FAR dq_entry_t *)work, WORK_READYQ(wqueue, work->wndx));
+    }
+  else
+    {
+      /* Delayed work goes into the timer wheel slot of the tick at which
+       * it expires.
+       */
+
+      dq_addlast((FAR dq_entry_t *)work,
+                 &wqueue->wheel[WORK_SLOT(work->qtime + delay)]);
+    }
 
   leave_critical_section(flags);
 }
@@ -162,31 +184,72 @@ static void work_qqueue(FAR struct kwork_wqueue_s *wqueue,
 int work_queue(int qid, FAR struct work_s *work, worker_t worker,
                FAR void *arg, clock_t delay)
 {
+  FAR struct kwork_wqueue_s *wqueue;
+
+  /* Get the work queue */
+
+  wqueue = work_wqueue(qid);
+  if (wqueue == NULL)
+    {
+      return -EINVAL;
+    }
+
   /* Queue the new work */
 
+  work_qqueue(wqueue, work, worker, arg, delay);
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  /* Immediate work is best performed by the worker whose queue holds it.
+   * Delayed work must wake worker 0:  Only it waits for delays to expire.
+   */
+
+  if (delay == 0)
+    {
+      return work_wsignal(wqueue, work->wndx);
+    }
+#endif
+
+  return work_signal(qid);
+}
+
+/****************************************************************************
+ * Name: work_wqueue
+ *
+ * Description:
+ *   Return the kernel work queue with the given ID.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   The work queue or NULL if there is no work queue with that ID.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_wqueue(int qid)
+{
 #ifdef CONFIG_SCHED_HPWORK
   if (qid == HPWORK)
     {
-      /* Queue high priority work */
-
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_hpwork, work, worker, arg, delay);
-      return work_signal(HPWORK);
+      return (FAR struct kwork_wqueue_s *)&g_hpwork;
     }
-  else
 #endif
+
 #ifdef CONFIG_SCHED_LPWORK
   if (qid == LPWORK)
     {
-      /* Queue low priority work */
-
-      work_qqueue((FAR struct kwork_wqueue_s *)&g_lpwork, work, worker, arg, delay);
-      return work_signal(LPWORK);
+      return (FAR struct kwork_wqueue_s *)&g_lpwork;
     }
-  else
 #endif
+
+#if CONFIG_SCHED_NWORKQUEUES > 0
+  if (qid >= NAMEDWORK && qid < NAMEDWORK + CONFIG_SCHED_NWORKQUEUES)
     {
-      return -EINVAL;
+      return g_namedwork[qid - NAMEDWORK];
     }
+#endif
+
+  return NULL;
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
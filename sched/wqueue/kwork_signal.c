@@ -54,47 +54,33 @@
  ****************************************************************************/
 
 /****************************************************************************
- * Name: work_signal
+ * Name: work_wsignal
  *
  * Description:
- *   Signal the worker thread to process the work queue now.  This function
- *   is used internally by the work logic but could also be used by the
- *   user to force an immediate re-assessment of pending work.
+ *   Signal an IDLE worker thread of a work queue, trying worker first
+ *   before the others.
  *
  * Input Parameters:
- *   qid    - The work queue ID
+ *   wqueue - The work queue
+ *   first  - The index of the worker thread to try first
  *
  * Returned Value:
  *   Zero (OK) on success, a negated errno value on failure
  *
  ****************************************************************************/
 
-int work_signal(int qid)
+int work_wsignal(FAR struct kwork_wqueue_s *wqueue, int first)
 {
-  FAR struct kwork_wqueue_s *work;
   int threads;
+  int wndx;
   int i;
 
-  /* Get the process ID of the worker thread */
+  /* There is nothing to signal until the worker threads are started */
 
-#ifdef CONFIG_SCHED_HPWORK
-  if (qid == HPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_hpwork;
-      threads = CONFIG_SCHED_HPNTHREADS;
-    }
-  else
-#endif
-#ifdef CONFIG_SCHED_LPWORK
-  if (qid == LPWORK)
-    {
-      work = (FAR struct kwork_wqueue_s *)&g_lpwork;
-      threads = CONFIG_SCHED_LPNTHREADS;
-    }
-  else
-#endif
+  threads = wqueue->nthreads;
+  if (threads == 0)
     {
-      return -EINVAL;
+      return OK;
     }
 
   /* Find an IDLE worker thread */
@@ -103,24 +89,51 @@ int work_signal(int qid)
     {
       /* Is this worker thread busy? */
 
-      if (!work->worker[i].busy)
+      wndx = (first + i) % threads;
+      if (!wqueue->worker[wndx].busy)
         {
-          /* No.. select this thread */
+          /* No.. signal this thread */
 
-          break;
+          return nxsig_kill(wqueue->worker[wndx].pid, SIGWORK);
         }
     }
 
   /* If all of the IDLE threads are busy, then just return successfully */
 
-  if (i >= threads)
+  return OK;
+}
+
+/****************************************************************************
+ * Name: work_signal
+ *
+ * Description:
+ *   Signal the worker thread to process the work queue now.  This function
+ *   is used internally by the work logic but could also be used by the
+ *   user to force an immediate re-assessment of pending work.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_signal(int qid)
+{
+  FAR struct kwork_wqueue_s *wqueue;
+
+  /* Get the work queue */
+
+  wqueue = work_wqueue(qid);
+  if (wqueue == NULL)
     {
-      return OK;
+      return -EINVAL;
     }
 
-  /* Otherwise, signal the first IDLE thread found */
+  /* Prefer worker 0:  Only it waits for delayed work to expire */
 
-  return nxsig_kill(work->worker[i].pid, SIGWORK);
+  return work_wsignal(wqueue, 0);
 }
 
 #endif /* CONFIG_SCHED_WORKQUEUE */
@@ -59,6 +59,38 @@
 #define HPWORKNAME "hpwork"
 #define LPWORKNAME "lpwork"
 
+/* Delayed work timer wheel */
+
+#ifndef CONFIG_SCHED_WORKWHEEL_SIZE
+#  define CONFIG_SCHED_WORKWHEEL_SIZE 32
+#endif
+
+#if (CONFIG_SCHED_WORKWHEEL_SIZE & (CONFIG_SCHED_WORKWHEEL_SIZE - 1)) != 0
+#  error CONFIG_SCHED_WORKWHEEL_SIZE must be a power of two
+#endif
+
+#define WORK_WHEEL_SIZE   CONFIG_SCHED_WORKWHEEL_SIZE
+#define WORK_WHEEL_MASK   (WORK_WHEEL_SIZE - 1)
+
+/* Return the timer wheel slot of work that expires at tick */
+
+#define WORK_SLOT(tick)   ((unsigned int)(tick) & WORK_WHEEL_MASK)
+
+/* Return the ready queue of worker wndx */
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+#  define WORK_READYQ(wqueue, wndx) (&(wqueue)->worker[wndx].q)
+#else
+#  define WORK_READYQ(wqueue, wndx) (&(wqueue)->q)
+#endif
+
+/* Return the queue that holds a queued work structure */
+
+#define WORK_QUEUE(wqueue, work) \
+  ((work)->delay > 0 ? \
+   &(wqueue)->wheel[WORK_SLOT((work)->qtime + (work)->delay)] : \
+   WORK_READYQ(wqueue, (work)->wndx))
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -69,13 +101,32 @@ struct kworker_s
 {
   pid_t             pid;    /* The task ID of the worker thread */
   volatile bool     busy;   /* True: Worker is not available */
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct dq_queue_s q;      /* The queue of pending work of this worker */
+#endif
 };
 
-/* This structure defines the state of one kernel-mode work queue */
+/* This structure defines the state of one kernel-mode work queue.
+ *
+ * Work queued with no delay is kept in the ready queue, q, in FIFO order.
+ * With CONFIG_SCHED_WORKQUEUE_PERCPU, each worker has its own ready queue
+ * instead.  Delayed work is kept in the timer wheel slot of the tick at
+ * which it expires and is moved to a ready queue once that tick has
+ * elapsed.  The delay of work in a ready queue is always zero; the delay
+ * of work in the wheel is always non-zero.
+ */
 
 struct kwork_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct dq_queue_s q;         /* The queue of pending work */
+#endif
+  struct dq_queue_s wheel[WORK_WHEEL_SIZE]; /* The delayed work */
+  clock_t           wtick;     /* Last tick processed in the wheel */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;   /* Latency statistics */
+#endif
+  uint8_t           nthreads;  /* Number of worker threads */
   struct kworker_s  worker[1]; /* Describes a worker thread */
 };
 
@@ -86,7 +137,15 @@ struct kwork_wqueue_s
 #ifdef CONFIG_SCHED_HPWORK
 struct hp_wqueue_s
 {
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
   struct dq_queue_s q;         /* The queue of pending work */
+#endif
+  struct dq_queue_s wheel[WORK_WHEEL_SIZE]; /* The delayed work */
+  clock_t           wtick;     /* Last tick processed in the wheel */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;   /* Latency statistics */
+#endif
+  uint8_t           nthreads;  /* Number of worker threads */
 
   /* Describes each thread in the high priority queue's thread pool */
 
@@ -101,7 +160,15 @@ struct hp_wqueue_s
 #ifdef CONFIG_SCHED_LPWORK
 struct lp_wqueue_s
 {
-  struct dq_queue_s q;      /* The queue of pending work */
+#ifndef CONFIG_SCHED_WORKQUEUE_PERCPU
+  struct dq_queue_s q;         /* The queue of pending work */
+#endif
+  struct dq_queue_s wheel[WORK_WHEEL_SIZE]; /* The delayed work */
+  clock_t           wtick;     /* Last tick processed in the wheel */
+#ifdef CONFIG_SCHED_WORKQUEUE_STATS
+  struct work_stats_s stats;   /* Latency statistics */
+#endif
+  uint8_t           nthreads;  /* Number of worker threads */
 
   /* Describes each thread in the low priority queue's thread pool */
 
@@ -125,6 +192,14 @@ extern struct hp_wqueue_s g_hpwork;
 extern struct lp_wqueue_s g_lpwork;
 #endif
 
+#if CONFIG_SCHED_NWORKQUEUES > 0
+/* The state of the work queues created by work_create().  Entry n holds
+ * the work queue with ID (NAMEDWORK + n) or NULL if it was not created.
+ */
+
+extern FAR struct kwork_wqueue_s *g_namedwork[CONFIG_SCHED_NWORKQUEUES];
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -187,6 +262,59 @@ int work_lpstart(void);
 
 void work_process(FAR struct kwork_wqueue_s *wqueue, int wndx);
 
+/****************************************************************************
+ * Name: work_wqueue
+ *
+ * Description:
+ *   Return the kernel work queue with the given ID.
+ *
+ * Input Parameters:
+ *   qid    - The work queue ID
+ *
+ * Returned Value:
+ *   The work queue or NULL if there is no work queue with that ID.
+ *
+ ****************************************************************************/
+
+FAR struct kwork_wqueue_s *work_wqueue(int qid);
+
+/****************************************************************************
+ * Name: work_wsignal
+ *
+ * Description:
+ *   Signal an IDLE worker thread of a work queue, trying worker first
+ *   before the others.
+ *
+ * Input Parameters:
+ *   wqueue - The work queue
+ *   first  - The index of the worker thread to try first
+ *
+ * Returned Value:
+ *   Zero (OK) on success, a negated errno value on failure
+ *
+ ****************************************************************************/
+
+int work_wsignal(FAR struct kwork_wqueue_s *wqueue, int first);
+
+/****************************************************************************
+ * Name: work_bindcpu
+ *
+ * Description:
+ *   Bind worker thread wndx to the CPU whose ready queue it services.
+ *
+ * Input Parameters:
+ *   pid    - The task ID of the worker thread
+ *   wndx   - The worker thread index
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_WORKQUEUE_PERCPU
+void work_bindcpu(pid_t pid, int wndx);
+#endif
+
 /****************************************************************************
  * Name: work_notifier_initialize
  *
@@ -259,6 +259,10 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(mkfifo2,                  3, STUB_mkfifo2)
 #  endif
 
+#  if defined(CONFIG_PIPES)
+  SYSCALL_LOOKUP(splice,                   6, STUB_splice)
+#  endif
+
 #  if CONFIG_NFILE_STREAMS > 0
   SYSCALL_LOOKUP(fdopen,                   3, STUB_fs_fdopen)
   SYSCALL_LOOKUP(sched_getstreams,         0, STUB_sched_getstreams)
@@ -379,6 +383,7 @@ SYSCALL_LOOKUP(up_assert,                  2, STUB_up_assert)
   SYSCALL_LOOKUP(sendto,                   6, STUB_sendto)
   SYSCALL_LOOKUP(setsockopt,               5, STUB_setsockopt)
   SYSCALL_LOOKUP(socket,                   3, STUB_socket)
+  SYSCALL_LOOKUP(socketpair,               4, STUB_socketpair)
 #endif
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
@@ -259,6 +259,9 @@ uintptr_t STUB_readlink(int nbr, uintptr_t parm1, uintptr_t parm2,
 uintptr_t STUB_pipe2(int nbr, uintptr_t parm1, uintptr_t parm2);
 uintptr_t STUB_mkfifo2(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
+uintptr_t STUB_splice(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4, uintptr_t parm5,
+            uintptr_t parm6);
 
 uintptr_t STUB_fs_fdopen(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
@@ -394,6 +397,8 @@ uintptr_t STUB_setsockopt(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3, uintptr_t parm4, uintptr_t parm5);
 uintptr_t STUB_socket(int nbr, uintptr_t parm1, uintptr_t parm2,
             uintptr_t parm3);
+uintptr_t STUB_socketpair(int nbr, uintptr_t parm1, uintptr_t parm2,
+            uintptr_t parm3, uintptr_t parm4);
 
 /* The following is defined only if CONFIG_TASK_NAME_SIZE > 0 */
 
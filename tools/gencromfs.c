@@ -161,7 +161,7 @@ struct cromfs_volume_s
 struct cromfs_node_s
 {
   uint16_t cn_mode;       /* File type, attributes, and access mode bits */
-  uint16_t cn_pad;        /* Not used */
+  uint16_t cn_pad;        /* Size of the directory index ('.' nodes only) */
   uint32_t cn_name;       /* Offset from the beginning of the volume header to the
                            * node name string.  NUL-terminated. */
   uint32_t cn_size;       /* Size of the uncompressed data (in bytes) */
@@ -174,6 +174,28 @@ struct cromfs_node_s
   } u;
 };
 
+/* The '.' node at the head of each directory is followed by an index of
+ * the directory:  The offsets of all of the nodes in the directory sorted
+ * by name.  cn_pad holds the number of entries in the index.
+ */
+
+#define CROMFS_INDEX_ALIGN(o) (((o) + 3) & ~3)
+
+/* Used to collect the directory index while a directory is generated */
+
+struct dirindex_entry_s
+{
+  char *name;             /* Name of the node */
+  uint32_t offset;        /* Offset to the node */
+};
+
+struct dirindex_s
+{
+  struct dirindex_entry_s *entries;
+  unsigned int nentries;
+  unsigned int nalloc;
+};
+
 /* LZF headers */
 
 struct lzf_header_s       /* Common data header */
@@ -250,6 +272,7 @@ static const char g_delim[] =
 static uint32_t g_offset;        /* Current image offset */
 static uint32_t g_diroffset;     /* Offset for '.' */
 static uint32_t g_parent_offset; /* Offset for '..' */
+static struct dirindex_s *g_dirindex; /* Index of the current directory */
 
 static unsigned int g_nnodes;  /* Number of nodes generated */
 static unsigned int g_nblocks; /* Number of blocks of data generated */
@@ -285,6 +308,10 @@ static inline uint32_t tgt_uint32(uint32_t a);
 #  define TGT_UINT16(a) (a)
 #  define TGT_UINT32(a) (a)
 #endif
+static void dirindex_add(const char *name, uint32_t offset);
+static int  dirindex_compare(const void *a, const void *b);
+static uint32_t dotlink_size(uint32_t dotoffs, unsigned int nindex);
+static void gen_dotlink(uint32_t dotoffs, bool dirempty);
 static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty);
 static void gen_directory(const char *path, const char *name, mode_t mode,
                           bool lastentry);
@@ -292,6 +319,8 @@ static void gen_file(const char *path, const char *name, mode_t mode,
                           bool lastentry);
 static int  dir_notempty(const char *dirpath, const char *name,
                          void *arg, bool lastentry);
+static int  dir_count(const char *dirpath, const char *name,
+                      void *arg, bool lastentry);
 static int  process_direntry(const char *dirpath, const char *name,
                              void *arg, bool lastentry);
 static int  traverse_directory(const char *dirpath,
@@ -895,6 +924,92 @@ static inline uint32_t tgt_uint32(uint32_t a)
 }
 #endif
 
+static void dirindex_add(const char *name, uint32_t offset)
+{
+  struct dirindex_s *index = g_dirindex;
+
+  if (index->nentries >= index->nalloc)
+    {
+      index->nalloc  = index->nalloc ? 2 * index->nalloc : 16;
+      index->entries = realloc(index->entries,
+                               index->nalloc * sizeof(struct dirindex_entry_s));
+      if (index->entries == NULL)
+        {
+          fprintf(stderr, "ERROR: Failed to allocate directory index\n");
+          exit(1);
+        }
+    }
+
+  index->entries[index->nentries].name   = strdup(name);
+  index->entries[index->nentries].offset = offset;
+  index->nentries++;
+}
+
+static int dirindex_compare(const void *a, const void *b)
+{
+  return strcmp(((const struct dirindex_entry_s *)a)->name,
+                ((const struct dirindex_entry_s *)b)->name);
+}
+
+static uint32_t dotlink_size(uint32_t dotoffs, unsigned int nindex)
+{
+  /* The '.' node, its name, padding and the index */
+
+  return CROMFS_INDEX_ALIGN(dotoffs + sizeof(struct cromfs_node_s) + 2) -
+         dotoffs + nindex * sizeof(uint32_t);
+}
+
+static void gen_dotlink(uint32_t dotoffs, bool dirempty)
+{
+  static const uint8_t pad[4];
+  struct dirindex_s *index = g_dirindex;
+  struct cromfs_node_s node;
+  uint32_t nameoffs;
+  uint32_t tbloffs;
+  uint32_t offset;
+  unsigned int i;
+
+  /* Sort the index by name */
+
+  qsort(index->entries, index->nentries, sizeof(struct dirindex_entry_s),
+        dirindex_compare);
+
+  /* Generate the hardlink node, followed by the index */
+
+  dump_nextline(g_tmpstream);
+  fprintf(g_tmpstream, "\n  /* Offset %6lu:  Hard link . (%u entries) */\n\n",
+          (unsigned long)dotoffs, index->nentries);
+
+  nameoffs        = dotoffs + sizeof(struct cromfs_node_s);
+  tbloffs         = CROMFS_INDEX_ALIGN(nameoffs + 2);
+
+  node.cn_mode    = TGT_UINT16(DIRLINK_MODEFLAGS);
+  node.cn_pad     = TGT_UINT16(index->nentries);
+  node.cn_name    = TGT_UINT32(nameoffs);
+  node.cn_size    = 0;
+  node.cn_peer    = TGT_UINT32(dirempty ? 0 :
+                               dotoffs + dotlink_size(dotoffs, index->nentries));
+  node.u.cn_link  = TGT_UINT32(dotoffs);
+
+  dump_hexbuffer(g_tmpstream, &node, sizeof(struct cromfs_node_s));
+  dump_hexbuffer(g_tmpstream, ".", 2);
+  dump_hexbuffer(g_tmpstream, pad, tbloffs - nameoffs - 2);
+
+  for (i = 0; i < index->nentries; i++)
+    {
+      offset = TGT_UINT32(index->entries[i].offset);
+      dump_hexbuffer(g_tmpstream, &offset, sizeof(uint32_t));
+      free(index->entries[i].name);
+    }
+
+  free(index->entries);
+  index->entries  = NULL;
+  index->nentries = 0;
+  index->nalloc   = 0;
+
+  g_nnodes++;
+}
+
 static void gen_dirlink(const char *name, uint32_t tgtoffs, bool dirempty)
 {
   struct cromfs_node_s node;
@@ -932,17 +1047,25 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
   uint32_t save_offset        = g_offset;
   uint32_t save_diroffset     = g_diroffset;
   uint32_t save_parent_offset = g_parent_offset;
+  struct dirindex_s *save_dirindex = g_dirindex;
   FILE *save_tmpstream      = g_tmpstream;
   FILE *subtree_stream;
+  FILE *children_stream;
+  struct dirindex_s dirindex;
+  unsigned int nentries;
   int namlen;
   int result;
 
   namlen          = strlen(name) + 1;
 
-  /* Open a new temporary file */
+  /* Open new temporary files:  One for the '.' link that heads the
+   * sub-directory and one for the remaining nodes.  The '.' link cannot be
+   * generated until the offsets of all of the other nodes are known.
+   */
 
   subtree_stream  = open_tmpfile();
-  g_tmpstream     = subtree_stream;
+  children_stream = open_tmpfile();
+  g_tmpstream     = children_stream;
 
   /* Update the offset to account for the file node which we have not yet
    * written (we can't, we don't have enough information yet)
@@ -956,16 +1079,23 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
   g_diroffset     = g_offset;     /* New offset for '.' */
 
   /* We are going to traverse the new directory twice; the first time just
-   * see if the directory is empty.  The second time is the real thing.
+   * to count the entries.  The second time is the real thing.
    */
 
-  result = traverse_directory(path, dir_notempty, NULL);
+  nentries = 0;
+  (void)traverse_directory(path, dir_count, &nentries);
+  result = nentries > 0;
 
-  /* Generate the '.' and '..' links for the directory (in the new temporary
-   * file).
+  /* Reserve space for the '.' link and the directory index ('.', '..' and
+   * the entries).  Then generate the '..' link.
    */
 
-  gen_dirlink(".", g_diroffset, false);
+  memset(&dirindex, 0, sizeof(struct dirindex_s));
+  g_dirindex      = &dirindex;
+  dirindex_add(".", g_diroffset);
+
+  g_offset       += dotlink_size(g_diroffset, nentries + 2);
+  dirindex_add("..", g_offset);
   gen_dirlink("..", g_parent_offset, result == 0);
   if (result != 0)
     {
@@ -974,6 +1104,12 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
       (void)traverse_directory(path, process_direntry, NULL);
     }
 
+  /* Now the '.' link can be generated at the head of the sub-directory */
+
+  g_tmpstream     = subtree_stream;
+  gen_dotlink(g_diroffset, false);
+  append_tmpfile(subtree_stream, children_stream);
+
   /* When traverse_directory() returns, all of the nodes in the sub-tree under
    * 'name' will have been written to the new tmpfile.  g_offset is correct,
    * but other settings are not.
@@ -984,6 +1120,7 @@ static void gen_directory(const char *path, const char *name, mode_t mode,
   g_tmpstream     = save_tmpstream;
   g_diroffset     = save_diroffset;
   g_parent_offset = save_parent_offset;
+  g_dirindex      = save_dirindex;
 
   /* Generate the directory node */
 
@@ -1161,6 +1298,19 @@ static int dir_notempty(const char *dirpath, const char *name,
   return (S_ISREG(buf.st_mode) || S_ISDIR(buf.st_mode));
 }
 
+static int dir_count(const char *dirpath, const char *name,
+                     void *arg, bool lastentry)
+{
+  /* Count the entries that will be generated */
+
+  if (dir_notempty(dirpath, name, NULL, lastentry))
+    {
+      (*(unsigned int *)arg)++;
+    }
+
+  return 0;
+}
+
 static int process_direntry(const char *dirpath, const char *name,
                             void *arg, bool lastentry)
 {
@@ -1191,10 +1341,12 @@ static int process_direntry(const char *dirpath, const char *name,
 
   else if (S_ISDIR(buf.st_mode))
     {
+      dirindex_add(name, g_offset);
       gen_directory(path, name, buf.st_mode, lastentry);
     }
   else if (S_ISREG(buf.st_mode))
     {
+      dirindex_add(name, g_offset);
       gen_file(path, name, buf.st_mode, lastentry);
     }
   else
@@ -1237,10 +1389,16 @@ static int traverse_directory(const char *dirpath,
       strncpy(name, direntry->d_name, NAME_MAX + 1);
 
       /* Get the next entry in advance so that we can anticipate the end of
-       * the directory.
+       * the directory.  The '.' and '..' entries do not count.
        */
 
-      direntry = readdir(dirp);
+      do
+        {
+          direntry = readdir(dirp);
+        }
+      while (direntry != NULL &&
+             (strcmp(direntry->d_name, ".") == 0 ||
+              strcmp(direntry->d_name, "..") == 0));
 
       /* Skip the '.' and '..' hard links */
 
@@ -1267,6 +1425,10 @@ static int traverse_directory(const char *dirpath,
 int main(int argc, char **argv, char **envp)
 {
   struct cromfs_volume_s vol;
+  struct dirindex_s dirindex;
+  FILE *root_stream;
+  FILE *children_stream;
+  unsigned int nentries;
   char *ptr;
   int result;
 
@@ -1307,23 +1469,40 @@ int main(int argc, char **argv, char **envp)
   g_parent_offset = sizeof(struct cromfs_volume_s);  /* Offset for '..' */
 
   /* We are going to traverse the new directory twice; the first time just
-   * see if the directory is empty.  The second time is the real thing.
+   * to count the entries.  The second time is the real thing.
    */
 
-  result = traverse_directory(g_dirname, dir_notempty, NULL);
+  nentries = 0;
+  (void)traverse_directory(g_dirname, dir_count, &nentries);
+  result = nentries > 0;
 
-  /* Generate the '.' link for the root directory (it can't have a '..') */
+  /* Reserve space for the '.' link for the root directory (it can't have a
+   * '..') and the directory index.
+   */
+
+  memset(&dirindex, 0, sizeof(struct dirindex_s));
+  g_dirindex      = &dirindex;
+  dirindex_add(".", g_diroffset);
+  g_offset       += dotlink_size(g_diroffset, nentries + 1);
 
-  gen_dirlink(".", g_diroffset, result == 0);
+  root_stream     = g_tmpstream;
+  children_stream = open_tmpfile();
   if (result != 0)
     {
       /* Then traverse each entry in the directory, generating node data for
        * each directory entry encountered.
        */
 
+      g_tmpstream = children_stream;
       (void)traverse_directory(g_dirname, process_direntry, NULL);
     }
 
+  /* Now generate the '.' link at the head of the root directory */
+
+  g_tmpstream = root_stream;
+  gen_dotlink(g_diroffset, result == 0);
+  append_tmpfile(g_tmpstream, children_stream);
+
   /* Now append the volume header to output file */
 
   fprintf(g_outstream, "/* CROMFS image */\n\n");